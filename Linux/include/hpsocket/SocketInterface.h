@@ -121,6 +121,32 @@ public:
 	*/
 	virtual BOOL DisconnectSilenceConnections(DWORD dwPeriod, BOOL bForce = TRUE)	= 0;
 
+	/*
+	* 名称：设置连接定时器
+	* 描述：为连接设置一次性定时器，定时器到期时在工作线程中调用 fnTimer（TCP 组件的分片分派模式下为连接所属分片的工作线程）
+	*		1、每个连接只有一个定时器，重复设置将替换原来的定时器
+	*		2、连接断开时定时器自动取消
+	*		3、定时精度为定时器刻度间隔（参考：SetTimerInterval()）
+	*		
+	* 参数：		dwConnID	-- 连接 ID
+	*			dwTimeout	-- 超时时间（毫秒）
+	*			fnTimer		-- 定时器回调函数
+	*			pvParam		-- 自定义参数
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL SetConnectionTimer(CONNID dwConnID, DWORD dwTimeout, Fn_ConnectionTimer fnTimer, PVOID pvParam = nullptr)	= 0;
+
+	/*
+	* 名称：取消连接定时器
+	* 描述：取消 SetConnectionTimer() 设置的连接定时器
+	*		
+	* 参数：		dwConnID	-- 连接 ID
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败（无效的连接 ID 或定时器未设置）
+	*/
+	virtual BOOL KillConnectionTimer(CONNID dwConnID)								= 0;
+
 public:
 
 	/***********************************************************************/
@@ -176,6 +202,8 @@ public:
 	virtual BOOL IsPauseReceive			(CONNID dwConnID, BOOL& bPaused)		= 0;
 	/* 检测是否有效连接 */
 	virtual BOOL IsConnected			(CONNID dwConnID)						= 0;
+	/* 获取内存块线程缓存槽的累计命中和未命中次数（未命中时从共享缓存池批量补充，组件未启动或未启用线程缓存槽时均为 0） */
+	virtual void GetFreeBufferObjCacheStat	(ULONGLONG& ullHits, ULONGLONG& ullMisses)	= 0;
 
 	/* 设置数据发送策略（对 Linux 平台组件无效） */
 	virtual void SetSendPolicy				(EnSendPolicy enSendPolicy)			= 0;
@@ -193,10 +221,32 @@ public:
 	virtual void SetFreeSocketObjHold		(DWORD dwFreeSocketObjHold)			= 0;
 	/* 设置内存块缓存池回收阀值（通常设置为内存块缓存池大小的 3 倍） */
 	virtual void SetFreeBufferObjHold		(DWORD dwFreeBufferObjHold)			= 0;
+	/* 设置启动时预先创建的 Socket 缓存对象数量（不超过 Socket 缓存池大小，可减少首批连接的内存分配和缺页，默认：0） */
+	virtual void SetFreeSocketObjPrealloc	(DWORD dwFreeSocketObjPrealloc)		= 0;
+	/* 设置启动时预先创建的内存块数量（不超过内存块缓存池大小，默认：0） */
+	virtual void SetFreeBufferObjPrealloc	(DWORD dwFreeBufferObjPrealloc)		= 0;
+	/* 设置内存块线程缓存槽容量（缓存槽数量为 CPU 核数的 2 倍，所有缓存槽最多占用内存块缓存池的一半，超出时自动减小容量，启用定时器时空闲缓存槽中的内存块会定期归还缓存池，0 则不使用线程缓存槽，默认：32） */
+	virtual void SetFreeBufferObjCache		(DWORD dwFreeBufferObjCache)		= 0;
+	/* 设置缓存池内存是否在各 NUMA 节点间交错分配（缓存池由所有工作线程共享，交错分配可均衡各节点的内存访问，默认：FALSE） */
+	virtual void SetPoolNumaInterleave		(BOOL bPoolNumaInterleave)			= 0;
 	/* 设置工作线程数量（通常设置为 2 * CPU + 2） */
 	virtual void SetWorkerThreadCount		(DWORD dwWorkerThreadCount)			= 0;
 	/* 设置是否标记静默时间（设置为 TRUE 时 DisconnectSilenceConnections() 和 GetSilencePeriod() 才有效，默认：TRUE） */
 	virtual void SetMarkSilence				(BOOL bMarkSilence)					= 0;
+	/* 设置定时器刻度间隔（毫秒，组件按该精度检测连接超时和触发连接定时器，0 则不启用定时器，默认：100） */
+	virtual void SetTimerInterval			(DWORD dwTimerInterval)				= 0;
+	/* 设置最大连接时长（毫秒，连接时长超过该值时自动断开连接，0 则不限制，默认：0） */
+	virtual void SetMaxConnectPeriod		(DWORD dwMaxConnectPeriod)			= 0;
+	/* 设置静默超时时间（毫秒，连接静默时间超过该值时自动断开连接，需要标记静默时间，0 则不检测，默认：0） */
+	virtual void SetSilenceTimeout			(DWORD dwSilenceTimeout)			= 0;
+	/* 设置握手超时时间（毫秒，连接超过该时间仍未完成握手时自动断开连接，只对 SSL 组件有效，0 则不检测，默认：0） */
+	virtual void SetHandShakeTimeout		(DWORD dwHandShakeTimeout)			= 0;
+	/* 设置连接发送缓冲区高水位（字节，连接待发数据达到该值时触发 OnWritable(FALSE) 事件并拒绝后续发送，0 则不限制，默认：0） */
+	virtual void SetSendHighWatermark		(DWORD dwSendHighWatermark)			= 0;
+	/* 设置连接发送缓冲区低水位（字节，达到高水位后待发数据降到该值以下时触发 OnWritable(TRUE) 事件并恢复发送，必须小于高水位，默认：0） */
+	virtual void SetSendLowWatermark		(DWORD dwSendLowWatermark)			= 0;
+	/* 设置组件所有连接待发数据总量上限（字节，达到该值时拒绝所有连接的后续发送，0 则不限制，默认：0） */
+	virtual void SetMaxSendPending			(DWORD dwMaxSendPending)			= 0;
 
 	/* 获取数据发送策略（对 Linux 平台组件无效） */
 	virtual EnSendPolicy GetSendPolicy				()	= 0;
@@ -214,10 +264,32 @@ public:
 	virtual DWORD GetFreeSocketObjHold				()	= 0;
 	/* 获取内存块缓存池回收阀值 */
 	virtual DWORD GetFreeBufferObjHold				()	= 0;
+	/* 获取启动时预先创建的 Socket 缓存对象数量 */
+	virtual DWORD GetFreeSocketObjPrealloc			()	= 0;
+	/* 获取启动时预先创建的内存块数量 */
+	virtual DWORD GetFreeBufferObjPrealloc			()	= 0;
+	/* 获取内存块线程缓存槽容量 */
+	virtual DWORD GetFreeBufferObjCache				()	= 0;
+	/* 检测缓存池内存是否在各 NUMA 节点间交错分配 */
+	virtual BOOL IsPoolNumaInterleave				()	= 0;
 	/* 获取工作线程数量 */
 	virtual DWORD GetWorkerThreadCount				()	= 0;
 	/* 检测是否标记静默时间 */
 	virtual BOOL IsMarkSilence						()	= 0;
+	/* 获取定时器刻度间隔 */
+	virtual DWORD GetTimerInterval					()	= 0;
+	/* 获取最大连接时长 */
+	virtual DWORD GetMaxConnectPeriod				()	= 0;
+	/* 获取静默超时时间 */
+	virtual DWORD GetSilenceTimeout					()	= 0;
+	/* 获取握手超时时间 */
+	virtual DWORD GetHandShakeTimeout				()	= 0;
+	/* 获取连接发送缓冲区高水位 */
+	virtual DWORD GetSendHighWatermark				()	= 0;
+	/* 获取连接发送缓冲区低水位 */
+	virtual DWORD GetSendLowWatermark				()	= 0;
+	/* 获取组件所有连接待发数据总量上限 */
+	virtual DWORD GetMaxSendPending					()	= 0;
 
 public:
 	virtual ~IComplexSocket() = default;
@@ -278,6 +350,94 @@ public:
 	*/
 	virtual BOOL SendSmallFile		(CONNID dwConnID, LPCTSTR lpszFileName, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr)	= 0;
 
+	/*
+	* 名称：发送文件
+	* 描述：向指定连接发送文件的指定区域（不限于小文件）
+	*		普通 TCP 连接使用 sendfile() 直接从文件发送，文件数据不经过用户态缓冲区；
+	*		SSL 连接或 Pack 组件等需要加工发送数据的情形则映射文件区域后按普通数据发送
+	*		（数据会被拷贝到发送缓冲区，因此一次发送的总长度与 SendSmallFile() 一样不能超过 4 MB）
+	*		（sendfile() 发送的数据触发 OnSend() 事件时 pData 参数为 nullptr）
+	*		
+	* 参数：		dwConnID		-- 连接 ID
+	*			lpszFileName	-- 文件路径
+	*			llOffset		-- 文件区域起始偏移
+	*			llLength		-- 文件区域长度（0：发送到文件末尾）
+	*			pHead			-- 头部附加数据
+	*			pTail			-- 尾部附加数据（文件区域长度不受 2 GB 限制，超大文件会分成多个窗口依次发送）
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL SendFile			(CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset = 0, LONGLONG llLength = 0, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr)	= 0;
+
+	/*
+	* 名称：以引用方式发送数据
+	* 描述：向指定连接发送数据，组件不拷贝缓冲区数据，而是引用该缓冲区直接提交给系统发送（适合发送大块数据）
+	*		缓冲区不再被组件引用时（数据已全部提交给系统，或者发送失败、连接关闭）调用 fnRelease，在此之前不能修改或释放该缓冲区；
+	*		无论本方法返回 TRUE 还是 FALSE，fnRelease 都会且只会被调用一次（可能在本方法返回前调用），fnRelease 中不要调用本组件的发送方法
+	*		（SSL 组件和 PACK 组件需要对发送数据进行加工，退化为拷贝发送，拷贝完成后立即调用 fnRelease）
+	*		
+	* 参数：		dwConnID	-- 连接 ID
+	*			pBuffer		-- 发送缓冲区
+	*			iLength		-- 发送缓冲区长度
+	*			fnRelease	-- 缓冲区释放函数（可以为 nullptr）
+	*			pvParam		-- 缓冲区释放函数的自定义参数
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL SendReference		(CONNID dwConnID, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam = nullptr)	= 0;
+
+	/*
+	* 名称：广播数据
+	* 描述：向多个连接发送相同的数据，数据只拷贝一次到引用计数的共享数据块，各连接以引用方式把共享数据块加入发送队列
+	*		（PACK 组件只构造一次包头；SSL 组件需要逐个连接加密，退化为逐个连接发送）
+	*		
+	* 参数：		pConnIDs	-- 连接 ID 数组
+	*			iConnCount	-- 连接 ID 数组长度
+	*			pBuffer		-- 发送缓冲区
+	*			iLength		-- 发送缓冲区长度
+	* 返回值：	TRUE	-- 全部连接发送成功
+	*			FALSE	-- 部分或全部连接发送失败（失败的连接不影响其它连接的发送），可通过系统 API 函数 ::GetLastError() 获取最后一个错误代码
+	*/
+	virtual BOOL Broadcast			(const CONNID pConnIDs[], int iConnCount, const BYTE* pBuffer, int iLength)	= 0;
+
+	/*
+	* 名称：广播多组数据
+	* 描述：向多个连接发送相同的多组数据，多组数据合并拷贝到一个引用计数的共享数据块（参考：Broadcast()）
+	*		
+	* 参数：		pConnIDs	-- 连接 ID 数组
+	*			iConnCount	-- 连接 ID 数组长度
+	*			pBuffers	-- 发送缓冲区数组
+	*			iCount		-- 发送缓冲区数目
+	* 返回值：	TRUE	-- 全部连接发送成功
+	*			FALSE	-- 部分或全部连接发送失败，可通过系统 API 函数 ::GetLastError() 获取最后一个错误代码
+	*/
+	virtual BOOL BroadcastPackets	(const CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount)	= 0;
+
+	/*
+	* 名称：分离接收缓冲区
+	* 描述：在 OnReceive 事件中取得接收缓冲区的所有权，OnReceive 事件返回后 pData 仍然有效，直到调用 ReleaseReceiveBuffer() 归还缓冲区
+	*		1、只在可分离接收模式下有效（参考：SetDetachableReceive()），并且只能在 OnReceive 事件中调用
+	*		2、pData 和 iLength 必须是 OnReceive 事件的原始参数；PULL / PACK / HTTP / SSL 组件的接收数据经过了加工，不能分离
+	*		3、应用程序可以在任意线程中归还缓冲区；Stop() 会等待所有已分离的缓冲区归还后才清理缓冲池，因此不能在调用 Stop() 的线程中持有缓冲区等待其返回
+	*		
+	* 参数：		pData		-- OnReceive 事件的数据缓冲区
+	*			iLength		-- OnReceive 事件的数据长度
+	*			ppBuffer	-- 缓冲区句柄（输出，用于 ReleaseReceiveBuffer()）
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL DetachReceiveBuffer	(const BYTE* pData, int iLength, PVOID* ppBuffer)	= 0;
+
+	/*
+	* 名称：归还接收缓冲区
+	* 描述：归还 DetachReceiveBuffer() 分离的接收缓冲区
+	*		
+	* 参数：		pBuffer		-- 缓冲区句柄
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL ReleaseReceiveBuffer	(PVOID pBuffer)	= 0;
+
 #ifdef _SSL_SUPPORT
 	/*
 	* 名称：初始化通信组件 SSL 环境参数
@@ -342,6 +502,27 @@ public:
 	/***********************************************************************/
 	/***************************** 属性访问方法 *****************************/
 
+	/* 设置 IO 分派模式（默认：DM_SHARED） */
+	virtual void SetDispatchMode		(EnDispatchMode enDispatchMode)	= 0;
+	/* 获取 IO 分派模式 */
+	virtual EnDispatchMode GetDispatchMode	()							= 0;
+	/* 设置监听模式（默认：LM_SINGLE） */
+	virtual void SetListenMode			(EnListenMode enListenMode)		= 0;
+	/* 获取监听模式 */
+	virtual EnListenMode GetListenMode	()								= 0;
+	/* 设置是否启用边缘触发模式（默认：不启用，每次处理 IO 事件后以 EPOLLONESHOT 方式重新注册；启用后只在关注事件变化时才重新注册） */
+	virtual void SetEdgeTrigger			(BOOL bEdgeTrigger)				= 0;
+	/* 检测是否启用边缘触发模式 */
+	virtual BOOL IsEdgeTrigger			()								= 0;
+	/* 设置是否合并 OnSend 通知（默认：不合并；启用后每次批量发送只触发一次 OnSend，pData 为 nullptr，iLength 为本次发送的数据总长度） */
+	virtual void SetBatchSendNotify		(BOOL bBatchSendNotify)			= 0;
+	/* 检测是否合并 OnSend 通知 */
+	virtual BOOL IsBatchSendNotify		()								= 0;
+	/* 设置是否启用可分离接收模式（默认：不启用；启用后数据直接读入缓冲池的数据块，OnReceive 事件中可以通过 DetachReceiveBuffer() 取走） */
+	virtual void SetDetachableReceive	(BOOL bDetachableReceive)		= 0;
+	/* 检测是否启用可分离接收模式 */
+	virtual BOOL IsDetachableReceive	()								= 0;
+
 	/* 设置 EPOLL 等待事件的最大数量 */
 	virtual void SetAcceptSocketCount	(DWORD dwAcceptSocketCount)		= 0;
 	/* 设置通信数据缓冲区大小（根据平均通信数据包大小调整设置，通常设置为 1024 的倍数） */
@@ -386,11 +567,25 @@ public:
 	/* 获取数据报文最大长度 */
 	virtual DWORD GetMaxDatagramSize	()							= 0;
 
+	/* 设置监听模式（默认：LM_SINGLE） */
+	virtual void SetListenMode			(EnListenMode enListenMode)	= 0;
+	/* 获取监听模式 */
+	virtual EnListenMode GetListenMode	()							= 0;
+
 	/* 设置 Receive 预投递数量（根据负载调整设置，Receive 预投递数量越大则丢包概率越小） */
 	virtual void SetPostReceiveCount	(DWORD dwPostReceiveCount)	= 0;
 	/* 获取 Receive 预投递数量 */
 	virtual DWORD GetPostReceiveCount	()							= 0;
 
+	/* 设置每次批量接收的数据报数量（大于 1 则使用 recvmmsg 批量接收并按连接合并接收命令，最大值：MAX_UDP_BATCH_COUNT，默认：1） */
+	virtual void SetReceiveBatchCount	(DWORD dwReceiveBatchCount)	= 0;
+	/* 设置每次批量发送的数据报数量（大于 1 则使用 sendmmsg 合并发送多个连接的数据报，最大值：MAX_UDP_BATCH_COUNT，默认：1） */
+	virtual void SetSendBatchCount		(DWORD dwSendBatchCount)	= 0;
+	/* 获取每次批量接收的数据报数量 */
+	virtual DWORD GetReceiveBatchCount	()							= 0;
+	/* 获取每次批量发送的数据报数量 */
+	virtual DWORD GetSendBatchCount		()							= 0;
+
 	/* 设置监测包尝试次数（0 则不发送监测跳包，如果超过最大尝试次数则认为已断线） */
 	virtual void SetDetectAttempts		(DWORD dwDetectAttempts)	= 0;
 	/* 设置监测包发送间隔（秒，0 不发送监测包） */
@@ -472,6 +667,94 @@ public:
 	*/
 	virtual BOOL SendSmallFile		(CONNID dwConnID, LPCTSTR lpszFileName, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr)	= 0;
 
+	/*
+	* 名称：发送文件
+	* 描述：向指定连接发送文件的指定区域（不限于小文件）
+	*		普通 TCP 连接使用 sendfile() 直接从文件发送，文件数据不经过用户态缓冲区；
+	*		SSL 连接或 Pack 组件等需要加工发送数据的情形则映射文件区域后按普通数据发送
+	*		（数据会被拷贝到发送缓冲区，因此一次发送的总长度与 SendSmallFile() 一样不能超过 4 MB）
+	*		（sendfile() 发送的数据触发 OnSend() 事件时 pData 参数为 nullptr）
+	*		
+	* 参数：		dwConnID		-- 连接 ID
+	*			lpszFileName	-- 文件路径
+	*			llOffset		-- 文件区域起始偏移
+	*			llLength		-- 文件区域长度（0：发送到文件末尾）
+	*			pHead			-- 头部附加数据
+	*			pTail			-- 尾部附加数据（文件区域长度不受 2 GB 限制，超大文件会分成多个窗口依次发送）
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL SendFile			(CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset = 0, LONGLONG llLength = 0, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr)	= 0;
+
+	/*
+	* 名称：以引用方式发送数据
+	* 描述：向指定连接发送数据，组件不拷贝缓冲区数据，而是引用该缓冲区直接提交给系统发送（适合发送大块数据）
+	*		缓冲区不再被组件引用时（数据已全部提交给系统，或者发送失败、连接关闭）调用 fnRelease，在此之前不能修改或释放该缓冲区；
+	*		无论本方法返回 TRUE 还是 FALSE，fnRelease 都会且只会被调用一次（可能在本方法返回前调用），fnRelease 中不要调用本组件的发送方法
+	*		（SSL 组件和 PACK 组件需要对发送数据进行加工，退化为拷贝发送，拷贝完成后立即调用 fnRelease）
+	*		
+	* 参数：		dwConnID	-- 连接 ID
+	*			pBuffer		-- 发送缓冲区
+	*			iLength		-- 发送缓冲区长度
+	*			fnRelease	-- 缓冲区释放函数（可以为 nullptr）
+	*			pvParam		-- 缓冲区释放函数的自定义参数
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL SendReference		(CONNID dwConnID, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam = nullptr)	= 0;
+
+	/*
+	* 名称：广播数据
+	* 描述：向多个连接发送相同的数据，数据只拷贝一次到引用计数的共享数据块，各连接以引用方式把共享数据块加入发送队列
+	*		（PACK 组件只构造一次包头；SSL 组件需要逐个连接加密，退化为逐个连接发送）
+	*		
+	* 参数：		pConnIDs	-- 连接 ID 数组
+	*			iConnCount	-- 连接 ID 数组长度
+	*			pBuffer		-- 发送缓冲区
+	*			iLength		-- 发送缓冲区长度
+	* 返回值：	TRUE	-- 全部连接发送成功
+	*			FALSE	-- 部分或全部连接发送失败（失败的连接不影响其它连接的发送），可通过系统 API 函数 ::GetLastError() 获取最后一个错误代码
+	*/
+	virtual BOOL Broadcast			(const CONNID pConnIDs[], int iConnCount, const BYTE* pBuffer, int iLength)	= 0;
+
+	/*
+	* 名称：广播多组数据
+	* 描述：向多个连接发送相同的多组数据，多组数据合并拷贝到一个引用计数的共享数据块（参考：Broadcast()）
+	*		
+	* 参数：		pConnIDs	-- 连接 ID 数组
+	*			iConnCount	-- 连接 ID 数组长度
+	*			pBuffers	-- 发送缓冲区数组
+	*			iCount		-- 发送缓冲区数目
+	* 返回值：	TRUE	-- 全部连接发送成功
+	*			FALSE	-- 部分或全部连接发送失败，可通过系统 API 函数 ::GetLastError() 获取最后一个错误代码
+	*/
+	virtual BOOL BroadcastPackets	(const CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount)	= 0;
+
+	/*
+	* 名称：分离接收缓冲区
+	* 描述：在 OnReceive 事件中取得接收缓冲区的所有权，OnReceive 事件返回后 pData 仍然有效，直到调用 ReleaseReceiveBuffer() 归还缓冲区
+	*		1、只在可分离接收模式下有效（参考：SetDetachableReceive()），并且只能在 OnReceive 事件中调用
+	*		2、pData 和 iLength 必须是 OnReceive 事件的原始参数；PULL / PACK / HTTP / SSL 组件的接收数据经过了加工，不能分离
+	*		3、应用程序可以在任意线程中归还缓冲区；Stop() 会等待所有已分离的缓冲区归还后才清理缓冲池，因此不能在调用 Stop() 的线程中持有缓冲区等待其返回
+	*		
+	* 参数：		pData		-- OnReceive 事件的数据缓冲区
+	*			iLength		-- OnReceive 事件的数据长度
+	*			ppBuffer	-- 缓冲区句柄（输出，用于 ReleaseReceiveBuffer()）
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL DetachReceiveBuffer	(const BYTE* pData, int iLength, PVOID* ppBuffer)	= 0;
+
+	/*
+	* 名称：归还接收缓冲区
+	* 描述：归还 DetachReceiveBuffer() 分离的接收缓冲区
+	*		
+	* 参数：		pBuffer		-- 缓冲区句柄
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL ReleaseReceiveBuffer	(PVOID pBuffer)	= 0;
+
 #ifdef _SSL_SUPPORT
 	/*
 	* 名称：初始化通信组件 SSL 环境参数
@@ -525,6 +808,23 @@ public:
 	/* 检测是否启用地址重用机制 */
 	virtual BOOL IsReuseAddress			()								= 0;
 
+	/* 设置 IO 分派模式（默认：DM_SHARED） */
+	virtual void SetDispatchMode		(EnDispatchMode enDispatchMode)	= 0;
+	/* 获取 IO 分派模式 */
+	virtual EnDispatchMode GetDispatchMode	()							= 0;
+	/* 设置是否启用边缘触发模式（默认：不启用，每次处理 IO 事件后以 EPOLLONESHOT 方式重新注册；启用后只在关注事件变化时才重新注册） */
+	virtual void SetEdgeTrigger			(BOOL bEdgeTrigger)				= 0;
+	/* 检测是否启用边缘触发模式 */
+	virtual BOOL IsEdgeTrigger			()								= 0;
+	/* 设置是否合并 OnSend 通知（默认：不合并；启用后每次批量发送只触发一次 OnSend，pData 为 nullptr，iLength 为本次发送的数据总长度） */
+	virtual void SetBatchSendNotify		(BOOL bBatchSendNotify)			= 0;
+	/* 检测是否合并 OnSend 通知 */
+	virtual BOOL IsBatchSendNotify		()								= 0;
+	/* 设置是否启用可分离接收模式（默认：不启用；启用后数据直接读入缓冲池的数据块，OnReceive 事件中可以通过 DetachReceiveBuffer() 取走） */
+	virtual void SetDetachableReceive	(BOOL bDetachableReceive)		= 0;
+	/* 检测是否启用可分离接收模式 */
+	virtual BOOL IsDetachableReceive	()								= 0;
+
 	/* 设置通信数据缓冲区大小（根据平均通信数据包大小调整设置，通常设置为 1024 的倍数） */
 	virtual void SetSocketBufferSize	(DWORD dwSocketBufferSize)		= 0;
 	/* 设置正常心跳包间隔（毫秒，0 则不发送心跳包，默认：60 * 1000） */
@@ -648,11 +948,19 @@ public:
 	virtual void SetFreeBufferPoolSize		(DWORD dwFreeBufferPoolSize)						= 0;
 	/* 设置内存块缓存池回收阀值（通常设置为内存块缓存池大小的 3 倍） */
 	virtual void SetFreeBufferPoolHold		(DWORD dwFreeBufferPoolHold)						= 0;
+	/* 设置发送缓冲区高水位（字节，待发数据达到该值时触发 OnWritable(FALSE) 事件并拒绝后续发送，0 则不限制，默认：0） */
+	virtual void SetSendHighWatermark		(DWORD dwSendHighWatermark)							= 0;
+	/* 设置发送缓冲区低水位（字节，达到高水位后待发数据降到该值以下时触发 OnWritable(TRUE) 事件并恢复发送，必须小于高水位，默认：0） */
+	virtual void SetSendLowWatermark		(DWORD dwSendLowWatermark)							= 0;
 
 	/* 获取内存块缓存池大小 */
 	virtual DWORD GetFreeBufferPoolSize		()													= 0;
 	/* 获取内存块缓存池回收阀值 */
 	virtual DWORD GetFreeBufferPoolHold		()													= 0;
+	/* 获取发送缓冲区高水位 */
+	virtual DWORD GetSendHighWatermark		()													= 0;
+	/* 获取发送缓冲区低水位 */
+	virtual DWORD GetSendLowWatermark		()													= 0;
 
 public:
 	virtual ~IClient() = default;
@@ -681,6 +989,40 @@ public:
 	*/
 	virtual BOOL SendSmallFile		(LPCTSTR lpszFileName, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr)	= 0;
 
+	/*
+	* 名称：发送文件
+	* 描述：向服务端发送文件的指定区域（不限于小文件）
+	*		普通 TCP 连接使用 sendfile() 直接从文件发送，文件数据不经过用户态缓冲区；
+	*		SSL 连接或 Pack 组件等需要加工发送数据的情形则映射文件区域后按普通数据发送
+	*		（数据会被拷贝到发送缓冲区，因此一次发送的总长度与 SendSmallFile() 一样不能超过 4 MB）
+	*		（sendfile() 发送的数据触发 OnSend() 事件时 pData 参数为 nullptr）
+	*		
+	* 参数：		lpszFileName	-- 文件路径
+	*			llOffset		-- 文件区域起始偏移
+	*			llLength		-- 文件区域长度（0：发送到文件末尾）
+	*			pHead			-- 头部附加数据
+	*			pTail			-- 尾部附加数据（文件区域长度不受 2 GB 限制，超大文件会分成多个窗口依次发送）
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL SendFile			(LPCTSTR lpszFileName, LONGLONG llOffset = 0, LONGLONG llLength = 0, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr)	= 0;
+
+	/*
+	* 名称：以引用方式发送数据
+	* 描述：向服务端发送数据，组件不拷贝缓冲区数据，而是引用该缓冲区直接提交给系统发送（适合发送大块数据）
+	*		缓冲区不再被组件引用时（数据已全部提交给系统，或者发送失败、连接关闭）调用 fnRelease，在此之前不能修改或释放该缓冲区；
+	*		无论本方法返回 TRUE 还是 FALSE，fnRelease 都会且只会被调用一次（可能在本方法返回前调用），fnRelease 中不要调用本组件的发送方法
+	*		（SSL 组件和 PACK 组件需要对发送数据进行加工，退化为拷贝发送，拷贝完成后立即调用 fnRelease）
+	*		
+	* 参数：		pBuffer		-- 发送缓冲区
+	*			iLength		-- 发送缓冲区长度
+	*			fnRelease	-- 缓冲区释放函数（可以为 nullptr）
+	*			pvParam		-- 缓冲区释放函数的自定义参数
+	* 返回值：	TRUE	-- 成功
+	*			FALSE	-- 失败，可通过系统 API 函数 ::GetLastError() 获取错误代码
+	*/
+	virtual BOOL SendReference		(const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam = nullptr)	= 0;
+
 #ifdef _SSL_SUPPORT
 	/*
 	* 名称：初始化通信组件 SSL 环境参数
@@ -729,6 +1071,16 @@ public:
 	/***********************************************************************/
 	/***************************** 属性访问方法 *****************************/
 
+	/* 设置是否合并 OnSend 通知（默认：不合并；启用后每次批量发送只触发一次 OnSend，pData 为 nullptr，iLength 为本次发送的数据总长度） */
+	virtual void SetBatchSendNotify		(BOOL bBatchSendNotify)		= 0;
+	/* 检测是否合并 OnSend 通知 */
+	virtual BOOL IsBatchSendNotify		()							= 0;
+
+	/* 设置是否使用共享 Reactor（默认：不使用，每个客户端组件独占一个工作线程；启用后所有启用该选项的客户端组件共用进程内的一组 IO 工作线程，线程数量等于 CPU 核数；在共享 Reactor 的工作线程中停止其它分片的客户端组件时 Stop() 立即返回，由该组件所在的工作线程完成停止，此时不能在共享 Reactor 的工作线程中销毁该组件或再次调用 Stop() 等待停止，否则分片之间互相等待会死锁） */
+	virtual void SetSharedReactor		(BOOL bSharedReactor)		= 0;
+	/* 检测是否使用共享 Reactor */
+	virtual BOOL IsSharedReactor		()							= 0;
+
 	/* 设置通信数据缓冲区大小（根据平均通信数据包大小调整设置，通常设置为：(N * 1024) - sizeof(TBufferObj)） */
 	virtual void SetSocketBufferSize	(DWORD dwSocketBufferSize)	= 0;
 	/* 设置正常心跳包间隔（毫秒，0 则不发送心跳包，默认：60 * 1000） */
@@ -1033,6 +1385,21 @@ public:
 	*/
 	virtual EnHandleResult OnSend(T* pSender, CONNID dwConnID, const BYTE* pData, int iLength)					= 0;
 
+	/*
+	* 名称：可写状态变化通知
+	* 描述：设置了发送缓冲区高水位时，连接待发数据达到高水位后 Socket 监听器将收到 bWritable
+	*		为 FALSE 的通知，此后该连接的发送操作将失败（错误代码：ERROR_WOULDBLOCK）；待发数据
+	*		降到低水位以下时 Socket 监听器将收到 bWritable 为 TRUE 的通知，此后可以继续发送数据
+	*		（代理转发类应用可以在收到通知时暂停/恢复对端连接的数据接收，实现端到端的流量控制）
+	*		
+	* 参数：		pSender		-- 事件源对象
+	*			dwConnID	-- 连接 ID
+	*			bWritable	-- TRUE - 恢复可写，FALSE - 达到高水位
+	* 返回值：	HR_OK / HR_IGNORE	-- 继续执行
+	*			HR_ERROR			-- 该通知不允许返回 HR_ERROR（调试模式下引发断言错误）
+	*/
+	virtual EnHandleResult OnWritable(T* pSender, CONNID dwConnID, BOOL bWritable)								= 0;
+
 	/*
 	* 名称：数据到达通知（PUSH 模型）
 	* 描述：对于 PUSH 模型的 Socket 通信组件，成功接收数据后将向 Socket 监听器发送该通知
@@ -1145,6 +1512,7 @@ public:
 	virtual EnHandleResult OnHandShake(ITcpServer* pSender, CONNID dwConnID)								override {return HR_IGNORE;}
 	virtual EnHandleResult OnReceive(ITcpServer* pSender, CONNID dwConnID, int iLength)						override {return HR_IGNORE;}
 	virtual EnHandleResult OnSend(ITcpServer* pSender, CONNID dwConnID, const BYTE* pData, int iLength)		override {return HR_IGNORE;}
+	virtual EnHandleResult OnWritable(ITcpServer* pSender, CONNID dwConnID, BOOL bWritable)					override {return HR_IGNORE;}
 	virtual EnHandleResult OnShutdown(ITcpServer* pSender)													override {return HR_IGNORE;}
 };
 
@@ -1181,6 +1549,7 @@ public:
 	virtual EnHandleResult OnHandShake(IUdpServer* pSender, CONNID dwConnID)							override {return HR_IGNORE;}
 	virtual EnHandleResult OnReceive(IUdpServer* pSender, CONNID dwConnID, int iLength)					override {return HR_IGNORE;}
 	virtual EnHandleResult OnSend(IUdpServer* pSender, CONNID dwConnID, const BYTE* pData, int iLength)	override {return HR_IGNORE;}
+	virtual EnHandleResult OnWritable(IUdpServer* pSender, CONNID dwConnID, BOOL bWritable)				override {return HR_IGNORE;}
 	virtual EnHandleResult OnShutdown(IUdpServer* pSender)												override {return HR_IGNORE;}
 };
 
@@ -1240,6 +1609,7 @@ public:
 	virtual EnHandleResult OnHandShake(ITcpAgent* pSender, CONNID dwConnID)									override {return HR_IGNORE;}
 	virtual EnHandleResult OnReceive(ITcpAgent* pSender, CONNID dwConnID, int iLength)						override {return HR_IGNORE;}
 	virtual EnHandleResult OnSend(ITcpAgent* pSender, CONNID dwConnID, const BYTE* pData, int iLength)		override {return HR_IGNORE;}
+	virtual EnHandleResult OnWritable(ITcpAgent* pSender, CONNID dwConnID, BOOL bWritable)					override {return HR_IGNORE;}
 	virtual EnHandleResult OnShutdown(ITcpAgent* pSender)													override {return HR_IGNORE;}
 };
 
@@ -1311,6 +1681,7 @@ public:
 	virtual EnHandleResult OnHandShake(ITcpClient* pSender, CONNID dwConnID)								override {return HR_IGNORE;}
 	virtual EnHandleResult OnReceive(ITcpClient* pSender, CONNID dwConnID, int iLength)						override {return HR_IGNORE;}
 	virtual EnHandleResult OnSend(ITcpClient* pSender, CONNID dwConnID, const BYTE* pData, int iLength)		override {return HR_IGNORE;}
+	virtual EnHandleResult OnWritable(ITcpClient* pSender, CONNID dwConnID, BOOL bWritable)					override {return HR_IGNORE;}
 };
 
 /************************************************************************
@@ -1346,6 +1717,7 @@ public:
 	virtual EnHandleResult OnHandShake(IUdpClient* pSender, CONNID dwConnID)								override {return HR_IGNORE;}
 	virtual EnHandleResult OnReceive(IUdpClient* pSender, CONNID dwConnID, int iLength)						override {return HR_IGNORE;}
 	virtual EnHandleResult OnSend(IUdpClient* pSender, CONNID dwConnID, const BYTE* pData, int iLength)		override {return HR_IGNORE;}
+	virtual EnHandleResult OnWritable(IUdpClient* pSender, CONNID dwConnID, BOOL bWritable)					override {return HR_IGNORE;}
 };
 
 /************************************************************************
@@ -1370,6 +1742,7 @@ public:
 	virtual EnHandleResult OnHandShake(IUdpCast* pSender, CONNID dwConnID)									override {return HR_IGNORE;}
 	virtual EnHandleResult OnReceive(IUdpCast* pSender, CONNID dwConnID, int iLength)						override {return HR_IGNORE;}
 	virtual EnHandleResult OnSend(IUdpCast* pSender, CONNID dwConnID, const BYTE* pData, int iLength)		override {return HR_IGNORE;}
+	virtual EnHandleResult OnWritable(IUdpCast* pSender, CONNID dwConnID, BOOL bWritable)					override {return HR_IGNORE;}
 };
 
 /*****************************************************************************************************************************************************/
@@ -1420,6 +1793,19 @@ public:
 	/* 获取本地协议版本 */
 	virtual EnHttpVersion GetLocalVersion()												= 0;
 
+	/* 设置是否启用 WebSocket permessage-deflate 扩展（默认：FALSE，启用后在升级请求 / 101 响应中自动协商，压缩消息的 OnWSMessageBody() 回调解压后的数据，OnWSMessageHeader() 的 ullBodyLen 为压缩数据长度并且 iReserved 不含 RSV1） */
+	virtual void SetWSDeflate(BOOL bDeflate)											= 0;
+	/* 设置 permessage-deflate 的最大压缩窗口位数（9 - 15，默认：15，窗口越小 z_stream 占用的内存越少） */
+	virtual void SetWSDeflateWindowBits(int iWindowBits)								= 0;
+	/* 设置 permessage-deflate 是否在消息之间保留压缩上下文（默认：TRUE，FALSE 时每条消息独立压缩，z_stream 对象在消息之间由组件复用） */
+	virtual void SetWSDeflateContextTakeover(BOOL bContextTakeover)						= 0;
+	/* 检查是否启用 WebSocket permessage-deflate 扩展 */
+	virtual BOOL IsWSDeflate()															= 0;
+	/* 获取 permessage-deflate 的最大压缩窗口位数 */
+	virtual int GetWSDeflateWindowBits()												= 0;
+	/* 检查 permessage-deflate 是否在消息之间保留压缩上下文 */
+	virtual BOOL IsWSDeflateContextTakeover()											= 0;
+
 	/* 检查是否升级协议 */
 	virtual BOOL IsUpgrade(CONNID dwConnID)												= 0;
 	/* 检查是否有 Keep-Alive 标识 */
@@ -1573,7 +1959,9 @@ public:
 
 	/*
 	* 名称：发送本地文件
-	* 描述：向指定连接发送 4096 KB 以下的小文件
+	* 描述：向指定连接发送本地文件（使用 SendFile() 发送）
+	*		usStatusCode 为 HSC_OK 时自动附加 Last-Modified 和 Accept-Ranges 响应头，
+	*		并根据请求的 If-Modified-Since 和 Range（单个字节范围）请求头回复 304、206 或 416
 	*		
 	* 参数：		dwConnID		-- 连接 ID
 	*			lpszFileName	-- 文件路径
@@ -1586,6 +1974,34 @@ public:
 	*/
 	virtual BOOL SendLocalFile(CONNID dwConnID, LPCSTR lpszFileName, USHORT usStatusCode = HSC_OK, LPCSTR lpszDesc = nullptr, const THeader lpHeaders[] = nullptr, int iHeaderCount = 0)				= 0;
 
+	/*
+	* 名称：注册响应模板
+	* 描述：预先生成状态行和固定响应头，通过 SendTemplateResponse() 回复时只需填充 Content-Length、
+	*		Connection 和 Date（每秒更新一次的缓存值）响应头；lpHeaders 中已包含的响应头不再自动填充
+	*		（只能在组件停止状态下注册）
+	*		
+	* 参数：		usStatusCode	-- HTTP 状态码
+	*			lpszDesc		-- HTTP 状态描述
+	*			lpHeaders		-- 固定响应头
+	*			iHeaderCount	-- 固定响应头数量
+	* 返回值：	非 0			-- 模板 ID
+	*			0				-- 失败，可通过 SYS_GetLastError() 获取错误代码
+	*/
+	virtual DWORD RegisterResponseTemplate(USHORT usStatusCode, LPCSTR lpszDesc = nullptr, const THeader lpHeaders[] = nullptr, int iHeaderCount = 0)				= 0;
+
+	/*
+	* 名称：使用响应模板回复请求
+	* 描述：使用 RegisterResponseTemplate() 注册的响应模板向客户端回复 HTTP 请求
+	*		
+	* 参数：		dwConnID		-- 连接 ID
+	*			dwTemplateID	-- 模板 ID
+	*			pData			-- 回复请求体
+	*			iLength			-- 回复请求体长度
+	* 返回值：	TRUE			-- 成功
+	*			FALSE			-- 失败
+	*/
+	virtual BOOL SendTemplateResponse(CONNID dwConnID, DWORD dwTemplateID, const BYTE* pData = nullptr, int iLength = 0)										= 0;
+
 	/*
 	* 名称：释放连接
 	* 描述：把连接放入释放队列，等待某个时间（通过 SetReleaseDelay() 设置）关闭连接
@@ -1658,6 +2074,19 @@ public:
 	/* 获取本地协议版本 */
 	virtual EnHttpVersion GetLocalVersion()								= 0;
 
+	/* 设置是否启用 WebSocket permessage-deflate 扩展（默认：FALSE，启用后在升级请求 / 101 响应中自动协商，压缩消息的 OnWSMessageBody() 回调解压后的数据，OnWSMessageHeader() 的 ullBodyLen 为压缩数据长度并且 iReserved 不含 RSV1） */
+	virtual void SetWSDeflate(BOOL bDeflate)							= 0;
+	/* 设置 permessage-deflate 的最大压缩窗口位数（9 - 15，默认：15，窗口越小 z_stream 占用的内存越少） */
+	virtual void SetWSDeflateWindowBits(int iWindowBits)				= 0;
+	/* 设置 permessage-deflate 是否在消息之间保留压缩上下文（默认：TRUE，FALSE 时每条消息独立压缩，z_stream 对象在消息之间由组件复用） */
+	virtual void SetWSDeflateContextTakeover(BOOL bContextTakeover)		= 0;
+	/* 检查是否启用 WebSocket permessage-deflate 扩展 */
+	virtual BOOL IsWSDeflate()											= 0;
+	/* 获取 permessage-deflate 的最大压缩窗口位数 */
+	virtual int GetWSDeflateWindowBits()								= 0;
+	/* 检查 permessage-deflate 是否在消息之间保留压缩上下文 */
+	virtual BOOL IsWSDeflateContextTakeover()							= 0;
+
 	/* 检查是否升级协议 */
 	virtual BOOL IsUpgrade()											= 0;
 	/* 检查是否有 Keep-Alive 标识 */
@@ -2077,6 +2506,7 @@ public:
 	virtual EnHandleResult OnReceive(ITcpServer* pSender, CONNID dwConnID, int iLength)									override {return HR_IGNORE;}
 	virtual EnHandleResult OnReceive(ITcpServer* pSender, CONNID dwConnID, const BYTE* pData, int iLength)				override {return HR_IGNORE;}
 	virtual EnHandleResult OnSend(ITcpServer* pSender, CONNID dwConnID, const BYTE* pData, int iLength)					override {return HR_IGNORE;}
+	virtual EnHandleResult OnWritable(ITcpServer* pSender, CONNID dwConnID, BOOL bWritable)							override {return HR_IGNORE;}
 	virtual EnHandleResult OnShutdown(ITcpServer* pSender)																override {return HR_IGNORE;}
 
 	virtual EnHttpParseResult OnMessageBegin(IHttpServer* pSender, CONNID dwConnID)										override {return HPR_OK;}
@@ -2105,6 +2535,7 @@ public:
 	virtual EnHandleResult OnReceive(ITcpAgent* pSender, CONNID dwConnID, int iLength)									override {return HR_IGNORE;}
 	virtual EnHandleResult OnReceive(ITcpAgent* pSender, CONNID dwConnID, const BYTE* pData, int iLength)				override {return HR_IGNORE;}
 	virtual EnHandleResult OnSend(ITcpAgent* pSender, CONNID dwConnID, const BYTE* pData, int iLength)					override {return HR_IGNORE;}
+	virtual EnHandleResult OnWritable(ITcpAgent* pSender, CONNID dwConnID, BOOL bWritable)							override {return HR_IGNORE;}
 	virtual EnHandleResult OnShutdown(ITcpAgent* pSender)																override {return HR_IGNORE;}
 
 	virtual EnHttpParseResult OnMessageBegin(IHttpAgent* pSender, CONNID dwConnID)										override {return HPR_OK;}
@@ -2134,6 +2565,7 @@ public:
 	virtual EnHandleResult OnReceive(ITcpClient* pSender, CONNID dwConnID, int iLength)									override {return HR_IGNORE;}
 	virtual EnHandleResult OnReceive(ITcpClient* pSender, CONNID dwConnID, const BYTE* pData, int iLength)				override {return HR_IGNORE;}
 	virtual EnHandleResult OnSend(ITcpClient* pSender, CONNID dwConnID, const BYTE* pData, int iLength)					override {return HR_IGNORE;}
+	virtual EnHandleResult OnWritable(ITcpClient* pSender, CONNID dwConnID, BOOL bWritable)							override {return HR_IGNORE;}
 
 	virtual EnHttpParseResult OnMessageBegin(IHttpClient* pSender, CONNID dwConnID)										override {return HPR_OK;}
 	virtual EnHttpParseResult OnRequestLine(IHttpClient* pSender, CONNID dwConnID, LPCSTR lpszMethod, LPCSTR lpszUrl)	override {return HPR_OK;}
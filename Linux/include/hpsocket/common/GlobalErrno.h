@@ -73,6 +73,9 @@
 #define ERROR_BUFFER_OVERFLOW			E2BIG
 #define ERROR_DESTINATION_ELEMENT_FULL	EXFULL
 #define ERROR_ALREADY_INITIALIZED		EALREADY
+#define ERROR_NOT_SUPPORTED				ENOTSUP
+#define ERROR_NOT_ENOUGH_MEMORY			ENOMEM
+#define ERROR_NOT_ENOUGH_QUOTA			ENOBUFS
 
 #define EXIT_CODE_OK					EX_OK
 #define EXIT_CODE_CONFIG				EX_CONFIG
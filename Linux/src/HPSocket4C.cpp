@@ -328,6 +328,11 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnSend(HP_ServerListener pListener,
 	((C_HP_TcpServerListener*)pListener)->m_fnOnSend = fn;
 }
 
+HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnWritable(HP_ServerListener pListener, HP_FN_Server_OnWritable fn)
+{
+	((C_HP_TcpServerListener*)pListener)->m_fnOnWritable = fn;
+}
+
 HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnReceive(HP_ServerListener pListener, HP_FN_Server_OnReceive fn)
 {
 	((C_HP_TcpServerListener*)pListener)->m_fnOnReceive = fn;
@@ -371,6 +376,11 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnSend(HP_AgentListener pListener, H
 	((C_HP_TcpAgentListener*)pListener)->m_fnOnSend = fn;
 }
 
+HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnWritable(HP_AgentListener pListener, HP_FN_Agent_OnWritable fn)
+{
+	((C_HP_TcpAgentListener*)pListener)->m_fnOnWritable = fn;
+}
+
 HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnReceive(HP_AgentListener pListener, HP_FN_Agent_OnReceive fn)
 {
 	((C_HP_TcpAgentListener*)pListener)->m_fnOnReceive = fn;
@@ -414,6 +424,11 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnSend(HP_ClientListener pListener,
 	((C_HP_TcpClientListener*)pListener)->m_fnOnSend = fn;
 }
 
+HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnWritable(HP_ClientListener pListener, HP_FN_Client_OnWritable fn)
+{
+	((C_HP_TcpClientListener*)pListener)->m_fnOnWritable = fn;
+}
+
 HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnReceive(HP_ClientListener pListener, HP_FN_Client_OnReceive fn)
 {
 	((C_HP_TcpClientListener*)pListener)->m_fnOnReceive = fn;
@@ -477,6 +492,16 @@ HPSOCKET_API BOOL __HP_CALL HP_Server_DisconnectSilenceConnections(HP_Server pSe
 	return C_HP_Object::ToSecond<IServer>(pServer)->DisconnectSilenceConnections(dwPeriod, bForce);
 }
 
+HPSOCKET_API BOOL __HP_CALL HP_Server_SetConnectionTimer(HP_Server pServer, HP_CONNID dwConnID, DWORD dwTimeout, HP_Fn_ConnectionTimer fnTimer, PVOID pvParam)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->SetConnectionTimer(dwConnID, dwTimeout, fnTimer, pvParam);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_Server_KillConnectionTimer(HP_Server pServer, HP_CONNID dwConnID)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->KillConnectionTimer(dwConnID);
+}
+
 /******************************************************************************/
 /***************************** Server Էʷ *****************************/
 
@@ -530,6 +555,11 @@ HPSOCKET_API BOOL __HP_CALL HP_Server_IsConnected(HP_Server pServer, HP_CONNID d
 	return C_HP_Object::ToSecond<IServer>(pServer)->IsConnected(dwConnID);
 }
 
+HPSOCKET_API void __HP_CALL HP_Server_GetFreeBufferObjCacheStat(HP_Server pServer, ULONGLONG* pullHits, ULONGLONG* pullMisses)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->GetFreeBufferObjCacheStat(*pullHits, *pullMisses);
+}
+
 HPSOCKET_API DWORD __HP_CALL HP_Server_GetConnectionCount(HP_Server pServer)
 {
 	return C_HP_Object::ToSecond<IServer>(pServer)->GetConnectionCount();
@@ -600,6 +630,26 @@ HPSOCKET_API void __HP_CALL HP_Server_SetFreeBufferObjHold(HP_Server pServer, DW
 	C_HP_Object::ToSecond<IServer>(pServer)->SetFreeBufferObjHold(dwFreeBufferObjHold);
 }
 
+HPSOCKET_API void __HP_CALL HP_Server_SetFreeSocketObjPrealloc(HP_Server pServer, DWORD dwFreeSocketObjPrealloc)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetFreeSocketObjPrealloc(dwFreeSocketObjPrealloc);
+}
+
+HPSOCKET_API void __HP_CALL HP_Server_SetFreeBufferObjPrealloc(HP_Server pServer, DWORD dwFreeBufferObjPrealloc)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetFreeBufferObjPrealloc(dwFreeBufferObjPrealloc);
+}
+
+HPSOCKET_API void __HP_CALL HP_Server_SetFreeBufferObjCache(HP_Server pServer, DWORD dwFreeBufferObjCache)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetFreeBufferObjCache(dwFreeBufferObjCache);
+}
+
+HPSOCKET_API void __HP_CALL HP_Server_SetPoolNumaInterleave(HP_Server pServer, BOOL bPoolNumaInterleave)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetPoolNumaInterleave(bPoolNumaInterleave);
+}
+
 HPSOCKET_API void __HP_CALL HP_Server_SetMaxConnectionCount(HP_Server pServer, DWORD dwMaxConnectionCount)
 {
 	C_HP_Object::ToSecond<IServer>(pServer)->SetMaxConnectionCount(dwMaxConnectionCount);
@@ -615,6 +665,41 @@ HPSOCKET_API void __HP_CALL HP_Server_SetMarkSilence(HP_Server pServer, BOOL bMa
 	C_HP_Object::ToSecond<IServer>(pServer)->SetMarkSilence(bMarkSilence);
 }
 
+HPSOCKET_API void __HP_CALL HP_Server_SetTimerInterval(HP_Server pServer, DWORD dwTimerInterval)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetTimerInterval(dwTimerInterval);
+}
+
+HPSOCKET_API void __HP_CALL HP_Server_SetMaxConnectPeriod(HP_Server pServer, DWORD dwMaxConnectPeriod)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetMaxConnectPeriod(dwMaxConnectPeriod);
+}
+
+HPSOCKET_API void __HP_CALL HP_Server_SetSilenceTimeout(HP_Server pServer, DWORD dwSilenceTimeout)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetSilenceTimeout(dwSilenceTimeout);
+}
+
+HPSOCKET_API void __HP_CALL HP_Server_SetHandShakeTimeout(HP_Server pServer, DWORD dwHandShakeTimeout)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetHandShakeTimeout(dwHandShakeTimeout);
+}
+
+HPSOCKET_API void __HP_CALL HP_Server_SetSendHighWatermark(HP_Server pServer, DWORD dwSendHighWatermark)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetSendHighWatermark(dwSendHighWatermark);
+}
+
+HPSOCKET_API void __HP_CALL HP_Server_SetSendLowWatermark(HP_Server pServer, DWORD dwSendLowWatermark)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetSendLowWatermark(dwSendLowWatermark);
+}
+
+HPSOCKET_API void __HP_CALL HP_Server_SetMaxSendPending(HP_Server pServer, DWORD dwMaxSendPending)
+{
+	C_HP_Object::ToSecond<IServer>(pServer)->SetMaxSendPending(dwMaxSendPending);
+}
+
 HPSOCKET_API En_HP_SendPolicy __HP_CALL HP_Server_GetSendPolicy(HP_Server pServer)
 {
 	return C_HP_Object::ToSecond<IServer>(pServer)->GetSendPolicy();
@@ -650,6 +735,26 @@ HPSOCKET_API DWORD __HP_CALL HP_Server_GetFreeBufferObjHold(HP_Server pServer)
 	return C_HP_Object::ToSecond<IServer>(pServer)->GetFreeBufferObjHold();
 }
 
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetFreeSocketObjPrealloc(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->GetFreeSocketObjPrealloc();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetFreeBufferObjPrealloc(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->GetFreeBufferObjPrealloc();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetFreeBufferObjCache(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->GetFreeBufferObjCache();
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_Server_IsPoolNumaInterleave(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->IsPoolNumaInterleave();
+}
+
 HPSOCKET_API DWORD __HP_CALL HP_Server_GetMaxConnectionCount(HP_Server pServer)
 {
 	return C_HP_Object::ToSecond<IServer>(pServer)->GetMaxConnectionCount();
@@ -665,6 +770,41 @@ HPSOCKET_API BOOL __HP_CALL HP_Server_IsMarkSilence(HP_Server pServer)
 	return C_HP_Object::ToSecond<IServer>(pServer)->IsMarkSilence();
 }
 
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetTimerInterval(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->GetTimerInterval();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetMaxConnectPeriod(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->GetMaxConnectPeriod();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetSilenceTimeout(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->GetSilenceTimeout();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetHandShakeTimeout(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->GetHandShakeTimeout();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetSendHighWatermark(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->GetSendHighWatermark();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetSendLowWatermark(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->GetSendLowWatermark();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetMaxSendPending(HP_Server pServer)
+{
+	return C_HP_Object::ToSecond<IServer>(pServer)->GetMaxSendPending();
+}
+
 /**********************************************************************************/
 /******************************* TCP Server  *******************************/
 
@@ -673,9 +813,64 @@ HPSOCKET_API BOOL __HP_CALL HP_TcpServer_SendSmallFile(HP_Server pServer, HP_CON
 	return C_HP_Object::ToSecond<ITcpServer>(pServer)->SendSmallFile(dwConnID, lpszFileName, pHead, pTail);
 }
 
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_SendFile(HP_Server pServer, HP_CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->SendFile(dwConnID, lpszFileName, llOffset, llLength, pHead, pTail);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_SendReference(HP_Server pServer, HP_CONNID dwConnID, const BYTE* pBuffer, int iLength, HP_Fn_SendRelease fnRelease, PVOID pvParam)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->SendReference(dwConnID, pBuffer, iLength, fnRelease, pvParam);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_Broadcast(HP_Server pServer, const HP_CONNID pConnIDs[], int iConnCount, const BYTE* pBuffer, int iLength)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->Broadcast(pConnIDs, iConnCount, pBuffer, iLength);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_BroadcastPackets(HP_Server pServer, const HP_CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->BroadcastPackets(pConnIDs, iConnCount, pBuffers, iCount);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_DetachReceiveBuffer(HP_Server pServer, const BYTE* pData, int iLength, PVOID* ppBuffer)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->DetachReceiveBuffer(pData, iLength, ppBuffer);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_ReleaseReceiveBuffer(HP_Server pServer, PVOID pBuffer)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->ReleaseReceiveBuffer(pBuffer);
+}
+
 /**********************************************************************************/
 /***************************** TCP Server Էʷ *****************************/
 
+HPSOCKET_API void __HP_CALL HP_TcpServer_SetDispatchMode(HP_TcpServer pServer, En_HP_DispatchMode enDispatchMode)
+{
+	C_HP_Object::ToSecond<ITcpServer>(pServer)->SetDispatchMode(enDispatchMode);
+}
+
+HPSOCKET_API void __HP_CALL HP_TcpServer_SetListenMode(HP_TcpServer pServer, En_HP_ListenMode enListenMode)
+{
+	C_HP_Object::ToSecond<ITcpServer>(pServer)->SetListenMode(enListenMode);
+}
+
+HPSOCKET_API void __HP_CALL HP_TcpServer_SetEdgeTrigger(HP_TcpServer pServer, BOOL bEdgeTrigger)
+{
+	C_HP_Object::ToSecond<ITcpServer>(pServer)->SetEdgeTrigger(bEdgeTrigger);
+}
+
+HPSOCKET_API void __HP_CALL HP_TcpServer_SetBatchSendNotify(HP_TcpServer pServer, BOOL bBatchSendNotify)
+{
+	C_HP_Object::ToSecond<ITcpServer>(pServer)->SetBatchSendNotify(bBatchSendNotify);
+}
+
+HPSOCKET_API void __HP_CALL HP_TcpServer_SetDetachableReceive(HP_TcpServer pServer, BOOL bDetachableReceive)
+{
+	C_HP_Object::ToSecond<ITcpServer>(pServer)->SetDetachableReceive(bDetachableReceive);
+}
+
 HPSOCKET_API void __HP_CALL HP_TcpServer_SetAcceptSocketCount(HP_TcpServer pServer, DWORD dwAcceptSocketCount)
 {
 	C_HP_Object::ToSecond<ITcpServer>(pServer)->SetAcceptSocketCount(dwAcceptSocketCount);
@@ -701,6 +896,31 @@ HPSOCKET_API void __HP_CALL HP_TcpServer_SetKeepAliveInterval(HP_TcpServer pServ
 	C_HP_Object::ToSecond<ITcpServer>(pServer)->SetKeepAliveInterval(dwKeepAliveInterval);
 }
 
+HPSOCKET_API En_HP_DispatchMode __HP_CALL HP_TcpServer_GetDispatchMode(HP_TcpServer pServer)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->GetDispatchMode();
+}
+
+HPSOCKET_API En_HP_ListenMode __HP_CALL HP_TcpServer_GetListenMode(HP_TcpServer pServer)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->GetListenMode();
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_IsEdgeTrigger(HP_TcpServer pServer)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->IsEdgeTrigger();
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_IsBatchSendNotify(HP_TcpServer pServer)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->IsBatchSendNotify();
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_IsDetachableReceive(HP_TcpServer pServer)
+{
+	return C_HP_Object::ToSecond<ITcpServer>(pServer)->IsDetachableReceive();
+}
+
 HPSOCKET_API DWORD __HP_CALL HP_TcpServer_GetAcceptSocketCount(HP_TcpServer pServer)
 {
 	return C_HP_Object::ToSecond<ITcpServer>(pServer)->GetAcceptSocketCount();
@@ -739,6 +959,16 @@ HPSOCKET_API DWORD __HP_CALL HP_UdpServer_GetMaxDatagramSize(HP_UdpServer pServe
 	return C_HP_Object::ToSecond<IUdpServer>(pServer)->GetMaxDatagramSize();
 }
 
+HPSOCKET_API void __HP_CALL HP_UdpServer_SetListenMode(HP_UdpServer pServer, En_HP_ListenMode enListenMode)
+{
+	C_HP_Object::ToSecond<IUdpServer>(pServer)->SetListenMode(enListenMode);
+}
+
+HPSOCKET_API En_HP_ListenMode __HP_CALL HP_UdpServer_GetListenMode(HP_UdpServer pServer)
+{
+	return C_HP_Object::ToSecond<IUdpServer>(pServer)->GetListenMode();
+}
+
 HPSOCKET_API void __HP_CALL HP_UdpServer_SetPostReceiveCount(HP_UdpServer pServer, DWORD dwPostReceiveCount)
 {
 	C_HP_Object::ToSecond<IUdpServer>(pServer)->SetPostReceiveCount(dwPostReceiveCount);
@@ -749,6 +979,26 @@ HPSOCKET_API DWORD __HP_CALL HP_UdpServer_GetPostReceiveCount(HP_UdpServer pServ
 	return C_HP_Object::ToSecond<IUdpServer>(pServer)->GetPostReceiveCount();
 }
 
+HPSOCKET_API void __HP_CALL HP_UdpServer_SetReceiveBatchCount(HP_UdpServer pServer, DWORD dwReceiveBatchCount)
+{
+	C_HP_Object::ToSecond<IUdpServer>(pServer)->SetReceiveBatchCount(dwReceiveBatchCount);
+}
+
+HPSOCKET_API void __HP_CALL HP_UdpServer_SetSendBatchCount(HP_UdpServer pServer, DWORD dwSendBatchCount)
+{
+	C_HP_Object::ToSecond<IUdpServer>(pServer)->SetSendBatchCount(dwSendBatchCount);
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_UdpServer_GetReceiveBatchCount(HP_UdpServer pServer)
+{
+	return C_HP_Object::ToSecond<IUdpServer>(pServer)->GetReceiveBatchCount();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_UdpServer_GetSendBatchCount(HP_UdpServer pServer)
+{
+	return C_HP_Object::ToSecond<IUdpServer>(pServer)->GetSendBatchCount();
+}
+
 HPSOCKET_API void __HP_CALL HP_UdpServer_SetDetectAttempts(HP_UdpServer pServer, DWORD dwDetectAttempts)
 {
 	C_HP_Object::ToSecond<IUdpServer>(pServer)->SetDetectAttempts(dwDetectAttempts);
@@ -837,6 +1087,16 @@ HPSOCKET_API BOOL __HP_CALL HP_Agent_DisconnectSilenceConnections(HP_Agent pAgen
 	return C_HP_Object::ToSecond<IAgent>(pAgent)->DisconnectSilenceConnections(dwPeriod, bForce);
 }
 
+HPSOCKET_API BOOL __HP_CALL HP_Agent_SetConnectionTimer(HP_Agent pAgent, HP_CONNID dwConnID, DWORD dwTimeout, HP_Fn_ConnectionTimer fnTimer, PVOID pvParam)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->SetConnectionTimer(dwConnID, dwTimeout, fnTimer, pvParam);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_Agent_KillConnectionTimer(HP_Agent pAgent, HP_CONNID dwConnID)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->KillConnectionTimer(dwConnID);
+}
+
 /******************************************************************************/
 /***************************** Agent Էʷ *****************************/
 
@@ -890,6 +1150,11 @@ HPSOCKET_API BOOL __HP_CALL HP_Agent_IsConnected(HP_Agent pAgent, HP_CONNID dwCo
 	return C_HP_Object::ToSecond<IAgent>(pAgent)->IsConnected(dwConnID);
 }
 
+HPSOCKET_API void __HP_CALL HP_Agent_GetFreeBufferObjCacheStat(HP_Agent pAgent, ULONGLONG* pullHits, ULONGLONG* pullMisses)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->GetFreeBufferObjCacheStat(*pullHits, *pullMisses);
+}
+
 HPSOCKET_API DWORD __HP_CALL HP_Agent_GetConnectionCount(HP_Agent pAgent)
 {
 	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetConnectionCount();
@@ -960,6 +1225,26 @@ HPSOCKET_API void __HP_CALL HP_Agent_SetFreeBufferObjHold(HP_Agent pAgent, DWORD
 	C_HP_Object::ToSecond<IAgent>(pAgent)->SetFreeBufferObjHold(dwFreeBufferObjHold);
 }
 
+HPSOCKET_API void __HP_CALL HP_Agent_SetFreeSocketObjPrealloc(HP_Agent pAgent, DWORD dwFreeSocketObjPrealloc)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetFreeSocketObjPrealloc(dwFreeSocketObjPrealloc);
+}
+
+HPSOCKET_API void __HP_CALL HP_Agent_SetFreeBufferObjPrealloc(HP_Agent pAgent, DWORD dwFreeBufferObjPrealloc)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetFreeBufferObjPrealloc(dwFreeBufferObjPrealloc);
+}
+
+HPSOCKET_API void __HP_CALL HP_Agent_SetFreeBufferObjCache(HP_Agent pAgent, DWORD dwFreeBufferObjCache)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetFreeBufferObjCache(dwFreeBufferObjCache);
+}
+
+HPSOCKET_API void __HP_CALL HP_Agent_SetPoolNumaInterleave(HP_Agent pAgent, BOOL bPoolNumaInterleave)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetPoolNumaInterleave(bPoolNumaInterleave);
+}
+
 HPSOCKET_API void __HP_CALL HP_Agent_SetMaxConnectionCount(HP_Agent pAgent, DWORD dwMaxConnectionCount)
 {
 	C_HP_Object::ToSecond<IAgent>(pAgent)->SetMaxConnectionCount(dwMaxConnectionCount);
@@ -975,6 +1260,41 @@ HPSOCKET_API void __HP_CALL HP_Agent_SetMarkSilence(HP_Agent pAgent, BOOL bMarkS
 	C_HP_Object::ToSecond<IAgent>(pAgent)->SetMarkSilence(bMarkSilence);
 }
 
+HPSOCKET_API void __HP_CALL HP_Agent_SetTimerInterval(HP_Agent pAgent, DWORD dwTimerInterval)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetTimerInterval(dwTimerInterval);
+}
+
+HPSOCKET_API void __HP_CALL HP_Agent_SetMaxConnectPeriod(HP_Agent pAgent, DWORD dwMaxConnectPeriod)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetMaxConnectPeriod(dwMaxConnectPeriod);
+}
+
+HPSOCKET_API void __HP_CALL HP_Agent_SetSilenceTimeout(HP_Agent pAgent, DWORD dwSilenceTimeout)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetSilenceTimeout(dwSilenceTimeout);
+}
+
+HPSOCKET_API void __HP_CALL HP_Agent_SetHandShakeTimeout(HP_Agent pAgent, DWORD dwHandShakeTimeout)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetHandShakeTimeout(dwHandShakeTimeout);
+}
+
+HPSOCKET_API void __HP_CALL HP_Agent_SetSendHighWatermark(HP_Agent pAgent, DWORD dwSendHighWatermark)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetSendHighWatermark(dwSendHighWatermark);
+}
+
+HPSOCKET_API void __HP_CALL HP_Agent_SetSendLowWatermark(HP_Agent pAgent, DWORD dwSendLowWatermark)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetSendLowWatermark(dwSendLowWatermark);
+}
+
+HPSOCKET_API void __HP_CALL HP_Agent_SetMaxSendPending(HP_Agent pAgent, DWORD dwMaxSendPending)
+{
+	C_HP_Object::ToSecond<IAgent>(pAgent)->SetMaxSendPending(dwMaxSendPending);
+}
+
 HPSOCKET_API En_HP_SendPolicy __HP_CALL HP_Agent_GetSendPolicy(HP_Agent pAgent)
 {
 	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetSendPolicy();
@@ -1010,6 +1330,26 @@ HPSOCKET_API DWORD __HP_CALL HP_Agent_GetFreeBufferObjHold(HP_Agent pAgent)
 	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetFreeBufferObjHold();
 }
 
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetFreeSocketObjPrealloc(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetFreeSocketObjPrealloc();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetFreeBufferObjPrealloc(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetFreeBufferObjPrealloc();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetFreeBufferObjCache(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetFreeBufferObjCache();
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_Agent_IsPoolNumaInterleave(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->IsPoolNumaInterleave();
+}
+
 HPSOCKET_API DWORD __HP_CALL HP_Agent_GetMaxConnectionCount(HP_Agent pAgent)
 {
 	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetMaxConnectionCount();
@@ -1025,6 +1365,41 @@ HPSOCKET_API BOOL __HP_CALL HP_Agent_IsMarkSilence(HP_Agent pAgent)
 	return C_HP_Object::ToSecond<IAgent>(pAgent)->IsMarkSilence();
 }
 
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetTimerInterval(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetTimerInterval();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetMaxConnectPeriod(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetMaxConnectPeriod();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetSilenceTimeout(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetSilenceTimeout();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetHandShakeTimeout(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetHandShakeTimeout();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetSendHighWatermark(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetSendHighWatermark();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetSendLowWatermark(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetSendLowWatermark();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetMaxSendPending(HP_Agent pAgent)
+{
+	return C_HP_Object::ToSecond<IAgent>(pAgent)->GetMaxSendPending();
+}
+
 /**********************************************************************************/
 /******************************* TCP Agent  *******************************/
 
@@ -1033,6 +1408,36 @@ HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_SendSmallFile(HP_Agent pAgent, HP_CONNID
 	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->SendSmallFile(dwConnID, lpszFileName, pHead, pTail);
 }
 
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_SendFile(HP_Agent pAgent, HP_CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->SendFile(dwConnID, lpszFileName, llOffset, llLength, pHead, pTail);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_SendReference(HP_Agent pAgent, HP_CONNID dwConnID, const BYTE* pBuffer, int iLength, HP_Fn_SendRelease fnRelease, PVOID pvParam)
+{
+	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->SendReference(dwConnID, pBuffer, iLength, fnRelease, pvParam);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_Broadcast(HP_Agent pAgent, const HP_CONNID pConnIDs[], int iConnCount, const BYTE* pBuffer, int iLength)
+{
+	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->Broadcast(pConnIDs, iConnCount, pBuffer, iLength);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_BroadcastPackets(HP_Agent pAgent, const HP_CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount)
+{
+	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->BroadcastPackets(pConnIDs, iConnCount, pBuffers, iCount);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_DetachReceiveBuffer(HP_Agent pAgent, const BYTE* pData, int iLength, PVOID* ppBuffer)
+{
+	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->DetachReceiveBuffer(pData, iLength, ppBuffer);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_ReleaseReceiveBuffer(HP_Agent pAgent, PVOID pBuffer)
+{
+	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->ReleaseReceiveBuffer(pBuffer);
+}
+
 /**********************************************************************************/
 /***************************** TCP Agent Էʷ *****************************/
 
@@ -1046,6 +1451,46 @@ HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_IsReuseAddress(HP_TcpAgent pAgent)
 	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->IsReuseAddress();
 }
 
+HPSOCKET_API void __HP_CALL HP_TcpAgent_SetDispatchMode(HP_TcpAgent pAgent, En_HP_DispatchMode enDispatchMode)
+{
+	C_HP_Object::ToSecond<ITcpAgent>(pAgent)->SetDispatchMode(enDispatchMode);
+}
+
+HPSOCKET_API En_HP_DispatchMode __HP_CALL HP_TcpAgent_GetDispatchMode(HP_TcpAgent pAgent)
+{
+	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->GetDispatchMode();
+}
+
+HPSOCKET_API void __HP_CALL HP_TcpAgent_SetEdgeTrigger(HP_TcpAgent pAgent, BOOL bEdgeTrigger)
+{
+	C_HP_Object::ToSecond<ITcpAgent>(pAgent)->SetEdgeTrigger(bEdgeTrigger);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_IsEdgeTrigger(HP_TcpAgent pAgent)
+{
+	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->IsEdgeTrigger();
+}
+
+HPSOCKET_API void __HP_CALL HP_TcpAgent_SetBatchSendNotify(HP_TcpAgent pAgent, BOOL bBatchSendNotify)
+{
+	C_HP_Object::ToSecond<ITcpAgent>(pAgent)->SetBatchSendNotify(bBatchSendNotify);
+}
+
+HPSOCKET_API void __HP_CALL HP_TcpAgent_SetDetachableReceive(HP_TcpAgent pAgent, BOOL bDetachableReceive)
+{
+	C_HP_Object::ToSecond<ITcpAgent>(pAgent)->SetDetachableReceive(bDetachableReceive);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_IsBatchSendNotify(HP_TcpAgent pAgent)
+{
+	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->IsBatchSendNotify();
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_IsDetachableReceive(HP_TcpAgent pAgent)
+{
+	return C_HP_Object::ToSecond<ITcpAgent>(pAgent)->IsDetachableReceive();
+}
+
 HPSOCKET_API void __HP_CALL HP_TcpAgent_SetSocketBufferSize(HP_TcpAgent pAgent, DWORD dwSocketBufferSize)
 {
 	C_HP_Object::ToSecond<ITcpAgent>(pAgent)->SetSocketBufferSize(dwSocketBufferSize);
@@ -1197,6 +1642,16 @@ HPSOCKET_API void __HP_CALL HP_Client_SetFreeBufferPoolHold(HP_Client pClient, D
 	C_HP_Object::ToSecond<IClient>(pClient)->SetFreeBufferPoolHold(dwFreeBufferPoolHold);
 }
 
+HPSOCKET_API void __HP_CALL HP_Client_SetSendHighWatermark(HP_Client pClient, DWORD dwSendHighWatermark)
+{
+	C_HP_Object::ToSecond<IClient>(pClient)->SetSendHighWatermark(dwSendHighWatermark);
+}
+
+HPSOCKET_API void __HP_CALL HP_Client_SetSendLowWatermark(HP_Client pClient, DWORD dwSendLowWatermark)
+{
+	C_HP_Object::ToSecond<IClient>(pClient)->SetSendLowWatermark(dwSendLowWatermark);
+}
+
 HPSOCKET_API DWORD __HP_CALL HP_Client_GetFreeBufferPoolSize(HP_Client pClient)
 {
 	return C_HP_Object::ToSecond<IClient>(pClient)->GetFreeBufferPoolSize();
@@ -1207,6 +1662,16 @@ HPSOCKET_API DWORD __HP_CALL HP_Client_GetFreeBufferPoolHold(HP_Client pClient)
 	return C_HP_Object::ToSecond<IClient>(pClient)->GetFreeBufferPoolHold();
 }
 
+HPSOCKET_API DWORD __HP_CALL HP_Client_GetSendHighWatermark(HP_Client pClient)
+{
+	return C_HP_Object::ToSecond<IClient>(pClient)->GetSendHighWatermark();
+}
+
+HPSOCKET_API DWORD __HP_CALL HP_Client_GetSendLowWatermark(HP_Client pClient)
+{
+	return C_HP_Object::ToSecond<IClient>(pClient)->GetSendLowWatermark();
+}
+
 /**********************************************************************************/
 /******************************* TCP Client  *******************************/
 
@@ -1215,9 +1680,39 @@ HPSOCKET_API BOOL __HP_CALL HP_TcpClient_SendSmallFile(HP_Client pClient, LPCTST
 	return C_HP_Object::ToSecond<ITcpClient>(pClient)->SendSmallFile(lpszFileName, pHead, pTail);
 }
 
+HPSOCKET_API BOOL __HP_CALL HP_TcpClient_SendFile(HP_Client pClient, LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	return C_HP_Object::ToSecond<ITcpClient>(pClient)->SendFile(lpszFileName, llOffset, llLength, pHead, pTail);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpClient_SendReference(HP_Client pClient, const BYTE* pBuffer, int iLength, HP_Fn_SendRelease fnRelease, PVOID pvParam)
+{
+	return C_HP_Object::ToSecond<ITcpClient>(pClient)->SendReference(pBuffer, iLength, fnRelease, pvParam);
+}
+
 /**********************************************************************************/
 /***************************** TCP Client Էʷ *****************************/
 
+HPSOCKET_API void __HP_CALL HP_TcpClient_SetBatchSendNotify(HP_TcpClient pClient, BOOL bBatchSendNotify)
+{
+	C_HP_Object::ToSecond<ITcpClient>(pClient)->SetBatchSendNotify(bBatchSendNotify);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpClient_IsBatchSendNotify(HP_TcpClient pClient)
+{
+	return C_HP_Object::ToSecond<ITcpClient>(pClient)->IsBatchSendNotify();
+}
+
+HPSOCKET_API void __HP_CALL HP_TcpClient_SetSharedReactor(HP_TcpClient pClient, BOOL bSharedReactor)
+{
+	C_HP_Object::ToSecond<ITcpClient>(pClient)->SetSharedReactor(bSharedReactor);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_TcpClient_IsSharedReactor(HP_TcpClient pClient)
+{
+	return C_HP_Object::ToSecond<ITcpClient>(pClient)->IsSharedReactor();
+}
+
 HPSOCKET_API void __HP_CALL HP_TcpClient_SetSocketBufferSize(HP_TcpClient pClient, DWORD dwSocketBufferSize)
 {
 	C_HP_Object::ToSecond<ITcpClient>(pClient)->SetSocketBufferSize(dwSocketBufferSize);
@@ -1894,6 +2389,11 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_HttpServer_OnSend(HP_HttpServerListener pL
 	((C_HP_HttpServerListener*)pListener)->m_lsnServer.m_fnOnSend = fn;
 }
 
+HPSOCKET_API void __HP_CALL HP_Set_FN_HttpServer_OnWritable(HP_HttpServerListener pListener, HP_FN_HttpServer_OnWritable fn)
+{
+	((C_HP_HttpServerListener*)pListener)->m_lsnServer.m_fnOnWritable = fn;
+}
+
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpServer_OnReceive(HP_HttpServerListener pListener, HP_FN_HttpServer_OnReceive fn)
 {
 	((C_HP_HttpServerListener*)pListener)->m_lsnServer.m_fnOnReceive = fn;
@@ -2002,6 +2502,11 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_HttpAgent_OnSend(HP_HttpAgentListener pLis
 	((C_HP_HttpAgentListener*)pListener)->m_lsnAgent.m_fnOnSend = fn;
 }
 
+HPSOCKET_API void __HP_CALL HP_Set_FN_HttpAgent_OnWritable(HP_HttpAgentListener pListener, HP_FN_HttpAgent_OnWritable fn)
+{
+	((C_HP_HttpAgentListener*)pListener)->m_lsnAgent.m_fnOnWritable = fn;
+}
+
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpAgent_OnClose(HP_HttpAgentListener pListener, HP_FN_HttpAgent_OnClose fn)
 {
 	((C_HP_HttpAgentListener*)pListener)->m_lsnAgent.m_fnOnClose = fn;
@@ -2105,6 +2610,11 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_HttpClient_OnSend(HP_HttpClientListener pL
 	((C_HP_HttpClientListener*)pListener)->m_lsnClient.m_fnOnSend = fn;
 }
 
+HPSOCKET_API void __HP_CALL HP_Set_FN_HttpClient_OnWritable(HP_HttpClientListener pListener, HP_FN_HttpClient_OnWritable fn)
+{
+	((C_HP_HttpClientListener*)pListener)->m_lsnClient.m_fnOnWritable = fn;
+}
+
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpClient_OnClose(HP_HttpClientListener pListener, HP_FN_HttpClient_OnClose fn)
 {
 	((C_HP_HttpClientListener*)pListener)->m_lsnClient.m_fnOnClose = fn;
@@ -2123,6 +2633,16 @@ HPSOCKET_API BOOL __HP_CALL HP_HttpServer_SendLocalFile(HP_HttpServer pServer, H
 	return C_HP_Object::ToFirst<IHttpServer>(pServer)->SendLocalFile(dwConnID, lpszFileName, usStatusCode, lpszDesc, lpHeaders, iHeaderCount);
 }
 
+HPSOCKET_API DWORD __HP_CALL HP_HttpServer_RegisterResponseTemplate(HP_HttpServer pServer, USHORT usStatusCode, LPCSTR lpszDesc, const HP_THeader lpHeaders[], int iHeaderCount)
+{
+	return C_HP_Object::ToFirst<IHttpServer>(pServer)->RegisterResponseTemplate(usStatusCode, lpszDesc, lpHeaders, iHeaderCount);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_HttpServer_SendTemplateResponse(HP_HttpServer pServer, HP_CONNID dwConnID, DWORD dwTemplateID, const BYTE* pData, int iLength)
+{
+	return C_HP_Object::ToFirst<IHttpServer>(pServer)->SendTemplateResponse(dwConnID, dwTemplateID, pData, iLength);
+}
+
 HPSOCKET_API BOOL __HP_CALL HP_HttpServer_SendWSMessage(HP_HttpServer pServer, HP_CONNID dwConnID, BOOL bFinal, BYTE iReserved, BYTE iOperationCode, const BYTE lpszMask[4], BYTE* pData, int iLength, ULONGLONG ullBodyLen)
 {
 	return C_HP_Object::ToFirst<IHttpServer>(pServer)->SendWSMessage(dwConnID, bFinal, iReserved, iOperationCode, lpszMask, pData, iLength, ullBodyLen);
@@ -2172,6 +2692,36 @@ HPSOCKET_API En_HP_HttpVersion __HP_CALL HP_HttpServer_GetLocalVersion(HP_HttpSe
 	return C_HP_Object::ToFirst<IHttpServer>(pServer)->GetLocalVersion();
 }
 
+HPSOCKET_API void __HP_CALL HP_HttpServer_SetWSDeflate(HP_HttpServer pServer, BOOL bDeflate)
+{
+	C_HP_Object::ToFirst<IHttpServer>(pServer)->SetWSDeflate(bDeflate);
+}
+
+HPSOCKET_API void __HP_CALL HP_HttpServer_SetWSDeflateWindowBits(HP_HttpServer pServer, int iWindowBits)
+{
+	C_HP_Object::ToFirst<IHttpServer>(pServer)->SetWSDeflateWindowBits(iWindowBits);
+}
+
+HPSOCKET_API void __HP_CALL HP_HttpServer_SetWSDeflateContextTakeover(HP_HttpServer pServer, BOOL bContextTakeover)
+{
+	C_HP_Object::ToFirst<IHttpServer>(pServer)->SetWSDeflateContextTakeover(bContextTakeover);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_HttpServer_IsWSDeflate(HP_HttpServer pServer)
+{
+	return C_HP_Object::ToFirst<IHttpServer>(pServer)->IsWSDeflate();
+}
+
+HPSOCKET_API int __HP_CALL HP_HttpServer_GetWSDeflateWindowBits(HP_HttpServer pServer)
+{
+	return C_HP_Object::ToFirst<IHttpServer>(pServer)->GetWSDeflateWindowBits();
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_HttpServer_IsWSDeflateContextTakeover(HP_HttpServer pServer)
+{
+	return C_HP_Object::ToFirst<IHttpServer>(pServer)->IsWSDeflateContextTakeover();
+}
+
 HPSOCKET_API BOOL __HP_CALL HP_HttpServer_IsUpgrade(HP_HttpServer pServer, HP_CONNID dwConnID)
 {
 	return C_HP_Object::ToFirst<IHttpServer>(pServer)->IsUpgrade(dwConnID);
@@ -2338,6 +2888,36 @@ HPSOCKET_API En_HP_HttpVersion __HP_CALL HP_HttpAgent_GetLocalVersion(HP_HttpAge
 	return C_HP_Object::ToFirst<IHttpAgent>(pAgent)->GetLocalVersion();
 }
 
+HPSOCKET_API void __HP_CALL HP_HttpAgent_SetWSDeflate(HP_HttpAgent pAgent, BOOL bDeflate)
+{
+	C_HP_Object::ToFirst<IHttpAgent>(pAgent)->SetWSDeflate(bDeflate);
+}
+
+HPSOCKET_API void __HP_CALL HP_HttpAgent_SetWSDeflateWindowBits(HP_HttpAgent pAgent, int iWindowBits)
+{
+	C_HP_Object::ToFirst<IHttpAgent>(pAgent)->SetWSDeflateWindowBits(iWindowBits);
+}
+
+HPSOCKET_API void __HP_CALL HP_HttpAgent_SetWSDeflateContextTakeover(HP_HttpAgent pAgent, BOOL bContextTakeover)
+{
+	C_HP_Object::ToFirst<IHttpAgent>(pAgent)->SetWSDeflateContextTakeover(bContextTakeover);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_HttpAgent_IsWSDeflate(HP_HttpAgent pAgent)
+{
+	return C_HP_Object::ToFirst<IHttpAgent>(pAgent)->IsWSDeflate();
+}
+
+HPSOCKET_API int __HP_CALL HP_HttpAgent_GetWSDeflateWindowBits(HP_HttpAgent pAgent)
+{
+	return C_HP_Object::ToFirst<IHttpAgent>(pAgent)->GetWSDeflateWindowBits();
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_HttpAgent_IsWSDeflateContextTakeover(HP_HttpAgent pAgent)
+{
+	return C_HP_Object::ToFirst<IHttpAgent>(pAgent)->IsWSDeflateContextTakeover();
+}
+
 HPSOCKET_API BOOL __HP_CALL HP_HttpAgent_IsUpgrade(HP_HttpAgent pAgent, HP_CONNID dwConnID)
 {
 	return C_HP_Object::ToFirst<IHttpAgent>(pAgent)->IsUpgrade(dwConnID);
@@ -2509,6 +3089,36 @@ HPSOCKET_API En_HP_HttpVersion __HP_CALL HP_HttpClient_GetLocalVersion(HP_HttpCl
 	return C_HP_Object::ToFirst<IHttpClient>(pClient)->GetLocalVersion();
 }
 
+HPSOCKET_API void __HP_CALL HP_HttpClient_SetWSDeflate(HP_HttpClient pClient, BOOL bDeflate)
+{
+	C_HP_Object::ToFirst<IHttpClient>(pClient)->SetWSDeflate(bDeflate);
+}
+
+HPSOCKET_API void __HP_CALL HP_HttpClient_SetWSDeflateWindowBits(HP_HttpClient pClient, int iWindowBits)
+{
+	C_HP_Object::ToFirst<IHttpClient>(pClient)->SetWSDeflateWindowBits(iWindowBits);
+}
+
+HPSOCKET_API void __HP_CALL HP_HttpClient_SetWSDeflateContextTakeover(HP_HttpClient pClient, BOOL bContextTakeover)
+{
+	C_HP_Object::ToFirst<IHttpClient>(pClient)->SetWSDeflateContextTakeover(bContextTakeover);
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_HttpClient_IsWSDeflate(HP_HttpClient pClient)
+{
+	return C_HP_Object::ToFirst<IHttpClient>(pClient)->IsWSDeflate();
+}
+
+HPSOCKET_API int __HP_CALL HP_HttpClient_GetWSDeflateWindowBits(HP_HttpClient pClient)
+{
+	return C_HP_Object::ToFirst<IHttpClient>(pClient)->GetWSDeflateWindowBits();
+}
+
+HPSOCKET_API BOOL __HP_CALL HP_HttpClient_IsWSDeflateContextTakeover(HP_HttpClient pClient)
+{
+	return C_HP_Object::ToFirst<IHttpClient>(pClient)->IsWSDeflateContextTakeover();
+}
+
 HPSOCKET_API BOOL __HP_CALL HP_HttpClient_IsUpgrade(HP_HttpClient pClient)
 {
 	return C_HP_Object::ToFirst<IHttpClient>(pClient)->IsUpgrade();
@@ -136,6 +136,7 @@ typedef En_HP_HandleResult (__HP_CALL *HP_FN_Server_OnPrepareListen)	(HP_Server
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Server_OnAccept)			(HP_Server pSender, HP_CONNID dwConnID, UINT_PTR pClient);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Server_OnHandShake)		(HP_Server pSender, HP_CONNID dwConnID);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Server_OnSend)				(HP_Server pSender, HP_CONNID dwConnID, const BYTE* pData, int iLength);
+typedef En_HP_HandleResult (__HP_CALL *HP_FN_Server_OnWritable)			(HP_Server pSender, HP_CONNID dwConnID, BOOL bWritable);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Server_OnReceive)			(HP_Server pSender, HP_CONNID dwConnID, const BYTE* pData, int iLength);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Server_OnPullReceive)		(HP_Server pSender, HP_CONNID dwConnID, int iLength);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Server_OnClose)			(HP_Server pSender, HP_CONNID dwConnID, En_HP_SocketOperation enOperation, int iErrorCode);
@@ -146,6 +147,7 @@ typedef En_HP_HandleResult (__HP_CALL *HP_FN_Agent_OnPrepareConnect)	(HP_Agent p
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Agent_OnConnect)			(HP_Agent pSender, HP_CONNID dwConnID);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Agent_OnHandShake)			(HP_Agent pSender, HP_CONNID dwConnID);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Agent_OnSend)				(HP_Agent pSender, HP_CONNID dwConnID, const BYTE* pData, int iLength);
+typedef En_HP_HandleResult (__HP_CALL *HP_FN_Agent_OnWritable)			(HP_Agent pSender, HP_CONNID dwConnID, BOOL bWritable);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Agent_OnReceive)			(HP_Agent pSender, HP_CONNID dwConnID, const BYTE* pData, int iLength);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Agent_OnPullReceive)		(HP_Agent pSender, HP_CONNID dwConnID, int iLength);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Agent_OnClose)				(HP_Agent pSender, HP_CONNID dwConnID, En_HP_SocketOperation enOperation, int iErrorCode);
@@ -156,6 +158,7 @@ typedef En_HP_HandleResult (__HP_CALL *HP_FN_Client_OnPrepareConnect)	(HP_Client
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Client_OnConnect)			(HP_Client pSender, HP_CONNID dwConnID);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Client_OnHandShake)		(HP_Client pSender, HP_CONNID dwConnID);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Client_OnSend)				(HP_Client pSender, HP_CONNID dwConnID, const BYTE* pData, int iLength);
+typedef En_HP_HandleResult (__HP_CALL *HP_FN_Client_OnWritable)			(HP_Client pSender, HP_CONNID dwConnID, BOOL bWritable);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Client_OnReceive)			(HP_Client pSender, HP_CONNID dwConnID, const BYTE* pData, int iLength);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Client_OnPullReceive)		(HP_Client pSender, HP_CONNID dwConnID, int iLength);
 typedef En_HP_HandleResult (__HP_CALL *HP_FN_Client_OnClose)			(HP_Client pSender, HP_CONNID dwConnID, En_HP_SocketOperation enOperation, int iErrorCode);
@@ -270,6 +273,7 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnPrepareListen(HP_ServerListener p
 HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnAccept(HP_ServerListener pListener			, HP_FN_Server_OnAccept fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnHandShake(HP_ServerListener pListener		, HP_FN_Server_OnHandShake fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnSend(HP_ServerListener pListener				, HP_FN_Server_OnSend fn);
+HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnWritable(HP_ServerListener pListener			, HP_FN_Server_OnWritable fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnReceive(HP_ServerListener pListener			, HP_FN_Server_OnReceive fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnPullReceive(HP_ServerListener pListener		, HP_FN_Server_OnPullReceive fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Server_OnClose(HP_ServerListener pListener			, HP_FN_Server_OnClose fn);
@@ -282,6 +286,7 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnPrepareConnect(HP_AgentListener pL
 HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnConnect(HP_AgentListener pListener			, HP_FN_Agent_OnConnect fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnHandShake(HP_AgentListener pListener			, HP_FN_Agent_OnHandShake fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnSend(HP_AgentListener pListener				, HP_FN_Agent_OnSend fn);
+HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnWritable(HP_AgentListener pListener			, HP_FN_Agent_OnWritable fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnReceive(HP_AgentListener pListener			, HP_FN_Agent_OnReceive fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnPullReceive(HP_AgentListener pListener		, HP_FN_Agent_OnPullReceive fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Agent_OnClose(HP_AgentListener pListener				, HP_FN_Agent_OnClose fn);
@@ -294,6 +299,7 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnPrepareConnect(HP_ClientListener
 HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnConnect(HP_ClientListener pListener			, HP_FN_Client_OnConnect fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnHandShake(HP_ClientListener pListener		, HP_FN_Client_OnHandShake fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnSend(HP_ClientListener pListener				, HP_FN_Client_OnSend fn);
+HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnWritable(HP_ClientListener pListener			, HP_FN_Client_OnWritable fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnReceive(HP_ClientListener pListener			, HP_FN_Client_OnReceive fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnPullReceive(HP_ClientListener pListener		, HP_FN_Client_OnPullReceive fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_Client_OnClose(HP_ClientListener pListener			, HP_FN_Client_OnClose fn);
@@ -405,6 +411,32 @@ HPSOCKET_API BOOL __HP_CALL HP_Server_DisconnectLongConnections(HP_Server pServe
 */
 HPSOCKET_API BOOL __HP_CALL HP_Server_DisconnectSilenceConnections(HP_Server pServer, DWORD dwPeriod, BOOL bForce);
 
+/*
+* ƣӶʱ
+* ΪһԶʱʱʱڹ߳е fnTimerTCP ķƬģʽΪƬḶ́߳
+*		1ÿֻһʱظý滻ԭĶʱ
+*		2ӶϿʱʱԶȡ
+*		3ʱΪʱ̶ȼοHP_Server_SetTimerInterval()
+*		
+* 		dwConnID	--  ID
+*			dwTimeout	-- ʱʱ䣨룩
+*			fnTimer		-- ʱص
+*			pvParam		-- Զ
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_Server_SetConnectionTimer(HP_Server pServer, HP_CONNID dwConnID, DWORD dwTimeout, HP_Fn_ConnectionTimer fnTimer, PVOID pvParam);
+
+/*
+* ƣȡӶʱ
+* ȡ HP_Server_SetConnectionTimer() õӶʱ
+*		
+* 		dwConnID	--  ID
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣЧ ID ʱδã
+*/
+HPSOCKET_API BOOL __HP_CALL HP_Server_KillConnectionTimer(HP_Server pServer, HP_CONNID dwConnID);
+
 /******************************************************************************/
 /***************************** Server Էʷ *****************************/
 
@@ -446,6 +478,8 @@ HPSOCKET_API BOOL __HP_CALL HP_Server_GetPendingDataLength(HP_Server pServer, HP
 HPSOCKET_API BOOL __HP_CALL HP_Server_IsPauseReceive(HP_Server pServer, HP_CONNID dwConnID, BOOL* pbPaused);
 /* ǷЧ */
 HPSOCKET_API BOOL __HP_CALL HP_Server_IsConnected(HP_Server pServer, HP_CONNID dwConnID);
+/* ȡڴ̻߳۵ۼкδд */
+HPSOCKET_API void __HP_CALL HP_Server_GetFreeBufferObjCacheStat(HP_Server pServer, ULONGLONG* pullHits, ULONGLONG* pullMisses);
 /* ȡͻ */
 HPSOCKET_API DWORD __HP_CALL HP_Server_GetConnectionCount(HP_Server pServer);
 /* ȡӵ HP_CONNID */
@@ -475,12 +509,34 @@ HPSOCKET_API void __HP_CALL HP_Server_SetFreeBufferObjPool(HP_Server pServer, DW
 HPSOCKET_API void __HP_CALL HP_Server_SetFreeSocketObjHold(HP_Server pServer, DWORD dwFreeSocketObjHold);
 /* ڴ黺ػշֵͨΪڴ黺شС 3  */
 HPSOCKET_API void __HP_CALL HP_Server_SetFreeBufferObjHold(HP_Server pServer, DWORD dwFreeBufferObjHold);
+/* ʱԤȴ Socket  Socket شСɼӵڴȱҳĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Server_SetFreeSocketObjPrealloc(HP_Server pServer, DWORD dwFreeSocketObjPrealloc);
+/* ʱԤȴڴڴ黺شСĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Server_SetFreeBufferObjPrealloc(HP_Server pServer, DWORD dwFreeBufferObjPrealloc);
+/* ڴ̻߳лռڴ黺صһ룬0 ʹ̻ۣ߳Ĭϣ32 */
+HPSOCKET_API void __HP_CALL HP_Server_SetFreeBufferObjCache(HP_Server pServer, DWORD dwFreeBufferObjCache);
+/* ûڴǷڸ NUMA ڵ佻䣨й̹߳ɾڵڴʣĬϣFALSE */
+HPSOCKET_API void __HP_CALL HP_Server_SetPoolNumaInterleave(HP_Server pServer, BOOL bPoolNumaInterleave);
 /* ֵԤڴ棬Ҫʵã˹*/
 HPSOCKET_API void __HP_CALL HP_Server_SetMaxConnectionCount(HP_Server pServer, DWORD dwMaxConnectionCount);
 /* ù߳ͨΪ 2 * CPU + 2 */
 HPSOCKET_API void __HP_CALL HP_Server_SetWorkerThreadCount(HP_Server pServer, DWORD dwWorkerThreadCount);
 /* ǷǾĬʱ䣨Ϊ TRUE ʱ DisconnectSilenceConnections()  GetSilencePeriod() ЧĬϣTRUE */
 HPSOCKET_API void __HP_CALL HP_Server_SetMarkSilence(HP_Server pServer, BOOL bMarkSilence);
+/* öʱ̶ȼ룬þȼӳʱʹӶʱ0 öʱĬϣ100 */
+HPSOCKET_API void __HP_CALL HP_Server_SetTimerInterval(HP_Server pServer, DWORD dwTimerInterval);
+/* ʱ룬ʱֵʱԶϿӣ0 ƣĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Server_SetMaxConnectPeriod(HP_Server pServer, DWORD dwMaxConnectPeriod);
+/* þĬʱʱ䣨룬ӾĬʱ䳬ֵʱԶϿӣҪǾĬʱ䣬0 򲻼⣬Ĭϣ0 */
+HPSOCKET_API void __HP_CALL HP_Server_SetSilenceTimeout(HP_Server pServer, DWORD dwSilenceTimeout);
+/* ֳʱʱ䣨룬ӳʱδʱԶϿӣֻ SSL Ч0 򲻼⣬Ĭϣ0 */
+HPSOCKET_API void __HP_CALL HP_Server_SetHandShakeTimeout(HP_Server pServer, DWORD dwHandShakeTimeout);
+/* ÷͸ˮλֽڣӴݴﵽֵʱ OnWritable(FALSE) ܾͣ0 ƣĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Server_SetSendHighWatermark(HP_Server pServer, DWORD dwSendHighWatermark);
+/* ÷͵ˮλֽڣӴݽֵʱ OnWritable(TRUE)Сڷ͸ˮλĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Server_SetSendLowWatermark(HP_Server pServer, DWORD dwSendLowWatermark);
+/* Ӵޣֽڣֵʱܾͣ0 ƣĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Server_SetMaxSendPending(HP_Server pServer, DWORD dwMaxSendPending);
 
 /* ȡݷͲԣ Linux ƽ̨Ч */
 HPSOCKET_API En_HP_SendPolicy __HP_CALL HP_Server_GetSendPolicy(HP_Server pServer);
@@ -496,12 +552,34 @@ HPSOCKET_API DWORD __HP_CALL HP_Server_GetFreeBufferObjPool(HP_Server pServer);
 HPSOCKET_API DWORD __HP_CALL HP_Server_GetFreeSocketObjHold(HP_Server pServer);
 /* ȡڴ黺ػշֵ */
 HPSOCKET_API DWORD __HP_CALL HP_Server_GetFreeBufferObjHold(HP_Server pServer);
+/* ȡʱԤȴ Socket  */
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetFreeSocketObjPrealloc(HP_Server pServer);
+/* ȡʱԤȴڴ */
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetFreeBufferObjPrealloc(HP_Server pServer);
+/* ȡڴ̻߳ */
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetFreeBufferObjCache(HP_Server pServer);
+/* ⻺ڴǷڸ NUMA ڵ佻 */
+HPSOCKET_API BOOL __HP_CALL HP_Server_IsPoolNumaInterleave(HP_Server pServer);
 /* ȡ */
 HPSOCKET_API DWORD __HP_CALL HP_Server_GetMaxConnectionCount(HP_Server pServer);
 /* ȡ߳ */
 HPSOCKET_API DWORD __HP_CALL HP_Server_GetWorkerThreadCount(HP_Server pServer);
 /* ǷǾĬʱ */
 HPSOCKET_API BOOL __HP_CALL HP_Server_IsMarkSilence(HP_Server pServer);
+/* ȡʱ̶ȼ */
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetTimerInterval(HP_Server pServer);
+/* ȡʱ */
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetMaxConnectPeriod(HP_Server pServer);
+/* ȡĬʱʱ */
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetSilenceTimeout(HP_Server pServer);
+/* ȡֳʱʱ */
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetHandShakeTimeout(HP_Server pServer);
+/* ȡ͸ˮλ */
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetSendHighWatermark(HP_Server pServer);
+/* ȡ͵ˮλ */
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetSendLowWatermark(HP_Server pServer);
+/* ȡӴ */
+HPSOCKET_API DWORD __HP_CALL HP_Server_GetMaxSendPending(HP_Server pServer);
 
 /**********************************************************************************/
 /******************************* TCP Server  *******************************/
@@ -519,9 +597,103 @@ HPSOCKET_API BOOL __HP_CALL HP_Server_IsMarkSilence(HP_Server pServer);
 */
 HPSOCKET_API BOOL __HP_CALL HP_TcpServer_SendSmallFile(HP_Server pServer, HP_CONNID dwConnID, LPCTSTR lpszFileName, const LPWSABUF pHead, const LPWSABUF pTail);
 
+/*
+* ƣļ
+* ָӷļָ򣨲Сļͨ TCP ʹ sendfile() ͣ
+*		
+* 		dwConnID		--  ID
+*			lpszFileName	-- ļ·
+*			llOffset		-- ļʼƫ
+*			llLength		-- ļ򳤶ȣ0͵ļĩβ
+*			pHead			-- ͷ
+*			pTail			-- βݣһη͵ܳȲܳ 2 GB
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_SendFile(HP_Server pServer, HP_CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail);
+
+/*
+* ƣ÷ʽ
+* ָӷݣݣøûֱύϵͳͣʺϷʹݣ
+*		ٱʱȫύϵͳ߷ʧܡӹرգ fnReleaseڴ֮ǰ޸ĻͷŸû
+*		۱ TRUE  FALSEfnRelease ֻᱻһΣڱǰãfnRelease вҪñķͷ
+*		SSL  PACK ҪԷݽмӹ˻Ϊͣɺ fnRelease
+*		
+* 		dwConnID	--  ID
+*			pBuffer		-- ͻ
+*			iLength		-- ͻ
+*			fnRelease	-- ͷźΪ NULL
+*			pvParam		-- ͷźԶ
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_SendReference(HP_Server pServer, HP_CONNID dwConnID, const BYTE* pBuffer, int iLength, HP_Fn_SendRelease fnRelease, PVOID pvParam);
+
+/*
+* ƣ㲥
+* ӷͬݣֻһεüĹݿ飬÷ʽѹݿ뷢Ͷ
+*		PACK ֻһΰͷSSL ҪӼܣ˻Ϊӷͣ
+*		
+* 		pConnIDs	--  ID 
+*			iConnCount	--  ID 鳤
+*			pBuffer		-- ͻ
+*			iLength		-- ͻ
+* ֵ	TRUE	-- ȫӷͳɹ
+*			FALSE	-- ֻȫӷʧܣʧܵӲӰӵķͣͨ SYS_GetLastError() ȡһ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_Broadcast(HP_Server pServer, const HP_CONNID pConnIDs[], int iConnCount, const BYTE* pBuffer, int iLength);
+
+/*
+* ƣ㲥
+* ӷͬĶݣݺϲһüĹݿ飨οHP_TcpServer_Broadcast()
+*		
+* 		pConnIDs	--  ID 
+*			iConnCount	--  ID 鳤
+*			pBuffers	-- ͻ
+*			iCount		-- ͻĿ
+* ֵ	TRUE	-- ȫӷͳɹ
+*			FALSE	-- ֻȫӷʧܣͨ SYS_GetLastError() ȡһ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_BroadcastPackets(HP_Server pServer, const HP_CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount);
+
+/*
+* ƣջ
+*  OnReceive ¼ȡýջȨOnReceive ¼غ pData ȻЧֱ HP_TcpServer_ReleaseReceiveBuffer() 黹
+*		1ֻڿɷģʽЧοHP_TcpServer_SetDetachableReceive()ֻ OnReceive ¼е
+*		2pData  iLength  OnReceive ¼ԭʼPULL / PACK / HTTP / SSL Ľݾ˼ӹܷ
+*		3Ӧó߳й黹HP_TcpServer_Stop() ȴѷĻ黹أ˲ڵ HP_TcpServer_Stop() ߳глȴ䷵
+*		
+* 		pData		-- OnReceive ¼ݻ
+*			iLength		-- OnReceive ¼ݳ
+*			ppBuffer	-- 
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_DetachReceiveBuffer(HP_Server pServer, const BYTE* pData, int iLength, PVOID* ppBuffer);
+
+/*
+* ƣ黹ջ
+* 黹 HP_TcpServer_DetachReceiveBuffer() Ľջ
+*		
+* 		pBuffer		-- 
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_ReleaseReceiveBuffer(HP_Server pServer, PVOID pBuffer);
+
 /**********************************************************************************/
 /***************************** TCP Server Էʷ *****************************/
 
+/*  IO ģʽĬϣDM_SHARED */
+HPSOCKET_API void __HP_CALL HP_TcpServer_SetDispatchMode(HP_TcpServer pServer, En_HP_DispatchMode enDispatchMode);
+/* üģʽĬϣLM_SINGLE */
+HPSOCKET_API void __HP_CALL HP_TcpServer_SetListenMode(HP_TcpServer pServer, En_HP_ListenMode enListenMode);
+/* ǷñԵģʽĬϣã */
+HPSOCKET_API void __HP_CALL HP_TcpServer_SetEdgeTrigger(HP_TcpServer pServer, BOOL bEdgeTrigger);
+/* Ƿϲ OnSend ֪ͨĬϣϲúÿֻһ OnSendpData Ϊ nullptr */
+HPSOCKET_API void __HP_CALL HP_TcpServer_SetBatchSendNotify(HP_TcpServer pServer, BOOL bBatchSendNotify);
+/* ǷÿɷģʽĬϣãú OnReceive ¼пͨ HP_TcpServer_DetachReceiveBuffer() ȡ߽ջ */
+HPSOCKET_API void __HP_CALL HP_TcpServer_SetDetachableReceive(HP_TcpServer pServer, BOOL bDetachableReceive);
 /* ü Socket ĵȺдСݲã */
 HPSOCKET_API void __HP_CALL HP_TcpServer_SetSocketListenQueue(HP_TcpServer pServer, DWORD dwSocketListenQueue);
 /*  EPOLL ȴ¼ */
@@ -533,6 +705,16 @@ HPSOCKET_API void __HP_CALL HP_TcpServer_SetKeepAliveTime(HP_TcpServer pServer,
 /* 쳣룬0 Ĭϣ20 * 1000ɴ [ĬϣWinXP 5 , Win7 10 ] ⲻȷϰΪѶߣ */
 HPSOCKET_API void __HP_CALL HP_TcpServer_SetKeepAliveInterval(HP_TcpServer pServer, DWORD dwKeepAliveInterval);
 
+/* ȡ IO ģʽ */
+HPSOCKET_API En_HP_DispatchMode __HP_CALL HP_TcpServer_GetDispatchMode(HP_TcpServer pServer);
+/* ȡģʽ */
+HPSOCKET_API En_HP_ListenMode __HP_CALL HP_TcpServer_GetListenMode(HP_TcpServer pServer);
+/* ǷñԵģʽ */
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_IsEdgeTrigger(HP_TcpServer pServer);
+/* Ƿϲ OnSend ֪ͨ */
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_IsBatchSendNotify(HP_TcpServer pServer);
+/* Ƿÿɷģʽ */
+HPSOCKET_API BOOL __HP_CALL HP_TcpServer_IsDetachableReceive(HP_TcpServer pServer);
 /* ȡ EPOLL ȴ¼ */
 HPSOCKET_API DWORD __HP_CALL HP_TcpServer_GetAcceptSocketCount(HP_TcpServer pServer);
 /* ȡͨݻС */
@@ -552,11 +734,25 @@ HPSOCKET_API void __HP_CALL HP_UdpServer_SetMaxDatagramSize(HP_UdpServer pServer
 /* ȡݱ󳤶 */
 HPSOCKET_API DWORD __HP_CALL HP_UdpServer_GetMaxDatagramSize(HP_UdpServer pServer);
 
+/* üģʽĬϣLM_SINGLE */
+HPSOCKET_API void __HP_CALL HP_UdpServer_SetListenMode(HP_UdpServer pServer, En_HP_ListenMode enListenMode);
+/* ȡģʽ */
+HPSOCKET_API En_HP_ListenMode __HP_CALL HP_UdpServer_GetListenMode(HP_UdpServer pServer);
+
 /*  Receive ԤͶݸصãReceive ԤͶԽ򶪰ԽС */
 HPSOCKET_API void __HP_CALL HP_UdpServer_SetPostReceiveCount(HP_UdpServer pServer, DWORD dwPostReceiveCount);
 /* ȡ Receive ԤͶ */
 HPSOCKET_API DWORD __HP_CALL HP_UdpServer_GetPostReceiveCount(HP_UdpServer pServer);
 
+/* ÿյݱ 1 ʹ recvmmsg ղӺϲֵ64Ĭϣ1 */
+HPSOCKET_API void __HP_CALL HP_UdpServer_SetReceiveBatchCount(HP_UdpServer pServer, DWORD dwReceiveBatchCount);
+/* ÿ͵ݱ 1 ʹ sendmmsg ϲͶӵݱֵ64Ĭϣ1 */
+HPSOCKET_API void __HP_CALL HP_UdpServer_SetSendBatchCount(HP_UdpServer pServer, DWORD dwSendBatchCount);
+/* ȡÿյݱ */
+HPSOCKET_API DWORD __HP_CALL HP_UdpServer_GetReceiveBatchCount(HP_UdpServer pServer);
+/* ȡÿ͵ݱ */
+HPSOCKET_API DWORD __HP_CALL HP_UdpServer_GetSendBatchCount(HP_UdpServer pServer);
+
 /* üԴ0 򲻷ͼԴΪѶߣ */
 HPSOCKET_API void __HP_CALL HP_UdpServer_SetDetectAttempts(HP_UdpServer pServer, DWORD dwDetectAttempts);
 /* üͼ룬0 ͼ */
@@ -624,7 +820,7 @@ HPSOCKET_API BOOL __HP_CALL HP_Agent_ConnectWithExtra(HP_Agent pAgent, LPCTSTR l
 *			pdwConnID			--  IDĬϣnullptrȡ ID
 *			usLocalPort			-- ض˿ڣĬϣ0
 * ֵ	TRUE	-- ɹ
-*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡ Windows 
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
 */
 HPSOCKET_API BOOL __HP_CALL HP_Agent_ConnectWithLocalPort(HP_Agent pAgent, LPCTSTR lpszRemoteAddress, USHORT usPort, HP_CONNID* pdwConnID, USHORT usLocalPort);
 
@@ -638,7 +834,7 @@ HPSOCKET_API BOOL __HP_CALL HP_Agent_ConnectWithLocalPort(HP_Agent pAgent, LPCTS
 *			pExtra				-- ӸݣĬϣnullptr
 *			usLocalPort			-- ض˿ڣĬϣ0
 * ֵ	TRUE	-- ɹ
-*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡ Windows 
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
 */
 HPSOCKET_API BOOL __HP_CALL HP_Agent_ConnectWithExtraAndLocalPort(HP_Agent pAgent, LPCTSTR lpszRemoteAddress, USHORT usPort, HP_CONNID* pdwConnID, PVOID pExtra, USHORT usLocalPort);
 
@@ -725,6 +921,32 @@ HPSOCKET_API BOOL __HP_CALL HP_Agent_DisconnectLongConnections(HP_Agent pAgent,
 */
 HPSOCKET_API BOOL __HP_CALL HP_Agent_DisconnectSilenceConnections(HP_Agent pAgent, DWORD dwPeriod, BOOL bForce);
 
+/*
+* ƣӶʱ
+* ΪһԶʱʱʱڹ߳е fnTimerTCP ķƬģʽΪƬḶ́߳
+*		1ÿֻһʱظý滻ԭĶʱ
+*		2ӶϿʱʱԶȡ
+*		3ʱΪʱ̶ȼοHP_Agent_SetTimerInterval()
+*		
+* 		dwConnID	--  ID
+*			dwTimeout	-- ʱʱ䣨룩
+*			fnTimer		-- ʱص
+*			pvParam		-- Զ
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_Agent_SetConnectionTimer(HP_Agent pAgent, HP_CONNID dwConnID, DWORD dwTimeout, HP_Fn_ConnectionTimer fnTimer, PVOID pvParam);
+
+/*
+* ƣȡӶʱ
+* ȡ HP_Agent_SetConnectionTimer() õӶʱ
+*		
+* 		dwConnID	--  ID
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣЧ ID ʱδã
+*/
+HPSOCKET_API BOOL __HP_CALL HP_Agent_KillConnectionTimer(HP_Agent pAgent, HP_CONNID dwConnID);
+
 /******************************************************************************/
 /***************************** Agent Էʷ *****************************/
 
@@ -780,6 +1002,8 @@ HPSOCKET_API BOOL __HP_CALL HP_Agent_GetPendingDataLength(HP_Agent pAgent, HP_CO
 HPSOCKET_API BOOL __HP_CALL HP_Agent_IsPauseReceive(HP_Agent pAgent, HP_CONNID dwConnID, BOOL* pbPaused);
 /* ǷЧ */
 HPSOCKET_API BOOL __HP_CALL HP_Agent_IsConnected(HP_Agent pAgent, HP_CONNID dwConnID);
+/* ȡڴ̻߳۵ۼкδд */
+HPSOCKET_API void __HP_CALL HP_Agent_GetFreeBufferObjCacheStat(HP_Agent pAgent, ULONGLONG* pullHits, ULONGLONG* pullMisses);
 
 /* ݷͲԣ Linux ƽ̨Ч */
 HPSOCKET_API void __HP_CALL HP_Agent_SetSendPolicy(HP_Agent pAgent, En_HP_SendPolicy enSendPolicy);
@@ -795,12 +1019,34 @@ HPSOCKET_API void __HP_CALL HP_Agent_SetFreeBufferObjPool(HP_Agent pAgent, DWORD
 HPSOCKET_API void __HP_CALL HP_Agent_SetFreeSocketObjHold(HP_Agent pAgent, DWORD dwFreeSocketObjHold);
 /* ڴ黺ػշֵͨΪڴ黺شС 3  */
 HPSOCKET_API void __HP_CALL HP_Agent_SetFreeBufferObjHold(HP_Agent pAgent, DWORD dwFreeBufferObjHold);
+/* ʱԤȴ Socket  Socket شСɼӵڴȱҳĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Agent_SetFreeSocketObjPrealloc(HP_Agent pAgent, DWORD dwFreeSocketObjPrealloc);
+/* ʱԤȴڴڴ黺شСĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Agent_SetFreeBufferObjPrealloc(HP_Agent pAgent, DWORD dwFreeBufferObjPrealloc);
+/* ڴ̻߳лռڴ黺صһ룬0 ʹ̻ۣ߳Ĭϣ32 */
+HPSOCKET_API void __HP_CALL HP_Agent_SetFreeBufferObjCache(HP_Agent pAgent, DWORD dwFreeBufferObjCache);
+/* ûڴǷڸ NUMA ڵ佻䣨й̹߳ɾڵڴʣĬϣFALSE */
+HPSOCKET_API void __HP_CALL HP_Agent_SetPoolNumaInterleave(HP_Agent pAgent, BOOL bPoolNumaInterleave);
 /* ֵԤڴ棬Ҫʵã˹*/
 HPSOCKET_API void __HP_CALL HP_Agent_SetMaxConnectionCount(HP_Agent pAgent, DWORD dwMaxConnectionCount);
 /* ù߳ͨΪ 2 * CPU + 2 */
 HPSOCKET_API void __HP_CALL HP_Agent_SetWorkerThreadCount(HP_Agent pAgent, DWORD dwWorkerThreadCount);
 /* ǷǾĬʱ䣨Ϊ TRUE ʱ DisconnectSilenceConnections()  GetSilencePeriod() ЧĬϣTRUE */
 HPSOCKET_API void __HP_CALL HP_Agent_SetMarkSilence(HP_Agent pAgent, BOOL bMarkSilence);
+/* öʱ̶ȼ룬þȼӳʱʹӶʱ0 öʱĬϣ100 */
+HPSOCKET_API void __HP_CALL HP_Agent_SetTimerInterval(HP_Agent pAgent, DWORD dwTimerInterval);
+/* ʱ룬ʱֵʱԶϿӣ0 ƣĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Agent_SetMaxConnectPeriod(HP_Agent pAgent, DWORD dwMaxConnectPeriod);
+/* þĬʱʱ䣨룬ӾĬʱ䳬ֵʱԶϿӣҪǾĬʱ䣬0 򲻼⣬Ĭϣ0 */
+HPSOCKET_API void __HP_CALL HP_Agent_SetSilenceTimeout(HP_Agent pAgent, DWORD dwSilenceTimeout);
+/* ֳʱʱ䣨룬ӳʱδʱԶϿӣֻ SSL Ч0 򲻼⣬Ĭϣ0 */
+HPSOCKET_API void __HP_CALL HP_Agent_SetHandShakeTimeout(HP_Agent pAgent, DWORD dwHandShakeTimeout);
+/* ÷͸ˮλֽڣӴݴﵽֵʱ OnWritable(FALSE) ܾͣ0 ƣĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Agent_SetSendHighWatermark(HP_Agent pAgent, DWORD dwSendHighWatermark);
+/* ÷͵ˮλֽڣӴݽֵʱ OnWritable(TRUE)Сڷ͸ˮλĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Agent_SetSendLowWatermark(HP_Agent pAgent, DWORD dwSendLowWatermark);
+/* Ӵޣֽڣֵʱܾͣ0 ƣĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Agent_SetMaxSendPending(HP_Agent pAgent, DWORD dwMaxSendPending);
 
 /* ȡݷͲԣ Linux ƽ̨Ч */
 HPSOCKET_API En_HP_SendPolicy __HP_CALL HP_Agent_GetSendPolicy(HP_Agent pAgent);
@@ -816,12 +1062,34 @@ HPSOCKET_API DWORD __HP_CALL HP_Agent_GetFreeBufferObjPool(HP_Agent pAgent);
 HPSOCKET_API DWORD __HP_CALL HP_Agent_GetFreeSocketObjHold(HP_Agent pAgent);
 /* ȡڴ黺ػշֵ */
 HPSOCKET_API DWORD __HP_CALL HP_Agent_GetFreeBufferObjHold(HP_Agent pAgent);
+/* ȡʱԤȴ Socket  */
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetFreeSocketObjPrealloc(HP_Agent pAgent);
+/* ȡʱԤȴڴ */
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetFreeBufferObjPrealloc(HP_Agent pAgent);
+/* ȡڴ̻߳ */
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetFreeBufferObjCache(HP_Agent pAgent);
+/* ⻺ڴǷڸ NUMA ڵ佻 */
+HPSOCKET_API BOOL __HP_CALL HP_Agent_IsPoolNumaInterleave(HP_Agent pAgent);
 /* ȡ */
 HPSOCKET_API DWORD __HP_CALL HP_Agent_GetMaxConnectionCount(HP_Agent pAgent);
 /* ȡ߳ */
 HPSOCKET_API DWORD __HP_CALL HP_Agent_GetWorkerThreadCount(HP_Agent pAgent);
 /* ǷǾĬʱ */
 HPSOCKET_API BOOL __HP_CALL HP_Agent_IsMarkSilence(HP_Agent pAgent);
+/* ȡʱ̶ȼ */
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetTimerInterval(HP_Agent pAgent);
+/* ȡʱ */
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetMaxConnectPeriod(HP_Agent pAgent);
+/* ȡĬʱʱ */
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetSilenceTimeout(HP_Agent pAgent);
+/* ȡֳʱʱ */
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetHandShakeTimeout(HP_Agent pAgent);
+/* ȡ͸ˮλ */
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetSendHighWatermark(HP_Agent pAgent);
+/* ȡ͵ˮλ */
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetSendLowWatermark(HP_Agent pAgent);
+/* ȡӴ */
+HPSOCKET_API DWORD __HP_CALL HP_Agent_GetMaxSendPending(HP_Agent pAgent);
 
 /**********************************************************************************/
 /******************************* TCP Agent  *******************************/
@@ -839,6 +1107,90 @@ HPSOCKET_API BOOL __HP_CALL HP_Agent_IsMarkSilence(HP_Agent pAgent);
 */
 HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_SendSmallFile(HP_Agent pAgent, HP_CONNID dwConnID, LPCTSTR lpszFileName, const LPWSABUF pHead, const LPWSABUF pTail);
 
+/*
+* ƣļ
+* ָӷļָ򣨲Сļͨ TCP ʹ sendfile() ͣ
+*		
+* 		dwConnID		--  ID
+*			lpszFileName	-- ļ·
+*			llOffset		-- ļʼƫ
+*			llLength		-- ļ򳤶ȣ0͵ļĩβ
+*			pHead			-- ͷ
+*			pTail			-- βݣһη͵ܳȲܳ 2 GB
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_SendFile(HP_Agent pAgent, HP_CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail);
+
+/*
+* ƣ÷ʽ
+* ָӷݣݣøûֱύϵͳͣʺϷʹݣ
+*		ٱʱȫύϵͳ߷ʧܡӹرգ fnReleaseڴ֮ǰ޸ĻͷŸû
+*		۱ TRUE  FALSEfnRelease ֻᱻһΣڱǰãfnRelease вҪñķͷ
+*		SSL  PACK ҪԷݽмӹ˻Ϊͣɺ fnRelease
+*		
+* 		dwConnID	--  ID
+*			pBuffer		-- ͻ
+*			iLength		-- ͻ
+*			fnRelease	-- ͷźΪ NULL
+*			pvParam		-- ͷźԶ
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_SendReference(HP_Agent pAgent, HP_CONNID dwConnID, const BYTE* pBuffer, int iLength, HP_Fn_SendRelease fnRelease, PVOID pvParam);
+
+/*
+* ƣ㲥
+* ӷͬݣֻһεüĹݿ飬÷ʽѹݿ뷢Ͷ
+*		PACK ֻһΰͷSSL ҪӼܣ˻Ϊӷͣ
+*		
+* 		pConnIDs	--  ID 
+*			iConnCount	--  ID 鳤
+*			pBuffer		-- ͻ
+*			iLength		-- ͻ
+* ֵ	TRUE	-- ȫӷͳɹ
+*			FALSE	-- ֻȫӷʧܣʧܵӲӰӵķͣͨ SYS_GetLastError() ȡһ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_Broadcast(HP_Agent pAgent, const HP_CONNID pConnIDs[], int iConnCount, const BYTE* pBuffer, int iLength);
+
+/*
+* ƣ㲥
+* ӷͬĶݣݺϲһüĹݿ飨οHP_TcpAgent_Broadcast()
+*		
+* 		pConnIDs	--  ID 
+*			iConnCount	--  ID 鳤
+*			pBuffers	-- ͻ
+*			iCount		-- ͻĿ
+* ֵ	TRUE	-- ȫӷͳɹ
+*			FALSE	-- ֻȫӷʧܣͨ SYS_GetLastError() ȡһ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_BroadcastPackets(HP_Agent pAgent, const HP_CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount);
+
+/*
+* ƣջ
+*  OnReceive ¼ȡýջȨOnReceive ¼غ pData ȻЧֱ HP_TcpAgent_ReleaseReceiveBuffer() 黹
+*		1ֻڿɷģʽЧοHP_TcpAgent_SetDetachableReceive()ֻ OnReceive ¼е
+*		2pData  iLength  OnReceive ¼ԭʼPULL / PACK / HTTP / SSL Ľݾ˼ӹܷ
+*		3Ӧó߳й黹HP_TcpAgent_Stop() ȴѷĻ黹أ˲ڵ HP_TcpAgent_Stop() ߳глȴ䷵
+*		
+* 		pData		-- OnReceive ¼ݻ
+*			iLength		-- OnReceive ¼ݳ
+*			ppBuffer	-- 
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_DetachReceiveBuffer(HP_Agent pAgent, const BYTE* pData, int iLength, PVOID* ppBuffer);
+
+/*
+* ƣ黹ջ
+* 黹 HP_TcpAgent_DetachReceiveBuffer() Ľջ
+*		
+* 		pBuffer		-- 
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_ReleaseReceiveBuffer(HP_Agent pAgent, PVOID pBuffer);
+
 /**********************************************************************************/
 /***************************** TCP Agent Էʷ *****************************/
 
@@ -847,6 +1199,23 @@ HPSOCKET_API void __HP_CALL HP_TcpAgent_SetReuseAddress(HP_TcpAgent pAgent, BOOL
 /* Ƿõַû */
 HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_IsReuseAddress(HP_TcpAgent pAgent);
 
+/*  IO ģʽĬϣDM_SHARED */
+HPSOCKET_API void __HP_CALL HP_TcpAgent_SetDispatchMode(HP_TcpAgent pAgent, En_HP_DispatchMode enDispatchMode);
+/* ȡ IO ģʽ */
+HPSOCKET_API En_HP_DispatchMode __HP_CALL HP_TcpAgent_GetDispatchMode(HP_TcpAgent pAgent);
+/* ǷñԵģʽĬϣã */
+HPSOCKET_API void __HP_CALL HP_TcpAgent_SetEdgeTrigger(HP_TcpAgent pAgent, BOOL bEdgeTrigger);
+/* ǷñԵģʽ */
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_IsEdgeTrigger(HP_TcpAgent pAgent);
+/* Ƿϲ OnSend ֪ͨĬϣϲúÿֻһ OnSendpData Ϊ nullptr */
+HPSOCKET_API void __HP_CALL HP_TcpAgent_SetBatchSendNotify(HP_TcpAgent pAgent, BOOL bBatchSendNotify);
+/* ǷÿɷģʽĬϣãú OnReceive ¼пͨ HP_TcpAgent_DetachReceiveBuffer() ȡ߽ջ */
+HPSOCKET_API void __HP_CALL HP_TcpAgent_SetDetachableReceive(HP_TcpAgent pAgent, BOOL bDetachableReceive);
+/* Ƿϲ OnSend ֪ͨ */
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_IsBatchSendNotify(HP_TcpAgent pAgent);
+/* Ƿÿɷģʽ */
+HPSOCKET_API BOOL __HP_CALL HP_TcpAgent_IsDetachableReceive(HP_TcpAgent pAgent);
+
 /* ͨݻСƽͨݰСãͨΪ 1024 ı */
 HPSOCKET_API void __HP_CALL HP_TcpAgent_SetSocketBufferSize(HP_TcpAgent pAgent, DWORD dwSocketBufferSize);
 /* 룬0 򲻷Ĭϣ60 * 1000 */
@@ -993,10 +1362,18 @@ HPSOCKET_API BOOL __HP_CALL HP_Client_IsConnected(HP_Client pClient);
 HPSOCKET_API void __HP_CALL HP_Client_SetFreeBufferPoolSize(HP_Client pClient, DWORD dwFreeBufferPoolSize);
 /* ڴ黺ػշֵͨΪڴ黺شС 3  */
 HPSOCKET_API void __HP_CALL HP_Client_SetFreeBufferPoolHold(HP_Client pClient, DWORD dwFreeBufferPoolHold);
+/* ÷͸ˮλֽڣݴﵽֵʱ OnWritable(FALSE) ܾͣ0 ƣĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Client_SetSendHighWatermark(HP_Client pClient, DWORD dwSendHighWatermark);
+/* ÷͵ˮλֽڣݽֵʱ OnWritable(TRUE)Сڷ͸ˮλĬϣ0 */
+HPSOCKET_API void __HP_CALL HP_Client_SetSendLowWatermark(HP_Client pClient, DWORD dwSendLowWatermark);
 /* ȡڴ黺شС */
 HPSOCKET_API DWORD __HP_CALL HP_Client_GetFreeBufferPoolSize(HP_Client pClient);
 /* ȡڴ黺ػշֵ */
 HPSOCKET_API DWORD __HP_CALL HP_Client_GetFreeBufferPoolHold(HP_Client pClient);
+/* ȡ͸ˮλ */
+HPSOCKET_API DWORD __HP_CALL HP_Client_GetSendHighWatermark(HP_Client pClient);
+/* ȡ͵ˮλ */
+HPSOCKET_API DWORD __HP_CALL HP_Client_GetSendLowWatermark(HP_Client pClient);
 
 /**********************************************************************************/
 /******************************* TCP Client  *******************************/
@@ -1013,9 +1390,49 @@ HPSOCKET_API DWORD __HP_CALL HP_Client_GetFreeBufferPoolHold(HP_Client pClient);
 */
 HPSOCKET_API BOOL __HP_CALL HP_TcpClient_SendSmallFile(HP_Client pClient, LPCTSTR lpszFileName, const LPWSABUF pHead, const LPWSABUF pTail);
 
+/*
+* ƣļ
+* ˷ļָ򣨲Сļͨ TCP ʹ sendfile() ͣ
+*		
+* 		lpszFileName	-- ļ·
+*			llOffset		-- ļʼƫ
+*			llLength		-- ļ򳤶ȣ0͵ļĩβ
+*			pHead			-- ͷ
+*			pTail			-- βݣһη͵ܳȲܳ 2 GB
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpClient_SendFile(HP_Client pClient, LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail);
+
+/*
+* ƣ÷ʽ
+* ˷ݣݣøûֱύϵͳͣʺϷʹݣ
+*		ٱʱȫύϵͳ߷ʧܡӹرգ fnReleaseڴ֮ǰ޸ĻͷŸû
+*		۱ TRUE  FALSEfnRelease ֻᱻһΣڱǰãfnRelease вҪñķͷ
+*		SSL  PACK ҪԷݽмӹ˻Ϊͣɺ fnRelease
+*		
+* 		pBuffer		-- ͻ
+*			iLength		-- ͻ
+*			fnRelease	-- ͷźΪ NULL
+*			pvParam		-- ͷźԶ
+* ֵ	TRUE	-- ɹ
+*			FALSE	-- ʧܣͨ SYS_GetLastError() ȡϵͳ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_TcpClient_SendReference(HP_Client pClient, const BYTE* pBuffer, int iLength, HP_Fn_SendRelease fnRelease, PVOID pvParam);
+
 /**********************************************************************************/
 /***************************** TCP Client Էʷ *****************************/
 
+/* Ƿϲ OnSend ֪ͨĬϣϲúÿֻһ OnSendpData Ϊ nullptr */
+HPSOCKET_API void __HP_CALL HP_TcpClient_SetBatchSendNotify(HP_TcpClient pClient, BOOL bBatchSendNotify);
+/* Ƿϲ OnSend ֪ͨ */
+HPSOCKET_API BOOL __HP_CALL HP_TcpClient_IsBatchSendNotify(HP_TcpClient pClient);
+
+/* Ƿʹù ReactorĬϣʹãúøѡĿͻýڵһ IO ̣߳ڹ Reactor Ĺֹ߳ͣƬĿͻʱ HP_Client_Stop() أɸڵĹֹ߳ͣ */
+HPSOCKET_API void __HP_CALL HP_TcpClient_SetSharedReactor(HP_TcpClient pClient, BOOL bSharedReactor);
+/* Ƿʹù Reactor */
+HPSOCKET_API BOOL __HP_CALL HP_TcpClient_IsSharedReactor(HP_TcpClient pClient);
+
 /* ͨݻСƽͨݰСãͨΪ(N * 1024) - sizeof(TBufferObj) */
 HPSOCKET_API void __HP_CALL HP_TcpClient_SetSocketBufferSize(HP_TcpClient pClient, DWORD dwSocketBufferSize);
 /* 룬0 򲻷Ĭϣ60 * 1000 */
@@ -1375,6 +1792,7 @@ typedef HP_FN_Server_OnAccept				HP_FN_HttpServer_OnAccept;
 typedef HP_FN_Server_OnHandShake			HP_FN_HttpServer_OnHandShake;
 typedef HP_FN_Server_OnReceive				HP_FN_HttpServer_OnReceive;
 typedef HP_FN_Server_OnSend					HP_FN_HttpServer_OnSend;
+typedef HP_FN_Server_OnWritable				HP_FN_HttpServer_OnWritable;
 typedef HP_FN_Server_OnClose				HP_FN_HttpServer_OnClose;
 typedef HP_FN_Server_OnShutdown				HP_FN_HttpServer_OnShutdown;
 
@@ -1399,6 +1817,7 @@ typedef HP_FN_Agent_OnConnect				HP_FN_HttpAgent_OnConnect;
 typedef HP_FN_Agent_OnHandShake				HP_FN_HttpAgent_OnHandShake;
 typedef HP_FN_Agent_OnReceive				HP_FN_HttpAgent_OnReceive;
 typedef HP_FN_Agent_OnSend					HP_FN_HttpAgent_OnSend;
+typedef HP_FN_Agent_OnWritable				HP_FN_HttpAgent_OnWritable;
 typedef HP_FN_Agent_OnClose					HP_FN_HttpAgent_OnClose;
 typedef HP_FN_Agent_OnShutdown				HP_FN_HttpAgent_OnShutdown;
 
@@ -1423,6 +1842,7 @@ typedef HP_FN_Client_OnConnect				HP_FN_HttpClient_OnConnect;
 typedef HP_FN_Client_OnHandShake			HP_FN_HttpClient_OnHandShake;
 typedef HP_FN_Client_OnReceive				HP_FN_HttpClient_OnReceive;
 typedef HP_FN_Client_OnSend					HP_FN_HttpClient_OnSend;
+typedef HP_FN_Client_OnWritable				HP_FN_HttpClient_OnWritable;
 typedef HP_FN_Client_OnClose				HP_FN_HttpClient_OnClose;
 
 /****************************************************/
@@ -1483,6 +1903,7 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_HttpServer_OnAccept(HP_HttpServerListener
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpServer_OnHandShake(HP_HttpServerListener pListener		, HP_FN_HttpServer_OnHandShake fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpServer_OnReceive(HP_HttpServerListener pListener			, HP_FN_HttpServer_OnReceive fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpServer_OnSend(HP_HttpServerListener pListener				, HP_FN_HttpServer_OnSend fn);
+HPSOCKET_API void __HP_CALL HP_Set_FN_HttpServer_OnWritable(HP_HttpServerListener pListener			, HP_FN_HttpServer_OnWritable fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpServer_OnClose(HP_HttpServerListener pListener			, HP_FN_HttpServer_OnClose fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpServer_OnShutdown(HP_HttpServerListener pListener			, HP_FN_HttpServer_OnShutdown fn);
 
@@ -1509,6 +1930,7 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_HttpAgent_OnConnect(HP_HttpAgentListener p
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpAgent_OnHandShake(HP_HttpAgentListener pListener			, HP_FN_HttpAgent_OnHandShake fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpAgent_OnReceive(HP_HttpAgentListener pListener			, HP_FN_HttpAgent_OnReceive fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpAgent_OnSend(HP_HttpAgentListener pListener				, HP_FN_HttpAgent_OnSend fn);
+HPSOCKET_API void __HP_CALL HP_Set_FN_HttpAgent_OnWritable(HP_HttpAgentListener pListener			, HP_FN_HttpAgent_OnWritable fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpAgent_OnClose(HP_HttpAgentListener pListener				, HP_FN_HttpAgent_OnClose fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpAgent_OnShutdown(HP_HttpAgentListener pListener			, HP_FN_HttpAgent_OnShutdown fn);
 
@@ -1535,6 +1957,7 @@ HPSOCKET_API void __HP_CALL HP_Set_FN_HttpClient_OnConnect(HP_HttpClientListener
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpClient_OnHandShake(HP_HttpClientListener pListener		, HP_FN_HttpClient_OnHandShake fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpClient_OnReceive(HP_HttpClientListener pListener			, HP_FN_HttpClient_OnReceive fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpClient_OnSend(HP_HttpClientListener pListener				, HP_FN_HttpClient_OnSend fn);
+HPSOCKET_API void __HP_CALL HP_Set_FN_HttpClient_OnWritable(HP_HttpClientListener pListener			, HP_FN_HttpClient_OnWritable fn);
 HPSOCKET_API void __HP_CALL HP_Set_FN_HttpClient_OnClose(HP_HttpClientListener pListener			, HP_FN_HttpClient_OnClose fn);
 
 /**************************************************************************/
@@ -1571,6 +1994,34 @@ HPSOCKET_API BOOL __HP_CALL HP_HttpServer_SendResponse(HP_HttpServer pServer, HP
 */
 HPSOCKET_API BOOL __HP_CALL HP_HttpServer_SendLocalFile(HP_HttpServer pServer, HP_CONNID dwConnID, LPCSTR lpszFileName, USHORT usStatusCode, LPCSTR lpszDesc, const HP_THeader lpHeaders[], int iHeaderCount);
 
+/*
+* ƣעӦģ
+* Ԥ״̬к͹̶Ӧͷͨ HP_HttpServer_SendTemplateResponse() ظʱֻ Content-Length
+*		Connection  DateÿһεĻֵӦͷlpHeaders ѰӦͷԶ
+*		ֹֻͣ״̬עᣩ
+*		
+* 		usStatusCode	-- HTTP ״̬
+*			lpszDesc		-- HTTP ״̬
+*			lpHeaders		-- ̶Ӧͷ
+*			iHeaderCount	-- ̶Ӧͷ
+* ֵ	 0			-- ģ ID
+*			0				-- ʧܣͨ SYS_GetLastError() ȡ
+*/
+HPSOCKET_API DWORD __HP_CALL HP_HttpServer_RegisterResponseTemplate(HP_HttpServer pServer, USHORT usStatusCode, LPCSTR lpszDesc, const HP_THeader lpHeaders[], int iHeaderCount);
+
+/*
+* ƣʹӦģظ
+* ʹ HP_HttpServer_RegisterResponseTemplate() עӦģͻ˻ظ HTTP 
+*		
+* 		dwConnID		--  ID
+*			dwTemplateID	-- ģ ID
+*			pData			-- ظ
+*			iLength			-- ظ峤
+* ֵ	TRUE			-- ɹ
+*			FALSE			-- ʧ
+*/
+HPSOCKET_API BOOL __HP_CALL HP_HttpServer_SendTemplateResponse(HP_HttpServer pServer, HP_CONNID dwConnID, DWORD dwTemplateID, const BYTE* pData, int iLength);
+
 /*
 * ƣ WebSocket Ϣ
 * Զ˶˷ WebSocket Ϣ
@@ -1621,6 +2072,19 @@ HPSOCKET_API void __HP_CALL HP_HttpServer_SetLocalVersion(HP_HttpServer pServer,
 /* ȡЭ汾 */
 HPSOCKET_API En_HP_HttpVersion __HP_CALL HP_HttpServer_GetLocalVersion(HP_HttpServer pServer);
 
+/* Ƿ WebSocket permessage-deflate չĬϣFALSE */
+HPSOCKET_API void __HP_CALL HP_HttpServer_SetWSDeflate(HP_HttpServer pServer, BOOL bDeflate);
+/*  permessage-deflate ѹλ9 - 15Ĭϣ15 */
+HPSOCKET_API void __HP_CALL HP_HttpServer_SetWSDeflateWindowBits(HP_HttpServer pServer, int iWindowBits);
+/*  permessage-deflate ǷϢ֮䱣ѹģĬϣTRUE */
+HPSOCKET_API void __HP_CALL HP_HttpServer_SetWSDeflateContextTakeover(HP_HttpServer pServer, BOOL bContextTakeover);
+/* Ƿ WebSocket permessage-deflate չ */
+HPSOCKET_API BOOL __HP_CALL HP_HttpServer_IsWSDeflate(HP_HttpServer pServer);
+/* ȡ permessage-deflate ѹλ */
+HPSOCKET_API int __HP_CALL HP_HttpServer_GetWSDeflateWindowBits(HP_HttpServer pServer);
+/*  permessage-deflate ǷϢ֮䱣ѹ */
+HPSOCKET_API BOOL __HP_CALL HP_HttpServer_IsWSDeflateContextTakeover(HP_HttpServer pServer);
+
 /* ǷЭ */
 HPSOCKET_API BOOL __HP_CALL HP_HttpServer_IsUpgrade(HP_HttpServer pServer, HP_CONNID dwConnID);
 /* Ƿ Keep-Alive ʶ */
@@ -1744,6 +2208,19 @@ HPSOCKET_API void __HP_CALL HP_HttpAgent_SetLocalVersion(HP_HttpAgent pAgent, En
 /* ȡЭ汾 */
 HPSOCKET_API En_HP_HttpVersion __HP_CALL HP_HttpAgent_GetLocalVersion(HP_HttpAgent pAgent);
 
+/* Ƿ WebSocket permessage-deflate չĬϣFALSE */
+HPSOCKET_API void __HP_CALL HP_HttpAgent_SetWSDeflate(HP_HttpAgent pAgent, BOOL bDeflate);
+/*  permessage-deflate ѹλ9 - 15Ĭϣ15 */
+HPSOCKET_API void __HP_CALL HP_HttpAgent_SetWSDeflateWindowBits(HP_HttpAgent pAgent, int iWindowBits);
+/*  permessage-deflate ǷϢ֮䱣ѹģĬϣTRUE */
+HPSOCKET_API void __HP_CALL HP_HttpAgent_SetWSDeflateContextTakeover(HP_HttpAgent pAgent, BOOL bContextTakeover);
+/* Ƿ WebSocket permessage-deflate չ */
+HPSOCKET_API BOOL __HP_CALL HP_HttpAgent_IsWSDeflate(HP_HttpAgent pAgent);
+/* ȡ permessage-deflate ѹλ */
+HPSOCKET_API int __HP_CALL HP_HttpAgent_GetWSDeflateWindowBits(HP_HttpAgent pAgent);
+/*  permessage-deflate ǷϢ֮䱣ѹ */
+HPSOCKET_API BOOL __HP_CALL HP_HttpAgent_IsWSDeflateContextTakeover(HP_HttpAgent pAgent);
+
 /* ǷЭ */
 HPSOCKET_API BOOL __HP_CALL HP_HttpAgent_IsUpgrade(HP_HttpAgent pAgent, HP_CONNID dwConnID);
 /* Ƿ Keep-Alive ʶ */
@@ -1867,6 +2344,19 @@ HPSOCKET_API void __HP_CALL HP_HttpClient_SetLocalVersion(HP_HttpClient pClient,
 /* ȡЭ汾 */
 HPSOCKET_API En_HP_HttpVersion __HP_CALL HP_HttpClient_GetLocalVersion(HP_HttpClient pClient);
 
+/* Ƿ WebSocket permessage-deflate չĬϣFALSE */
+HPSOCKET_API void __HP_CALL HP_HttpClient_SetWSDeflate(HP_HttpClient pClient, BOOL bDeflate);
+/*  permessage-deflate ѹλ9 - 15Ĭϣ15 */
+HPSOCKET_API void __HP_CALL HP_HttpClient_SetWSDeflateWindowBits(HP_HttpClient pClient, int iWindowBits);
+/*  permessage-deflate ǷϢ֮䱣ѹģĬϣTRUE */
+HPSOCKET_API void __HP_CALL HP_HttpClient_SetWSDeflateContextTakeover(HP_HttpClient pClient, BOOL bContextTakeover);
+/* Ƿ WebSocket permessage-deflate չ */
+HPSOCKET_API BOOL __HP_CALL HP_HttpClient_IsWSDeflate(HP_HttpClient pClient);
+/* ȡ permessage-deflate ѹλ */
+HPSOCKET_API int __HP_CALL HP_HttpClient_GetWSDeflateWindowBits(HP_HttpClient pClient);
+/*  permessage-deflate ǷϢ֮䱣ѹ */
+HPSOCKET_API BOOL __HP_CALL HP_HttpClient_IsWSDeflateContextTakeover(HP_HttpClient pClient);
+
 /* ǷЭ */
 HPSOCKET_API BOOL __HP_CALL HP_HttpClient_IsUpgrade(HP_HttpClient pClient);
 /* Ƿ Keep-Alive ʶ */
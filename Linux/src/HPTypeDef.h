@@ -132,12 +132,14 @@ typedef enum EnFetchResult
 * 打包发送策略（默认）	：尽量把多个发送操作的数据组合在一起发送，增加传输效率
 * 安全发送策略			：尽量把多个发送操作的数据组合在一起发送，并控制传输速度，避免缓冲区溢出
 * 直接发送策略			：对每一个发送操作都直接投递，适用于负载不高但要求实时性较高的场合
+						  （发送队列为空时在调用线程中直接写入 Socket：全部写入时在调用线程中触发 OnSend 事件；
+						    部分写入时剩余数据加入发送队列，已写入部分由工作线程触发 OnSend 事件，pData 为 nullptr）
 ************************************************************************/
 typedef enum EnSendPolicy
 {
 	SP_PACK				= 0,	// 打包模式（默认）
 	SP_SAFE				= 1,	// 安全模式
-	SP_DIRECT			= 2,	// 直接模式
+	SP_DIRECT			= 2,	// 直接模式（调用线程直接发送）
 } En_HP_SendPolicy;
 
 /************************************************************************
@@ -155,6 +157,50 @@ typedef enum EnOnSendSyncPolicy
 	OSSP_RECEIVE		= 2,	// 同步 OnReceive（只用于 TCP 组件）	
 } En_HP_OnSendSyncPolicy;
 
+/************************************************************************
+名称：IO 分派模式
+描述：Server 组件和 Agent 组件的 IO 事件分派模式
+
+* 共享模式（默认）	：所有工作线程共用一个 EPOLL 实例，连接的 IO 事件可能由任意工作线程处理
+* 分片模式			：每个工作线程独占一个 EPOLL 实例和命令队列，连接固定绑定到某个工作线程，
+*					  提高 CPU 缓存亲和性并避免惊群，且无需对连接的 IO 处理加锁
+* io_uring 模式		：在分片模式的基础上以 io_uring 代替 EPOLL。TCP Server 组件的连接以完成方式
+*					  收发数据：内核直接把数据读入接收缓冲区、从发送缓冲区发出，收发请求在工作线程中
+*					  批量提交，不再产生 read() / writev() 系统调用；内核 5.19 起接收缓冲区由每个工作
+*					  线程的缓冲区环（容量 URING_RECV_BUFFER_COUNT 个 SocketBufferSize 大小的缓冲区）
+*					  按需提供，空闲连接不占用接收缓冲区，新连接由 multishot accept 请求接受；更早的
+*					  内核中每个连接独占一个接收缓冲区，监听 Socket 以 poll 请求模拟 EPOLL 注册。
+*					  TCP Agent 及其它组件仍以 poll 请求模拟 EPOLL 注册、以 read() / writev() 收发
+*					  数据，只是 IO 事件的重新注册批量提交，不再产生 epoll_ctl() 系统调用；内核不支持
+*					  io_uring 时自动回退到分片模式
+************************************************************************/
+typedef enum EnDispatchMode
+{
+	DM_SHARED			= 0,	// 共享模式（默认）
+	DM_SHARDED			= 1,	// 分片模式
+	DM_IO_URING			= 2,	// io_uring 模式
+} En_HP_DispatchMode;
+
+/************************************************************************
+名称：监听模式
+描述：Server 组件监听 Socket 的创建方式
+
+* 单一监听（默认）	：只创建一个监听 Socket，所有连接请求（UDP 数据报）由同一个内核队列接收
+* 端口复用			：为每个工作线程创建一个绑定到相同地址的 SO_REUSEPORT 监听 Socket，由内核按
+*					  四元组哈希分配连接请求（UDP 数据报）；分片和 io_uring 分派模式下每个工作线程
+*					  只处理自己的监听 Socket，新连接固定绑定到该工作线程（UDP Server 在该模式下
+*					  总是使用分片分派）
+* 端口复用 + CPU 亲和	：在端口复用的基础上加载 BPF 程序，按处理网卡中断的 CPU 选择监听 Socket，并把
+*					  工作线程绑定到对应的 CPU（工作线程数量等于 CPU 数量时效果最佳）；内核不支持
+*					  时退化为端口复用模式
+************************************************************************/
+typedef enum EnListenMode
+{
+	LM_SINGLE			= 0,	// 单一监听（默认）
+	LM_REUSE_PORT		= 1,	// 端口复用
+	LM_REUSE_PORT_CPU	= 2,	// 端口复用 + CPU 亲和
+} En_HP_ListenMode;
+
 /************************************************************************
 名称：操作结果代码
 描述：组件 Start() / Stop() 方法执行失败时，可通过 GetLastError() 获取错误代码
@@ -280,6 +326,28 @@ typedef struct TSocketTask
 	LPARAM				lparam;		// 自定义参数
 } *LPTSocketTask, HP_TSocketTask, *HP_LPTSocketTask;
 
+/************************************************************************
+名称：发送缓冲区释放函数
+描述：SendReference() 以引用方式发送的缓冲区不再被通信组件引用时调用，此后应用程序可以释放或重用该缓冲区
+参数：pBuffer	-- 缓冲区地址（SendReference() 传入的缓冲区地址）
+		iLength	-- 缓冲区长度
+		pvParam	-- 自定义参数
+		bSent	-- TRUE：缓冲区数据已全部提交给系统；FALSE：发送失败或连接已关闭，缓冲区数据未全部发送
+返回值：（无）
+************************************************************************/
+typedef VOID (CALLBACK *Fn_SendRelease)(LPCBYTE pBuffer, int iLength, PVOID pvParam, BOOL bSent);
+typedef Fn_SendRelease	HP_Fn_SendRelease;
+
+/************************************************************************
+名称：连接定时器回调函数
+描述：SetConnectionTimer() 设置的连接定时器到期时在通信组件的工作线程中调用（定时器为一次性定时器，到期后自动失效）
+参数：dwConnID	-- 连接 ID
+		pvParam	-- 自定义参数
+返回值：（无）
+************************************************************************/
+typedef VOID (CALLBACK *Fn_ConnectionTimer)(CONNID dwConnID, PVOID pvParam);
+typedef Fn_ConnectionTimer	HP_Fn_ConnectionTimer;
+
 /************************************************************************
 名称：获取 HPSocket 版本号
 描述：版本号（4 个字节分别为：主版本号，子版本号，修正版本号，构建编号）
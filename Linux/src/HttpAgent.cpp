@@ -27,7 +27,7 @@
 
 template<class T, USHORT default_port> BOOL CHttpAgentT<T, default_port>::CheckParams()
 {
-	if(m_enLocalVersion != HV_1_1 && m_enLocalVersion != HV_1_0)
+	if((m_enLocalVersion != HV_1_1 && m_enLocalVersion != HV_1_0) || !m_wsDeflateMgr.IsValidWindowBits())
 	{
 		SetLastError(SE_INVALID_PARAM, __FUNCTION__, ERROR_INVALID_PARAMETER);
 		return FALSE;
@@ -77,6 +77,7 @@ template<class T, USHORT default_port> BOOL CHttpAgentT<T, default_port>::SendRe
 	pHttpObj->ReloadCookies();
 
 	::MakeRequestLine(lpszMethod, strPath, m_enLocalVersion, strHeader);
+	pHttpObj->MakeWSDeflateOffer(lpHeaders, iHeaderCount, strHeader);
 	::MakeHeaderLines(lpHeaders, iHeaderCount, &pHttpObj->GetCookieMap(), iLength, TRUE, -1, lpszHost, usPort, strHeader);
 	::MakeHttpPacket(strHeader, pBody, iLength, szBuffer);
 
@@ -104,8 +105,28 @@ template<class T, USHORT default_port> BOOL CHttpAgentT<T, default_port>::SendWS
 	WSABUF szBuffer[2];
 	BYTE szHeader[HTTP_MAX_WS_HEADER_LEN];
 
-	if(!::MakeWSPacket(bFinal, iReserved, iOperationCode, lpszMask, pData, iLength, ullBodyLen, szHeader, szBuffer))
-		return FALSE;
+	THttpObj* pHttpObj			= FindHttpObj(dwConnID);
+	CWSDeflateContext* pDeflate	= pHttpObj != nullptr ? pHttpObj->GetWSDeflateContext() : nullptr;
+
+	if(pDeflate == nullptr)
+	{
+		if(!::MakeWSPacket(bFinal, iReserved, iOperationCode, lpszMask, pData, iLength, ullBodyLen, szHeader, szBuffer))
+			return FALSE;
+
+		return SendPackets(dwConnID, szBuffer, 2);
+	}
+
+	CBufferPtr buffer;
+
+	{
+		CCriSecLock locallock(pDeflate->GetLock());
+
+		if(!pDeflate->DeflateFrame(bFinal, iReserved, iOperationCode, pData, iLength, ullBodyLen, buffer))
+			return FALSE;
+
+		if(!::MakeWSPacket(bFinal, iReserved, iOperationCode, lpszMask, pData, iLength, ullBodyLen, szHeader, szBuffer))
+			return FALSE;
+	}
 
 	return SendPackets(dwConnID, szBuffer, 2);
 }
@@ -167,6 +188,7 @@ template<class T, USHORT default_port> EnHandleResult CHttpAgentT<T, default_por
 	EnHandleResult result = __super::DoFireShutdown();
 
 	m_objPool.Clear();
+	m_wsDeflateMgr.Clear();
 
 	return result;
 }
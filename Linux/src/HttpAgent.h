@@ -82,6 +82,13 @@ public:
 	virtual void SetLocalVersion(EnHttpVersion enLocalVersion)	{m_enLocalVersion = enLocalVersion;}
 	virtual EnHttpVersion GetLocalVersion()						{return m_enLocalVersion;}
 
+	virtual void SetWSDeflate(BOOL bDeflate)					{m_wsDeflateMgr.SetEnabled(bDeflate);}
+	virtual BOOL IsWSDeflate()									{return m_wsDeflateMgr.IsEnabled();}
+	virtual void SetWSDeflateWindowBits(int iWindowBits)		{m_wsDeflateMgr.SetWindowBits(iWindowBits);}
+	virtual int GetWSDeflateWindowBits()						{return m_wsDeflateMgr.GetWindowBits();}
+	virtual void SetWSDeflateContextTakeover(BOOL bContextTakeover)	{m_wsDeflateMgr.SetContextTakeover(bContextTakeover);}
+	virtual BOOL IsWSDeflateContextTakeover()					{return m_wsDeflateMgr.IsContextTakeover();}
+
 	virtual BOOL IsUpgrade(CONNID dwConnID);
 	virtual BOOL IsKeepAlive(CONNID dwConnID);
 	virtual USHORT GetVersion(CONNID dwConnID);
@@ -150,6 +157,7 @@ private:
 	inline THttpObj* FindHttpObj(TAgentSocketObj* pSocketObj);
 
 	CCookieMgr* GetCookieMgr()						{return m_pCookieMgr;}
+	CWSDeflateMgr* GetWSDeflateMgr()				{return &m_wsDeflateMgr;}
 	LPCSTR GetRemoteDomain(TAgentSocketObj* pSocketObj)	{LPCSTR lpszDomain; pSocketObj->GetRemoteHost(&lpszDomain); return lpszDomain;}
 
 public:
@@ -172,6 +180,7 @@ private:
 	CCookieMgr*			m_pCookieMgr;
 	EnHttpVersion		m_enLocalVersion;
 
+	CWSDeflateMgr		m_wsDeflateMgr;
 	CHttpObjPool		m_objPool;
 };
 
@@ -27,7 +27,7 @@
 
 template<class R, class T, USHORT default_port> BOOL CHttpClientT<R, T, default_port>::CheckParams()
 {
-	if(m_enLocalVersion != HV_1_1 && m_enLocalVersion != HV_1_0)
+	if((m_enLocalVersion != HV_1_1 && m_enLocalVersion != HV_1_0) || !m_wsDeflateMgr.IsValidWindowBits())
 	{
 		SetLastError(SE_INVALID_PARAM, __FUNCTION__, ERROR_INVALID_PARAMETER);
 		return FALSE;
@@ -60,6 +60,7 @@ template<class R, class T, USHORT default_port> BOOL CHttpClientT<R, T, default_
 	m_objHttp.ReloadCookies();
 
 	::MakeRequestLine(lpszMethod, strPath, m_enLocalVersion, strHeader);
+	m_objHttp.MakeWSDeflateOffer(lpHeaders, iHeaderCount, strHeader);
 	::MakeHeaderLines(lpHeaders, iHeaderCount, &m_objHttp.GetCookieMap(), iLength, TRUE, -1, lpszHost, usPort, strHeader);
 	::MakeHttpPacket(strHeader, pBody, iLength, szBuffer);
 
@@ -87,8 +88,27 @@ template<class R, class T, USHORT default_port> BOOL CHttpClientT<R, T, default_
 	WSABUF szBuffer[2];
 	BYTE szHeader[HTTP_MAX_WS_HEADER_LEN];
 
-	if(!::MakeWSPacket(bFinal, iReserved, iOperationCode, lpszMask, pData, iLength, ullBodyLen, szHeader, szBuffer))
-		return FALSE;
+	CWSDeflateContext* pDeflate = m_objHttp.GetWSDeflateContext();
+
+	if(pDeflate == nullptr)
+	{
+		if(!::MakeWSPacket(bFinal, iReserved, iOperationCode, lpszMask, pData, iLength, ullBodyLen, szHeader, szBuffer))
+			return FALSE;
+
+		return SendPackets(szBuffer, 2);
+	}
+
+	CBufferPtr buffer;
+
+	{
+		CCriSecLock locallock(pDeflate->GetLock());
+
+		if(!pDeflate->DeflateFrame(bFinal, iReserved, iOperationCode, pData, iLength, ullBodyLen, buffer))
+			return FALSE;
+
+		if(!::MakeWSPacket(bFinal, iReserved, iOperationCode, lpszMask, pData, iLength, ullBodyLen, szHeader, szBuffer))
+			return FALSE;
+	}
 
 	return SendPackets(szBuffer, 2);
 }
@@ -431,6 +451,16 @@ template<class T, USHORT default_port> EnHandleResult CHttpSyncClientT<T, defaul
 	return rs;
 }
 
+template<class T, USHORT default_port> EnHandleResult CHttpSyncClientT<T, default_port>::OnWritable(ITcpClient* pSender, CONNID dwConnID, BOOL bWritable)
+{
+	EnHandleResult rs = HR_OK;
+
+	if(m_pListener2 != nullptr)
+		return m_pListener2->OnWritable(pSender, dwConnID, bWritable);
+
+	return rs;
+}
+
 template<class T, USHORT default_port> EnHttpParseResult CHttpSyncClientT<T, default_port>::OnMessageBegin(IHttpClient* pSender, CONNID dwConnID)
 {
 	EnHttpParseResult rs = HPR_OK;
@@ -76,6 +76,13 @@ public:
 	virtual void SetLocalVersion(EnHttpVersion enLocalVersion)	{m_enLocalVersion = enLocalVersion;}
 	virtual EnHttpVersion GetLocalVersion()						{return m_enLocalVersion;}
 
+	virtual void SetWSDeflate(BOOL bDeflate)					{m_wsDeflateMgr.SetEnabled(bDeflate);}
+	virtual BOOL IsWSDeflate()									{return m_wsDeflateMgr.IsEnabled();}
+	virtual void SetWSDeflateWindowBits(int iWindowBits)		{m_wsDeflateMgr.SetWindowBits(iWindowBits);}
+	virtual int GetWSDeflateWindowBits()						{return m_wsDeflateMgr.GetWindowBits();}
+	virtual void SetWSDeflateContextTakeover(BOOL bContextTakeover)	{m_wsDeflateMgr.SetContextTakeover(bContextTakeover);}
+	virtual BOOL IsWSDeflateContextTakeover()					{return m_wsDeflateMgr.IsContextTakeover();}
+
 	virtual BOOL IsUpgrade()
 		{return m_objHttp.IsUpgrade();}
 	virtual BOOL IsKeepAlive()
@@ -171,6 +178,7 @@ private:
 		{return m_pListener->OnWSMessageComplete(pSender, pSender->GetConnectionID());}
 
 	CCookieMgr* GetCookieMgr()						{return m_pCookieMgr;}
+	CWSDeflateMgr* GetWSDeflateMgr()				{return &m_wsDeflateMgr;}
 	LPCSTR GetRemoteDomain(IHttpClient* pSender)	{LPCSTR lpszDomain; GetRemoteHost(&lpszDomain); return lpszDomain;}
 
 public:
@@ -187,9 +195,11 @@ public:
 	virtual ~CHttpClientT()
 	{
 		Stop();
+		__super::WaitForStop();
 	}
 
 protected:
+	CWSDeflateMgr			m_wsDeflateMgr;
 	THttpObj				m_objHttp;
 
 private:
@@ -290,6 +300,7 @@ private:
 	virtual EnHandleResult OnPrepareConnect(ITcpClient* pSender, CONNID dwConnID, SOCKET socket);
 	virtual EnHandleResult OnConnect(ITcpClient* pSender, CONNID dwConnID);
 	virtual EnHandleResult OnSend(ITcpClient* pSender, CONNID dwConnID, const BYTE* pData, int iLength);
+	virtual EnHandleResult OnWritable(ITcpClient* pSender, CONNID dwConnID, BOOL bWritable);
 
 	virtual EnHttpParseResult OnMessageBegin(IHttpClient* pSender, CONNID dwConnID);
 	virtual EnHttpParseResult OnStatusLine(IHttpClient* pSender, CONNID dwConnID, USHORT usStatusCode, LPCSTR lpszDesc);
@@ -321,6 +332,7 @@ public:
 	virtual ~CHttpSyncClientT()
 	{
 		Stop();
+		__super::WaitForStop();
 	}
 
 private:
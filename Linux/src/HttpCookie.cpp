@@ -344,6 +344,22 @@ CStringA CCookie::MakeExpiresStr(__time64_t tmExpires)
 	return str;
 }
 
+CStringA CCookie::MakeHttpDateStr(__time64_t tmTime)
+{
+	ASSERT(tmTime >= 0);
+
+	if(tmTime < 0) tmTime = 0;
+
+	tm t;
+	VERIFY(_gmtime64(&t, &tmTime) != nullptr);
+
+	CStringA str;
+	str.Format("%s, %02d %s %04d %02d:%02d:%02d GMT", 
+				s_short_week[t.tm_wday], t.tm_mday, s_short_month[t.tm_mon], t.tm_year + 1900, t.tm_hour, t.tm_min, t.tm_sec);
+
+	return str;
+}
+
 BOOL CCookie::MakeExpiresStr(char lpszBuff[], int& iBuffLen, __time64_t tmExpires)
 {
 	BOOL isOK	 = FALSE;
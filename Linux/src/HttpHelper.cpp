@@ -148,7 +148,7 @@ void MakeStatusLine(EnHttpVersion enVersion, USHORT usStatusCode, LPCSTR lpszDes
 	strValue.Format("HTTP/%d.%d %d %s%s", LOBYTE(enVersion), HIBYTE(enVersion), usStatusCode, lpszDesc, HTTP_CRLF);
 }
 
-void MakeHeaderLines(const THeader lpHeaders[], int iHeaderCount, const TCookieMap* pCookies, int iBodyLength, BOOL bRequest, int iConnFlag, LPCSTR lpszDefaultHost, USHORT usPort, CStringA& strValue)
+void MakeHeaderLines(const THeader lpHeaders[], int iHeaderCount, const TCookieMap* pCookies, LONGLONG llBodyLength, BOOL bRequest, int iConnFlag, LPCSTR lpszDefaultHost, USHORT usPort, CStringA& strValue)
 {
 	unordered_set<LPCSTR, str_hash_func::hash, str_hash_func::equal_to> szHeaderNames;
 
@@ -170,13 +170,13 @@ void MakeHeaderLines(const THeader lpHeaders[], int iHeaderCount, const TCookieM
 		}
 	}
 
-	if(	(!bRequest || iBodyLength > 0)											&&
+	if(	(bRequest ? llBodyLength > 0 : llBodyLength >= 0)						&&
 		(szHeaderNames.empty()													||	
 		(szHeaderNames.find(HTTP_HEADER_CONTENT_LENGTH) == szHeaderNames.end()	&&
 		szHeaderNames.find(HTTP_HEADER_TRANSFER_ENCODING) == szHeaderNames.end())))
 	{
-		char szBodyLength[16];
-		itoa(iBodyLength, szBodyLength, 10);
+		char szBodyLength[24];
+		lltoa(llBodyLength, szBodyLength, 10);
 
 		AppendHeader(HTTP_HEADER_CONTENT_LENGTH, szBodyLength, strValue);
 	}
@@ -239,6 +239,423 @@ void MakeHttpPacket(const CStringA& strHeader, const BYTE* pBody, int iLength, W
 	szBuffer[1].len = iLength;
 }
 
+void MakeResponseTemplate(USHORT usStatusCode, LPCSTR lpszDesc, const THeader lpHeaders[], int iHeaderCount, THttpResponseTemplate& tpl)
+{
+	tpl.statusCode		= usStatusCode;
+	tpl.desc			= lpszDesc ? lpszDesc : ::GetHttpDefaultStatusCodeDesc((EnHttpStatusCode)usStatusCode);
+	tpl.hasLength		= FALSE;
+	tpl.hasConnection	= FALSE;
+	tpl.hasDate			= FALSE;
+
+	tpl.lines.Empty();
+	tpl.header.Empty();
+
+	for(int i = 0; i < iHeaderCount; i++)
+	{
+		const THeader& header = lpHeaders[i];
+
+		ASSERT(!::IsStrEmptyA(header.name));
+
+		if(::IsStrEmptyA(header.name))
+			continue;
+
+		if(stricmp(header.name, HTTP_HEADER_CONTENT_LENGTH) == 0 || stricmp(header.name, HTTP_HEADER_TRANSFER_ENCODING) == 0)
+			tpl.hasLength = TRUE;
+		else if(stricmp(header.name, HTTP_HEADER_CONNECTION) == 0)
+			tpl.hasConnection = TRUE;
+		else if(stricmp(header.name, HTTP_HEADER_DATE) == 0)
+			tpl.hasDate = TRUE;
+
+		AppendHeader(header.name, header.value, tpl.lines);
+	}
+}
+
+void CompileResponseTemplate(EnHttpVersion enVersion, THttpResponseTemplate& tpl)
+{
+	::MakeStatusLine(enVersion, tpl.statusCode, tpl.desc, tpl.header);
+	tpl.header.Append(tpl.lines);
+}
+
+static inline char* AppendTail(char* lpszTail, LPCSTR lpszStr, int iLength)
+{
+	memcpy(lpszTail, lpszStr, iLength);
+	return lpszTail + iLength;
+}
+
+#define _APPEND_TAIL_LITERAL(p, str)	p = AppendTail(p, str, sizeof(str) - 1)
+
+int MakeResponseTemplateTail(const THttpResponseTemplate& tpl, int iBodyLength, int iConnFlag, char szTail[HTTP_MAX_RESPONSE_TAIL_LEN])
+{
+	char* p = szTail;
+
+	if(!tpl.hasLength)
+	{
+		char szLength[16];
+		int iLength = (int)strlen(itoa(iBodyLength, szLength, 10));
+
+		_APPEND_TAIL_LITERAL(p, HTTP_HEADER_CONTENT_LENGTH HTTP_HEADER_SEPARATOR);
+		p = AppendTail(p, szLength, iLength);
+		_APPEND_TAIL_LITERAL(p, HTTP_CRLF);
+	}
+
+	if(!tpl.hasConnection && (iConnFlag == 0 || iConnFlag == 1))
+	{
+		if(iConnFlag == 0)
+			_APPEND_TAIL_LITERAL(p, HTTP_HEADER_CONNECTION HTTP_HEADER_SEPARATOR HTTP_CONNECTION_CLOSE_VALUE HTTP_CRLF);
+		else
+			_APPEND_TAIL_LITERAL(p, HTTP_HEADER_CONNECTION HTTP_HEADER_SEPARATOR HTTP_CONNECTION_KEEPALIVE_VALUE HTTP_CRLF);
+	}
+
+	if(!tpl.hasDate)
+	{
+		LPCSTR lpszDate = ::GetCachedHttpDateStr();
+
+		_APPEND_TAIL_LITERAL(p, HTTP_HEADER_DATE HTTP_HEADER_SEPARATOR);
+		p = AppendTail(p, lpszDate, (int)strlen(lpszDate));
+		_APPEND_TAIL_LITERAL(p, HTTP_CRLF);
+	}
+
+	_APPEND_TAIL_LITERAL(p, HTTP_CRLF);
+
+	ASSERT(p - szTail <= HTTP_MAX_RESPONSE_TAIL_LEN);
+
+	return (int)(p - szTail);
+}
+
+LPCSTR GetCachedHttpDateStr()
+{
+	static thread_local __time64_t	t_tmDate = -1;
+	static thread_local char		t_szDate[32];
+
+	__time64_t tmNow = _time64();
+
+	if(tmNow != t_tmDate)
+	{
+		CStringA strDate = CCookie::MakeHttpDateStr(tmNow);
+
+		ASSERT(strDate.GetLength() < (int)sizeof(t_szDate));
+
+		strncpy(t_szDate, strDate, sizeof(t_szDate) - 1);
+		t_tmDate = tmNow;
+	}
+
+	return t_szDate;
+}
+
+#define _HTTP_HEADER_INDEX(name, index)								\
+	if(strnicmp(lpszName, name, iLength) == 0) return index;
+
+EnHttpHeaderIndex GetHttpHeaderIndex(LPCSTR lpszName, int iLength)
+{
+	switch(iLength)
+	{
+	case 4:
+		_HTTP_HEADER_INDEX(HTTP_HEADER_HOST, HHI_HOST)
+		break;
+	case 5:
+		_HTTP_HEADER_INDEX(HTTP_HEADER_RANGE, HHI_RANGE)
+		break;
+	case 6:
+		_HTTP_HEADER_INDEX(HTTP_HEADER_COOKIE, HHI_COOKIE)
+		break;
+	case 7:
+		_HTTP_HEADER_INDEX(HTTP_HEADER_UPGRADE, HHI_UPGRADE)
+		break;
+	case 10:
+		_HTTP_HEADER_INDEX(HTTP_HEADER_CONNECTION, HHI_CONNECTION)
+		_HTTP_HEADER_INDEX(HTTP_HEADER_SET_COOKIE, HHI_SET_COOKIE)
+		break;
+	case 12:
+		_HTTP_HEADER_INDEX(HTTP_HEADER_CONTENT_TYPE, HHI_CONTENT_TYPE)
+		break;
+	case 14:
+		_HTTP_HEADER_INDEX(HTTP_HEADER_CONTENT_LENGTH, HHI_CONTENT_LENGTH)
+		break;
+	case 16:
+		_HTTP_HEADER_INDEX(HTTP_HEADER_CONTENT_ENCODING, HHI_CONTENT_ENCODING)
+		break;
+	case 17:
+		_HTTP_HEADER_INDEX(HTTP_HEADER_TRANSFER_ENCODING, HHI_TRANSFER_ENCODING)
+		_HTTP_HEADER_INDEX(HTTP_HEADER_IF_MODIFIED_SINCE, HHI_IF_MODIFIED_SINCE)
+		break;
+	case 24:
+		_HTTP_HEADER_INDEX(HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS, HHI_SEC_WEBSOCKET_EXTENSIONS)
+		break;
+	}
+
+	return HHI_UNKNOWN;
+}
+
+CHttpHeaderTable::CHttpHeaderTable()
+: m_iBlock	(0)
+, m_iUsed	(0)
+, m_iPending(0)
+{
+	m_entries.reserve(DEF_ENTRY_RESERVE);
+
+	Clear();
+}
+
+CHttpHeaderTable::~CHttpHeaderTable()
+{
+	for(size_t i = 0; i < m_blocks.size(); i++)
+		free(m_blocks[i].data);
+}
+
+void CHttpHeaderTable::Clear()
+{
+	m_iBlock	= 0;
+	m_iUsed		= 0;
+	m_iPending	= 0;
+
+	m_entries.clear();
+
+	for(int i = 0; i < HHI_MAX; i++)
+		m_iIndex[i] = -1;
+}
+
+void CHttpHeaderTable::NextBlock(int iRequired)
+{
+	int iPending = m_iUsed - m_iPending;
+	int iBlock	 = m_blocks.empty() ? 0 : m_iBlock + 1;
+
+	if(iBlock == (int)m_blocks.size())
+	{
+		TBlock block = {nullptr, 0};
+		m_blocks.push_back(block);
+	}
+
+	TBlock& block = m_blocks[iBlock];
+
+	if(block.capacity < iRequired)
+	{
+		free(block.data);
+
+		block.capacity	= max(iRequired, (int)DEF_BLOCK_SIZE);
+		block.data		= (char*)malloc(block.capacity);
+	}
+
+	if(iPending > 0)
+		memcpy(m_blocks[iBlock].data, m_blocks[m_iBlock].data + m_iPending, iPending);
+
+	m_iBlock	= iBlock;
+	m_iPending	= 0;
+	m_iUsed		= iPending;
+}
+
+void CHttpHeaderTable::Append(const char* at, size_t length)
+{
+	int iRequired = m_iUsed + (int)length + 1;
+
+	if(m_blocks.empty() || iRequired > m_blocks[m_iBlock].capacity)
+		NextBlock(m_iUsed - m_iPending + (int)length + 1);
+
+	memcpy(m_blocks[m_iBlock].data + m_iUsed, at, length);
+	m_iUsed += (int)length;
+}
+
+LPCSTR CHttpHeaderTable::Commit(int& iLength)
+{
+	if(m_blocks.empty() || m_iUsed == m_blocks[m_iBlock].capacity)
+		NextBlock(m_iUsed - m_iPending + 1);
+
+	char* lpszStr = m_blocks[m_iBlock].data + m_iPending;
+	iLength		  = m_iUsed - m_iPending;
+
+	lpszStr[iLength] = 0;
+	m_iPending = ++m_iUsed;
+
+	return lpszStr;
+}
+
+EnHttpHeaderIndex CHttpHeaderTable::Add(LPCSTR lpszName, int iNameLength, LPCSTR lpszValue)
+{
+	ASSERT(lpszName && lpszValue);
+
+	EnHttpHeaderIndex enIndex = ::GetHttpHeaderIndex(lpszName, iNameLength);
+
+	if(enIndex != HHI_UNKNOWN && m_iIndex[enIndex] < 0)
+		m_iIndex[enIndex] = (int)m_entries.size();
+
+	TEntry entry = {lpszName, lpszValue, enIndex};
+	m_entries.push_back(entry);
+
+	return enIndex;
+}
+
+LPCSTR CHttpHeaderTable::Get(EnHttpHeaderIndex enIndex) const
+{
+	ASSERT(enIndex > HHI_UNKNOWN && enIndex < HHI_MAX);
+
+	int iIndex = m_iIndex[enIndex];
+
+	return iIndex >= 0 ? m_entries[iIndex].value : nullptr;
+}
+
+LPCSTR CHttpHeaderTable::Get(LPCSTR lpszName) const
+{
+	EnHttpHeaderIndex enIndex = ::GetHttpHeaderIndex(lpszName, (int)strlen(lpszName));
+
+	if(enIndex != HHI_UNKNOWN)
+		return Get(enIndex);
+
+	for(size_t i = 0; i < m_entries.size(); i++)
+	{
+		const TEntry& entry = m_entries[i];
+
+		if(entry.index == HHI_UNKNOWN && stricmp(entry.name, lpszName) == 0)
+			return entry.value;
+	}
+
+	return nullptr;
+}
+
+DWORD CHttpHeaderTable::GetValues(LPCSTR lpszName, LPCSTR lpszValue[], DWORD dwCount) const
+{
+	EnHttpHeaderIndex enIndex = ::GetHttpHeaderIndex(lpszName, (int)strlen(lpszName));
+
+	size_t i	  = (enIndex != HHI_UNKNOWN) ? (m_iIndex[enIndex] >= 0 ? m_iIndex[enIndex] : m_entries.size()) : 0;
+	DWORD dwFound = 0;
+
+	for(; i < m_entries.size(); i++)
+	{
+		const TEntry& entry = m_entries[i];
+
+		if(entry.index != enIndex || (enIndex == HHI_UNKNOWN && stricmp(entry.name, lpszName) != 0))
+			continue;
+
+		if(dwFound < dwCount)
+			lpszValue[dwFound] = entry.value;
+
+		++dwFound;
+	}
+
+	return dwFound;
+}
+
+void CHttpHeaderTable::Copy(const CHttpHeaderTable& other)
+{
+	if(&other == this)
+		return;
+
+	Clear();
+
+	int iNameLength;
+	int iValueLength;
+
+	for(size_t i = 0; i < other.m_entries.size(); i++)
+	{
+		const TEntry& entry = other.m_entries[i];
+
+		Append(entry.name, strlen(entry.name));
+		LPCSTR lpszName = Commit(iNameLength);
+
+		Append(entry.value, strlen(entry.value));
+		LPCSTR lpszValue = Commit(iValueLength);
+
+		Add(lpszName, iNameLength, lpszValue);
+	}
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define _WS_MASK_SIMD_SUPPORT
+#endif
+
+using Fn_WSMask = void (*)(BYTE* pData, int iLength, UINT uiMask);
+
+static void WSMaskWord(BYTE* pData, int iLength, UINT uiMask)
+{
+	ULONGLONG ullMask	= ((ULONGLONG)uiMask << 32) | uiMask;
+	const BYTE* pMask	= (const BYTE*)&uiMask;
+
+	int i = 0;
+
+	for(; i + 8 <= iLength; i += 8)
+	{
+		ULONGLONG ullData;
+
+		memcpy(&ullData, pData + i, 8);
+		ullData ^= ullMask;
+		memcpy(pData + i, &ullData, 8);
+	}
+
+	for(; i < iLength; i++)
+		pData[i] ^= pMask[i & 0x03];
+}
+
+#ifdef _WS_MASK_SIMD_SUPPORT
+
+__attribute__ ((__target__("sse2"))) static void WSMaskSSE2(BYTE* pData, int iLength, UINT uiMask)
+{
+	__m128i xmmMask = _mm_set1_epi32((int)uiMask);
+
+	int i = 0;
+
+	for(; i + 16 <= iLength; i += 16)
+	{
+		__m128i xmmData = _mm_loadu_si128((const __m128i*)(pData + i));
+		_mm_storeu_si128((__m128i*)(pData + i), _mm_xor_si128(xmmData, xmmMask));
+	}
+
+	WSMaskWord(pData + i, iLength - i, uiMask);
+}
+
+__attribute__ ((__target__("avx2"))) static void WSMaskAVX2(BYTE* pData, int iLength, UINT uiMask)
+{
+	__m256i ymmMask = _mm256_set1_epi32((int)uiMask);
+
+	int i = 0;
+
+	for(; i + 32 <= iLength; i += 32)
+	{
+		__m256i ymmData = _mm256_loadu_si256((const __m256i*)(pData + i));
+		_mm256_storeu_si256((__m256i*)(pData + i), _mm256_xor_si256(ymmData, ymmMask));
+	}
+
+	WSMaskWord(pData + i, iLength - i, uiMask);
+}
+
+#endif
+
+static Fn_WSMask GetWSMaskFunc()
+{
+#ifdef _WS_MASK_SIMD_SUPPORT
+	__builtin_cpu_init();
+
+	if(__builtin_cpu_supports("avx2"))
+		return WSMaskAVX2;
+	if(__builtin_cpu_supports("sse2"))
+		return WSMaskSSE2;
+#endif
+
+	return WSMaskWord;
+}
+
+void MaskWSData(BYTE* pData, int iLength, const BYTE lpszMask[4], int iFactor)
+{
+	ASSERT(lpszMask != nullptr && (pData != nullptr || iLength == 0));
+
+	static const Fn_WSMask s_fnWSMask = GetWSMaskFunc();
+
+	if(iLength <= 0)
+		return;
+
+	UINT uiMask;
+	memcpy(&uiMask, lpszMask, 4);
+
+	if(iFactor &= 0x03)
+	{
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		uiMask = (uiMask << (iFactor * 8)) | (uiMask >> (32 - iFactor * 8));
+#else
+		uiMask = (uiMask >> (iFactor * 8)) | (uiMask << (32 - iFactor * 8));
+#endif
+	}
+
+	s_fnWSMask(pData, iLength, uiMask);
+}
+
 BOOL MakeWSPacket(BOOL bFinal, BYTE iReserved, BYTE iOperationCode, const BYTE lpszMask[4], BYTE* pData, int iLength, ULONGLONG ullBodyLen, BYTE szHeader[HTTP_MAX_WS_HEADER_LEN], WSABUF szBuffer[2])
 {
 	ULONGLONG ullLength = (ULONGLONG)iLength;
@@ -283,9 +700,7 @@ BOOL MakeWSPacket(BOOL bFinal, BYTE iReserved, BYTE iOperationCode, const BYTE l
 	if(lpszMask)
 	{
 		memcpy(szHeader + iHeaderLen, lpszMask, 4);
-
-		for(int i = 0; i < iLength; i++)
-			pData[i] = pData[i] ^ lpszMask[i & 0x03];
+		MaskWSData(pData, iLength, lpszMask);
 
 		iHeaderLen += 4;
 	}
@@ -298,6 +713,499 @@ BOOL MakeWSPacket(BOOL bFinal, BYTE iReserved, BYTE iOperationCode, const BYTE l
 	return TRUE;
 }
 
+struct TWSDeflateOffer
+{
+	BOOL	serverNoContextTakeover;
+	BOOL	clientNoContextTakeover;
+	int		serverMaxWindowBits;	/* 0：未指定 */
+	int		clientMaxWindowBits;	/* 0：未指定，-1：指定但不带参数值 */
+};
+
+static const BYTE s_szWSDeflateTail[] = {0x00, 0x00, 0xFF, 0xFF};
+static thread_local BYTE t_szWSInflateBuffer[HTTP_WS_INFLATE_BUFFER_SIZE];
+
+static void TrimWSExtensionItem(LPCSTR& lpszBegin, LPCSTR& lpszEnd)
+{
+	while(lpszBegin < lpszEnd && (*lpszBegin == ' ' || *lpszBegin == '\t'))
+		++lpszBegin;
+	while(lpszEnd > lpszBegin && (lpszEnd[-1] == ' ' || lpszEnd[-1] == '\t'))
+		--lpszEnd;
+}
+
+static BOOL IsWSExtensionItem(LPCSTR lpszBegin, LPCSTR lpszEnd, LPCSTR lpszName)
+{
+	int iLength = (int)strlen(lpszName);
+
+	return (lpszEnd - lpszBegin == iLength) && strnicmp(lpszBegin, lpszName, iLength) == 0;
+}
+
+static int ParseWSWindowBits(LPCSTR lpszBegin, LPCSTR lpszEnd)
+{
+	if(lpszEnd - lpszBegin >= 2 && *lpszBegin == '"' && lpszEnd[-1] == '"')
+	{
+		++lpszBegin;
+		--lpszEnd;
+	}
+
+	if(lpszBegin == lpszEnd || lpszEnd - lpszBegin > 2)
+		return 0;
+
+	int iBits = 0;
+
+	for(; lpszBegin < lpszEnd; ++lpszBegin)
+	{
+		if(*lpszBegin < '0' || *lpszBegin > '9')
+			return 0;
+
+		iBits = iBits * 10 + (*lpszBegin - '0');
+	}
+
+	return (iBits >= MIN_WS_DEFLATE_WINDOW_BITS && iBits <= MAX_WS_DEFLATE_WINDOW_BITS) ? iBits : 0;
+}
+
+/* 解析 "permessage-deflate; param[=value]; ..." 格式的扩展提议，包含未知或重复的参数时提议无效（RFC 7692 7.1） */
+static BOOL ParseWSDeflateOffer(LPCSTR lpszBegin, LPCSTR lpszEnd, TWSDeflateOffer& offer)
+{
+	memset(&offer, 0, sizeof(offer));
+
+	for(BOOL bFirst = TRUE; ; bFirst = FALSE)
+	{
+		LPCSTR lpszSep = (LPCSTR)memchr(lpszBegin, ';', lpszEnd - lpszBegin);
+		if(lpszSep == nullptr) lpszSep = lpszEnd;
+
+		LPCSTR lpszName		= lpszBegin;
+		LPCSTR lpszNameEnd	= lpszSep;
+
+		TrimWSExtensionItem(lpszName, lpszNameEnd);
+
+		if(bFirst)
+		{
+			if(!IsWSExtensionItem(lpszName, lpszNameEnd, HTTP_WS_DEFLATE_EXTENSION))
+				return FALSE;
+		}
+		else
+		{
+			LPCSTR lpszValue	= (LPCSTR)memchr(lpszName, '=', lpszNameEnd - lpszName);
+			LPCSTR lpszValueEnd	= lpszNameEnd;
+
+			if(lpszValue != nullptr)
+			{
+				lpszNameEnd = lpszValue++;
+
+				TrimWSExtensionItem(lpszName, lpszNameEnd);
+				TrimWSExtensionItem(lpszValue, lpszValueEnd);
+			}
+
+			if(IsWSExtensionItem(lpszName, lpszNameEnd, "server_no_context_takeover") && !lpszValue && !offer.serverNoContextTakeover)
+				offer.serverNoContextTakeover = TRUE;
+			else if(IsWSExtensionItem(lpszName, lpszNameEnd, "client_no_context_takeover") && !lpszValue && !offer.clientNoContextTakeover)
+				offer.clientNoContextTakeover = TRUE;
+			else if(IsWSExtensionItem(lpszName, lpszNameEnd, "server_max_window_bits") && lpszValue && offer.serverMaxWindowBits == 0)
+			{
+				if((offer.serverMaxWindowBits = ParseWSWindowBits(lpszValue, lpszValueEnd)) == 0)
+					return FALSE;
+			}
+			else if(IsWSExtensionItem(lpszName, lpszNameEnd, "client_max_window_bits") && offer.clientMaxWindowBits == 0)
+			{
+				if(!lpszValue)
+					offer.clientMaxWindowBits = -1;
+				else if((offer.clientMaxWindowBits = ParseWSWindowBits(lpszValue, lpszValueEnd)) == 0)
+					return FALSE;
+			}
+			else
+				return FALSE;
+		}
+
+		if(lpszSep == lpszEnd)
+			break;
+
+		lpszBegin = lpszSep + 1;
+	}
+
+	return TRUE;
+}
+
+static BOOL FindWSDeflateOffer(LPCSTR lpszValues[], int iCount, TWSDeflateOffer& offer)
+{
+	for(int i = 0; i < iCount; i++)
+	{
+		LPCSTR lpszBegin = lpszValues[i];
+		LPCSTR lpszEnd	 = lpszBegin + strlen(lpszBegin);
+
+		while(lpszBegin < lpszEnd)
+		{
+			LPCSTR lpszSep = (LPCSTR)memchr(lpszBegin, ',', lpszEnd - lpszBegin);
+			if(lpszSep == nullptr) lpszSep = lpszEnd;
+
+			if(ParseWSDeflateOffer(lpszBegin, lpszSep, offer))
+				return TRUE;
+
+			lpszBegin = lpszSep + 1;
+		}
+	}
+
+	return FALSE;
+}
+
+static BOOL HasWSHeader(const THeader lpHeaders[], int iHeaderCount, LPCSTR lpszName, LPCSTR lpszValue = nullptr)
+{
+	for(int i = 0; i < iHeaderCount; i++)
+	{
+		const THeader& header = lpHeaders[i];
+
+		if(::IsStrEmptyA(header.name) || stricmp(header.name, lpszName) != 0)
+			continue;
+		if(lpszValue == nullptr || (header.value != nullptr && stricmp(header.value, lpszValue) == 0))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static void AppendWSWindowBits(LPCSTR lpszName, int iBits, CStringA& strValue)
+{
+	char szBits[16];
+	itoa(iBits, szBits, 10);
+
+	strValue.Append("; ");
+	strValue.Append(lpszName);
+	strValue.AppendChar('=');
+	strValue.Append(szBits);
+}
+
+BOOL CWSDeflateMgr::MakeOffer(const THeader lpHeaders[], int iHeaderCount, CStringA& strHeader)
+{
+	if(!m_bEnabled																		||
+		!::HasWSHeader(lpHeaders, iHeaderCount, HTTP_HEADER_UPGRADE, HTTP_HEADER_VALUE_WEB_SOCKET)	||
+		::HasWSHeader(lpHeaders, iHeaderCount, HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS))
+		return FALSE;
+
+	CStringA strValue(HTTP_WS_DEFLATE_EXTENSION);
+
+	if(m_iWindowBits < MAX_WS_DEFLATE_WINDOW_BITS)
+	{
+		::AppendWSWindowBits("client_max_window_bits", m_iWindowBits, strValue);
+		::AppendWSWindowBits("server_max_window_bits", m_iWindowBits, strValue);
+	}
+	else
+		strValue.Append("; client_max_window_bits");
+
+	if(!m_bContextTakeover)
+		strValue.Append("; server_no_context_takeover; client_no_context_takeover");
+
+	::AppendHeader(HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS, strValue, strHeader);
+
+	return TRUE;
+}
+
+BOOL CWSDeflateMgr::AcceptOffer(LPCSTR lpszValues[], int iCount, TWSDeflateParam& param)
+{
+	TWSDeflateOffer offer;
+
+	if(!::FindWSDeflateOffer(lpszValues, iCount, offer))
+		return FALSE;
+
+	param.deflateNoContextTakeover	= offer.serverNoContextTakeover || !m_bContextTakeover;
+	param.inflateNoContextTakeover	= offer.clientNoContextTakeover || !m_bContextTakeover;
+	param.deflateWindowBits			= offer.serverMaxWindowBits > 0 ? min(offer.serverMaxWindowBits, m_iWindowBits) : m_iWindowBits;
+
+	/* 只有提议带有 client_max_window_bits 参数时才能限制客户端的窗口大小 */
+	if(offer.clientMaxWindowBits > 0)
+		param.inflateWindowBits = min(offer.clientMaxWindowBits, m_iWindowBits);
+	else if(offer.clientMaxWindowBits < 0)
+		param.inflateWindowBits = m_iWindowBits;
+	else
+		param.inflateWindowBits = MAX_WS_DEFLATE_WINDOW_BITS;
+
+	return TRUE;
+}
+
+BOOL CWSDeflateMgr::MakeResponse(const TWSDeflateParam& param, const THeader lpHeaders[], int iHeaderCount, CStringA& strHeader)
+{
+	if(::HasWSHeader(lpHeaders, iHeaderCount, HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS))
+		return FALSE;
+
+	CStringA strValue(HTTP_WS_DEFLATE_EXTENSION);
+
+	if(param.deflateNoContextTakeover)
+		strValue.Append("; server_no_context_takeover");
+	if(param.inflateNoContextTakeover)
+		strValue.Append("; client_no_context_takeover");
+	if(param.deflateWindowBits < MAX_WS_DEFLATE_WINDOW_BITS)
+		::AppendWSWindowBits("server_max_window_bits", param.deflateWindowBits, strValue);
+	if(param.inflateWindowBits < MAX_WS_DEFLATE_WINDOW_BITS)
+		::AppendWSWindowBits("client_max_window_bits", param.inflateWindowBits, strValue);
+
+	::AppendHeader(HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS, strValue, strHeader);
+
+	return TRUE;
+}
+
+BOOL CWSDeflateMgr::ConfirmResponse(LPCSTR lpszValues[], int iCount, TWSDeflateParam& param)
+{
+	TWSDeflateOffer offer;
+
+	if(!::FindWSDeflateOffer(lpszValues, iCount, offer) || offer.clientMaxWindowBits < 0)
+		return FALSE;
+
+	param.deflateNoContextTakeover	= offer.clientNoContextTakeover || !m_bContextTakeover;
+	param.inflateNoContextTakeover	= offer.serverNoContextTakeover;
+	param.deflateWindowBits			= offer.clientMaxWindowBits > 0 ? min(offer.clientMaxWindowBits, m_iWindowBits) : m_iWindowBits;
+	param.inflateWindowBits			= offer.serverMaxWindowBits > 0 ? offer.serverMaxWindowBits : MAX_WS_DEFLATE_WINDOW_BITS;
+
+	return TRUE;
+}
+
+z_stream* CWSDeflateMgr::PickFreeStream(BOOL bDeflate, int iWindowBits)
+{
+	ASSERT(iWindowBits >= MIN_WS_DEFLATE_WINDOW_BITS && iWindowBits <= MAX_WS_DEFLATE_WINDOW_BITS);
+
+	vector<z_stream*>& lsFree = m_lsFreeStreams[bDeflate ? 1 : 0][iWindowBits - MIN_WS_DEFLATE_WINDOW_BITS];
+
+	{
+		CCriSecLock locallock(m_cs);
+
+		if(!lsFree.empty())
+		{
+			z_stream* pStream = lsFree.back();
+			lsFree.pop_back();
+
+			return pStream;
+		}
+	}
+
+	z_stream* pStream = new z_stream;
+	memset(pStream, 0, sizeof(z_stream));
+
+	int rs;
+
+	if(bDeflate)
+	{
+		/* zlib 不支持 256 字节窗口的原始 deflate 流，此时只输出不引用窗口的存储块 */
+		int iLevel	  = iWindowBits > MIN_WS_DEFLATE_WINDOW_BITS ? Z_DEFAULT_COMPRESSION : Z_NO_COMPRESSION;
+		int iBits	  = max(iWindowBits, MIN_WS_DEFLATE_WINDOW_BITS + 1);
+		int iMemLevel = iBits - 7;
+
+		rs = ::deflateInit2(pStream, iLevel, Z_DEFLATED, -iBits, iMemLevel, Z_DEFAULT_STRATEGY);
+	}
+	else
+		rs = ::inflateInit2(pStream, -iWindowBits);
+
+	if(rs != Z_OK)
+	{
+		delete pStream;
+		::SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+
+		return nullptr;
+	}
+
+	return pStream;
+}
+
+void CWSDeflateMgr::PutFreeStream(z_stream* pStream, BOOL bDeflate, int iWindowBits)
+{
+	ASSERT(iWindowBits >= MIN_WS_DEFLATE_WINDOW_BITS && iWindowBits <= MAX_WS_DEFLATE_WINDOW_BITS);
+
+	vector<z_stream*>& lsFree = m_lsFreeStreams[bDeflate ? 1 : 0][iWindowBits - MIN_WS_DEFLATE_WINDOW_BITS];
+
+	int rs = bDeflate ? ::deflateReset(pStream) : ::inflateReset(pStream);
+
+	if(rs == Z_OK)
+	{
+		CCriSecLock locallock(m_cs);
+
+		if(lsFree.size() < DEFAULT_WS_DEFLATE_POOL_HOLD)
+		{
+			lsFree.push_back(pStream);
+			return;
+		}
+	}
+
+	bDeflate ? ::deflateEnd(pStream) : ::inflateEnd(pStream);
+	delete pStream;
+}
+
+void CWSDeflateMgr::Clear()
+{
+	CCriSecLock locallock(m_cs);
+
+	for(int i = 0; i < 2; i++)
+	{
+		for(int j = 0; j < (int)_countof(m_lsFreeStreams[i]); j++)
+		{
+			vector<z_stream*>& lsFree = m_lsFreeStreams[i][j];
+
+			for(size_t k = 0; k < lsFree.size(); k++)
+			{
+				i == 1 ? ::deflateEnd(lsFree[k]) : ::inflateEnd(lsFree[k]);
+				delete lsFree[k];
+			}
+
+			lsFree.clear();
+		}
+	}
+}
+
+CWSDeflateContext::~CWSDeflateContext()
+{
+	if(m_pDeflater)
+		m_pMgr->PutFreeStream(m_pDeflater, TRUE, m_param.deflateWindowBits);
+	if(m_pInflater)
+		m_pMgr->PutFreeStream(m_pInflater, FALSE, m_param.inflateWindowBits);
+}
+
+BOOL CWSDeflateContext::DeflateFrame(BOOL bFinal, BYTE& iReserved, BYTE iOperationCode, BYTE*& pData, int& iLength, ULONGLONG& ullBodyLen, CBufferPtr& buffer)
+{
+	BOOL bCompress = FALSE;
+
+	if(iOperationCode >= 0x8)
+		return TRUE;
+	else if(iOperationCode == 0x0)
+		bCompress = m_bDeflating;
+	else
+	{
+		if(m_bDeflating)
+		{
+			::SetLastError(ERROR_INVALID_STATE);
+			return FALSE;
+		}
+
+		/* 消息体随后由 Send() 发送的帧以及应用程序已压缩的消息原样发送 */
+		bCompress = (iReserved & HTTP_WS_DEFLATE_RSV) == 0					&&
+					(ullBodyLen == 0 || ullBodyLen == (ULONGLONG)iLength)	&&
+					(!bFinal || iLength >= HTTP_WS_DEFLATE_MIN_LEN);
+	}
+
+	if(!bCompress)
+		return TRUE;
+
+	if(ullBodyLen > (ULONGLONG)iLength)
+	{
+		::SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	int iOutLength = 0;
+
+	if(!Deflate(pData, iLength, bFinal, buffer, iOutLength))
+		return FALSE;
+
+	if(iOperationCode != 0x0)
+		iReserved |= HTTP_WS_DEFLATE_RSV;
+
+	m_bDeflating	= !bFinal;
+	pData			= buffer.Ptr();
+	iLength			= iOutLength;
+	ullBodyLen		= 0;
+
+	return TRUE;
+}
+
+BOOL CWSDeflateContext::Deflate(const BYTE* pData, int iLength, BOOL bFinal, CBufferPtr& buffer, int& iOutLength)
+{
+	if(m_pDeflater == nullptr && (m_pDeflater = m_pMgr->PickFreeStream(TRUE, m_param.deflateWindowBits)) == nullptr)
+		return FALSE;
+
+	z_stream* pStream	= m_pDeflater;
+	pStream->next_in	= (z_const Bytef*)pData;
+	pStream->avail_in	= (uInt)iLength;
+
+	buffer.Malloc(::deflateBound(pStream, (uLong)iLength) + sizeof(s_szWSDeflateTail) * 2);
+
+	iOutLength = 0;
+
+	do
+	{
+		if((size_t)iOutLength == buffer.Size())
+			buffer.Realloc(buffer.Size() * 2);
+
+		pStream->next_out	= buffer.Ptr() + iOutLength;
+		pStream->avail_out	= (uInt)(buffer.Size() - iOutLength);
+
+		int rs = ::deflate(pStream, Z_SYNC_FLUSH);
+
+		if(rs != Z_OK && rs != Z_BUF_ERROR)
+		{
+			m_pMgr->PutFreeStream(m_pDeflater, TRUE, m_param.deflateWindowBits);
+			m_pDeflater = nullptr;
+
+			::SetLastError(ERROR_INVALID_DATA);
+			return FALSE;
+		}
+
+		iOutLength = (int)(buffer.Size() - pStream->avail_out);
+	} while(pStream->avail_out == 0);
+
+	if(bFinal)
+	{
+		/* 去掉同步刷新产生的 0x00 0x00 0xFF 0xFF 尾部，由接收方补回（RFC 7692 7.2.1） */
+		if(iOutLength >= (int)sizeof(s_szWSDeflateTail) && memcmp(buffer.Ptr() + iOutLength - sizeof(s_szWSDeflateTail), s_szWSDeflateTail, sizeof(s_szWSDeflateTail)) == 0)
+			iOutLength -= (int)sizeof(s_szWSDeflateTail);
+
+		if(m_param.deflateNoContextTakeover)
+		{
+			m_pMgr->PutFreeStream(m_pDeflater, TRUE, m_param.deflateWindowBits);
+			m_pDeflater = nullptr;
+		}
+	}
+
+	return TRUE;
+}
+
+BOOL CWSDeflateContext::SetInflateInput(const BYTE* pData, int iLength)
+{
+	if(m_pInflater == nullptr && (m_pInflater = m_pMgr->PickFreeStream(FALSE, m_param.inflateWindowBits)) == nullptr)
+		return FALSE;
+
+	if(pData == nullptr)
+	{
+		pData	= s_szWSDeflateTail;
+		iLength	= (int)sizeof(s_szWSDeflateTail);
+	}
+
+	m_pInflater->next_in	= (z_const Bytef*)pData;
+	m_pInflater->avail_in	= (uInt)iLength;
+
+	return TRUE;
+}
+
+int CWSDeflateContext::Inflate(const BYTE** ppOutput)
+{
+	z_stream* pStream = m_pInflater;
+
+	/* 忽略最后一个 deflate 块（BFINAL = 1）之后的数据 */
+	if(m_bInflateEnd)
+	{
+		pStream->avail_in = 0;
+		return 0;
+	}
+
+	pStream->next_out	= t_szWSInflateBuffer;
+	pStream->avail_out	= (uInt)sizeof(t_szWSInflateBuffer);
+
+	int rs = ::inflate(pStream, Z_SYNC_FLUSH);
+
+	if(rs == Z_STREAM_END)
+		m_bInflateEnd = TRUE;
+	else if(rs != Z_OK && rs != Z_BUF_ERROR)
+		return -1;
+
+	*ppOutput = t_szWSInflateBuffer;
+
+	return (int)(sizeof(t_szWSInflateBuffer) - pStream->avail_out);
+}
+
+void CWSDeflateContext::EndInflate()
+{
+	if(m_pInflater != nullptr && (m_param.inflateNoContextTakeover || m_bInflateEnd))
+	{
+		m_pMgr->PutFreeStream(m_pInflater, FALSE, m_param.inflateWindowBits);
+		m_pInflater = nullptr;
+	}
+
+	m_bInflateEnd = FALSE;
+}
+
 BOOL ParseUrl(const CStringA& strUrl, BOOL& bHttps, CStringA& strHost, USHORT& usPort, CStringA& strPath)
 {
 	int iSchemaLength = (int)strlen(HTTP_SCHEMA);
@@ -387,4 +1295,67 @@ BOOL ParseUrl(const CStringA& strUrl, BOOL& bHttps, CStringA& strHost, USHORT& u
 	return TRUE;
 }
 
+int ParseHttpRange(LPCSTR lpszRange, LONGLONG llSize, LONGLONG& llOffset, LONGLONG& llLength)
+{
+	ASSERT(lpszRange != nullptr && llSize >= 0);
+
+	static const int iUnitLength = (int)strlen(HTTP_RANGE_UNIT_BYTES);
+
+	while(*lpszRange == ' ')
+		++lpszRange;
+
+	if(strnicmp(lpszRange, HTTP_RANGE_UNIT_BYTES, iUnitLength) != 0 || lpszRange[iUnitLength] != '=' || strchr(lpszRange, ',') != nullptr)
+		return -1;
+
+	lpszRange += iUnitLength + 1;
+
+	char* lpszEnd;
+	LONGLONG llFirst = -1;
+	LONGLONG llLast	 = -1;
+
+	if(::isdigit(*lpszRange))
+	{
+		llFirst		= strtoll(lpszRange, &lpszEnd, 10);
+		lpszRange	= lpszEnd;
+	}
+
+	if(*lpszRange++ != '-')
+		return -1;
+
+	if(::isdigit(*lpszRange))
+	{
+		llLast		= strtoll(lpszRange, &lpszEnd, 10);
+		lpszRange	= lpszEnd;
+	}
+
+	while(*lpszRange == ' ')
+		++lpszRange;
+
+	if(*lpszRange != 0 || (llFirst < 0 && llLast < 0) || (llFirst >= 0 && llLast >= 0 && llLast < llFirst))
+		return -1;
+
+	if(llFirst < 0)
+	{
+		if(llLast == 0 || llSize == 0)
+			return 0;
+
+		llOffset = (llLast < llSize ? llSize - llLast : 0);
+	}
+	else
+	{
+		if(llFirst >= llSize)
+			return 0;
+
+		if(llLast < 0 || llLast >= llSize)
+			llLast = llSize - 1;
+
+		llOffset = llFirst;
+		llSize	 = llLast + 1;
+	}
+
+	llLength = llSize - llOffset;
+
+	return 1;
+}
+
 #endif
\ No newline at end of file
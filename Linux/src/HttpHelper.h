@@ -59,6 +59,16 @@
 #define HTTP_HEADER_CONNECTION				"Connection"
 #define HTTP_HEADER_UPGRADE					"Upgrade"
 #define HTTP_HEADER_VALUE_WEB_SOCKET		"WebSocket"
+#define HTTP_HEADER_RANGE					"Range"
+#define HTTP_HEADER_CONTENT_RANGE			"Content-Range"
+#define HTTP_HEADER_ACCEPT_RANGES			"Accept-Ranges"
+#define HTTP_HEADER_LAST_MODIFIED			"Last-Modified"
+#define HTTP_HEADER_IF_MODIFIED_SINCE		"If-Modified-Since"
+#define HTTP_HEADER_DATE					"Date"
+#define HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS	"Sec-WebSocket-Extensions"
+#define HTTP_WS_DEFLATE_EXTENSION			"permessage-deflate"
+
+#define HTTP_RANGE_UNIT_BYTES				"bytes"
 
 #define HTTP_CONNECTION_CLOSE_VALUE			"close"
 #define HTTP_CONNECTION_KEEPALIVE_VALUE		"keep-alive"
@@ -75,6 +85,15 @@
 
 #define HTTP_MIN_WS_HEADER_LEN				2
 #define HTTP_MAX_WS_HEADER_LEN				14
+#define HTTP_MAX_RESPONSE_TAIL_LEN			128
+
+#define HTTP_WS_DEFLATE_RSV					0x4
+#define HTTP_WS_DEFLATE_MIN_LEN				64
+#define HTTP_WS_INFLATE_BUFFER_SIZE			(16 * 1024)
+#define MIN_WS_DEFLATE_WINDOW_BITS			8
+#define MAX_WS_DEFLATE_WINDOW_BITS			15
+#define DEFAULT_WS_DEFLATE_WINDOW_BITS		MAX_WS_DEFLATE_WINDOW_BITS
+#define DEFAULT_WS_DEFLATE_POOL_HOLD		32
 
 #define MIN_HTTP_RELEASE_CHECK_INTERVAL		((DWORD)1000)
 #define MIN_HTTP_RELEASE_DELAY				100
@@ -112,16 +131,106 @@ struct TDyingConnection
 
 };
 
-typedef unordered_multimap<CStringA, CStringA,
-		cstringa_nc_hash_func::hash, cstringa_nc_hash_func::equal_to>	THeaderMap;
-typedef THeaderMap::const_iterator										THeaderMapCI;
-typedef THeaderMap::iterator											THeaderMapI;
+/* Ӧģ壺Ԥ״̬к͹̶Ӧͷظʱֻ Content-LengthConnection  Date */
+struct THttpResponseTemplate
+{
+	USHORT		statusCode;
+	CStringA	desc;
+	CStringA	lines;
+	CStringA	header;
+	BOOL		hasLength;
+	BOOL		hasConnection;
+	BOOL		hasDate;
+};
 
 typedef unordered_map<CStringA, CStringA,
 		cstringa_hash_func::hash, cstringa_hash_func::equal_to>			TCookieMap;
 typedef TCookieMap::const_iterator										TCookieMapCI;
 typedef TCookieMap::iterator											TCookieMapI;
 
+/*  HTTP ͷ */
+enum EnHttpHeaderIndex
+{
+	HHI_UNKNOWN				= -1,
+	HHI_HOST				= 0,
+	HHI_COOKIE,
+	HHI_SET_COOKIE,
+	HHI_CONTENT_TYPE,
+	HHI_CONTENT_LENGTH,
+	HHI_CONTENT_ENCODING,
+	HHI_TRANSFER_ENCODING,
+	HHI_CONNECTION,
+	HHI_UPGRADE,
+	HHI_RANGE,
+	HHI_IF_MODIFIED_SINCE,
+	HHI_SEC_WEBSOCKET_EXTENSIONS,
+	HHI_MAX
+};
+
+/* ȡ HTTP ͷƶӦĳͷִСдǳͷ HHI_UNKNOWN */
+extern EnHttpHeaderIndex GetHttpHeaderIndex(LPCSTR lpszName, int iLength);
+
+/*
+* HTTP ͷ
+* 
+* ͷƺֵ鱣е arena У (name, value) ƽ¼ͷ
+* arena Ϣ֮临ãύַĵַ Clear() ֮ǰֲ
+*/
+class CHttpHeaderTable
+{
+public:
+	struct TEntry
+	{
+		LPCSTR				name;
+		LPCSTR				value;
+		EnHttpHeaderIndex	index;
+	};
+
+public:
+	/* ׷ӵǰδύַ */
+	void Append(const char* at, size_t length);
+	/* ύǰַ '\0' βַַ */
+	LPCSTR Commit(int& iLength);
+	/* һͷ䳣ͷ */
+	EnHttpHeaderIndex Add(LPCSTR lpszName, int iNameLength, LPCSTR lpszValue);
+
+	LPCSTR Get(EnHttpHeaderIndex enIndex) const;
+	LPCSTR Get(LPCSTR lpszName) const;
+	DWORD GetValues(LPCSTR lpszName, LPCSTR lpszValue[], DWORD dwCount) const;
+
+	DWORD Size()							const	{return (DWORD)m_entries.size();}
+	const TEntry& operator [] (DWORD i)		const	{return m_entries[i];}
+
+	void Clear();
+	void Copy(const CHttpHeaderTable& other);
+
+private:
+	struct TBlock
+	{
+		char*	data;
+		int		capacity;
+	};
+
+	void NextBlock(int iRequired);
+
+public:
+	CHttpHeaderTable();
+	~CHttpHeaderTable();
+
+	DECLARE_NO_COPY_CLASS(CHttpHeaderTable)
+
+private:
+	static const int DEF_BLOCK_SIZE		= 2048;
+	static const int DEF_ENTRY_RESERVE	= 16;
+
+	vector<TBlock>	m_blocks;
+	vector<TEntry>	m_entries;
+	int				m_iBlock;
+	int				m_iUsed;
+	int				m_iPending;
+	int				m_iIndex[HHI_MAX];
+};
+
 // ------------------------------------------------------------------------------------------------------------- //
 
 struct TBaseWSHeader
@@ -197,6 +306,125 @@ private:
 	UINT& data;
 };
 
+/* WebSocket 㣨iFactor ΪһֽڶӦ±꣬ʱ CPU ѡ AVX2 / SSE2 / ʵ֣ */
+extern void MaskWSData(BYTE* pData, int iLength, const BYTE lpszMask[4], int iFactor = 0);
+
+/* permessage-deflate Э̽deflate Ϊ˷ͷinflate ΪԶ˷ͷ */
+struct TWSDeflateParam
+{
+	BOOL	deflateNoContextTakeover;
+	BOOL	inflateNoContextTakeover;
+	int		deflateWindowBits;
+	int		inflateWindowBits;
+};
+
+/*
+* permessage-deflate RFC 7692
+* 
+* ѹòչЭ̣е z_stream 󰴷ʹڴС棬
+* ĵֻѹѹһϢڼռ z_streamڴ濪벢Ϣ
+*/
+class CWSDeflateMgr
+{
+public:
+	/* ˣ WebSocket ׷ Sec-WebSocket-Extensions ͷ WebSocket Ӧóָͷʱ FALSE */
+	BOOL MakeOffer(const THeader lpHeaders[], int iHeaderCount, CStringA& strHeader);
+	/* Ӧˣ Sec-WebSocket-Extensions ѡһЧ permessage-deflate Э */
+	BOOL AcceptOffer(LPCSTR lpszValues[], int iCount, TWSDeflateParam& param);
+	/* Ӧˣ 101 Ӧ׷ Sec-WebSocket-Extensions ӦͷӦóָӦͷʱ FALSE */
+	BOOL MakeResponse(const TWSDeflateParam& param, const THeader lpHeaders[], int iHeaderCount, CStringA& strHeader);
+	/* ˣ 101 Ӧ Sec-WebSocket-Extensions */
+	BOOL ConfirmResponse(LPCSTR lpszValues[], int iCount, TWSDeflateParam& param);
+
+	z_stream* PickFreeStream(BOOL bDeflate, int iWindowBits);
+	void PutFreeStream(z_stream* pStream, BOOL bDeflate, int iWindowBits);
+	void Clear();
+
+public:
+	void SetEnabled			(BOOL bEnabled)			{m_bEnabled			= bEnabled;}
+	void SetWindowBits		(int iWindowBits)		{m_iWindowBits		= iWindowBits;}
+	void SetContextTakeover	(BOOL bContextTakeover)	{m_bContextTakeover	= bContextTakeover;}
+
+	BOOL IsEnabled			()	{return m_bEnabled;}
+	int GetWindowBits		()	{return m_iWindowBits;}
+	BOOL IsContextTakeover	()	{return m_bContextTakeover;}
+
+	BOOL IsValidWindowBits	()	{return m_iWindowBits > MIN_WS_DEFLATE_WINDOW_BITS && m_iWindowBits <= MAX_WS_DEFLATE_WINDOW_BITS;}
+
+public:
+	CWSDeflateMgr()
+	: m_bEnabled		(FALSE)
+	, m_iWindowBits		(DEFAULT_WS_DEFLATE_WINDOW_BITS)
+	, m_bContextTakeover(TRUE)
+	{
+
+	}
+
+	~CWSDeflateMgr() {Clear();}
+
+	DECLARE_NO_COPY_CLASS(CWSDeflateMgr)
+
+private:
+	BOOL	m_bEnabled;
+	int		m_iWindowBits;
+	BOOL	m_bContextTakeover;
+
+	CCriSec				m_cs;
+	vector<z_stream*>	m_lsFreeStreams[2][MAX_WS_DEFLATE_WINDOW_BITS - MIN_WS_DEFLATE_WINDOW_BITS + 1];
+};
+
+/*
+* WebSocket ӵ permessage-deflate 
+* 
+* շֻӵĽ߳ʹãͷܱ߳ͬʱã
+* ߱ GetLock() ѹ֡У߳ͬһӷϢʱӦó֤Ϣ˳
+*/
+class CWSDeflateContext
+{
+public:
+	/* ѹ֡֡Ϣͷֶη͵֡ԭѹ pData / iLength / ullBodyLen ָ buffer еѹݣһ֡ RSV1 */
+	BOOL DeflateFrame(BOOL bFinal, BYTE& iReserved, BYTE iOperationCode, BYTE*& pData, int& iLength, ULONGLONG& ullBodyLen, CBufferPtr& buffer);
+
+	/* ôѹݣpData Ϊ nullptr ʱϢβ 0x00 0x00 0xFF 0xFF */
+	BOOL SetInflateInput(const BYTE* pData, int iLength);
+	/* ȡѹݣֵ> 0 -- ѹݳȣ0 -- Ѵϣ-1 -- ݴ */
+	int Inflate(const BYTE** ppOutput);
+	/* ǰϢĽѹ */
+	void EndInflate();
+
+	CCriSec& GetLock() {return m_cs;}
+
+private:
+	BOOL Deflate(const BYTE* pData, int iLength, BOOL bFinal, CBufferPtr& buffer, int& iOutLength);
+
+public:
+	CWSDeflateContext(CWSDeflateMgr* pMgr, const TWSDeflateParam& param)
+	: m_pMgr		(pMgr)
+	, m_param		(param)
+	, m_pDeflater	(nullptr)
+	, m_pInflater	(nullptr)
+	, m_bDeflating	(FALSE)
+	, m_bInflateEnd	(FALSE)
+	{
+
+	}
+
+	~CWSDeflateContext();
+
+	DECLARE_NO_COPY_CLASS(CWSDeflateContext)
+
+private:
+	CWSDeflateMgr*	m_pMgr;
+	TWSDeflateParam	m_param;
+
+	z_stream*		m_pDeflater;
+	z_stream*		m_pInflater;
+	BOOL			m_bDeflating;
+	BOOL			m_bInflateEnd;
+
+	CCriSec			m_cs;
+};
+
 template<class T> struct TWSContext
 {
 public:
@@ -238,7 +466,9 @@ public:
 						m_ullBodyRemain	= m_ullBodyLen;
 						m_lpszMask		= iMaskLen > 0 ? m_szHeader + HTTP_MIN_WS_HEADER_LEN + iExtLen : nullptr;
 
-						hr = m_pHttpObj->on_ws_message_header(bh.fin(), bh.rsv(), bh.code(), m_lpszMask, m_ullBodyLen);
+						CheckInflate(bh.rsv(), bh.code());
+
+						hr = m_pHttpObj->on_ws_message_header(bh.fin(), GetReserved(bh.rsv()), bh.code(), m_lpszMask, m_ullBodyLen);
 
 						if(hr == HR_ERROR)
 							break;
@@ -260,16 +490,14 @@ public:
 				iMin = (int)min(m_ullBodyRemain, (ULONGLONG)iRemain);
 
 				if(m_lpszMask)
-				{
-					int iFactor = (m_ullBodyLen - m_ullBodyRemain) & 0x03;
-
-					for(int i = 0; i < iMin; i++)
-						pTemp[i] = pTemp[i] ^ m_lpszMask[(i + iFactor) & 0x03];
-				}
+					::MaskWSData(pTemp, iMin, m_lpszMask, (int)((m_ullBodyLen - m_ullBodyRemain) & 0x03));
 
 				m_ullBodyRemain	-= iMin;
 
-				EnHandleResult hr = m_pHttpObj->on_ws_message_body(pTemp, iMin);
+				if(m_bInflate)
+					hr = InflateBody(pTemp, iMin);
+				else
+					hr = m_pHttpObj->on_ws_message_body(pTemp, iMin);
 
 				if(hr == HR_ERROR)
 					break;
@@ -287,7 +515,7 @@ public:
 			iRemain	-= iMin;
 		}
 
-		return HR_OK;
+		return hr;
 	}
 
 	BOOL GetMessageState(BOOL* lpbFinal, BYTE* lpiReserved, BYTE* lpiOperationCode, LPCBYTE* lpszMask, ULONGLONG* lpullBodyLen, ULONGLONG* lpullBodyRemain)
@@ -295,7 +523,7 @@ public:
 		TBaseWSHeader bh(m_szHeader);
 
 		if(lpbFinal)			*lpbFinal			= bh.fin();
-		if(lpiReserved)			*lpiReserved		= bh.rsv();
+		if(lpiReserved)			*lpiReserved		= GetReserved(bh.rsv());
 		if(lpiOperationCode)	*lpiOperationCode	= bh.code();
 		if(lpszMask)			*lpszMask			= m_lpszMask;
 		if(lpullBodyLen)		*lpullBodyLen		= m_ullBodyLen;
@@ -318,19 +546,88 @@ public:
 
 		m_ullBodyLen	= src.m_ullBodyLen;
 		m_ullBodyRemain	= src.m_ullBodyRemain;
+		m_bInflate		= src.m_bInflate;
 
 		return TRUE;
 	}
 
+	CWSDeflateContext* GetDeflateContext() {return m_pDeflate;}
+
+	void SetDeflateContext(CWSDeflateContext* pDeflate)
+	{
+		ASSERT(m_pDeflate == nullptr);
+		m_pDeflate = pDeflate;
+	}
+
+	void ReleaseDeflateContext()
+	{
+		if(m_pDeflate)
+		{
+			delete m_pDeflate;
+			m_pDeflate = nullptr;
+		}
+	}
+
 public:
-	TWSContext(T* pHttpObj) : m_pHttpObj(pHttpObj)
+	TWSContext(T* pHttpObj, CWSDeflateContext* pDeflate = nullptr)
+	: m_pHttpObj	(pHttpObj)
+	, m_pDeflate	(pDeflate)
+	, m_bCompressed	(FALSE)
+	, m_bInflate	(FALSE)
 	{
 		Reset();
 	}
 
+	~TWSContext()
+	{
+		ReleaseDeflateContext();
+	}
+
 private:
+	/* Ϣĵһ֡ͨ RSV1 ʶǷѹ֡øñʶ֡ѹ */
+	void CheckInflate(BYTE iReserved, BYTE iOperationCode)
+	{
+		if(m_pDeflate == nullptr)
+			return;
+
+		if(iOperationCode == 0x1 || iOperationCode == 0x2)
+			m_bCompressed = (iReserved & HTTP_WS_DEFLATE_RSV) != 0;
+
+		m_bInflate = m_bCompressed && iOperationCode < 0x8;
+	}
+
+	BYTE GetReserved(BYTE iReserved)
+	{
+		return m_bInflate ? (iReserved & ~HTTP_WS_DEFLATE_RSV) : iReserved;
+	}
+
+	EnHandleResult InflateBody(const BYTE* pData, int iLength)
+	{
+		if(!m_pDeflate->SetInflateInput(pData, iLength))
+			return HR_ERROR;
+
+		const BYTE* pOutput;
+		int iOutput;
+
+		while((iOutput = m_pDeflate->Inflate(&pOutput)) > 0)
+		{
+			if(m_pHttpObj->on_ws_message_body(pOutput, iOutput) == HR_ERROR)
+				return HR_ERROR;
+		}
+
+		return iOutput == 0 ? HR_OK : HR_ERROR;
+	}
+
 	EnHandleResult CompleteMessage()
 	{
+		if(m_bInflate && TBaseWSHeader(m_szHeader).fin())
+		{
+			if(InflateBody(nullptr, 0) == HR_ERROR)
+				return HR_ERROR;
+
+			m_pDeflate->EndInflate();
+		}
+
 		EnHandleResult hr = m_pHttpObj->on_ws_message_complete();
 
 		Reset();
@@ -350,6 +647,7 @@ private:
 
 private:
 	T* m_pHttpObj;
+	CWSDeflateContext* m_pDeflate;
 
 	BYTE m_szHeader[HTTP_MAX_WS_HEADER_LEN];
 	const BYTE* m_lpszMask;
@@ -359,6 +657,9 @@ private:
 	int m_iHeaderRemain;
 	ULONGLONG m_ullBodyLen;
 	ULONGLONG m_ullBodyRemain;
+
+	BOOL m_bCompressed;
+	BOOL m_bInflate;
 };
 
 // ------------------------------------------------------------------------------------------------------------- //
@@ -451,13 +752,12 @@ public:
 		EnHttpParseResult hpr	= HPR_OK;
 		THttpObjT* pSelf		= Self(p);
 
-		pSelf->AppendBuffer(at, length);
+		pSelf->m_headers.Append(at, length);
 
 		if(p->state != s_header_value_discard_ws)
 			return hpr;
 
-		pSelf->m_strCurHeader = pSelf->GetBuffer();
-		pSelf->ResetBuffer();
+		pSelf->m_lpszCurHeader = pSelf->m_headers.Commit(pSelf->m_iCurHeaderLen);
 
 		return hpr;
 	}
@@ -467,23 +767,26 @@ public:
 		EnHttpParseResult hpr	= HPR_OK;
 		THttpObjT* pSelf		= Self(p);
 
-		pSelf->AppendBuffer(at, length);
+		pSelf->m_headers.Append(at, length);
 
 		if(p->state != s_header_almost_done && p->state != s_header_field_start)
 			return hpr;
 
-		pSelf->m_headers.emplace(move(THeaderMap::value_type(pSelf->m_strCurHeader, pSelf->GetBuffer())));
-		hpr = pSelf->m_pContext->FireHeader(pSelf->m_pSocket, pSelf->m_strCurHeader, pSelf->GetBuffer());
+		int iLength;
+		LPCSTR lpszValue			= pSelf->m_headers.Commit(iLength);
+		EnHttpHeaderIndex enIndex	= pSelf->m_headers.Add(pSelf->m_lpszCurHeader, pSelf->m_iCurHeaderLen, lpszValue);
+
+		hpr = pSelf->m_pContext->FireHeader(pSelf->m_pSocket, pSelf->m_lpszCurHeader, lpszValue);
 
 		if(hpr != HPR_ERROR)
 		{
-			if(pSelf->m_bRequest && pSelf->m_strCurHeader == HTTP_HEADER_COOKIE)
-				hpr = pSelf->ParseCookie();
-			else if(!pSelf->m_bRequest && pSelf->m_strCurHeader == HTTP_HEADER_SET_COOKIE)
-				hpr = pSelf->ParseSetCookie();
+			if(pSelf->m_bRequest && enIndex == HHI_COOKIE)
+				hpr = pSelf->ParseCookie(lpszValue, iLength);
+			else if(!pSelf->m_bRequest && enIndex == HHI_SET_COOKIE)
+				hpr = pSelf->ParseSetCookie(lpszValue);
 		}
 
-		pSelf->ResetBuffer();
+		pSelf->m_lpszCurHeader = nullptr;
 
 		return hpr;
 	}
@@ -559,13 +862,23 @@ private:
 	{
 		ASSERT(m_parser.upgrade);
 
+		if(m_enUpgrade == HUT_WEB_SOCKET)
+			NegotiateWSDeflate();
+
 		if(m_pContext->FireUpgrade(m_pSocket, m_enUpgrade) != HPR_OK)
 			return HR_ERROR;
 
 		ResetHeaderState();
 
 		if(m_enUpgrade == HUT_WEB_SOCKET)
-			m_pwsContext = new TWSContext<THttpObjT<T, S>>(this);
+		{
+			CWSDeflateContext* pDeflate = nullptr;
+
+			if(m_bWSDeflate && (!m_bRequest || m_bWSDeflateResponded))
+				pDeflate = new CWSDeflateContext(m_pContext->GetWSDeflateMgr(), m_wsDeflateParam);
+
+			m_pwsContext = new TWSContext<THttpObjT<T, S>>(this, pDeflate);
+		}
 
 		if(iPased < iLength)
 			return Execute(pData + iPased, iLength - iPased);
@@ -573,6 +886,28 @@ private:
 		return HR_OK;
 	}
 
+	void NegotiateWSDeflate()
+	{
+		CWSDeflateMgr* pMgr = m_pContext->GetWSDeflateMgr();
+
+		if(m_bRequest)
+		{
+			m_bWSDeflate		  = pMgr->IsEnabled();
+			m_bWSDeflateResponded = FALSE;
+		}
+
+		if(!m_bWSDeflate)
+			return;
+
+		LPCSTR szValues[8];
+		int iCount = (int)min(m_headers.GetValues(HTTP_HEADER_SEC_WEBSOCKET_EXTENSIONS, szValues, _countof(szValues)), (DWORD)_countof(szValues));
+
+		if(m_bRequest)
+			m_bWSDeflate = pMgr->AcceptOffer(szValues, iCount, m_wsDeflateParam);
+		else
+			m_bWSDeflate = pMgr->ConfirmResponse(szValues, iCount, m_wsDeflateParam);
+	}
+
 	void CheckUpgrade()
 	{
 		if(!m_parser.upgrade)
@@ -582,8 +917,8 @@ private:
 			m_enUpgrade = HUT_HTTP_TUNNEL;
 		else
 		{
-			LPCSTR lpszValue;
-			if(GetHeader(HTTP_HEADER_UPGRADE, &lpszValue) && stricmp(HTTP_HEADER_VALUE_WEB_SOCKET, lpszValue) == 0)
+			LPCSTR lpszValue = m_headers.Get(HHI_UPGRADE);
+			if(lpszValue != nullptr && stricmp(HTTP_HEADER_VALUE_WEB_SOCKET, lpszValue) == 0)
 				m_enUpgrade = HUT_WEB_SOCKET;
 			else
 				m_enUpgrade = HUT_UNKNOWN;
@@ -615,36 +950,44 @@ private:
 		return HPR_OK;
 	}
 
-	EnHttpParseResult ParseCookie()
+	EnHttpParseResult ParseCookie(LPCSTR lpszValue, int iLength)
 	{
-		int i = 0;
+		CStringA strName;
+		CStringA strValue;
 
-		do 
+		LPCSTR lpszEnd = lpszValue + iLength;
+
+		for(LPCSTR lpszTk = lpszValue; lpszTk < lpszEnd; )
 		{
-			CStringA tk = m_strBuffer.Tokenize(COOKIE_FIELD_SEP, i);
+			LPCSTR lpszTkEnd = (LPCSTR)memchr(lpszTk, COOKIE_FIELD_SEP[0], lpszEnd - lpszTk);
+
+			if(lpszTkEnd == nullptr)
+				lpszTkEnd = lpszEnd;
+
+			LPCSTR lpszNext = lpszTkEnd + 1;
 
-			if(i == -1)
-				break;
+			while(lpszTk < lpszTkEnd && ::isspace((BYTE)*lpszTk))
+				++lpszTk;
+			while(lpszTkEnd > lpszTk && ::isspace((BYTE)*(lpszTkEnd - 1)))
+				--lpszTkEnd;
 
-			int j = tk.Trim().Find(COOKIE_KV_SEP_CHAR);
+			LPCSTR lpszSep = (LPCSTR)memchr(lpszTk, COOKIE_KV_SEP_CHAR, lpszTkEnd - lpszTk);
 
-			if(j <= 0)
-				continue;
-			/*
+			if(lpszSep != nullptr && lpszSep > lpszTk)
 			{
-				m_parser.http_errno = HPE_INVALID_HEADER_TOKEN;
-				return HPR_ERROR;
-			}
-			*/
+				strName.SetString(lpszTk, (int)(lpszSep - lpszTk));
+				strValue.SetString(lpszSep + 1, (int)(lpszTkEnd - lpszSep - 1));
 
-			AddCookie(tk.Left(j), tk.Mid(j + 1));
+				AddCookie(strName, strValue);
+			}
 
-		} while(TRUE);
+			lpszTk = lpszNext;
+		}
 
 		return HPR_OK;
 	}
 
-	EnHttpParseResult ParseSetCookie()
+	EnHttpParseResult ParseSetCookie(LPCSTR lpszValue)
 	{
 		CCookieMgr* pCookieMgr = m_pContext->GetCookieMgr();
 
@@ -654,7 +997,7 @@ private:
 		LPCSTR lpszDomain	= GetDomain();
 		LPCSTR lpszPath		= GetPath();
 
-		unique_ptr<CCookie> pCookie(CCookie::FromString(m_strBuffer, lpszDomain, lpszPath));
+		unique_ptr<CCookie> pCookie(CCookie::FromString(lpszValue, lpszDomain, lpszPath));
 
 		if(pCookie == nullptr)
 			return HPR_ERROR;
@@ -689,43 +1032,15 @@ public:
 
 	EnHttpUpgradeType GetUpgradeType()	{return m_enUpgrade;}
 
-	THeaderMap& GetHeaderMap()		{return m_headers;}
 	TCookieMap& GetCookieMap()		{return m_cookies;}
 
 	BOOL HasReleased()				{return m_bReleased;}
 	void Release()					{m_bReleased = TRUE;}
 
-	LPCSTR GetContentType()
-	{
-		LPCSTR lpszValue = nullptr;
-		GetHeader(HTTP_HEADER_CONTENT_TYPE, &lpszValue);
-
-		return lpszValue;
-	}
-
-	LPCSTR GetContentEncoding()
-	{
-		LPCSTR lpszValue = nullptr;
-		GetHeader(HTTP_HEADER_CONTENT_ENCODING, &lpszValue);
-
-		return lpszValue;
-	}
-
-	LPCSTR GetTransferEncoding()
-	{
-		LPCSTR lpszValue = nullptr;
-		GetHeader(HTTP_HEADER_TRANSFER_ENCODING, &lpszValue);
-
-		return lpszValue;
-	}
-
-	LPCSTR GetHost()
-	{
-		LPCSTR lpszValue = nullptr;
-		GetHeader(HTTP_HEADER_HOST, &lpszValue);
-
-		return lpszValue;
-	}
+	LPCSTR GetContentType()			{return m_headers.Get(HHI_CONTENT_TYPE);}
+	LPCSTR GetContentEncoding()		{return m_headers.Get(HHI_CONTENT_ENCODING);}
+	LPCSTR GetTransferEncoding()	{return m_headers.Get(HHI_TRANSFER_ENCODING);}
+	LPCSTR GetHost()				{return m_headers.Get(HHI_HOST);}
 
 	USHORT GetParseErrorCode(LPCSTR* lpszErrorDesc = nullptr)
 	{
@@ -803,16 +1118,14 @@ public:
 	{
 		ASSERT(lpszName);
 
-		BOOL isOK		= FALSE;
-		THeaderMapCI it = m_headers.find(lpszName);
+		LPCSTR lpszFound = m_headers.Get(lpszName);
 
-		if(it != m_headers.end())
-		{
-			*lpszValue	= it->second;
-			isOK		= TRUE;
-		}
+		if(lpszFound == nullptr)
+			return FALSE;
 
-		return isOK;
+		*lpszValue = lpszFound;
+
+		return TRUE;
 	}
 
 	BOOL GetHeaders(LPCSTR lpszName, LPCSTR lpszValue[], DWORD& dwCount)
@@ -821,23 +1134,11 @@ public:
 
 		if(lpszValue == nullptr || dwCount == 0)
 		{
-			dwCount = (DWORD)m_headers.count(lpszName);
+			dwCount = m_headers.GetValues(lpszName, nullptr, 0);
 			return FALSE;
 		}
 
-		pair<THeaderMapCI, THeaderMapCI> range = m_headers.equal_range(lpszName);
-
-		THeaderMapCI it	= range.first;
-		DWORD dwIndex	= 0;
-
-		while(it != range.second)
-		{
-			if(dwIndex < dwCount)
-				lpszValue[dwIndex] = it->second;
-
-			++dwIndex;
-			++it;
-		}
+		DWORD dwIndex = m_headers.GetValues(lpszName, lpszValue, dwCount);
 
 		BOOL isOK	= (dwIndex > 0 && dwIndex <= dwCount);
 		dwCount		= dwIndex;
@@ -847,7 +1148,7 @@ public:
 
 	BOOL GetAllHeaders(THeader lpHeaders[], DWORD& dwCount)
 	{
-		DWORD dwSize = (DWORD)m_headers.size();
+		DWORD dwSize = m_headers.Size();
 
 		if(lpHeaders == nullptr || dwCount == 0 || dwSize == 0 || dwSize > dwCount)
 		{
@@ -855,12 +1156,10 @@ public:
 			return FALSE;
 		}
 
-		DWORD dwIndex = 0;
-
-		for(THeaderMapCI it = m_headers.begin(), end = m_headers.end(); it != end; ++it, ++dwIndex)
+		for(DWORD dwIndex = 0; dwIndex < dwSize; dwIndex++)
 		{
-			lpHeaders[dwIndex].name  = it->first;
-			lpHeaders[dwIndex].value = it->second;
+			lpHeaders[dwIndex].name  = m_headers[dwIndex].name;
+			lpHeaders[dwIndex].value = m_headers[dwIndex].value;
 		}
 
 		dwCount = dwSize;
@@ -869,7 +1168,7 @@ public:
 
 	BOOL GetAllHeaderNames(LPCSTR lpszName[], DWORD& dwCount)
 	{
-		DWORD dwSize = (DWORD)m_headers.size();
+		DWORD dwSize = m_headers.Size();
 
 		if(lpszName == nullptr || dwCount == 0 || dwSize == 0 || dwSize > dwCount)
 		{
@@ -877,10 +1176,8 @@ public:
 			return FALSE;
 		}
 
-		DWORD dwIndex = 0;
-
-		for(THeaderMapCI it = m_headers.begin(), end = m_headers.end(); it != end; ++it, ++dwIndex)
-			lpszName[dwIndex] = it->first;
+		for(DWORD dwIndex = 0; dwIndex < dwSize; dwIndex++)
+			lpszName[dwIndex] = m_headers[dwIndex].name;
 
 		dwCount = dwSize;
 		return TRUE;
@@ -984,17 +1281,54 @@ public:
 		return m_pwsContext->GetMessageState(lpbFinal, lpiReserved, lpiOperationCode, lpszMask, lpullBodyLen, lpullBodyRemain);
 	}
 
+	/* ˣ WebSocket ׷ permessage-deflate Э */
+	void MakeWSDeflateOffer(const THeader lpHeaders[], int iHeaderCount, CStringA& strHeader)
+	{
+		m_bWSDeflate = m_pContext->GetWSDeflateMgr()->MakeOffer(lpHeaders, iHeaderCount, strHeader);
+	}
+
+	/*
+	* Ӧˣ 101 Ӧ׷ permessage-deflate ЭӦӦóָ Sec-WebSocket-Extensions ʱѹ
+	* 
+	* ֻͨЭӦѹӦóʽ磺Send() Ӧģ壩 101 Ӧʱѹ
+	*/
+	void MakeWSDeflateResponse(const THeader lpHeaders[], int iHeaderCount, CStringA& strHeader)
+	{
+		if(!m_bWSDeflate || m_bWSDeflateResponded)
+			return;
+
+		if(!m_pContext->GetWSDeflateMgr()->MakeResponse(m_wsDeflateParam, lpHeaders, iHeaderCount, strHeader))
+		{
+			m_bWSDeflate = FALSE;
+			return;
+		}
+
+		m_bWSDeflateResponded = TRUE;
+
+		if(m_pwsContext)
+			m_pwsContext->SetDeflateContext(new CWSDeflateContext(m_pContext->GetWSDeflateMgr(), m_wsDeflateParam));
+	}
+
+	CWSDeflateContext* GetWSDeflateContext()
+	{
+		return m_pwsContext ? m_pwsContext->GetDeflateContext() : nullptr;
+	}
+
 public:
 	THttpObjT			(BOOL bRequest, T* pContext, S* pSocket)
 	: m_pContext		(pContext)
 	, m_pSocket			(pSocket)
 	, m_bRequest		(bRequest)
 	, m_bReleased		(FALSE)
+	, m_lpszCurHeader	(nullptr)
+	, m_iCurHeaderLen	(0)
 	, m_dwFreeTime		(0)
 	, m_usUrlFieldSet	(m_bRequest ? 0 : -1)
 	, m_pstrUrlFileds	(nullptr)
 	, m_enUpgrade		(HUT_NONE)
 	, m_pwsContext		(nullptr)
+	, m_bWSDeflate		(FALSE)
+	, m_bWSDeflateResponded(FALSE)
 	{
 		if(m_bRequest)
 			m_pstrUrlFileds	  = new CStringA[HUF_MAX];
@@ -1027,6 +1361,8 @@ public:
 		ReleaseWSContext();
 
 		m_bReleased  = FALSE;
+		m_bWSDeflate = FALSE;
+		m_bWSDeflateResponded = FALSE;
 		m_enUpgrade  = HUT_NONE;
 		m_dwFreeTime = 0;
 	}
@@ -1050,7 +1386,7 @@ public:
 		m_parser		= src.m_parser;
 		m_parser.data	= p;
 
-		m_headers = src.m_headers;
+		m_headers.Copy(src.m_headers);
 		m_cookies = src.m_cookies;
 
 		if(m_bRequest)
@@ -1128,14 +1464,16 @@ private:
 		if(m_bRequest || bClearCookies)
 			DeleteAllCookies();
 			
-		m_headers.clear();
+		m_headers.Clear();
 		ResetHeaderBuffer();
 	}
 
 	void ResetHeaderBuffer()
 	{
 		ResetBuffer();
-		m_strCurHeader.Empty();
+
+		m_lpszCurHeader	= nullptr;
+		m_iCurHeaderLen	= 0;
 	}
 
 	void ReleaseWSContext()
@@ -1161,10 +1499,12 @@ private:
 	T*			m_pContext;
 	S*			m_pSocket;
 	http_parser	m_parser;
-	THeaderMap	m_headers;
 	TCookieMap	m_cookies;
 	CStringA	m_strBuffer;
-	CStringA	m_strCurHeader;
+
+	CHttpHeaderTable	m_headers;
+	LPCSTR				m_lpszCurHeader;
+	int					m_iCurHeaderLen;
 
 	union
 	{
@@ -1182,6 +1522,9 @@ private:
 	DWORD				m_dwFreeTime;
 
 	TWSContext<THttpObjT<T, S>>* m_pwsContext;
+	BOOL				m_bWSDeflate;
+	BOOL				m_bWSDeflateResponded;
+	TWSDeflateParam		m_wsDeflateParam;
 
 	static http_parser_settings sm_settings;
 };
@@ -1320,9 +1663,20 @@ extern CStringA& AdjustRequestPath(BOOL bConnect, LPCSTR lpszPath, CStringA& str
 extern LPCSTR GetHttpDefaultStatusCodeDesc(EnHttpStatusCode enCode);
 extern void MakeRequestLine(LPCSTR lpszMethod, LPCSTR lpszPath, EnHttpVersion enVersion, CStringA& strValue);
 extern void MakeStatusLine(EnHttpVersion enVersion, USHORT usStatusCode, LPCSTR lpszDesc, CStringA& strValue);
-extern void MakeHeaderLines(const THeader lpHeaders[], int iHeaderCount, const TCookieMap* pCookies, int iBodyLength, BOOL bRequest, int iConnFlag, LPCSTR lpszDefaultHost, USHORT usPort, CStringA& strValue);
+/* llBodyLength С 0 ʱ Content-Length ͷ 304 Ӧ */
+extern void MakeHeaderLines(const THeader lpHeaders[], int iHeaderCount, const TCookieMap* pCookies, LONGLONG llBodyLength, BOOL bRequest, int iConnFlag, LPCSTR lpszDefaultHost, USHORT usPort, CStringA& strValue);
 extern void MakeHttpPacket(const CStringA& strHeader, const BYTE* pBody, int iLength, WSABUF szBuffer[2]);
 extern BOOL MakeWSPacket(BOOL bFinal, BYTE iReserved, BYTE iOperationCode, const BYTE lpszMask[4], BYTE* pData, int iLength, ULONGLONG ullBodyLen, BYTE szHeader[HTTP_MAX_WS_HEADER_LEN], WSABUF szBuffer[2]);
 extern BOOL ParseUrl(const CStringA& strUrl, BOOL& bHttps, CStringA& strHost, USHORT& usPort, CStringA& strPath);
+/* Ӧģ壨״̬У */
+extern void MakeResponseTemplate(USHORT usStatusCode, LPCSTR lpszDesc, const THeader lpHeaders[], int iHeaderCount, THttpResponseTemplate& tpl);
+/*  HTTP 汾Ӧģ״̬к͹̶Ӧͷ */
+extern void CompileResponseTemplate(EnHttpVersion enVersion, THttpResponseTemplate& tpl);
+/* ӦģĿɱӦͷContent-LengthConnectionDate Уس */
+extern int MakeResponseTemplateTail(const THttpResponseTemplate& tpl, int iBodyLength, int iConnFlag, char szTail[HTTP_MAX_RESPONSE_TAIL_LEN]);
+/* ȡǰʱ HTTP Date ַÿ߳ÿһΣ */
+extern LPCSTR GetCachedHttpDateStr();
+/* ֽڷΧ Range ͷֵ1 -- ΧЧ0 -- Χ㣬-1 -- ʽЧ֧֣ӦԸͷ */
+extern int ParseHttpRange(LPCSTR lpszRange, LONGLONG llSize, LONGLONG& llOffset, LONGLONG& llLength);
 
 #endif
\ No newline at end of file
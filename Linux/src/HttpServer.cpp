@@ -37,7 +37,8 @@ template<class T, USHORT default_port> BOOL CHttpServerT<T, default_port>::Start
 template<class T, USHORT default_port> BOOL CHttpServerT<T, default_port>::CheckParams()
 {
 	if	((m_enLocalVersion != HV_1_1 && m_enLocalVersion != HV_1_0)								||
-		(m_dwReleaseDelay < MIN_HTTP_RELEASE_DELAY || m_dwReleaseDelay > MAX_HTTP_RELEASE_DELAY))
+		(m_dwReleaseDelay < MIN_HTTP_RELEASE_DELAY || m_dwReleaseDelay > MAX_HTTP_RELEASE_DELAY)	||
+		(!m_wsDeflateMgr.IsValidWindowBits()))
 	{
 		SetLastError(SE_INVALID_PARAM, __FUNCTION__, ERROR_INVALID_PARAMETER);
 		return FALSE;
@@ -55,6 +56,9 @@ template<class T, USHORT default_port> void CHttpServerT<T, default_port>::Prepa
 	m_objPool.SetHttpObjPoolHold(GetFreeSocketObjHold());
 
 	m_objPool.Prepare();
+
+	for(size_t i = 0; i < m_vtResponseTemplates.size(); i++)
+		::CompileResponseTemplate(m_enLocalVersion, m_vtResponseTemplates[i]);
 }
 
 template<class T, USHORT default_port> BOOL CHttpServerT<T, default_port>::SendResponse(CONNID dwConnID, USHORT usStatusCode, LPCSTR lpszDesc, const THeader lpHeaders[], int iHeaderCount, const BYTE* pData, int iLength)
@@ -63,26 +67,151 @@ template<class T, USHORT default_port> BOOL CHttpServerT<T, default_port>::SendR
 	CStringA strHeader;
 
 	::MakeStatusLine(m_enLocalVersion, usStatusCode, lpszDesc, strHeader);
+
+	if(usStatusCode == HSC_SWITCHING_PROTOCOLS)
+	{
+		THttpObj* pHttpObj = FindHttpObj(dwConnID);
+
+		if(pHttpObj != nullptr)
+			pHttpObj->MakeWSDeflateResponse(lpHeaders, iHeaderCount, strHeader);
+	}
+
 	::MakeHeaderLines(lpHeaders, iHeaderCount, nullptr, iLength, FALSE, IsKeepAlive(dwConnID), nullptr, 0, strHeader);
 	::MakeHttpPacket(strHeader, pData, iLength, szBuffer);
 
 	return SendPackets(dwConnID, szBuffer, 2);
 }
 
+template<class T, USHORT default_port> DWORD CHttpServerT<T, default_port>::RegisterResponseTemplate(USHORT usStatusCode, LPCSTR lpszDesc, const THeader lpHeaders[], int iHeaderCount)
+{
+	if(HasStarted())
+	{
+		::SetLastError(ERROR_INVALID_STATE);
+		return 0;
+	}
+
+	if(iHeaderCount < 0 || (iHeaderCount > 0 && lpHeaders == nullptr))
+	{
+		::SetLastError(ERROR_INVALID_PARAMETER);
+		return 0;
+	}
+
+	THttpResponseTemplate tpl;
+
+	::MakeResponseTemplate(usStatusCode, lpszDesc, lpHeaders, iHeaderCount, tpl);
+	::CompileResponseTemplate(m_enLocalVersion, tpl);
+
+	m_vtResponseTemplates.push_back(move(tpl));
+
+	return (DWORD)m_vtResponseTemplates.size();
+}
+
+template<class T, USHORT default_port> BOOL CHttpServerT<T, default_port>::SendTemplateResponse(CONNID dwConnID, DWORD dwTemplateID, const BYTE* pData, int iLength)
+{
+	if(dwTemplateID == 0 || dwTemplateID > (DWORD)m_vtResponseTemplates.size() || iLength < 0 || (pData == nullptr && iLength > 0))
+	{
+		::SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	const THttpResponseTemplate& tpl = m_vtResponseTemplates[dwTemplateID - 1];
+
+	char szTail[HTTP_MAX_RESPONSE_TAIL_LEN];
+	WSABUF szBuffer[3];
+
+	szBuffer[0].buf = (LPBYTE)(LPCSTR)tpl.header;
+	szBuffer[0].len = tpl.header.GetLength();
+	szBuffer[1].buf = (LPBYTE)szTail;
+	szBuffer[1].len = ::MakeResponseTemplateTail(tpl, iLength, IsKeepAlive(dwConnID), szTail);
+	szBuffer[2].buf = (LPBYTE)pData;
+	szBuffer[2].len = iLength;
+
+	return SendPackets(dwConnID, szBuffer, 3);
+}
+
 template<class T, USHORT default_port> BOOL CHttpServerT<T, default_port>::SendLocalFile(CONNID dwConnID, LPCSTR lpszFileName, USHORT usStatusCode, LPCSTR lpszDesc, const THeader lpHeaders[], int iHeaderCount)
 {
-	CFile file;
-	CFileMapping fmap;
+	struct stat st;
 
-	HRESULT hr = ::ReadSmallFile(CA2T(lpszFileName), file, fmap);
+	if(stat(CA2T(lpszFileName), &st) != 0)
+		return FALSE;
 
-	if(FAILED(hr))
+	if(!S_ISREG(st.st_mode))
 	{
-		::SetLastError(hr);
+		::SetLastError(ERROR_BAD_FILE_TYPE);
 		return FALSE;
 	}
 
-	return SendResponse(dwConnID, usStatusCode, lpszDesc, lpHeaders, iHeaderCount, (BYTE*)fmap, (int)fmap.Size());
+	LONGLONG llOffset = 0;
+	LONGLONG llLength = st.st_size;
+
+	CStringA strLastModified;
+	CStringA strContentRange;
+
+	if(usStatusCode == HSC_OK)
+	{
+		LPCSTR lpszValue = nullptr;
+		__time64_t tmSince;
+
+		strLastModified = CCookie::MakeHttpDateStr(st.st_mtime);
+
+		if(GetHeader(dwConnID, HTTP_HEADER_IF_MODIFIED_SINCE, &lpszValue) && CCookie::ParseExpires(lpszValue, tmSince) && st.st_mtime <= tmSince)
+		{
+			usStatusCode	= HSC_NOT_MODIFIED;
+			lpszDesc		= nullptr;
+			llLength		= 0;
+		}
+		else if(GetHeader(dwConnID, HTTP_HEADER_RANGE, &lpszValue))
+		{
+			int rs = ::ParseHttpRange(lpszValue, st.st_size, llOffset, llLength);
+
+			if(rs > 0)
+			{
+				usStatusCode = HSC_PARTIAL_CONTENT;
+				strContentRange.Format("%s %lld-%lld/%lld", HTTP_RANGE_UNIT_BYTES, llOffset, llOffset + llLength - 1, (LONGLONG)st.st_size);
+			}
+			else if(rs == 0)
+			{
+				usStatusCode = HSC_REQUESTED_RANGE_NOT_SATISFIABLE;
+				strContentRange.Format("%s */%lld", HTTP_RANGE_UNIT_BYTES, (LONGLONG)st.st_size);
+				llOffset	 = 0;
+				llLength	 = 0;
+			}
+
+			if(rs >= 0)
+				lpszDesc = nullptr;
+		}
+	}
+
+	int iCount = 0;
+	unique_ptr<THeader[]> headers(new THeader[iHeaderCount + 3]);
+
+	for(int i = 0; i < iHeaderCount; i++)
+		headers[iCount++] = lpHeaders[i];
+
+	if(!strLastModified.IsEmpty())
+	{
+		headers[iCount++] = {HTTP_HEADER_LAST_MODIFIED, (LPCSTR)strLastModified};
+		headers[iCount++] = {HTTP_HEADER_ACCEPT_RANGES, HTTP_RANGE_UNIT_BYTES};
+	}
+
+	if(!strContentRange.IsEmpty())
+		headers[iCount++] = {HTTP_HEADER_CONTENT_RANGE, (LPCSTR)strContentRange};
+
+	CStringA strHeader;
+
+	::MakeStatusLine(m_enLocalVersion, usStatusCode, lpszDesc, strHeader);
+	/* 304 响应不带消息体，也不能带 Content-Length 头 */
+	::MakeHeaderLines(headers.get(), iCount, nullptr, usStatusCode == HSC_NOT_MODIFIED ? -1 : llLength, FALSE, IsKeepAlive(dwConnID), nullptr, 0, strHeader);
+
+	WSABUF bufHeader;
+	bufHeader.len = strHeader.GetLength();
+	bufHeader.buf = (LPBYTE)(LPCSTR)strHeader;
+
+	if(llLength == 0)
+		return SendPackets(dwConnID, &bufHeader, 1);
+
+	return SendFile(dwConnID, CA2T(lpszFileName), llOffset, llLength, &bufHeader, nullptr);
 }
 
 template<class T, USHORT default_port> BOOL CHttpServerT<T, default_port>::Release(CONNID dwConnID)
@@ -107,8 +236,28 @@ template<class T, USHORT default_port> BOOL CHttpServerT<T, default_port>::SendW
 	WSABUF szBuffer[2];
 	BYTE szHeader[HTTP_MAX_WS_HEADER_LEN];
 
-	if(!::MakeWSPacket(bFinal, iReserved, iOperationCode, lpszMask, pData, iLength, ullBodyLen, szHeader, szBuffer))
-		return FALSE;
+	THttpObj* pHttpObj			= FindHttpObj(dwConnID);
+	CWSDeflateContext* pDeflate	= pHttpObj != nullptr ? pHttpObj->GetWSDeflateContext() : nullptr;
+
+	if(pDeflate == nullptr)
+	{
+		if(!::MakeWSPacket(bFinal, iReserved, iOperationCode, lpszMask, pData, iLength, ullBodyLen, szHeader, szBuffer))
+			return FALSE;
+
+		return SendPackets(dwConnID, szBuffer, 2);
+	}
+
+	CBufferPtr buffer;
+
+	{
+		CCriSecLock locallock(pDeflate->GetLock());
+
+		if(!pDeflate->DeflateFrame(bFinal, iReserved, iOperationCode, pData, iLength, ullBodyLen, buffer))
+			return FALSE;
+
+		if(!::MakeWSPacket(bFinal, iReserved, iOperationCode, lpszMask, pData, iLength, ullBodyLen, szHeader, szBuffer))
+			return FALSE;
+	}
 
 	return SendPackets(dwConnID, szBuffer, 2);
 }
@@ -263,6 +412,7 @@ template<class T, USHORT default_port> EnHandleResult CHttpServerT<T, default_po
 	EnHandleResult result = __super::DoFireShutdown();
 
 	m_objPool.Clear();
+	m_wsDeflateMgr.Clear();
 	WaitForCleanerThreadEnd();
 
 	return result;
@@ -39,6 +39,7 @@ template<class T, USHORT default_port> class CHttpServerT : public IComplexHttpR
 public:
 	using __super::Stop;
 	using __super::SendPackets;
+	using __super::SendFile;
 	using __super::Disconnect;
 	using __super::HasStarted;
 	using __super::GetFreeSocketObjLockTime;
@@ -61,6 +62,9 @@ public:
 	virtual BOOL SendResponse(CONNID dwConnID, USHORT usStatusCode, LPCSTR lpszDesc = nullptr, const THeader lpHeaders[] = nullptr, int iHeaderCount = 0, const BYTE* pData = nullptr, int iLength = 0);
 	virtual BOOL SendLocalFile(CONNID dwConnID, LPCSTR lpszFileName, USHORT usStatusCode = HSC_OK, LPCSTR lpszDesc = nullptr, const THeader lpHeaders[] = nullptr, int iHeaderCount = 0);
 
+	virtual DWORD RegisterResponseTemplate(USHORT usStatusCode, LPCSTR lpszDesc = nullptr, const THeader lpHeaders[] = nullptr, int iHeaderCount = 0);
+	virtual BOOL SendTemplateResponse(CONNID dwConnID, DWORD dwTemplateID, const BYTE* pData = nullptr, int iLength = 0);
+
 	virtual BOOL Release(CONNID dwConnID);
 
 	virtual BOOL SendWSMessage(CONNID dwConnID, BOOL bFinal, BYTE iReserved, BYTE iOperationCode, const BYTE lpszMask[4] = nullptr, BYTE* pData = nullptr, int iLength = 0, ULONGLONG ullBodyLen = 0);
@@ -73,6 +77,13 @@ public:
 	virtual EnHttpVersion GetLocalVersion	()	{return m_enLocalVersion;}
 	virtual DWORD GetReleaseDelay			()	{return m_dwReleaseDelay;}
 
+	virtual void SetWSDeflate(BOOL bDeflate)					{m_wsDeflateMgr.SetEnabled(bDeflate);}
+	virtual BOOL IsWSDeflate()									{return m_wsDeflateMgr.IsEnabled();}
+	virtual void SetWSDeflateWindowBits(int iWindowBits)		{m_wsDeflateMgr.SetWindowBits(iWindowBits);}
+	virtual int GetWSDeflateWindowBits()						{return m_wsDeflateMgr.GetWindowBits();}
+	virtual void SetWSDeflateContextTakeover(BOOL bContextTakeover)	{m_wsDeflateMgr.SetContextTakeover(bContextTakeover);}
+	virtual BOOL IsWSDeflateContextTakeover()					{return m_wsDeflateMgr.IsContextTakeover();}
+
 	virtual BOOL IsUpgrade(CONNID dwConnID);
 	virtual BOOL IsKeepAlive(CONNID dwConnID);
 	virtual USHORT GetVersion(CONNID dwConnID);
@@ -144,6 +155,7 @@ private:
 	inline THttpObj* FindHttpObj(TSocketObj* pSocketObj);
 
 	CCookieMgr* GetCookieMgr()						{return nullptr;}
+	CWSDeflateMgr* GetWSDeflateMgr()				{return &m_wsDeflateMgr;}
 	LPCSTR GetRemoteDomain(TSocketObj* pSocketObj)	{return nullptr;}
 
 private:
@@ -179,7 +191,10 @@ private:
 
 	CCASQueue<TDyingConnection>	m_lsDyingQueue;
 
+	CWSDeflateMgr				m_wsDeflateMgr;
 	CHttpObjPool				m_objPool;
+
+	vector<THttpResponseTemplate>	m_vtResponseTemplates;
 };
 
 // ------------------------------------------------------------------------------------------------------------- //
@@ -28,9 +28,11 @@
 /* Pack Data Info */
 template<typename B = void> struct TPackInfo
 {
-	bool	header;
-	DWORD	length;
-	B*		pBuffer;
+	bool		header;
+	DWORD		length;
+	B*			pBuffer;
+	/* 跨越多次接收的包体的组装缓冲区（连接内重复使用） */
+	CBufferPtr	frame;
 
 	static TPackInfo* Construct(B* pbuf = nullptr, bool head = true, DWORD len = sizeof(DWORD))
 	{
@@ -90,68 +92,141 @@ template<class B> EnFetchResult PeekBuffer(B* pBuffer, BYTE* pData, int iLength)
 	return result;
 }
 
+template<class B> BOOL ParsePackHeader(TPackInfo<B>* pInfo, DWORD header, DWORD dwMaxPackSize, USHORT usPackHeaderFlag)
+{
+	if(usPackHeaderFlag != 0)
+	{
+		USHORT flag = (USHORT)(header >> TCP_PACK_LENGTH_BITS);
+
+		if(flag != usPackHeaderFlag)
+		{
+			::SetLastError(ERROR_INVALID_DATA);
+			return FALSE;
+		}
+	}
+
+	DWORD len = header & TCP_PACK_LENGTH_MASK;
+
+	if(len == 0 || len > dwMaxPackSize)
+	{
+		::SetLastError(ERROR_BAD_LENGTH);
+		return FALSE;
+	}
+
+	pInfo->header = false;
+	pInfo->length = len;
+
+	return TRUE;
+}
+
+/* 解析连接缓冲区中的数据（包体被拷贝到连接的组装缓冲区后再触发 OnReceive） */
 template<class T, class B, class S> EnHandleResult ParsePack(T* pThis, TPackInfo<B>* pInfo, B* pBuffer, S* pSocket, DWORD dwMaxPackSize, USHORT usPackHeaderFlag)
 {
 	EnHandleResult rs = HR_OK;
 
-	int required = pInfo->length;
-	int remain	 = pBuffer->Length();
-
-	while(remain >= required)
+	while(pBuffer->Length() >= (int)pInfo->length)
 	{
 		if(pSocket->IsPaused())
 			break;
 
-		remain -= required;
-		CBufferPtr buffer(required);
-
-		pBuffer->Fetch(buffer, (int)buffer.Size());
+		int required = (int)pInfo->length;
 
 		if(pInfo->header)
 		{
-			DWORD header = *((DWORD*)(BYTE*)buffer);
+			DWORD header;
+			pBuffer->Fetch((BYTE*)&header, sizeof(DWORD));
 
-			if(usPackHeaderFlag != 0)
-			{
-				USHORT flag = (USHORT)(header >> TCP_PACK_LENGTH_BITS);
-
-				if(flag != usPackHeaderFlag)
-				{
-					::SetLastError(ERROR_INVALID_DATA);
-					return HR_ERROR;
-				}
-			}
-
-			DWORD len = header & TCP_PACK_LENGTH_MASK;
-
-			if(len == 0 || len > dwMaxPackSize)
-			{
-				::SetLastError(ERROR_BAD_LENGTH);
+			if(!ParsePackHeader(pInfo, header, dwMaxPackSize, usPackHeaderFlag))
 				return HR_ERROR;
-			}
-
-			required = len;
 		}
 		else
 		{
-			rs = pThis->DoFireSuperReceive(pSocket, (const BYTE*)buffer, (int)buffer.Size());
+			CBufferPtr buffer;
+			CBufferPtr& frame = (required <= TCP_PACK_MAX_CACHED_FRAME_SIZE) ? pInfo->frame : buffer;
+
+			if((int)frame.Size() < required)
+				frame.Realloc(required);
+
+			pBuffer->Fetch(frame, required);
+
+			rs = pThis->DoFireSuperReceive(pSocket, (const BYTE*)frame, required);
 
 			if(rs == HR_ERROR)
 				return rs;
 
-			required = sizeof(DWORD);
+			pInfo->header = true;
+			pInfo->length = sizeof(DWORD);
 		}
-
-		pInfo->header = !pInfo->header;
-		pInfo->length = required;
 	}
 
 	return rs;
 }
 
+/* 解析新接收的数据：已完整位于 pData 中的包直接原地触发 OnReceive，只有跨越多次接收的包才进入连接缓冲区 */
 template<class T, class B, class S> EnHandleResult ParsePack(T* pThis, TPackInfo<B>* pInfo, B* pBuffer, S* pSocket, DWORD dwMaxPackSize, USHORT usPackHeaderFlag, const BYTE* pData, int iLength)
 {
-	pBuffer->Cat(pData, iLength);
+	EnHandleResult rs = HR_OK;
+
+	if(pBuffer->Length() > 0)
+	{
+		int required = (int)pInfo->length - pBuffer->Length();
+
+		if(required > iLength || required <= 0 || pSocket->IsPaused())
+		{
+			pBuffer->Cat(pData, iLength);
+
+			return (required <= iLength) ? ParsePack(pThis, pInfo, pBuffer, pSocket, dwMaxPackSize, usPackHeaderFlag) : rs;
+		}
 
-	return ParsePack(pThis, pInfo, pBuffer, pSocket, dwMaxPackSize, usPackHeaderFlag);
+		pBuffer->Cat(pData, required);
+
+		pData	+= required;
+		iLength	-= required;
+
+		rs = ParsePack(pThis, pInfo, pBuffer, pSocket, dwMaxPackSize, usPackHeaderFlag);
+
+		if(rs == HR_ERROR)
+			return rs;
+
+		if(pBuffer->Length() > 0)
+		{
+			pBuffer->Cat(pData, iLength);
+			return rs;
+		}
+	}
+
+	while(iLength >= (int)pInfo->length)
+	{
+		if(pSocket->IsPaused())
+			break;
+
+		int required = (int)pInfo->length;
+
+		if(pInfo->header)
+		{
+			DWORD header;
+			memcpy(&header, pData, sizeof(DWORD));
+
+			if(!ParsePackHeader(pInfo, header, dwMaxPackSize, usPackHeaderFlag))
+				return HR_ERROR;
+		}
+		else
+		{
+			rs = pThis->DoFireSuperReceive(pSocket, pData, required);
+
+			if(rs == HR_ERROR)
+				return rs;
+
+			pInfo->header = true;
+			pInfo->length = sizeof(DWORD);
+		}
+
+		pData	+= required;
+		iLength	-= required;
+	}
+
+	if(iLength > 0)
+		pBuffer->Cat(pData, iLength);
+
+	return rs;
 }
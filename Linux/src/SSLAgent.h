@@ -35,6 +35,10 @@ class CSSLAgent : public CTcpAgent
 public:
 	virtual BOOL IsSecure() {return TRUE;}
 	virtual BOOL SendPackets(CONNID dwConnID, const WSABUF pBuffers[], int iCount);
+	virtual BOOL SendFile(CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset = 0, LONGLONG llLength = 0, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr);
+	virtual BOOL BroadcastPackets(const CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount);
+	virtual BOOL SendReference(CONNID dwConnID, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam = nullptr)
+		{return ::ReleaseSendReference(Send(dwConnID, pBuffer, iLength), pBuffer, iLength, fnRelease, pvParam);}
 
 	virtual BOOL SetupSSLContext(int iVerifyMode = SSL_VM_NONE, LPCTSTR lpszPemCertFile = nullptr, LPCTSTR lpszPemKeyFile = nullptr, LPCTSTR lpszKeyPasswod = nullptr, LPCTSTR lpszCAPemCertFileOrPath = nullptr)
 		{return m_sslCtx.Initialize(SSL_SM_CLIENT, iVerifyMode, lpszPemCertFile, lpszPemKeyFile, lpszKeyPasswod, lpszCAPemCertFileOrPath, nullptr);}
@@ -58,6 +62,7 @@ protected:
 	virtual void Reset();
 
 	virtual void OnWorkerThreadEnd(DWORD dwThreadID);
+	virtual BOOL IsHandShaked(TAgentSocketObj* pSocketObj);
 
 private:
 	void StartSSLHandShake(TAgentSocketObj* pSocketObj);
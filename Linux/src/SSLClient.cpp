@@ -68,12 +68,36 @@ BOOL CSSLClient::SendPackets(const WSABUF pBuffers[], int iCount)
 {
 	ASSERT(pBuffers && iCount > 0);
 
+	if(!CheckSendQuota())
+		return FALSE;
+
 	if(m_sslSession.IsValid())
 		return ::ProcessSend(this, this, &m_sslSession, pBuffers, iCount);
 	else
 		return DoSendPackets(this, pBuffers, iCount);
 }
 
+BOOL CSSLClient::SendFile(LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	if(!m_sslSession.IsValid())
+		return __super::SendFile(lpszFileName, llOffset, llLength, pHead, pTail);
+
+	/* SSL 连接的数据需要加密后发送，无法使用 sendfile() */
+	CFile file;
+	CFileMapping fmap;
+	WSABUF szBuf[3];
+
+	HRESULT hr = ::MakeFileRegionPackage(lpszFileName, file, fmap, llOffset, llLength, szBuf, pHead, pTail);
+
+	if(FAILED(hr))
+	{
+		::SetLastError(hr);
+		return FALSE;
+	}
+
+	return SendPackets(szBuf, 3);
+}
+
 EnHandleResult CSSLClient::FireConnect()
 {
 	EnHandleResult result = DoFireConnect(this);
@@ -35,6 +35,9 @@ class CSSLClient : public CTcpClient
 public:
 	virtual BOOL IsSecure() {return TRUE;}
 	virtual BOOL SendPackets(const WSABUF pBuffers[], int iCount);
+	virtual BOOL SendFile(LPCTSTR lpszFileName, LONGLONG llOffset = 0, LONGLONG llLength = 0, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr);
+	virtual BOOL SendReference(const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam = nullptr)
+		{return ::ReleaseSendReference(Send(pBuffer, iLength), pBuffer, iLength, fnRelease, pvParam);}
 
 	virtual BOOL SetupSSLContext(int iVerifyMode = SSL_VM_NONE, LPCTSTR lpszPemCertFile = nullptr, LPCTSTR lpszPemKeyFile = nullptr, LPCTSTR lpszKeyPasswod = nullptr, LPCTSTR lpszCAPemCertFileOrPath = nullptr)
 		{return m_sslCtx.Initialize(SSL_SM_CLIENT, iVerifyMode, lpszPemCertFile, lpszPemKeyFile, lpszKeyPasswod, lpszCAPemCertFileOrPath, nullptr);}
@@ -78,6 +81,7 @@ public:
 	virtual ~CSSLClient()
 	{
 		Stop();
+		WaitForStop();
 	}
 
 private:
@@ -77,6 +77,9 @@ BOOL CSSLServer::SendPackets(CONNID dwConnID, const WSABUF pBuffers[], int iCoun
 		return FALSE;
 	}
 
+	if(!CheckSendQuota(pSocketObj))
+		return FALSE;
+
 	CSSLSession* pSession = nullptr;
 	GetConnectionReserved2(pSocketObj, (PVOID*)&pSession);
 
@@ -86,6 +89,57 @@ BOOL CSSLServer::SendPackets(CONNID dwConnID, const WSABUF pBuffers[], int iCoun
 		return DoSendPackets(pSocketObj, pBuffers, iCount);
 }
 
+BOOL CSSLServer::SendFile(CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	TSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(!TSocketObj::IsValid(pSocketObj))
+	{
+		::SetLastError(ERROR_OBJECT_NOT_FOUND);
+		return FALSE;
+	}
+
+	CSSLSession* pSession = nullptr;
+	GetConnectionReserved2(pSocketObj, (PVOID*)&pSession);
+
+	if(pSession == nullptr)
+		return __super::SendFile(dwConnID, lpszFileName, llOffset, llLength, pHead, pTail);
+
+	/* SSL 连接的数据需要加密后发送，无法使用 sendfile() */
+	CFile file;
+	CFileMapping fmap;
+	WSABUF szBuf[3];
+
+	HRESULT hr = ::MakeFileRegionPackage(lpszFileName, file, fmap, llOffset, llLength, szBuf, pHead, pTail);
+
+	if(FAILED(hr))
+	{
+		::SetLastError(hr);
+		return FALSE;
+	}
+
+	return SendPackets(dwConnID, szBuf, 3);
+}
+
+BOOL CSSLServer::BroadcastPackets(const CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount)
+{
+	ASSERT(pConnIDs && iConnCount > 0);
+
+	/* SSL 连接的数据需要逐个连接加密，无法共享发送数据 */
+	int result = NO_ERROR;
+
+	for(int i = 0; i < iConnCount; i++)
+	{
+		if(!CSSLServer::SendPackets(pConnIDs[i], pBuffers, iCount))
+			result = ::GetLastError();
+	}
+
+	if(result != NO_ERROR)
+		::SetLastError(result);
+
+	return (result == NO_ERROR);
+}
+
 EnHandleResult CSSLServer::FireAccept(TSocketObj* pSocketObj)
 {
 	EnHandleResult result = DoFireAccept(pSocketObj);
@@ -129,6 +183,14 @@ EnHandleResult CSSLServer::FireShutdown()
 	return result;
 }
 
+BOOL CSSLServer::IsHandShaked(TSocketObj* pSocketObj)
+{
+	CSSLSession* pSession = nullptr;
+	GetConnectionReserved2(pSocketObj, (PVOID*)&pSession);
+
+	return pSession != nullptr && pSession->IsReady();
+}
+
 BOOL CSSLServer::StartSSLHandShake(CONNID dwConnID)
 {
 	TSocketObj* pSocketObj = FindSocketObj(dwConnID);
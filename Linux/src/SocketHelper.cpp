@@ -27,6 +27,7 @@
 #include <arpa/inet.h>
 #include <netinet/tcp.h>
 #include <netinet/udp.h>
+#include <linux/filter.h>
 
 #ifdef _ICONV_SUPPORT
 #include <iconv.h>
@@ -434,6 +435,91 @@ HRESULT MakeSmallFilePackage(LPCTSTR lpszFileName, CFile& file, CFileMapping& fm
 	return hr;
 }
 
+HRESULT OpenFileRegion(LPCTSTR lpszFileName, CFile& file, LONGLONG& llOffset, LONGLONG& llLength, const LPWSABUF pHead, const LPWSABUF pTail, LONGLONG llMaxSize)
+{
+	ASSERT(lpszFileName != nullptr);
+
+	if(llOffset < 0 || llLength < 0)
+		return ERROR_INVALID_PARAMETER;
+
+	if(file.Open(lpszFileName, O_RDONLY))
+	{
+		struct stat st;
+		if(file.Stat(st))
+		{
+			if(!S_ISREG(st.st_mode))
+				::SetLastError(ERROR_BAD_FILE_TYPE);
+			else if(llOffset > st.st_size || llLength > st.st_size - llOffset)
+				::SetLastError(ERROR_INVALID_PARAMETER);
+			else
+			{
+				if(llLength == 0)
+					llLength = st.st_size - llOffset;
+
+				LONGLONG llTotal = llLength + (pHead ? pHead->len : 0) + (pTail ? pTail->len : 0);
+
+				if(llTotal == 0)
+					::SetLastError(ERROR_EMPTY);
+				else if(llTotal > llMaxSize)
+					::SetLastError(ERROR_FILE_TOO_LARGE);
+				else
+					return NO_ERROR;
+			}
+		}
+	}
+
+	HRESULT rs = ::GetLastError();
+
+	return (!IS_NO_ERROR(rs) ? rs : ERROR_UNKNOWN);
+}
+
+HRESULT MakeFileRegionPackage(LPCTSTR lpszFileName, CFile& file, CFileMapping& fmap, LONGLONG llOffset, LONGLONG llLength, WSABUF szBuf[3], const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	HRESULT hr = OpenFileRegion(lpszFileName, file, llOffset, llLength, pHead, pTail, MAX_SMALL_FILE_SIZE);
+
+	if(!IS_NO_ERROR(hr))
+		return hr;
+
+	memset(&szBuf[1], 0, sizeof(WSABUF));
+
+	if(llLength > 0)
+	{
+		/* 映射偏移必须按页对齐 */
+		LONGLONG llAligned	= llOffset & ~((LONGLONG)SysGetPageSize() - 1);
+		SIZE_T dwDelta		= (SIZE_T)(llOffset - llAligned);
+
+		if(!fmap.Map(file, (SIZE_T)llLength + dwDelta, (SIZE_T)llAligned))
+		{
+			hr = ::GetLastError();
+			return (!IS_NO_ERROR(hr) ? hr : ERROR_UNKNOWN);
+		}
+
+		szBuf[1].len = (UINT)llLength;
+		szBuf[1].buf = fmap.Ptr() + dwDelta;
+	}
+
+	if(pHead) memcpy(&szBuf[0], pHead, sizeof(WSABUF));
+	else	  memset(&szBuf[0], 0, sizeof(WSABUF));
+
+	if(pTail) memcpy(&szBuf[2], pTail, sizeof(WSABUF));
+	else	  memset(&szBuf[2], 0, sizeof(WSABUF));
+
+	return NO_ERROR;
+}
+
+BOOL ReleaseSendReference(BOOL bSent, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam)
+{
+	if(fnRelease != nullptr)
+	{
+		int code = bSent ? NO_ERROR : ::GetLastError();
+		fnRelease(pBuffer, iLength, pvParam, bSent);
+
+		if(!bSent) ::SetLastError(code);
+	}
+
+	return bSent;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int SSO_SetSocketOption(SOCKET sock, int level, int name, LPVOID val, int len)
@@ -511,6 +597,29 @@ int SSO_ReuseAddress(SOCKET sock, BOOL bReuse)
 	return setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &val, sizeof(int));
 }
 
+int SSO_ReusePort(SOCKET sock, BOOL bReuse)
+{
+	int val = bReuse ? 1 : 0;
+	return setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &val, sizeof(int));
+}
+
+int SSO_ReusePortCpuSteering(SOCKET sock, int iGroupSize)
+{
+	ASSERT(iGroupSize > 0);
+
+	/* 返回值为 SO_REUSEPORT 组内 Socket 的序号（按 bind / listen 的先后顺序）：cpu % iGroupSize */
+	sock_filter code[] =
+	{
+		{BPF_LD  | BPF_W | BPF_ABS,	0, 0, (UINT)(SKF_AD_OFF + SKF_AD_CPU)},
+		{BPF_ALU | BPF_MOD | BPF_K,	0, 0, (UINT)iGroupSize},
+		{BPF_RET | BPF_A,			0, 0, 0}
+	};
+
+	sock_fprog prog = {(USHORT)ARRAY_SIZE(code), code};
+
+	return setsockopt(sock, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+}
+
 int SSO_RecvBuffSize(SOCKET sock, int size)
 {
 	return setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &size, sizeof(int));
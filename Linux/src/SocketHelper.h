@@ -30,11 +30,13 @@
 #include "common/BufferPtr.h"
 #include "common/BufferPool.h"
 #include "common/RingBuffer.h"
+#include "common/TimingWheel.h"
 #include "common/FileHelper.h"
 
 #include <netdb.h>
 #include <sys/un.h>
 #include <sys/socket.h>
+#include <limits.h>
 #include <arpa/inet.h>
 
 #ifdef _ZLIB_SUPPORT
@@ -57,12 +59,22 @@ using SOCKADDR_IN6		= sockaddr_in6;
 #define MIN_SOCKET_BUFFER_SIZE					8
 /* 小文件最大字节数 */
 #define MAX_SMALL_FILE_SIZE						0x3FFFFF
+/* 发送队列的最大字节数（SendFile() 的头部、尾部附加数据和文件区域的当前窗口都计入，受发送缓冲区 32 位长度的限制） */
+#define MAX_SEND_FILE_SIZE						MAXINT
 /* 最大连接时长 */
 #define MAX_CONNECTION_PERIOD					(MAXINT / 2)
 /* 处理接收事件时最大读取次数 */
 #define MAX_CONTINUE_READS						30
 /* 处理发送事件时最大写入次数 */
 #define MAX_CONTINUE_WRITES						50
+/* 每次批量发送（writev）的最大数据块数量 */
+#define MAX_SEND_IOV_COUNT						IOV_MAX
+/* io_uring 模式下每个发送请求的最大数据块数量 */
+#define MAX_URING_SEND_IOV_COUNT				32
+/* io_uring 模式下每个分片的接收缓冲区环容量（必须是 2 的幂） */
+#define URING_RECV_BUFFER_COUNT					256
+/* UDP 每次批量收发（recvmmsg/sendmmsg）的最大数据报数量 */
+#define MAX_UDP_BATCH_COUNT						64
 
 /* 默认工作队列等待的最大描述符事件数量 */
 #define DEFAULT_WORKER_MAX_EVENT_COUNT			CIODispatcher::DEF_WORKER_MAX_EVENTS
@@ -79,6 +91,8 @@ using SOCKADDR_IN6		= sockaddr_in6;
 #define DEFAULT_FREE_BUFFEROBJ_POOL				1200
 /* Server/Agent 默认内存块缓存池回收阀值 */
 #define DEFAULT_FREE_BUFFEROBJ_HOLD				1200
+/* Server/Agent 内存块缓存池每个线程缓存槽的容量 */
+#define DEFAULT_FREE_BUFFEROBJ_CACHE			32
 /* Client 默认内存块缓存池大小 */
 #define DEFAULT_CLIENT_FREE_BUFFER_POOL_SIZE	60
 /* Client 默认内存块缓存池回收阀值 */
@@ -97,10 +111,17 @@ using SOCKADDR_IN6		= sockaddr_in6;
 /* TCP Server 默认 Listen 队列大小 */
 #define DEFAULT_TCP_SERVER_SOCKET_LISTEN_QUEUE	SOMAXCONN
 
+/* Server/Agent 默认定时器刻度间隔 */
+#define DEFAULT_TIMER_INTERVAL					100
+
 /* UDP 默认数据报文最大长度 */
 #define DEFAULT_UDP_MAX_DATAGRAM_SIZE			1472
 /* UDP 默认 Receive 预投递数量 */
 #define DEFAULT_UDP_POST_RECEIVE_COUNT			DEFAULT_WORKER_MAX_EVENT_COUNT
+/* UDP 默认每次批量接收的数据报数量（1 则逐个 recvfrom） */
+#define DEFAULT_UDP_RECEIVE_BATCH_COUNT			1
+/* UDP 默认每次批量发送的数据报数量（1 则逐个 sendto） */
+#define DEFAULT_UDP_SEND_BATCH_COUNT			1
 /* UDP 默认监测包尝试次数 */
 #define DEFAULT_UDP_DETECT_ATTEMPTS				3
 /* UDP 默认监测包发送间隔 */
@@ -118,6 +139,8 @@ using SOCKADDR_IN6		= sockaddr_in6;
 #define TCP_PACK_HEADER_FLAG_LIMIT				0x0003FF
 /* TCP Pack 包头默认标识值 */
 #define TCP_PACK_DEFAULT_HEADER_FLAG			0x000000
+/* TCP Pack 跨越多次接收的包体的组装缓冲区缓存上限（超过则临时分配） */
+#define TCP_PACK_MAX_CACHED_FRAME_SIZE			0x004000
 
 #define PORT_SEPARATOR_CHAR						':'
 #define IPV6_ADDR_BEGIN_CHAR					'['
@@ -301,7 +324,9 @@ enum EnDispCmdType
 	DISP_CMD_SEND		= 0x01,	// 发送数据
 	DISP_CMD_RECEIVE	= 0x02,	// 接收数据
 	DISP_CMD_UNPAUSE	= 0x03,	// 恢复接收数据
-	DISP_CMD_DISCONNECT	= 0x04	// 断开连接
+	DISP_CMD_DISCONNECT	= 0x04,	// 断开连接
+	DISP_CMD_IO			= 0x05,	// 处理挂起的 IO 事件
+	DISP_CMD_DETACH		= 0x06	// 解除注册（共享 Reactor）
 };
 
 /* 关闭连接标识 */
@@ -326,18 +351,41 @@ typedef TReceiveBufferMap::iterator			TReceiveBufferMapI;
 /* 线程 ID - 接收缓冲区哈希表 const 迭代器 */
 typedef TReceiveBufferMap::const_iterator	TReceiveBufferMapCI;
 
+/* 线程 ID - 可分离接收数据块哈希表（值为工作线程当前用于接收的数据块，分离后置为 nullptr） */
+typedef unordered_map<THR_ID, TItem*>		TReceiveItemMap;
+/* 线程 ID - 可分离接收数据块哈希表迭代器 */
+typedef TReceiveItemMap::iterator			TReceiveItemMapI;
+
+/* 连接定时器（系统定时器负责连接时长、静默和握手超时检测，fnTimer 为空；用户定时器由 SetConnectionTimer() 设置） */
+struct TConnTimer : public TTimerNode
+{
+	CONNID				connID;
+	Fn_ConnectionTimer	fnTimer;
+	PVOID				pvParam;
+
+	TConnTimer() : connID(0), fnTimer(nullptr), pvParam(nullptr) {}
+};
+
+/* 连接定时轮 */
+typedef CTimingWheelT<TConnTimer>			CConnTimingWheel;
+/* 到期的连接定时器列表 */
+typedef vector<TConnTimer>					TConnTimerList;
+
 /* Socket 缓冲区基础结构 */
 struct TSocketObjBase
 {
-	CPrivateHeap& heap;
+	/*
+	* 字段按访问方式分组：
+	* 1、首个缓存行：收发路径上频繁读取而很少修改的字段
+	* 2、其后：较少访问的字段（地址、定时器等），activeTime 由接收线程修改，放在这里以免影响首个缓存行
+	* 3、派生类把接收线程和发送线程各自修改的字段分别放在独立的缓存行中（对象按缓存行对齐分配）
+	*/
 
 	CONNID		connID;
-	HP_SOCKADDR	remoteAddr;
-	PVOID		extra;
-	PVOID		reserved;
-	PVOID		reserved2;
 	BOOL		valid;
-	DWORD		activeTime;
+
+	volatile BOOL connected;
+	volatile BOOL paused;
 
 	union
 	{
@@ -345,11 +393,37 @@ struct TSocketObjBase
 		DWORD	connTime;
 	};
 
-	volatile BOOL connected;
-	volatile BOOL paused;
+	PVOID		extra;
+	PVOID		reserved;
+	PVOID		reserved2;
+
+	CPrivateHeap& heap;
+
+	HP_SOCKADDR	remoteAddr;
+	DWORD		activeTime;
+
+	TConnTimer	sysTimer;
+	TConnTimer	userTimer;
 
 	TSocketObjBase(CPrivateHeap& hp) : heap(hp) {}
 
+	/* 从私有堆分配按缓存行对齐的内存（私有堆只保证基本对齐），btOffset 返回对齐地址相对于内存块起始地址的偏移 */
+	static PVOID AllocAligned(CPrivateHeap& hp, SIZE_T dwSize, BYTE& btOffset)
+	{
+		BYTE* pv = (BYTE*)hp.Alloc(dwSize + CACHE_LINE - alignof(max_align_t));
+		ASSERT(pv && ((UINT_PTR)pv & (alignof(max_align_t) - 1)) == 0);
+
+		BYTE* pvAligned	= (BYTE*)(((UINT_PTR)pv + CACHE_LINE - 1) & ~(UINT_PTR)(CACHE_LINE - 1));
+		btOffset		= (BYTE)(pvAligned - pv);
+
+		return pvAligned;
+	}
+
+	static void FreeAligned(CPrivateHeap& hp, PVOID pv, BYTE btOffset)
+	{
+		hp.Free((BYTE*)pv - btOffset);
+	}
+
 	static BOOL IsExist(TSocketObjBase* pSocketObj)
 		{return pSocketObj != nullptr;}
 
@@ -370,8 +444,43 @@ struct TSocketObjBase
 	BOOL HasConnected()							{return connected;}
 	void SetConnected(BOOL bConnected = TRUE)	{connected = bConnected;}
 
+	/* 检测连接是否超时（周期为 0 的项不检测），未超时则通过 dwRemain 返回距离最近超时点的时间（0 表示无需再检测） */
+	BOOL IsTimeout(DWORD dwMaxConnectPeriod, DWORD dwSilenceTimeout, DWORD dwHandShakeTimeout, DWORD& dwRemain) const
+	{
+		DWORD now	= ::TimeGetTime();
+		dwRemain	= 0;
+
+		return	CheckTimeout(connTime, dwMaxConnectPeriod, now, dwRemain)	||
+				CheckTimeout(activeTime, dwSilenceTimeout, now, dwRemain)	||
+				CheckTimeout(connTime, dwHandShakeTimeout, now, dwRemain)	;
+	}
+
+	/* 检测从 dwBegin 开始的周期是否已超时，未超时则把剩余时间合并到 dwRemain（取最小值） */
+	static BOOL CheckTimeout(DWORD dwBegin, DWORD dwPeriod, DWORD now, DWORD& dwRemain)
+	{
+		if(dwPeriod == 0)
+			return FALSE;
+
+		int iRemain = (int)(dwBegin + dwPeriod - now);
+
+		if(iRemain <= 0)
+			return TRUE;
+
+		if(dwRemain == 0 || (DWORD)iRemain < dwRemain)
+			dwRemain = (DWORD)iRemain;
+
+		return FALSE;
+	}
+
 	void Reset(CONNID dwConnID)
 	{
+		ASSERT(!sysTimer.IsArmed() && !userTimer.IsArmed());
+
+		sysTimer.connID		= dwConnID;
+		userTimer.connID	= dwConnID;
+		userTimer.fnTimer	= nullptr;
+		userTimer.pvParam	= nullptr;
+
 		connID		= dwConnID;
 		connected	= FALSE;
 		valid		= TRUE;
@@ -382,48 +491,127 @@ struct TSocketObjBase
 	}
 };
 
+/* io_uring 模式下发送请求的消息头和数据块向量 */
+struct TUringSendMsg
+{
+	msghdr	msg;
+	iovec	iov[MAX_URING_SEND_IOV_COUNT];
+};
+
 /* 数据缓冲区结构 */
 struct TSocketObj : public TSocketObjBase
 {
 	using __super = TSocketObjBase;
 
+	SOCKET				socket;
+	int					shard;
+
+	/* 接收线程修改的字段 */
+	alignas(CACHE_LINE)
 	CReentrantCriSec	csIo;
+	UINT				ioEvents;
+	volatile UINT		ioState;
+	BYTE				allocOffset;
+	/* io_uring 模式下的接收数据块（接收请求完成前由内核写入，不能释放或复用） */
+	TItem*				rcvItem;
+	volatile BOOL		rcvPosted;
+
+	/* 发送线程修改的字段 */
+	alignas(CACHE_LINE)
 	CReentrantCriSec	csSend;
-
-	SOCKET				socket;
 	TBufferObjList		sndBuff;
+	/* 直接发送模式下部分发送时已在调用线程中发送、尚未在工作线程中触发 OnSend 事件的数据长度 */
+	int					sndNotifyLen;
+	/* 待发数据达到高水位，尚未降到低水位 */
+	BOOL				sndBlocked;
+	/* io_uring 模式下已提交的发送请求（请求完成前 sndMsg 及其指向的发送缓冲区数据块必须保持有效） */
+	volatile BOOL		sndPosted;
+	/* 只在 io_uring 模式下首次提交发送请求时分配，对象销毁时释放 */
+	TUringSendMsg*		sndMsg;
+
+	/* IO 处理中标志（边缘触发模式下，用于保证同一时刻只有一个工作线程处理该连接的 IO 事件） */
+	static const UINT IO_BUSY_FLAG = 0x80000000;
 
 	static TSocketObj* Construct(CPrivateHeap& hp, CBufferObjPool& bfPool)
 	{
-		TSocketObj* pSocketObj = (TSocketObj*)hp.Alloc(sizeof(TSocketObj));
-		ASSERT(pSocketObj);
+		BYTE btOffset;
+		TSocketObj* pSocketObj = (TSocketObj*)AllocAligned(hp, sizeof(TSocketObj), btOffset);
+
+		new (pSocketObj) TSocketObj(hp, bfPool);
+		pSocketObj->allocOffset = btOffset;
 
-		return new (pSocketObj) TSocketObj(hp, bfPool);
+		return pSocketObj;
 	}
 
 	static void Destruct(TSocketObj* pSocketObj)
 	{
 		ASSERT(pSocketObj);
 
-		CPrivateHeap& heap = pSocketObj->heap;
+		CPrivateHeap& heap	= pSocketObj->heap;
+		BYTE btOffset		= pSocketObj->allocOffset;
+
 		pSocketObj->TSocketObj::~TSocketObj();
-		heap.Free(pSocketObj);
+		FreeAligned(heap, pSocketObj, btOffset);
 	}
 	
 	TSocketObj(CPrivateHeap& hp, CBufferObjPool& bfPool)
-	: __super(hp), sndBuff(bfPool)
+	: __super(hp), rcvItem(nullptr), rcvPosted(FALSE), sndBuff(bfPool), sndPosted(FALSE), sndMsg(nullptr)
 	{
 
 	}
 
+	~TSocketObj()
+	{
+		if(sndMsg != nullptr)
+			heap.Free(sndMsg);
+	}
+
+	TUringSendMsg* GetSendMsg()
+	{
+		if(sndMsg == nullptr)
+			sndMsg = (TUringSendMsg*)heap.Alloc(sizeof(TUringSendMsg));
+
+		return sndMsg;
+	}
+
 	static void Release(TSocketObj* pSocketObj)
 	{
 		__super::Release(pSocketObj);
 		pSocketObj->sndBuff.Release();
+		pSocketObj->sndNotifyLen = 0;
 	}
 
-	int Pending()		{return sndBuff.Length();}
-	BOOL IsPending()	{return Pending() > 0;}
+	int Pending()			{return sndBuff.Length();}
+	BOOL IsPending()		{return Pending() > 0;}
+	BOOL IsNotifyPending()	{return sndNotifyLen > 0;}
+	/* io_uring 模式下是否有尚未完成的收发请求（此时不能复用该对象） */
+	BOOL IsIoPosted()		{return rcvPosted || sndPosted;}
+
+	static BOOL IsIoIdle(TSocketObj* pSocketObj)	{return !pSocketObj->IsIoPosted();}
+
+	/* 获取 IO 处理权，如果其它线程正在处理则把事件合并到挂起事件中并返回 FALSE */
+	BOOL AcquireIo(UINT events)
+	{
+		events &= ~IO_BUSY_FLAG;
+
+		UINT uiCur;
+		UINT uiOld = ioState;
+
+		do
+		{
+			uiCur		= uiOld;
+			UINT uiNew	= (uiCur & IO_BUSY_FLAG) ? (uiCur | events) : IO_BUSY_FLAG;
+			uiOld		= ::InterlockedCompareExchange(&ioState, uiNew, uiCur);
+		} while(uiOld != uiCur);
+
+		return !(uiCur & IO_BUSY_FLAG);
+	}
+
+	/* 释放 IO 处理权，返回处理期间被合并的挂起事件 */
+	UINT ReleaseIo()
+	{
+		return InterlockedExchange(&ioState, 0U) & ~IO_BUSY_FLAG;
+	}
 
 	static BOOL InvalidSocketObj(TSocketObj* pSocketObj)
 	{
@@ -450,7 +638,12 @@ struct TSocketObj : public TSocketObjBase
 	{
 		__super::Reset(dwConnID);
 		
-		socket = soClient;
+		socket		= soClient;
+		shard		= 0;
+		ioEvents	= 0;
+		ioState		= 0;
+		sndBlocked	= FALSE;
+		sndNotifyLen	= 0;
 	}
 };
 
@@ -463,19 +656,24 @@ struct TAgentSocketObj : public TSocketObj
 	
 	static TAgentSocketObj* Construct(CPrivateHeap& hp, CBufferObjPool& bfPool)
 	{
-		TAgentSocketObj* pSocketObj = (TAgentSocketObj*)hp.Alloc(sizeof(TAgentSocketObj));
-		ASSERT(pSocketObj);
+		BYTE btOffset;
+		TAgentSocketObj* pSocketObj = (TAgentSocketObj*)AllocAligned(hp, sizeof(TAgentSocketObj), btOffset);
+
+		new (pSocketObj) TAgentSocketObj(hp, bfPool);
+		pSocketObj->allocOffset = btOffset;
 
-		return new (pSocketObj) TAgentSocketObj(hp, bfPool);
+		return pSocketObj;
 	}
 
 	static void Destruct(TAgentSocketObj* pSocketObj)
 	{
 		ASSERT(pSocketObj);
 
-		CPrivateHeap& heap = pSocketObj->heap;
+		CPrivateHeap& heap	= pSocketObj->heap;
+		BYTE btOffset		= pSocketObj->allocOffset;
+
 		pSocketObj->TAgentSocketObj::~TAgentSocketObj();
-		heap.Free(pSocketObj);
+		FreeAligned(heap, pSocketObj, btOffset);
 	}
 	
 	TAgentSocketObj(CPrivateHeap& hp, CBufferObjPool& bfPool)
@@ -510,33 +708,47 @@ struct TUdpSocketObj : public TSocketObjBase
 
 	CBufferObjPool&		itPool;
 
+	/* 接收线程修改的字段 */
+	alignas(CACHE_LINE)
 	CSimpleRWLock		lcIo;
-	CReentrantCriSec	csSend;
+	volatile DWORD		detectFails;
+	DWORD				detectTime;
 
+	/* 发送线程修改的字段 */
+	alignas(CACHE_LINE)
+	CReentrantCriSec	csSend;
 	TBufferObjList		sndBuff;
-	CRecvQueue			recvQueue;
+	BOOL				sndBlocked;
+	BYTE				allocOffset;
 
-	volatile DWORD		detectFails;
+	/* 接收队列（接收线程写入，处理线程读取） */
+	alignas(CACHE_LINE)
+	CRecvQueue			recvQueue;
 
 	static TUdpSocketObj* Construct(CPrivateHeap& hp, CBufferObjPool& bfPool)
 	{
-		TUdpSocketObj* pSocketObj = (TUdpSocketObj*)hp.Alloc(sizeof(TUdpSocketObj));
-		ASSERT(pSocketObj);
+		BYTE btOffset;
+		TUdpSocketObj* pSocketObj = (TUdpSocketObj*)AllocAligned(hp, sizeof(TUdpSocketObj), btOffset);
+
+		new (pSocketObj) TUdpSocketObj(hp, bfPool);
+		pSocketObj->allocOffset = btOffset;
 
-		return new (pSocketObj) TUdpSocketObj(hp, bfPool);
+		return pSocketObj;
 	}
 
 	static void Destruct(TUdpSocketObj* pSocketObj)
 	{
 		ASSERT(pSocketObj);
 
-		CPrivateHeap& heap = pSocketObj->heap;
+		CPrivateHeap& heap	= pSocketObj->heap;
+		BYTE btOffset		= pSocketObj->allocOffset;
+
 		pSocketObj->TUdpSocketObj::~TUdpSocketObj();
-		heap.Free(pSocketObj);
+		FreeAligned(heap, pSocketObj, btOffset);
 	}
 	
 	TUdpSocketObj(CPrivateHeap& hp, CBufferObjPool& bfPool)
-	: __super(hp), sndBuff(bfPool), itPool(bfPool)
+	: __super(hp), itPool(bfPool), sndBuff(bfPool)
 	{
 
 	}
@@ -564,8 +776,8 @@ struct TUdpSocketObj : public TSocketObjBase
 		{
 			pSocketObj->SetConnected(FALSE);
 
-			CWriteLock			 locallock(pSocketObj->lcIo);
-			CReentrantCriSecLock locallock2(pSocketObj->csSend);
+			CWriteLock			locallock(pSocketObj->lcIo);
+			CReentrantCriSecLock	locallock2(pSocketObj->csSend);
 
 			if(TSocketObjBase::IsValid(pSocketObj))
 			{
@@ -582,6 +794,8 @@ struct TUdpSocketObj : public TSocketObjBase
 		__super::Reset(dwConnID);
 
 		detectFails = 0;
+		detectTime	= 0;
+		sndBlocked	= FALSE;
 	}
 
 	void ClearRecvQueue()
@@ -710,6 +924,15 @@ ULONGLONG HToN64(ULONGLONG value);
 
 HRESULT ReadSmallFile(LPCTSTR lpszFileName, CFile& file, CFileMapping& fmap, DWORD dwMaxFileSize = MAX_SMALL_FILE_SIZE);
 HRESULT MakeSmallFilePackage(LPCTSTR lpszFileName, CFile& file, CFileMapping& fmap, WSABUF szBuf[3], const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr);
+/* 打开文件并检查发送区域（llLength 为 0 表示发送到文件末尾，返回时为实际区域长度；含头部和尾部的总长度超过 llMaxSize 时返回 ERROR_FILE_TOO_LARGE） */
+HRESULT OpenFileRegion(LPCTSTR lpszFileName, CFile& file, LONGLONG& llOffset, LONGLONG& llLength, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr, LONGLONG llMaxSize = MAXINT64);
+/*
+* 把文件区域映射到内存并生成 [头部, 文件数据, 尾部] 数据包（用于需要对发送数据进行加工而不能使用 sendfile() 的组件）；
+* 数据包会被整个拷贝到发送缓冲区，因此总长度与小文件一样不能超过 MAX_SMALL_FILE_SIZE
+*/
+HRESULT MakeFileRegionPackage(LPCTSTR lpszFileName, CFile& file, CFileMapping& fmap, LONGLONG llOffset, LONGLONG llLength, WSABUF szBuf[3], const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr);
+/* 以拷贝方式发送引用缓冲区后调用缓冲区释放函数（用于需要对发送数据进行加工的组件，bSent 为拷贝发送的结果） */
+BOOL ReleaseSendReference(BOOL bSent, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam);
 
 /************************************************************************
 名称：setsockopt() 帮助方法
@@ -727,6 +950,8 @@ int SSO_Linger				(SOCKET sock, int l_onoff, int l_linger);
 int SSO_KeepAlive			(SOCKET sock, BOOL bKeepAlive = TRUE);
 int SSO_KeepAliveVals		(SOCKET sock, BOOL bOnOff, DWORD dwIdle, DWORD dwInterval, DWORD dwCount = 5);
 int SSO_ReuseAddress		(SOCKET sock, BOOL bReuse = TRUE);
+int SSO_ReusePort			(SOCKET sock, BOOL bReuse = TRUE);
+int SSO_ReusePortCpuSteering(SOCKET sock, int iGroupSize);
 int SSO_RecvBuffSize		(SOCKET sock, int size);
 int SSO_SendBuffSize		(SOCKET sock, int size);
 int SSO_RecvTimeout			(SOCKET sock, int sec, int microsec = 0);
@@ -108,6 +108,13 @@ public:
 				: HR_IGNORE;
 	}
 
+	virtual EnHandleResult OnWritable(T* pSender, CONNID dwConnID, BOOL bWritable)
+	{
+		return	(m_fnOnWritable)
+				? m_fnOnWritable(C_HP_Object::FromSecond<offset>(pSender), dwConnID, bWritable)
+				: HR_IGNORE;
+	}
+
 	virtual EnHandleResult OnReceive(T* pSender, CONNID dwConnID, const BYTE* pData, int iLength)
 	{
 		ASSERT(m_fnOnReceive);
@@ -148,6 +155,7 @@ public:
 	, m_fnOnAccept			(nullptr)
 	, m_fnOnHandShake		(nullptr)
 	, m_fnOnSend			(nullptr)
+	, m_fnOnWritable		(nullptr)
 	, m_fnOnReceive			(nullptr)
 	, m_fnOnPullReceive		(nullptr)
 	, m_fnOnClose			(nullptr)
@@ -160,6 +168,7 @@ public:
 	HP_FN_Server_OnAccept			m_fnOnAccept		;
 	HP_FN_Server_OnHandShake		m_fnOnHandShake		;
 	HP_FN_Server_OnSend				m_fnOnSend			;
+	HP_FN_Server_OnWritable			m_fnOnWritable		;
 	HP_FN_Server_OnReceive			m_fnOnReceive		;
 	HP_FN_Server_OnPullReceive		m_fnOnPullReceive	;
 	HP_FN_Server_OnClose			m_fnOnClose			;
@@ -197,6 +206,13 @@ public:
 				: HR_IGNORE;
 	}
 
+	virtual EnHandleResult OnWritable(T* pSender, CONNID dwConnID, BOOL bWritable)
+	{
+		return	(m_fnOnWritable)
+				? m_fnOnWritable(C_HP_Object::FromSecond<offset>(pSender), dwConnID, bWritable)
+				: HR_IGNORE;
+	}
+
 	virtual EnHandleResult OnReceive(T* pSender, CONNID dwConnID, const BYTE* pData, int iLength)
 	{
 		ASSERT(m_fnOnReceive);
@@ -237,6 +253,7 @@ public:
 	, m_fnOnConnect			(nullptr)
 	, m_fnOnHandShake		(nullptr)
 	, m_fnOnSend			(nullptr)
+	, m_fnOnWritable		(nullptr)
 	, m_fnOnReceive			(nullptr)
 	, m_fnOnPullReceive		(nullptr)
 	, m_fnOnClose			(nullptr)
@@ -249,6 +266,7 @@ public:
 	HP_FN_Agent_OnConnect			m_fnOnConnect		;
 	HP_FN_Agent_OnHandShake			m_fnOnHandShake		;
 	HP_FN_Agent_OnSend				m_fnOnSend			;
+	HP_FN_Agent_OnWritable			m_fnOnWritable		;
 	HP_FN_Agent_OnReceive			m_fnOnReceive		;
 	HP_FN_Agent_OnPullReceive		m_fnOnPullReceive	;
 	HP_FN_Agent_OnClose				m_fnOnClose			;
@@ -286,6 +304,13 @@ public:
 				: HR_IGNORE;
 	}
 
+	virtual EnHandleResult OnWritable(T* pSender, CONNID dwConnID, BOOL bWritable)
+	{
+		return	(m_fnOnWritable)
+				? m_fnOnWritable(C_HP_Object::FromSecond<offset>(pSender), dwConnID, bWritable)
+				: HR_IGNORE;
+	}
+
 	virtual EnHandleResult OnReceive(T* pSender, CONNID dwConnID, const BYTE* pData, int iLength)
 	{
 		ASSERT(m_fnOnReceive);
@@ -319,6 +344,7 @@ public:
 	, m_fnOnConnect			(nullptr)
 	, m_fnOnHandShake		(nullptr)
 	, m_fnOnSend			(nullptr)
+	, m_fnOnWritable		(nullptr)
 	, m_fnOnReceive			(nullptr)
 	, m_fnOnPullReceive		(nullptr)
 	, m_fnOnClose			(nullptr)
@@ -330,6 +356,7 @@ public:
 	HP_FN_Client_OnConnect			m_fnOnConnect		;
 	HP_FN_Client_OnHandShake		m_fnOnHandShake		;
 	HP_FN_Client_OnSend				m_fnOnSend			;
+	HP_FN_Client_OnWritable			m_fnOnWritable		;
 	HP_FN_Client_OnReceive			m_fnOnReceive		;
 	HP_FN_Client_OnPullReceive		m_fnOnPullReceive	;
 	HP_FN_Client_OnClose			m_fnOnClose			;
@@ -546,6 +573,8 @@ public:
 		{return m_lsnServer.OnHandShake(pSender, dwConnID);}
 	virtual EnHandleResult OnSend(ITcpServer* pSender, CONNID dwConnID, const BYTE* pData, int iLength)
 		{return m_lsnServer.OnSend(pSender, dwConnID, pData, iLength);}
+	virtual EnHandleResult OnWritable(ITcpServer* pSender, CONNID dwConnID, BOOL bWritable)
+		{return m_lsnServer.OnWritable(pSender, dwConnID, bWritable);}
 	virtual EnHandleResult OnReceive(ITcpServer* pSender, CONNID dwConnID, const BYTE* pData, int iLength)
 		{return m_lsnServer.OnReceive(pSender, dwConnID, pData, iLength);}
 	virtual EnHandleResult OnReceive(ITcpServer* pSender, CONNID dwConnID, int iLength)
@@ -601,6 +630,8 @@ public:
 		{return m_lsnAgent.OnHandShake(pSender, dwConnID);}
 	virtual EnHandleResult OnSend(ITcpAgent* pSender, CONNID dwConnID, const BYTE* pData, int iLength)
 		{return m_lsnAgent.OnSend(pSender, dwConnID, pData, iLength);}
+	virtual EnHandleResult OnWritable(ITcpAgent* pSender, CONNID dwConnID, BOOL bWritable)
+		{return m_lsnAgent.OnWritable(pSender, dwConnID, bWritable);}
 	virtual EnHandleResult OnReceive(ITcpAgent* pSender, CONNID dwConnID, const BYTE* pData, int iLength)
 		{return m_lsnAgent.OnReceive(pSender, dwConnID, pData, iLength);}
 	virtual EnHandleResult OnReceive(ITcpAgent* pSender, CONNID dwConnID, int iLength)
@@ -656,6 +687,8 @@ public:
 		{return m_lsnClient.OnHandShake(pSender, dwConnID);}
 	virtual EnHandleResult OnSend(ITcpClient* pSender, CONNID dwConnID, const BYTE* pData, int iLength)
 		{return m_lsnClient.OnSend(pSender, dwConnID, pData, iLength);}
+	virtual EnHandleResult OnWritable(ITcpClient* pSender, CONNID dwConnID, BOOL bWritable)
+		{return m_lsnClient.OnWritable(pSender, dwConnID, bWritable);}
 	virtual EnHandleResult OnReceive(ITcpClient* pSender, CONNID dwConnID, const BYTE* pData, int iLength)
 		{return m_lsnClient.OnReceive(pSender, dwConnID, pData, iLength);}
 	virtual EnHandleResult OnReceive(ITcpClient* pSender, CONNID dwConnID, int iLength)
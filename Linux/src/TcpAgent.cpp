@@ -56,6 +56,7 @@ BOOL CTcpAgent::CheckParams()
 {
 	if	((m_enSendPolicy >= SP_PACK && m_enSendPolicy <= SP_DIRECT)								&&
 		(m_enOnSendSyncPolicy >= OSSP_NONE && m_enOnSendSyncPolicy <= OSSP_RECEIVE)				&&
+		(m_enDispatchMode >= DM_SHARED && m_enDispatchMode <= DM_IO_URING)						&&
 		((int)m_dwMaxConnectionCount > 0)														&&
 		((int)m_dwWorkerThreadCount > 0 && m_dwWorkerThreadCount <= MAX_WORKER_THREAD_COUNT)	&&
 		((int)m_dwSocketBufferSize >= MIN_SOCKET_BUFFER_SIZE)									&&
@@ -64,8 +65,18 @@ BOOL CTcpAgent::CheckParams()
 		((int)m_dwFreeBufferObjPool >= 0)														&&
 		((int)m_dwFreeSocketObjHold >= 0)														&&
 		((int)m_dwFreeBufferObjHold >= 0)														&&
+		((int)m_dwFreeBufferObjCache >= 0)														&&
 		((int)m_dwKeepAliveTime >= 1000 || m_dwKeepAliveTime == 0)								&&
-		((int)m_dwKeepAliveInterval >= 1000 || m_dwKeepAliveInterval == 0)						)
+		((int)m_dwKeepAliveInterval >= 1000 || m_dwKeepAliveInterval == 0)						&&
+		((int)m_dwTimerInterval >= 0)															&&
+		(m_dwMaxConnectPeriod <= MAX_CONNECTION_PERIOD)											&&
+		(m_dwSilenceTimeout <= MAX_CONNECTION_PERIOD)											&&
+		(m_dwHandShakeTimeout <= MAX_CONNECTION_PERIOD)											&&
+		(IsTimerEnabled() || (m_dwMaxConnectPeriod == 0 && m_dwSilenceTimeout == 0 && m_dwHandShakeTimeout == 0))	&&
+		((int)m_dwSendHighWatermark >= 0 && (int)m_dwMaxSendPending >= 0)						&&
+		(m_dwSendHighWatermark == 0 || m_dwSendLowWatermark < m_dwSendHighWatermark)			&&
+		(m_dwFreeSocketObjPrealloc <= m_dwFreeSocketObjPool)									&&
+		(m_dwFreeBufferObjPrealloc <= m_dwFreeBufferObjPool)									)
 		return TRUE;
 
 	SetLastError(SE_INVALID_PARAM, __FUNCTION__, ERROR_INVALID_PARAMETER);
@@ -77,11 +88,28 @@ void CTcpAgent::PrepareStart()
 	m_bfActiveSockets.Reset(m_dwMaxConnectionCount);
 	m_lsFreeSocket.Reset(m_dwFreeSocketObjPool);
 
+	m_phSocket.SetNumaInterleave(m_bPoolNumaInterleave);
+
 	m_bfObjPool.SetItemCapacity(m_dwSocketBufferSize);
 	m_bfObjPool.SetPoolSize(m_dwFreeBufferObjPool);
 	m_bfObjPool.SetPoolHold(m_dwFreeBufferObjHold);
+	m_bfObjPool.SetCacheSize(m_dwFreeBufferObjCache);
+	m_bfObjPool.SetPoolPrealloc(m_dwFreeBufferObjPrealloc);
+	m_bfObjPool.SetNumaInterleave(m_bPoolNumaInterleave);
 
 	m_bfObjPool.Prepare();
+
+	PreallocSocketObj();
+
+	/* 每个分片一个定时轮（与分派器的分片一一对应），连接的定时器只在其所属分片的工作线程中到期 */
+	if(IsTimerEnabled())
+	{
+		m_iConnTimers	= (m_enDispatchMode != DM_SHARED) ? (int)m_dwWorkerThreadCount : 1;
+		m_pConnTimers	= make_unique<CConnTimingWheel[]>(m_iConnTimers);
+
+		for(int i = 0; i < m_iConnTimers; i++)
+			VERIFY(m_pConnTimers[i].Init(m_dwTimerInterval));
+	}
 }
 
 BOOL CTcpAgent::CheckStarting()
@@ -154,14 +182,19 @@ BOOL CTcpAgent::ParseBindAddress(LPCTSTR lpszBindAddress)
 
 BOOL CTcpAgent::CreateWorkerThreads()
 {
-	if(!m_ioDispatcher.Start(this, DEFAULT_WORKER_MAX_EVENT_COUNT, m_dwWorkerThreadCount))
+	if(!m_ioDispatcher.Start(this, DEFAULT_WORKER_MAX_EVENT_COUNT, m_dwWorkerThreadCount, m_dwTimerInterval, m_enDispatchMode != DM_SHARED, m_enDispatchMode == DM_IO_URING))
 		return FALSE;
 
 	const CIODispatcher::CWorkerThread* pWorkerThread = m_ioDispatcher.GetWorkerThreads();
 
 	for(DWORD i = 0; i < m_dwWorkerThreadCount; i++)
+	{
 		m_rcBufferMap[pWorkerThread[i].GetThreadID()] = new CBufferPtr(m_dwSocketBufferSize);
 
+		if(m_bDetachableReceive)
+			m_rcItemMap[pWorkerThread[i].GetThreadID()] = nullptr;
+	}
+
 	return TRUE;
 }
 
@@ -179,6 +212,7 @@ BOOL CTcpAgent::Stop()
 	FireShutdown();
 
 	ReleaseFreeSocket();
+	WaitForDetachedBufferRelease();
 
 	Reset();
 
@@ -207,10 +241,25 @@ void CTcpAgent::WaitForWorkerThreadEnd()
 	m_ioDispatcher.Stop();
 }
 
+void CTcpAgent::WaitForDetachedBufferRelease()
+{
+	/* 已分离的接收缓冲区占用 m_bfObjPool 的内存，必须全部归还后才能清理缓冲池 */
+	if(m_lDetachedBuffers > 0)
+	{
+		TRACE("CTcpAgent(0x%p) wait for %d detached receive buffer(s) to be released", this, m_lDetachedBuffers);
+
+		while(m_lDetachedBuffers > 0)
+			::WaitFor(10);
+	}
+}
+
 void CTcpAgent::ReleaseClientSocket()
 {
 	VERIFY(m_bfActiveSockets.IsEmpty());
 	m_bfActiveSockets.Reset();
+
+	for(int i = 0; i < m_iConnTimers; i++)
+		m_pConnTimers[i].Clear();
 }
 
 void CTcpAgent::ReleaseFreeSocket()
@@ -229,13 +278,25 @@ void CTcpAgent::ReleaseFreeSocket()
 
 void CTcpAgent::Reset()
 {
+	for(TReceiveItemMapI it = m_rcItemMap.begin(), end = m_rcItemMap.end(); it != end; ++it)
+	{
+		if(it->second != nullptr)
+			m_bfObjPool.PutFreeItem(it->second);
+	}
+
+	m_rcItemMap.clear();
+
 	m_bfObjPool.Clear();
 	m_phSocket.Reset();
 	m_soAddr.Reset();
 
 	::ClearPtrMap(m_rcBufferMap);
 
-	m_enState = SS_STOPPED;
+	m_pConnTimers.reset();
+	m_iConnTimers	= 0;
+
+	m_llSendPending	= 0;
+	m_enState		= SS_STOPPED;
 }
 
 BOOL CTcpAgent::Connect(LPCTSTR lpszRemoteAddress, USHORT usPort, CONNID* pdwConnID, PVOID pExtra, USHORT usLocalPort)
@@ -338,6 +399,7 @@ int CTcpAgent::PrepareConnect(CONNID& dwConnID, SOCKET soClient)
 int CTcpAgent::ConnectToServer(CONNID dwConnID, LPCTSTR lpszRemoteAddress, SOCKET soClient, const HP_SOCKADDR& addr, PVOID pExtra)
 {
 	TAgentSocketObj* pSocketObj = GetFreeSocketObj(dwConnID, soClient);
+	pSocketObj->shard			= m_ioDispatcher.AssignShard();
 
 	CReentrantCriSecLock locallock(pSocketObj->csIo);
 
@@ -353,7 +415,9 @@ int CTcpAgent::ConnectToServer(CONNID dwConnID, LPCTSTR lpszRemoteAddress, SOCKE
 
 		if(IS_NO_ERROR(rc) || IS_IO_PENDING_ERROR())
 		{
-			if(m_ioDispatcher.AddFD(pSocketObj->socket, EPOLLOUT | EPOLLONESHOT, pSocketObj))
+			pSocketObj->ioEvents = EPOLLOUT | EPOLLONESHOT;
+
+			if(m_ioDispatcher.AddFD(pSocketObj->shard, pSocketObj->socket, pSocketObj->ioEvents, pSocketObj))
 				result = NO_ERROR;
 		}
 	}
@@ -369,9 +433,9 @@ int CTcpAgent::ConnectToServer(CONNID dwConnID, LPCTSTR lpszRemoteAddress, SOCKE
 				result = ENSURE_ERROR_CANCELLED;
 			else
 			{
-				UINT evts = (pSocketObj->IsPending() ? EPOLLOUT : 0) | (pSocketObj->IsPaused() ? 0 : EPOLLIN);
+				pSocketObj->ioEvents = GetIoEvents(pSocketObj);
 
-				if(m_ioDispatcher.AddFD(pSocketObj->socket, evts | EPOLLRDHUP | EPOLLONESHOT, pSocketObj))
+				if(m_ioDispatcher.AddFD(pSocketObj->shard, pSocketObj->socket, pSocketObj->ioEvents, pSocketObj))
 					result = NO_ERROR;
 			}
 		}
@@ -412,6 +476,21 @@ TAgentSocketObj* CTcpAgent::CreateSocketObj()
 	return TAgentSocketObj::Construct(m_phSocket, m_bfObjPool);
 }
 
+void CTcpAgent::PreallocSocketObj()
+{
+	/* 预先创建的 Socket 缓存对象释放时间提前一个锁定周期，可以立即被获取使用 */
+	DWORD dwPrealloc = min(m_dwFreeSocketObjPrealloc, m_dwFreeSocketObjPool);
+	DWORD dwFreeTime = ::TimeGetTime() - m_dwFreeSocketObjLockTime;
+
+	for(DWORD i = 0; i < dwPrealloc; i++)
+	{
+		TAgentSocketObj* pSocketObj	= CreateSocketObj();
+		pSocketObj->freeTime		= dwFreeTime;
+
+		VERIFY(m_lsFreeSocket.TryPut(pSocketObj));
+	}
+}
+
 void CTcpAgent::DeleteSocketObj(TAgentSocketObj* pSocketObj)
 {
 	TAgentSocketObj::Destruct(pSocketObj);
@@ -423,9 +502,21 @@ void CTcpAgent::AddFreeSocketObj(TAgentSocketObj* pSocketObj, EnSocketCloseFlag
 		return;
 
 	CloseClientSocketObj(pSocketObj, enFlag, enOperation, iErrorCode);
+	KillTimers(pSocketObj);
 
+	m_ioDispatcher.ReleaseShard(pSocketObj->shard);
 	m_bfActiveSockets.Remove(pSocketObj->connID);
-	TAgentSocketObj::Release(pSocketObj);
+
+	if(!IsSendPendingLimited())
+		TAgentSocketObj::Release(pSocketObj);
+	else
+	{
+		/* 在 csSend 锁内扣减剩余待发数据，避免与并发的发送操作竞争导致统计偏差 */
+		CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+		::InterlockedExchangeSub(&m_llSendPending, (LLONG)pSocketObj->Pending());
+		TAgentSocketObj::Release(pSocketObj);
+	}
 
 	ReleaseGCSocketObj();
 
@@ -455,6 +546,9 @@ void CTcpAgent::AddClientSocketObj(CONNID dwConnID, TAgentSocketObj* pSocketObj,
 	remoteAddr.Copy(pSocketObj->remoteAddr);
 
 	VERIFY(m_bfActiveSockets.ReleaseLock(dwConnID, pSocketObj));
+
+	if(IsNeedCheckTimeout())
+		HandleTimeout(pSocketObj);
 }
 
 TAgentSocketObj* CTcpAgent::FindSocketObj(CONNID dwConnID)
@@ -479,6 +573,9 @@ void CTcpAgent::CloseClientSocketObj(TAgentSocketObj* pSocketObj, EnSocketCloseF
 	SOCKET socket = pSocketObj->socket;
 	pSocketObj->socket = INVALID_SOCKET;
 
+	if(m_ioDispatcher.IsIoUring())
+		m_ioDispatcher.DelFD(pSocketObj->shard, socket, pSocketObj);
+
 	::ManualCloseSocket(socket, iShutdownFlag);
 }
 
@@ -743,7 +840,7 @@ BOOL CTcpAgent::Disconnect(CONNID dwConnID, BOOL bForce)
 		return FALSE;
 	}
 
-	return m_ioDispatcher.SendCommand(DISP_CMD_DISCONNECT, dwConnID, bForce);
+	return m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_DISCONNECT, dwConnID, bForce);
 }
 
 BOOL CTcpAgent::DisconnectLongConnections(DWORD dwPeriod, BOOL bForce)
@@ -790,6 +887,80 @@ BOOL CTcpAgent::DisconnectSilenceConnections(DWORD dwPeriod, BOOL bForce)
 	return TRUE;
 }
 
+BOOL CTcpAgent::SetConnectionTimer(CONNID dwConnID, DWORD dwTimeout, Fn_ConnectionTimer fnTimer, PVOID pvParam)
+{
+	if(!IsTimerEnabled() || !HasStarted())
+	{
+		::SetLastError(ERROR_INVALID_STATE);
+		return FALSE;
+	}
+
+	if(dwTimeout == 0 || dwTimeout > MAX_CONNECTION_PERIOD || fnTimer == nullptr)
+	{
+		::SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	TAgentSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(!TAgentSocketObj::IsValid(pSocketObj))
+	{
+		::SetLastError(ERROR_OBJECT_NOT_FOUND);
+		return FALSE;
+	}
+
+	TConnTimer* pTimer = &pSocketObj->userTimer;
+
+	GetConnTimer(pSocketObj).Cancel(pTimer);
+
+	pTimer->fnTimer = fnTimer;
+	pTimer->pvParam = pvParam;
+
+	return ArmTimer(pSocketObj, pTimer, dwTimeout);
+}
+
+BOOL CTcpAgent::KillConnectionTimer(CONNID dwConnID)
+{
+	TAgentSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(!TAgentSocketObj::IsValid(pSocketObj))
+	{
+		::SetLastError(ERROR_OBJECT_NOT_FOUND);
+		return FALSE;
+	}
+
+	if(!GetConnTimer(pSocketObj).Cancel(&pSocketObj->userTimer))
+	{
+		::SetLastError(ERROR_INVALID_STATE);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+BOOL CTcpAgent::ArmTimer(TAgentSocketObj* pSocketObj, TConnTimer* pTimer, DWORD dwTimeout)
+{
+	GetConnTimer(pSocketObj).Arm(pTimer, dwTimeout);
+
+	/* 关闭连接时先使连接失效再取消定时器，如果设置定时器期间连接已失效则由这里取消定时器 */
+	if(TAgentSocketObj::IsValid(pSocketObj))
+		return TRUE;
+
+	GetConnTimer(pSocketObj).Cancel(pTimer);
+	::SetLastError(ERROR_OBJECT_NOT_FOUND);
+
+	return FALSE;
+}
+
+VOID CTcpAgent::KillTimers(TAgentSocketObj* pSocketObj)
+{
+	if(!IsTimerEnabled())
+		return;
+
+	GetConnTimer(pSocketObj).Cancel(&pSocketObj->sysTimer);
+	GetConnTimer(pSocketObj).Cancel(&pSocketObj->userTimer);
+}
+
 BOOL CTcpAgent::PauseReceive(CONNID dwConnID, BOOL bPause)
 {
 	TAgentSocketObj* pSocketObj = FindSocketObj(dwConnID);
@@ -812,7 +983,7 @@ BOOL CTcpAgent::PauseReceive(CONNID dwConnID, BOOL bPause)
 	pSocketObj->paused = bPause;
 
 	if(!bPause)
-		return m_ioDispatcher.SendCommand(DISP_CMD_UNPAUSE, pSocketObj->connID);
+		return m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_UNPAUSE, pSocketObj->connID);
 
 	return TRUE;
 }
@@ -827,19 +998,27 @@ BOOL CTcpAgent::OnBeforeProcessIo(PVOID pv, UINT events)
 	if(events & _EPOLL_ALL_ERROR_EVENTS)
 		pSocketObj->SetConnected(FALSE);
 
-	pSocketObj->csIo.lock();
+	BOOL bLock = !m_ioDispatcher.IsSharded();
 
-	if(!TAgentSocketObj::IsValid(pSocketObj))
+	if(bLock)
 	{
-		pSocketObj->csIo.unlock();
-		return FALSE;
+		if(m_bEdgeTrigger && !pSocketObj->AcquireIo(events))
+			return FALSE;
+
+		pSocketObj->csIo.lock();
+
+		if(!TAgentSocketObj::IsValid(pSocketObj))
+		{
+			UnlockIo(pSocketObj);
+			return FALSE;
+		}
 	}
 
 	if(!pSocketObj->HasConnected())
 	{
 		HandleConnect(pSocketObj, events);
 
-		pSocketObj->csIo.unlock();
+		if(bLock) UnlockIo(pSocketObj);
 		return FALSE;
 	}
 
@@ -854,11 +1033,40 @@ VOID CTcpAgent::OnAfterProcessIo(PVOID pv, UINT events, BOOL rs)
 	{
 		ASSERT(rs && !(events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)));
 
-		UINT evts = (pSocketObj->IsPending() ? EPOLLOUT : 0) | (pSocketObj->IsPaused() ? 0 : EPOLLIN);
-		m_ioDispatcher.ModFD(pSocketObj->socket, evts | EPOLLRDHUP | EPOLLONESHOT, pSocketObj);
+		UINT evts = GetIoEvents(pSocketObj);
+
+		if(!m_bEdgeTrigger || evts != pSocketObj->ioEvents)
+		{
+			pSocketObj->ioEvents = evts;
+			m_ioDispatcher.ModFD(pSocketObj->shard, pSocketObj->socket, evts, pSocketObj);
+		}
 	}
 
+	if(!m_ioDispatcher.IsSharded())
+		UnlockIo(pSocketObj);
+}
+
+UINT CTcpAgent::GetIoEvents(TAgentSocketObj* pSocketObj)
+{
+	UINT evts = (pSocketObj->IsPaused() ? 0 : EPOLLIN) | EPOLLRDHUP;
+
+	if(m_bEdgeTrigger)
+		return evts | EPOLLOUT | EPOLLET;
+
+	return evts | (pSocketObj->IsPending() ? EPOLLOUT : 0) | EPOLLONESHOT;
+}
+
+VOID CTcpAgent::UnlockIo(TAgentSocketObj* pSocketObj)
+{
 	pSocketObj->csIo.unlock();
+
+	if(!m_bEdgeTrigger)
+		return;
+
+	UINT evts = pSocketObj->ReleaseIo();
+
+	if(evts != 0 && TAgentSocketObj::IsValid(pSocketObj))
+		VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_IO, pSocketObj->connID, evts));
 }
 
 VOID CTcpAgent::OnCommand(TDispCommand* pCmd)
@@ -868,6 +1076,12 @@ VOID CTcpAgent::OnCommand(TDispCommand* pCmd)
 	case DISP_CMD_SEND:
 		HandleCmdSend((CONNID)(pCmd->wParam));
 		break;
+	case DISP_CMD_RECEIVE:
+		HandleCmdReceive((CONNID)(pCmd->wParam));
+		break;
+	case DISP_CMD_IO:
+		HandleCmdIo((CONNID)(pCmd->wParam), (UINT)(pCmd->lParam));
+		break;
 	case DISP_CMD_UNPAUSE:
 		HandleCmdUnpause((CONNID)(pCmd->wParam));
 		break;
@@ -877,14 +1091,70 @@ VOID CTcpAgent::OnCommand(TDispCommand* pCmd)
 	}
 }
 
+VOID CTcpAgent::OnTimer(int iShard, LLONG llExpirations)
+{
+	ASSERT(iShard >= 0 && iShard < m_iConnTimers);
+
+	/* 定时把空闲线程缓存槽中的内存块归还共享缓存池 */
+	if(iShard == 0)
+		m_bfObjPool.FlushIdleCache();
+
+	TConnTimerList timers;
+
+	if(m_pConnTimers[iShard].Advance(timers) == 0)
+		return;
+
+	for(size_t i = 0; i < timers.size(); i++)
+	{
+		const TConnTimer& timer = timers[i];
+		TAgentSocketObj* pSocketObj	= FindSocketObj(timer.connID);
+
+		if(!TAgentSocketObj::IsValid(pSocketObj))
+			continue;
+
+		if(timer.fnTimer == nullptr)
+			HandleTimeout(pSocketObj);
+		else
+			timer.fnTimer(timer.connID, timer.pvParam);
+	}
+}
+
+VOID CTcpAgent::HandleTimeout(TAgentSocketObj* pSocketObj)
+{
+	DWORD dwRemain;
+	DWORD dwSilenceTimeout	 = m_bMarkSilence ? m_dwSilenceTimeout : 0;
+	DWORD dwHandShakeTimeout = IsHandShaked(pSocketObj) ? 0 : m_dwHandShakeTimeout;
+
+	if(pSocketObj->IsTimeout(m_dwMaxConnectPeriod, dwSilenceTimeout, dwHandShakeTimeout, dwRemain))
+		Disconnect(pSocketObj->connID);
+	else if(dwRemain > 0)
+		ArmTimer(pSocketObj, &pSocketObj->sysTimer, dwRemain);
+}
+
 VOID CTcpAgent::HandleCmdSend(CONNID dwConnID)
 {
 	TAgentSocketObj* pSocketObj = FindSocketObj(dwConnID);
 
-	if(TAgentSocketObj::IsValid(pSocketObj) && pSocketObj->IsPending())
+	if(TAgentSocketObj::IsValid(pSocketObj) && (pSocketObj->IsPending() || pSocketObj->IsNotifyPending()))
 		m_ioDispatcher.ProcessIo(pSocketObj, EPOLLOUT);
 }
 
+VOID CTcpAgent::HandleCmdReceive(CONNID dwConnID)
+{
+	TAgentSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(TAgentSocketObj::IsValid(pSocketObj) && !pSocketObj->IsPaused())
+		m_ioDispatcher.ProcessIo(pSocketObj, EPOLLIN);
+}
+
+VOID CTcpAgent::HandleCmdIo(CONNID dwConnID, UINT events)
+{
+	TAgentSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(TAgentSocketObj::IsValid(pSocketObj))
+		m_ioDispatcher.ProcessIo(pSocketObj, events);
+}
+
 VOID CTcpAgent::HandleCmdUnpause(CONNID dwConnID)
 {
 	TAgentSocketObj* pSocketObj = FindSocketObj(dwConnID);
@@ -978,8 +1248,8 @@ BOOL CTcpAgent::HandleConnect(TAgentSocketObj* pSocketObj, UINT events)
 		return FALSE;
 	}
 
-	UINT evts = (pSocketObj->IsPending() ? EPOLLOUT : 0) | (pSocketObj->IsPaused() ? 0 : EPOLLIN);
-	m_ioDispatcher.ModFD(pSocketObj->socket, evts | EPOLLRDHUP | EPOLLONESHOT, pSocketObj);
+	pSocketObj->ioEvents = GetIoEvents(pSocketObj);
+	m_ioDispatcher.ModFD(pSocketObj->shard, pSocketObj->socket, pSocketObj->ioEvents, pSocketObj);
 
 	return TRUE;
 }
@@ -990,20 +1260,38 @@ BOOL CTcpAgent::HandleReceive(TAgentSocketObj* pSocketObj, int flag)
 
 	if(m_bMarkSilence) pSocketObj->activeTime = ::TimeGetTime();
 
-	CBufferPtr& buffer = *(m_rcBufferMap[SELF_THREAD_ID]);
+	CBufferPtr& buffer	= *(m_rcBufferMap[SELF_THREAD_ID]);
+	TItem** ppItem		= m_bDetachableReceive ? &m_rcItemMap[SELF_THREAD_ID] : nullptr;
 
-	int reads = flag ? -1 : MAX_CONTINUE_READS;
+	int i		= 0;
+	int reads	= flag ? -1 : MAX_CONTINUE_READS;
 
-	for(int i = 0; i < reads || reads < 0; i++)
+	for(; i < reads || reads < 0; i++)
 	{
 		if(pSocketObj->paused)
 			break;
 
-		int rc = (int)read(pSocketObj->socket, buffer.Ptr(), buffer.Size());
+		BYTE* pBuffer	= buffer.Ptr();
+		int iBufferSize	= (int)buffer.Size();
+
+		/* 可分离接收模式直接读入数据块，OnReceive 事件中可通过 DetachReceiveBuffer() 取走该数据块 */
+		if(ppItem != nullptr)
+		{
+			if(*ppItem == nullptr)
+				*ppItem = m_bfObjPool.PickFreeItem();
+
+			pBuffer		= (*ppItem)->Ptr();
+			iBufferSize	= (*ppItem)->Capacity();
+		}
+
+		int rc = (int)read(pSocketObj->socket, pBuffer, iBufferSize);
 
 		if(rc > 0)
 		{
-			if(TRIGGER(FireReceive(pSocketObj, buffer.Ptr(), rc)) == HR_ERROR)
+			if(ppItem != nullptr)
+				(*ppItem)->Reset(0, rc);
+
+			if(TRIGGER(FireReceive(pSocketObj, pBuffer, rc)) == HR_ERROR)
 			{
 				TRACE("<C-CNNID: %zu> OnReceive() event return 'HR_ERROR', connection will be closed !", pSocketObj->connID);
 
@@ -1030,6 +1318,9 @@ BOOL CTcpAgent::HandleReceive(TAgentSocketObj* pSocketObj, int flag)
 		}
 	}
 
+	if(i == reads && m_bEdgeTrigger)
+		VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_RECEIVE, pSocketObj->connID));
+
 	return TRUE;
 }
 
@@ -1037,74 +1328,204 @@ BOOL CTcpAgent::HandleSend(TAgentSocketObj* pSocketObj, int flag)
 {
 	ASSERT(TAgentSocketObj::IsValid(pSocketObj));
 
-	if(!pSocketObj->IsPending())
+	if(!pSocketObj->IsPending() && !pSocketObj->IsNotifyPending())
 		return TRUE;
 
 	CReentrantCriSecLock locallock(pSocketObj->csSend);
 
+	if(pSocketObj->IsNotifyPending())
+		FlushSendNotify(pSocketObj);
+
 	if(!pSocketObj->IsPending())
 		return TRUE;
 
-	BOOL isOK = TRUE;
+	BOOL isOK		= TRUE;
+	BOOL bBlocked	= FALSE;
 
-	int writes = flag ? -1 : MAX_CONTINUE_WRITES;
-	TBufferObjList& sndBuff = pSocketObj->sndBuff;
+	int i		= 0;
+	int writes	= flag ? -1 : MAX_CONTINUE_WRITES;
 
-	for(int i = 0; i < writes || writes < 0; i++)
+	for(; i < writes || writes < 0; i++)
 	{
-		TItemPtr itPtr(sndBuff, sndBuff.PopFront());
+		if(!pSocketObj->IsPending())
+			break;
+
+		isOK = SendItems(pSocketObj, bBlocked);
 
-		if(!itPtr.IsValid())
+		if(!isOK || bBlocked)
 			break;
+	}
 
-		ASSERT(!itPtr->IsEmpty());
+	if(i == writes && m_bEdgeTrigger && pSocketObj->IsPending())
+		VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_SEND, pSocketObj->connID));
 
-		isOK = SendItem(pSocketObj, itPtr);
+	return isOK;
+}
 
-		if(!isOK)
-			break;
+BOOL CTcpAgent::SendItems(TAgentSocketObj* pSocketObj, BOOL& bBlocked)
+{
+	TBufferObjList& sndBuff = pSocketObj->sndBuff;
+
+	iovec iov[MAX_SEND_IOV_COUNT];
+	int iLength	= 0;
+	int iCount	= sndBuff.Gather(iov, MAX_SEND_IOV_COUNT, iLength);
+	int rc;
 
-		if(!itPtr->IsEmpty())
+	if(iCount > 0)
+		rc = (int)writev(pSocketObj->socket, iov, iCount);
+	else
+	{
+		/* 前部为文件区域数据块，使用 sendfile() 直接从文件发送 */
+		TItem* pItem = sndBuff.Front();
+
+		iLength	= pItem->Size();
+		rc		= (int)pItem->SendFile(pSocketObj->socket);
+	}
+
+	ASSERT(iLength > 0);
+
+	if(rc > 0)
+	{
+		if(iCount > 0)
+			NotifySend(pSocketObj, iov, rc);
+		else
+			NotifySend(pSocketObj, (const BYTE*)nullptr, rc);
+
+		/* 文件区域数据块移动到下一个窗口时发送队列长度会增加，按净减少量计算 */
+		int iPending = pSocketObj->Pending();
+
+		sndBuff.Reduce(rc);
+		ReduceSendPending(pSocketObj, iPending - pSocketObj->Pending());
+
+		bBlocked = (rc < iLength);
+	}
+	else if(rc == SOCKET_ERROR)
+	{
+		int code = ::WSAGetLastError();
+
+		if(code == ERROR_WOULDBLOCK)
+			bBlocked = TRUE;
+		else
 		{
-			sndBuff.PushFront(itPtr.Detach());
-			break;
+			AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_SEND, code);
+			return FALSE;
 		}
 	}
+	else if(iCount == 0)
+	{
+		/* 文件在发送过程中被截断 */
+		AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_SEND, ERROR_READ_FAULT);
+		return FALSE;
+	}
+	else
+		ASSERT(FALSE);
 
-	return isOK;
+	return TRUE;
 }
 
-BOOL CTcpAgent::SendItem(TAgentSocketObj* pSocketObj, TItem* pItem)
+void CTcpAgent::NotifySend(TAgentSocketObj* pSocketObj, const iovec iov[], int iSent)
 {
-	while(!pItem->IsEmpty())
+	if(m_bBatchSendNotify)
+		NotifySend(pSocketObj, (const BYTE*)nullptr, iSent);
+	else
 	{
-		int rc = (int)write(pSocketObj->socket, pItem->Ptr(), pItem->Size());
-
-		if(rc > 0)
+		for(int i = 0; iSent > 0; i++)
 		{
-			if(TRIGGER(FireSend(pSocketObj, pItem->Ptr(), rc)) == HR_ERROR)
-			{
-				TRACE("<C-CNNID: %zu> OnSend() event should not return 'HR_ERROR' !!", pSocketObj->connID);
-				ASSERT(FALSE);
-			}
+			int iLength = min((int)iov[i].iov_len, iSent);
+			NotifySend(pSocketObj, (const BYTE*)iov[i].iov_base, iLength);
 
-			pItem->Reduce(rc);
+			iSent -= iLength;
 		}
-		else if(rc == SOCKET_ERROR)
-		{
-			int code = ::WSAGetLastError();
+	}
+}
 
-			if(code == ERROR_WOULDBLOCK)
-				break;
+/* 直接发送的数据全部写入 Socket 后，在调用线程中释放发送锁后触发 OnSend 事件 */
+void CTcpAgent::NotifyDirectSend(TAgentSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int iSent)
+{
+	if(!TAgentSocketObj::IsValid(pSocketObj))
+		return;
 
-			AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_SEND, code);
-			return FALSE;
+	if(m_bBatchSendNotify)
+		NotifySend(pSocketObj, (const BYTE*)nullptr, iSent);
+	else
+	{
+		for(int i = 0; i < iCount; i++)
+		{
+			if(pBuffers[i].len > 0)
+				NotifySend(pSocketObj, (const BYTE*)pBuffers[i].buf, (int)pBuffers[i].len);
 		}
-		else
-			ASSERT(FALSE);
 	}
+}
 
-	return TRUE;
+/* 直接发送只写入部分数据时，已发送部分只记录长度，由工作线程在发送剩余数据前触发 OnSend 事件（pData 为 nullptr） */
+void CTcpAgent::FlushSendNotify(TAgentSocketObj* pSocketObj)
+{
+	int iLength = pSocketObj->sndNotifyLen;
+	pSocketObj->sndNotifyLen = 0;
+
+	NotifySend(pSocketObj, (const BYTE*)nullptr, iLength);
+}
+
+void CTcpAgent::NotifySend(TAgentSocketObj* pSocketObj, const BYTE* pData, int iLength)
+{
+	if(TRIGGER(FireSend(pSocketObj, pData, iLength)) == HR_ERROR)
+	{
+		TRACE("<C-CNNID: %zu> OnSend() event should not return 'HR_ERROR' !!", pSocketObj->connID);
+		ASSERT(FALSE);
+	}
+}
+
+void CTcpAgent::NotifyWritable(TAgentSocketObj* pSocketObj, BOOL bWritable)
+{
+	if(TRIGGER(FireWritable(pSocketObj, bWritable)) == HR_ERROR)
+	{
+		TRACE("<C-CNNID: %zu> OnWritable() event should not return 'HR_ERROR' !!", pSocketObj->connID);
+		ASSERT(FALSE);
+	}
+}
+
+/* 检查是否允许发送新的应用数据：待发数据超过高水位或总量超过 MaxSendPending 时拒绝发送 */
+BOOL CTcpAgent::CheckSendQuota(TAgentSocketObj* pSocketObj)
+{
+	int result = NO_ERROR;
+
+	if(pSocketObj->sndBlocked)
+		result = ERROR_WOULDBLOCK;
+	else if(IsSendPendingLimited() && m_llSendPending >= (LLONG)m_dwMaxSendPending)
+		result = ERROR_NOT_ENOUGH_QUOTA;
+
+	if(result != NO_ERROR)
+		::SetLastError(result);
+
+	return (result == NO_ERROR);
+}
+
+/* 统计新加入发送缓冲区的数据（iPending 为加入前的待发数据长度），达到高水位时触发 OnWritable(FALSE)（在 csSend 锁内调用） */
+void CTcpAgent::AddSendPending(TAgentSocketObj* pSocketObj, int iPending)
+{
+	int iCurPending = pSocketObj->Pending();
+
+	if(IsSendPendingLimited() && iCurPending != iPending)
+		::InterlockedExchangeAdd(&m_llSendPending, (LLONG)(iCurPending - iPending));
+
+	if(m_dwSendHighWatermark > 0 && !pSocketObj->sndBlocked && iCurPending >= (int)m_dwSendHighWatermark)
+	{
+		pSocketObj->sndBlocked = TRUE;
+		NotifyWritable(pSocketObj, FALSE);
+	}
+}
+
+/* 统计已从发送缓冲区发出的数据，降到低水位以下时触发 OnWritable(TRUE)（在 csSend 锁内调用） */
+void CTcpAgent::ReduceSendPending(TAgentSocketObj* pSocketObj, int iLength)
+{
+	if(IsSendPendingLimited())
+		::InterlockedExchangeSub(&m_llSendPending, (LLONG)iLength);
+
+	if(pSocketObj->sndBlocked && pSocketObj->Pending() <= (int)m_dwSendLowWatermark)
+	{
+		pSocketObj->sndBlocked = FALSE;
+		NotifyWritable(pSocketObj, TRUE);
+	}
 }
 
 BOOL CTcpAgent::Send(CONNID dwConnID, const BYTE* pBuffer, int iLength, int iOffset)
@@ -1132,6 +1553,9 @@ BOOL CTcpAgent::DoSendPackets(CONNID dwConnID, const WSABUF pBuffers[], int iCou
 		return FALSE;
 	}
 
+	if(!CheckSendQuota(pSocketObj))
+		return FALSE;
+
 	return DoSendPackets(pSocketObj, pBuffers, iCount);
 }
 
@@ -1139,7 +1563,8 @@ BOOL CTcpAgent::DoSendPackets(TAgentSocketObj* pSocketObj, const WSABUF pBuffers
 {
 	ASSERT(pSocketObj && pBuffers && iCount > 0);
 
-	int result = NO_ERROR;
+	int result	= NO_ERROR;
+	int iDirect	= 0;
 
 	if(!pSocketObj->HasConnected())
 	{
@@ -1151,24 +1576,35 @@ BOOL CTcpAgent::DoSendPackets(TAgentSocketObj* pSocketObj, const WSABUF pBuffers
 	{
 		CReentrantCriSecLock locallock(pSocketObj->csSend);
 
-		if(TAgentSocketObj::IsValid(pSocketObj))
-			result = SendInternal(pSocketObj, pBuffers, iCount);
-		else
+		if(!TAgentSocketObj::IsValid(pSocketObj))
 			result = ERROR_OBJECT_NOT_FOUND;
+		else
+		{
+			int iPending = pSocketObj->Pending();
+
+			result = SendInternal(pSocketObj, pBuffers, iCount, iDirect);
+			AddSendPending(pSocketObj, iPending);
+		}
 	}
 	else
 		result = ERROR_INVALID_PARAMETER;
 
+	if(iDirect > 0)
+		NotifyDirectSend(pSocketObj, pBuffers, iCount, iDirect);
+
 	if(result != NO_ERROR)
 		::SetLastError(result);
 
 	return (result == NO_ERROR);
 }
 
-int CTcpAgent::SendInternal(TAgentSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount)
+int CTcpAgent::SendInternal(TAgentSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int& iDirect)
 {
 	int iPending = pSocketObj->Pending();
 
+	if(iPending == 0 && m_enSendPolicy == SP_DIRECT && iCount <= MAX_SEND_IOV_COUNT)
+		return SendDirect(pSocketObj, pBuffers, iCount, iDirect);
+
 	for(int i = 0; i < iCount; i++)
 	{
 		int iBufLen = pBuffers[i].len;
@@ -1184,13 +1620,281 @@ int CTcpAgent::SendInternal(TAgentSocketObj* pSocketObj, const WSABUF pBuffers[]
 
 	if(iPending == 0 && pSocketObj->IsPending())
 	{
-		if(!m_ioDispatcher.SendCommand(DISP_CMD_SEND, pSocketObj->connID))
+		if(!m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_SEND, pSocketObj->connID))
 			return ::GetLastError();
 	}
 
 	return NO_ERROR;
 }
 
+int CTcpAgent::SendDirect(TAgentSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int& iDirect)
+{
+	iovec iov[MAX_SEND_IOV_COUNT];
+	int iLength	= 0;
+	int iVecs	= 0;
+
+	for(int i = 0; i < iCount; i++)
+	{
+		int iBufLen = pBuffers[i].len;
+
+		if(iBufLen > 0)
+		{
+			ASSERT(pBuffers[i].buf);
+
+			iov[iVecs].iov_base	= pBuffers[i].buf;
+			iov[iVecs].iov_len	= iBufLen;
+
+			iLength += iBufLen;
+			++iVecs;
+		}
+	}
+
+	if(iVecs == 0)
+		return NO_ERROR;
+
+	int rc = (int)writev(pSocketObj->socket, iov, iVecs);
+
+	if(rc == SOCKET_ERROR)
+	{
+		int code = ::WSAGetLastError();
+
+		if(code != ERROR_WOULDBLOCK)
+			return code;
+
+		rc = 0;
+	}
+
+	/* 已有未触发的 OnSend 事件时，工作线程尚未处理的 DISP_CMD_SEND 命令会一并处理本次发送 */
+	BOOL bPost = !pSocketObj->IsNotifyPending();
+
+	if(rc == iLength && bPost)
+	{
+		iDirect = rc;
+		return NO_ERROR;
+	}
+
+	pSocketObj->sndNotifyLen += rc;
+
+	for(int i = 0, iSkip = rc; i < iVecs; i++)
+	{
+		int iBufLen = (int)iov[i].iov_len;
+
+		if(iSkip >= iBufLen)
+			iSkip -= iBufLen;
+		else
+		{
+			pSocketObj->sndBuff.Cat((const BYTE*)iov[i].iov_base + iSkip, iBufLen - iSkip);
+			iSkip = 0;
+		}
+	}
+
+	if(bPost && !m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_SEND, pSocketObj->connID))
+		return ::GetLastError();
+
+	return NO_ERROR;
+}
+
+BOOL CTcpAgent::SendReference(CONNID dwConnID, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam)
+{
+	ASSERT(pBuffer && iLength > 0);
+
+	int result	= NO_ERROR;
+	int iDirect	= 0;
+
+	if(pBuffer && iLength > 0)
+	{
+		TAgentSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+		if(!TAgentSocketObj::IsValid(pSocketObj))
+			result = ERROR_OBJECT_NOT_FOUND;
+		else if(!pSocketObj->HasConnected())
+			result = ERROR_INVALID_STATE;
+		else
+		{
+			{
+				CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+				if(!TAgentSocketObj::IsValid(pSocketObj))
+					result = ERROR_OBJECT_NOT_FOUND;
+				else if(!CheckSendQuota(pSocketObj))
+					result = ::GetLastError();
+				else
+				{
+					int iPending = pSocketObj->Pending();
+
+					result = SendReference(pSocketObj, pBuffer, iLength, fnRelease, pvParam, iDirect);
+					AddSendPending(pSocketObj, iPending);
+				}
+			}
+
+			if(iDirect > 0)
+			{
+				WSABUF buffer;
+				buffer.len = iLength;
+				buffer.buf = (BYTE*)pBuffer;
+
+				NotifyDirectSend(pSocketObj, &buffer, 1, iDirect);
+
+				if(fnRelease != nullptr)
+					fnRelease(pBuffer, iLength, pvParam, TRUE);
+			}
+		}
+	}
+	else
+		result = ERROR_INVALID_PARAMETER;
+
+	if(result != NO_ERROR)
+	{
+		if(fnRelease != nullptr)
+			fnRelease(pBuffer, iLength, pvParam, FALSE);
+
+		::SetLastError(result);
+	}
+
+	return (result == NO_ERROR);
+}
+
+int CTcpAgent::SendReference(TAgentSocketObj* pSocketObj, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam, int& iDirect)
+{
+	int iPending = pSocketObj->Pending();
+	int iSent	 = 0;
+
+	if(iPending == 0 && m_enSendPolicy == SP_DIRECT)
+	{
+		iovec iov;
+		iov.iov_base = (PVOID)pBuffer;
+		iov.iov_len	 = iLength;
+
+		int rc = (int)writev(pSocketObj->socket, &iov, 1);
+
+		if(rc == SOCKET_ERROR)
+		{
+			int code = ::WSAGetLastError();
+
+			if(code != ERROR_WOULDBLOCK)
+				return code;
+		}
+		else if(rc > 0)
+		{
+			/* 全部发送完成后由调用者释放锁后触发 OnSend 事件并调用 fnRelease */
+			if(rc == iLength && !pSocketObj->IsNotifyPending())
+			{
+				iDirect = rc;
+				return NO_ERROR;
+			}
+
+			iSent = rc;
+			pSocketObj->sndNotifyLen += rc;
+		}
+	}
+
+	/* 缓冲区引用加入发送队列后由发送队列负责调用 fnRelease */
+	pSocketObj->sndBuff.Attach(pBuffer, iLength, fnRelease, pvParam);
+
+	if(iSent > 0)
+		pSocketObj->sndBuff.Reduce(iSent);
+
+	if(iPending == 0)
+		VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_SEND, pSocketObj->connID));
+
+	return NO_ERROR;
+}
+
+BOOL CTcpAgent::Broadcast(const CONNID pConnIDs[], int iConnCount, const BYTE* pBuffer, int iLength)
+{
+	ASSERT(pBuffer && iLength > 0);
+
+	WSABUF buffer;
+	buffer.len = iLength;
+	buffer.buf = (BYTE*)pBuffer;
+
+	return BroadcastPackets(pConnIDs, iConnCount, &buffer, 1);
+}
+
+BOOL CTcpAgent::BroadcastPackets(const CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount)
+{
+	ASSERT(pConnIDs && iConnCount > 0 && pBuffers && iCount > 0);
+
+	int iLength = 0;
+
+	for(int i = 0; pBuffers && i < iCount; i++)
+		iLength += (int)pBuffers[i].len;
+
+	if(!pConnIDs || iConnCount <= 0 || iLength <= 0)
+	{
+		::SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	TSharedItem* pShared = TSharedItem::Construct(m_bfObjPool.GetPrivateHeap(), iLength);
+	BYTE* pData			 = pShared->Ptr();
+
+	for(int i = 0; i < iCount; i++)
+	{
+		if(pBuffers[i].len > 0)
+		{
+			memcpy(pData, pBuffers[i].buf, pBuffers[i].len);
+			pData += pBuffers[i].len;
+		}
+	}
+
+	int result = NO_ERROR;
+
+	for(int i = 0; i < iConnCount; i++)
+	{
+		pShared->AddRef();
+
+		if(!CTcpAgent::SendReference(pConnIDs[i], pShared->Ptr(), iLength, TSharedItem::ReleaseRef, pShared))
+			result = ::GetLastError();
+	}
+
+	pShared->Release();
+
+	if(result != NO_ERROR)
+		::SetLastError(result);
+
+	return (result == NO_ERROR);
+}
+
+BOOL CTcpAgent::DetachReceiveBuffer(const BYTE* pData, int iLength, PVOID* ppBuffer)
+{
+	ASSERT(pData && iLength > 0 && ppBuffer);
+
+	TReceiveItemMapI it = m_rcItemMap.find(SELF_THREAD_ID);
+
+	/* 只能在 OnReceive 事件中分离，并且 OnReceive 事件的数据必须是未经加工的完整接收数据 */
+	if(it == m_rcItemMap.end() || it->second == nullptr || it->second->Ptr() != pData || it->second->Size() != iLength)
+	{
+		::SetLastError(ERROR_INVALID_STATE);
+		return FALSE;
+	}
+
+	*ppBuffer	= it->second;
+	it->second	= nullptr;
+
+	::InterlockedIncrement(&m_lDetachedBuffers);
+
+	return TRUE;
+}
+
+BOOL CTcpAgent::ReleaseReceiveBuffer(PVOID pBuffer)
+{
+	ASSERT(pBuffer);
+
+	if(pBuffer == nullptr)
+	{
+		::SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	m_bfObjPool.PutFreeItem((TItem*)pBuffer);
+
+	/* 计数最后递减：Stop() 在计数归零之后才会清理缓冲池 */
+	::InterlockedDecrement(&m_lDetachedBuffers);
+
+	return TRUE;
+}
+
 BOOL CTcpAgent::SendSmallFile(CONNID dwConnID, LPCTSTR lpszFileName, const LPWSABUF pHead, const LPWSABUF pTail)
 {
 	CFile file;
@@ -1207,3 +1911,64 @@ BOOL CTcpAgent::SendSmallFile(CONNID dwConnID, LPCTSTR lpszFileName, const LPWSA
 
 	return SendPackets(dwConnID, szBuf, 3);
 }
+
+BOOL CTcpAgent::SendFile(CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	CFile file;
+	HRESULT result = ::OpenFileRegion(lpszFileName, file, llOffset, llLength, pHead, pTail);
+
+	if(SUCCEEDED(result))
+	{
+		TAgentSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+		if(!TAgentSocketObj::IsValid(pSocketObj))
+			result = ERROR_OBJECT_NOT_FOUND;
+		else if(!pSocketObj->HasConnected())
+			result = ERROR_INVALID_STATE;
+		else
+		{
+			CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+			if(!TAgentSocketObj::IsValid(pSocketObj))
+				result = ERROR_OBJECT_NOT_FOUND;
+			else if(!CheckSendQuota(pSocketObj))
+				result = ::GetLastError();
+			else
+			{
+				int iPending = pSocketObj->Pending();
+
+				result = SendFileRegion(pSocketObj, file, llOffset, llLength, pHead, pTail);
+				AddSendPending(pSocketObj, iPending);
+			}
+		}
+	}
+
+	if(result != NO_ERROR)
+		::SetLastError(result);
+
+	return (result == NO_ERROR);
+}
+
+int CTcpAgent::SendFileRegion(TAgentSocketObj* pSocketObj, CFile& file, LLONG llOffset, LLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	int iPending	= pSocketObj->Pending();
+	int iHead		= pHead ? (int)pHead->len : 0;
+	int iTail		= pTail ? (int)pTail->len : 0;
+	int iWindow		= (int)MIN(llLength, (LLONG)TItem::MAX_FILE_WINDOW_SIZE);
+
+	/* 发送队列长度为 32 位整数（文件区域每次只占用一个窗口的长度） */
+	if(iHead + iWindow + iTail > MAX_SEND_FILE_SIZE - iPending)
+		return ERROR_NOT_ENOUGH_QUOTA;
+
+	/* 文件数据不拷贝到发送队列，由发送队列接管文件并在发送时使用 sendfile() */
+	TBufferObjList& sndBuff = pSocketObj->sndBuff;
+
+	if(iHead > 0) sndBuff.Cat((const BYTE*)pHead->buf, iHead);
+	if(llLength > 0) sndBuff.AttachFile(file.Detach(), llOffset, llLength);
+	if(iTail > 0) sndBuff.Cat((const BYTE*)pTail->buf, iTail);
+
+	if(iPending == 0)
+		VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_SEND, pSocketObj->connID));
+
+	return NO_ERROR;
+}
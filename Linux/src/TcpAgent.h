@@ -35,13 +35,21 @@ public:
 	virtual BOOL Connect(LPCTSTR lpszRemoteAddress, USHORT usPort, CONNID* pdwConnID = nullptr, PVOID pExtra = nullptr, USHORT usLocalPort = 0);
 	virtual BOOL Send	(CONNID dwConnID, const BYTE* pBuffer, int iLength, int iOffset = 0);
 	virtual BOOL SendSmallFile	(CONNID dwConnID, LPCTSTR lpszFileName, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr);
+	virtual BOOL SendFile		(CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset = 0, LONGLONG llLength = 0, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr);
 	virtual BOOL SendPackets	(CONNID dwConnID, const WSABUF pBuffers[], int iCount)	{return DoSendPackets(dwConnID, pBuffers, iCount);}
+	virtual BOOL SendReference	(CONNID dwConnID, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam = nullptr);
+	virtual BOOL Broadcast		(const CONNID pConnIDs[], int iConnCount, const BYTE* pBuffer, int iLength);
+	virtual BOOL BroadcastPackets	(const CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount);
+	virtual BOOL DetachReceiveBuffer	(const BYTE* pData, int iLength, PVOID* ppBuffer);
+	virtual BOOL ReleaseReceiveBuffer	(PVOID pBuffer);
 	virtual BOOL PauseReceive	(CONNID dwConnID, BOOL bPause = TRUE);
 	virtual BOOL			HasStarted					()	{return m_enState == SS_STARTED || m_enState == SS_STARTING;}
 	virtual EnServiceState	GetState					()	{return m_enState;}
 	virtual BOOL			Disconnect					(CONNID dwConnID, BOOL bForce = TRUE);
 	virtual BOOL			DisconnectLongConnections	(DWORD dwPeriod, BOOL bForce = TRUE);
 	virtual BOOL			DisconnectSilenceConnections(DWORD dwPeriod, BOOL bForce = TRUE);
+	virtual BOOL			SetConnectionTimer			(CONNID dwConnID, DWORD dwTimeout, Fn_ConnectionTimer fnTimer, PVOID pvParam = nullptr);
+	virtual BOOL			KillConnectionTimer			(CONNID dwConnID);
 	virtual BOOL			GetLocalAddress				(CONNID dwConnID, TCHAR lpszAddress[], int& iAddressLen, USHORT& usPort);
 	virtual BOOL			GetRemoteAddress			(CONNID dwConnID, TCHAR lpszAddress[], int& iAddressLen, USHORT& usPort);
 	virtual BOOL			GetRemoteHost				(CONNID dwConnID, TCHAR lpszHost[], int& iHostLen, USHORT& usPort);
@@ -49,6 +57,7 @@ public:
 	virtual BOOL IsConnected			(CONNID dwConnID);
 	virtual BOOL IsPauseReceive			(CONNID dwConnID, BOOL& bPaused);
 	virtual BOOL GetPendingDataLength	(CONNID dwConnID, int& iPending);
+	virtual void GetFreeBufferObjCacheStat	(ULONGLONG& ullHits, ULONGLONG& ullMisses)	{m_bfObjPool.GetCacheStat(ullHits, ullMisses);}
 	virtual DWORD GetConnectionCount	();
 	virtual BOOL GetAllConnectionIDs	(CONNID pIDs[], DWORD& dwCount);
 	virtual BOOL GetConnectPeriod		(CONNID dwConnID, DWORD& dwPeriod);
@@ -60,6 +69,7 @@ private:
 	virtual BOOL OnBeforeProcessIo(PVOID pv, UINT events)			override;
 	virtual VOID OnAfterProcessIo(PVOID pv, UINT events, BOOL rs)	override;
 	virtual VOID OnCommand(TDispCommand* pCmd)						override;
+	virtual VOID OnTimer(int iShard, LLONG llExpirations)			override;
 	virtual BOOL OnReadyRead(PVOID pv, UINT events)					override;
 	virtual BOOL OnReadyWrite(PVOID pv, UINT events)				override;
 	virtual BOOL OnHungUp(PVOID pv, UINT events)					override;
@@ -83,6 +93,7 @@ public:
 
 	virtual void SetSendPolicy				(EnSendPolicy enSendPolicy)				{m_enSendPolicy			= enSendPolicy;}
 	virtual void SetOnSendSyncPolicy		(EnOnSendSyncPolicy enOnSendSyncPolicy)	{m_enOnSendSyncPolicy	= enOnSendSyncPolicy;}
+	virtual void SetDispatchMode			(EnDispatchMode enDispatchMode)			{m_enDispatchMode		= enDispatchMode;}
 	virtual void SetMaxConnectionCount		(DWORD dwMaxConnectionCount)	{m_dwMaxConnectionCount		= dwMaxConnectionCount;}
 	virtual void SetWorkerThreadCount		(DWORD dwWorkerThreadCount)		{m_dwWorkerThreadCount		= dwWorkerThreadCount;}
 	virtual void SetSocketBufferSize		(DWORD dwSocketBufferSize)		{m_dwSocketBufferSize		= dwSocketBufferSize;}
@@ -91,13 +102,28 @@ public:
 	virtual void SetFreeBufferObjPool		(DWORD dwFreeBufferObjPool)		{m_dwFreeBufferObjPool		= dwFreeBufferObjPool;}
 	virtual void SetFreeSocketObjHold		(DWORD dwFreeSocketObjHold)		{m_dwFreeSocketObjHold		= dwFreeSocketObjHold;}
 	virtual void SetFreeBufferObjHold		(DWORD dwFreeBufferObjHold)		{m_dwFreeBufferObjHold		= dwFreeBufferObjHold;}
+	virtual void SetFreeSocketObjPrealloc	(DWORD dwFreeSocketObjPrealloc)	{m_dwFreeSocketObjPrealloc	= dwFreeSocketObjPrealloc;}
+	virtual void SetFreeBufferObjPrealloc	(DWORD dwFreeBufferObjPrealloc)	{m_dwFreeBufferObjPrealloc	= dwFreeBufferObjPrealloc;}
+	virtual void SetFreeBufferObjCache		(DWORD dwFreeBufferObjCache)	{m_dwFreeBufferObjCache		= dwFreeBufferObjCache;}
+	virtual void SetPoolNumaInterleave		(BOOL bPoolNumaInterleave)		{m_bPoolNumaInterleave		= bPoolNumaInterleave;}
 	virtual void SetKeepAliveTime			(DWORD dwKeepAliveTime)			{m_dwKeepAliveTime			= dwKeepAliveTime;}
 	virtual void SetKeepAliveInterval		(DWORD dwKeepAliveInterval)		{m_dwKeepAliveInterval		= dwKeepAliveInterval;}
 	virtual void SetReuseAddress			(BOOL bReuseAddress)			{m_bReuseAddress			= bReuseAddress;}
 	virtual void SetMarkSilence				(BOOL bMarkSilence)				{m_bMarkSilence				= bMarkSilence;}
+	virtual void SetEdgeTrigger				(BOOL bEdgeTrigger)				{m_bEdgeTrigger				= bEdgeTrigger;}
+	virtual void SetBatchSendNotify			(BOOL bBatchSendNotify)			{m_bBatchSendNotify			= bBatchSendNotify;}
+	virtual void SetDetachableReceive		(BOOL bDetachableReceive)		{m_bDetachableReceive		= bDetachableReceive;}
+	virtual void SetTimerInterval			(DWORD dwTimerInterval)			{m_dwTimerInterval			= dwTimerInterval;}
+	virtual void SetMaxConnectPeriod		(DWORD dwMaxConnectPeriod)		{m_dwMaxConnectPeriod		= dwMaxConnectPeriod;}
+	virtual void SetSilenceTimeout			(DWORD dwSilenceTimeout)		{m_dwSilenceTimeout			= dwSilenceTimeout;}
+	virtual void SetHandShakeTimeout		(DWORD dwHandShakeTimeout)		{m_dwHandShakeTimeout		= dwHandShakeTimeout;}
+	virtual void SetSendHighWatermark		(DWORD dwSendHighWatermark)		{m_dwSendHighWatermark		= dwSendHighWatermark;}
+	virtual void SetSendLowWatermark		(DWORD dwSendLowWatermark)		{m_dwSendLowWatermark		= dwSendLowWatermark;}
+	virtual void SetMaxSendPending			(DWORD dwMaxSendPending)		{m_dwMaxSendPending			= dwMaxSendPending;}
 
 	virtual EnSendPolicy GetSendPolicy				()	{return m_enSendPolicy;}
 	virtual EnOnSendSyncPolicy GetOnSendSyncPolicy	()	{return m_enOnSendSyncPolicy;}
+	virtual EnDispatchMode GetDispatchMode			()	{return m_enDispatchMode;}
 	virtual DWORD GetMaxConnectionCount		()	{return m_dwMaxConnectionCount;}
 	virtual DWORD GetWorkerThreadCount		()	{return m_dwWorkerThreadCount;}
 	virtual DWORD GetSocketBufferSize		()	{return m_dwSocketBufferSize;}
@@ -106,10 +132,24 @@ public:
 	virtual DWORD GetFreeBufferObjPool		()	{return m_dwFreeBufferObjPool;}
 	virtual DWORD GetFreeSocketObjHold		()	{return m_dwFreeSocketObjHold;}
 	virtual DWORD GetFreeBufferObjHold		()	{return m_dwFreeBufferObjHold;}
+	virtual DWORD GetFreeSocketObjPrealloc	()	{return m_dwFreeSocketObjPrealloc;}
+	virtual DWORD GetFreeBufferObjPrealloc	()	{return m_dwFreeBufferObjPrealloc;}
+	virtual DWORD GetFreeBufferObjCache		()	{return m_dwFreeBufferObjCache;}
+	virtual BOOL  IsPoolNumaInterleave		()	{return m_bPoolNumaInterleave;}
 	virtual DWORD GetKeepAliveTime			()	{return m_dwKeepAliveTime;}
 	virtual DWORD GetKeepAliveInterval		()	{return m_dwKeepAliveInterval;}
 	virtual BOOL  IsReuseAddress			()	{return m_bReuseAddress;}
 	virtual BOOL  IsMarkSilence				()	{return m_bMarkSilence;}
+	virtual BOOL  IsEdgeTrigger				()	{return m_bEdgeTrigger;}
+	virtual BOOL  IsBatchSendNotify			()	{return m_bBatchSendNotify;}
+	virtual BOOL  IsDetachableReceive		()	{return m_bDetachableReceive;}
+	virtual DWORD GetTimerInterval			()	{return m_dwTimerInterval;}
+	virtual DWORD GetMaxConnectPeriod		()	{return m_dwMaxConnectPeriod;}
+	virtual DWORD GetSilenceTimeout			()	{return m_dwSilenceTimeout;}
+	virtual DWORD GetHandShakeTimeout		()	{return m_dwHandShakeTimeout;}
+	virtual DWORD GetSendHighWatermark		()	{return m_dwSendHighWatermark;}
+	virtual DWORD GetSendLowWatermark		()	{return m_dwSendLowWatermark;}
+	virtual DWORD GetMaxSendPending			()	{return m_dwMaxSendPending;}
 
 protected:
 	virtual EnHandleResult FirePrepareConnect(CONNID dwConnID, SOCKET socket)
@@ -128,6 +168,8 @@ protected:
 		{return DoFireReceive(pSocketObj, iLength);}
 	virtual EnHandleResult FireSend(TAgentSocketObj* pSocketObj, const BYTE* pData, int iLength)
 		{return DoFireSend(pSocketObj, pData, iLength);}
+	virtual EnHandleResult FireWritable(TAgentSocketObj* pSocketObj, BOOL bWritable)
+		{return DoFireWritable(pSocketObj, bWritable);}
 	virtual EnHandleResult FireClose(TAgentSocketObj* pSocketObj, EnSocketOperation enOperation, int iErrorCode)
 		{return DoFireClose(pSocketObj, enOperation, iErrorCode);}
 	virtual EnHandleResult FireShutdown()
@@ -145,6 +187,8 @@ protected:
 		{return m_pListener->OnReceive(this, pSocketObj->connID, iLength);}
 	virtual EnHandleResult DoFireSend(TAgentSocketObj* pSocketObj, const BYTE* pData, int iLength)
 		{return m_pListener->OnSend(this, pSocketObj->connID, pData, iLength);}
+	virtual EnHandleResult DoFireWritable(TAgentSocketObj* pSocketObj, BOOL bWritable)
+		{return m_pListener->OnWritable(this, pSocketObj->connID, bWritable);}
 	virtual EnHandleResult DoFireClose(TAgentSocketObj* pSocketObj, EnSocketOperation enOperation, int iErrorCode)
 		{return m_pListener->OnClose(this, pSocketObj->connID, enOperation, iErrorCode);}
 	virtual EnHandleResult DoFireShutdown()
@@ -156,10 +200,12 @@ protected:
 	virtual void Reset();
 
 	virtual BOOL BeforeUnpause(TAgentSocketObj* pSocketObj) {return TRUE;}
+	virtual BOOL IsHandShaked(TAgentSocketObj* pSocketObj) {return TRUE;}
 	virtual void OnWorkerThreadEnd(THR_ID tid) {}
 
 	BOOL DoSendPackets(CONNID dwConnID, const WSABUF pBuffers[], int iCount);
 	BOOL DoSendPackets(TAgentSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount);
+	BOOL CheckSendQuota(TAgentSocketObj* pSocketObj);
 	TAgentSocketObj* FindSocketObj(CONNID dwConnID);
 	BOOL GetRemoteHost(CONNID dwConnID, LPCSTR* lpszHost, USHORT* pusPort = nullptr);
 
@@ -186,9 +232,11 @@ private:
 	void ReleaseClientSocket();
 	void ReleaseFreeSocket();
 	void WaitForWorkerThreadEnd();
+	void WaitForDetachedBufferRelease();
 
 	TAgentSocketObj* GetFreeSocketObj(CONNID dwConnID, SOCKET soClient);
 	TAgentSocketObj* CreateSocketObj();
+	void PreallocSocketObj();
 	void AddFreeSocketObj	(TAgentSocketObj* pSocketObj, EnSocketCloseFlag enFlag = SCF_NONE, EnSocketOperation enOperation = SO_UNKNOWN, int iErrorCode = 0);
 	void DeleteSocketObj	(TAgentSocketObj* pSocketObj);
 	BOOL InvalidSocketObj	(TAgentSocketObj* pSocketObj);
@@ -202,15 +250,39 @@ private:
 	int ConnectToServer	(CONNID dwConnID, LPCTSTR lpszRemoteAddress, SOCKET soClient, const HP_SOCKADDR& addr, PVOID pExtra);
 
 	VOID HandleCmdSend		(CONNID dwConnID);
+	VOID HandleCmdReceive	(CONNID dwConnID);
+	VOID HandleCmdIo		(CONNID dwConnID, UINT events);
 	VOID HandleCmdUnpause	(CONNID dwConnID);
 	VOID HandleCmdDisconnect(CONNID dwConnID, BOOL bForce);
+	VOID HandleTimeout		(TAgentSocketObj* pSocketObj);
 	BOOL HandleConnect		(TAgentSocketObj* pSocketObj, UINT events);
 	BOOL HandleReceive		(TAgentSocketObj* pSocketObj, int flag);
 	BOOL HandleSend			(TAgentSocketObj* pSocketObj, int flag);
 	BOOL HandleClose		(TAgentSocketObj* pSocketObj, EnSocketCloseFlag enFlag, UINT events);
 
-	int SendInternal	(TAgentSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount);
-	BOOL SendItem		(TAgentSocketObj* pSocketObj, TItem* pItem);
+	int SendInternal	(TAgentSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int& iDirect);
+	int SendDirect		(TAgentSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int& iDirect);
+	int SendReference	(TAgentSocketObj* pSocketObj, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam, int& iDirect);
+	int SendFileRegion	(TAgentSocketObj* pSocketObj, CFile& file, LLONG llOffset, LLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail);
+	BOOL SendItems		(TAgentSocketObj* pSocketObj, BOOL& bBlocked);
+	void FlushSendNotify(TAgentSocketObj* pSocketObj);
+	void NotifyDirectSend	(TAgentSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int iSent);
+	void NotifySend		(TAgentSocketObj* pSocketObj, const iovec iov[], int iSent);
+	void NotifySend		(TAgentSocketObj* pSocketObj, const BYTE* pData, int iLength);
+	void NotifyWritable	(TAgentSocketObj* pSocketObj, BOOL bWritable);
+
+	void AddSendPending		(TAgentSocketObj* pSocketObj, int iPending);
+	void ReduceSendPending	(TAgentSocketObj* pSocketObj, int iLength);
+	BOOL IsSendPendingLimited	()	{return m_dwMaxSendPending > 0;}
+
+	UINT GetIoEvents	(TAgentSocketObj* pSocketObj);
+	VOID UnlockIo		(TAgentSocketObj* pSocketObj);
+
+	BOOL ArmTimer		(TAgentSocketObj* pSocketObj, TConnTimer* pTimer, DWORD dwTimeout);
+	VOID KillTimers		(TAgentSocketObj* pSocketObj);
+	BOOL IsTimerEnabled	()	{return m_dwTimerInterval > 0;}
+	CConnTimingWheel& GetConnTimer	(TAgentSocketObj* pSocketObj)	{return m_pConnTimers[pSocketObj->shard];}
+	BOOL IsNeedCheckTimeout	()	{return IsTimerEnabled() && (m_dwMaxConnectPeriod > 0 || m_dwSilenceTimeout > 0 || m_dwHandShakeTimeout > 0);}
 
 public:
 	CTcpAgent(ITcpAgentListener* pListener)
@@ -220,6 +292,7 @@ public:
 	, m_bAsyncConnect			(TRUE)
 	, m_enSendPolicy			(SP_PACK)
 	, m_enOnSendSyncPolicy		(OSSP_NONE)
+	, m_enDispatchMode			(DM_SHARED)
 	, m_dwMaxConnectionCount	(DEFAULT_MAX_CONNECTION_COUNT)
 	, m_dwWorkerThreadCount		(DEFAULT_WORKER_THREAD_COUNT)
 	, m_dwSocketBufferSize		(DEFAULT_TCP_SOCKET_BUFFER_SIZE)
@@ -228,11 +301,28 @@ public:
 	, m_dwFreeBufferObjPool		(DEFAULT_FREE_BUFFEROBJ_POOL)
 	, m_dwFreeSocketObjHold		(DEFAULT_FREE_SOCKETOBJ_HOLD)
 	, m_dwFreeBufferObjHold		(DEFAULT_FREE_BUFFEROBJ_HOLD)
+	, m_dwFreeSocketObjPrealloc	(0)
+	, m_dwFreeBufferObjPrealloc	(0)
+	, m_dwFreeBufferObjCache	(DEFAULT_FREE_BUFFEROBJ_CACHE)
 	, m_dwKeepAliveTime			(DEFALUT_TCP_KEEPALIVE_TIME)
 	, m_dwKeepAliveInterval		(DEFALUT_TCP_KEEPALIVE_INTERVAL)
+	, m_dwTimerInterval			(DEFAULT_TIMER_INTERVAL)
+	, m_dwMaxConnectPeriod		(0)
+	, m_dwSilenceTimeout		(0)
+	, m_dwHandShakeTimeout		(0)
+	, m_dwSendHighWatermark		(0)
+	, m_dwSendLowWatermark		(0)
+	, m_dwMaxSendPending		(0)
 	, m_bReuseAddress			(FALSE)
 	, m_bMarkSilence			(TRUE)
+	, m_bPoolNumaInterleave		(FALSE)
+	, m_bEdgeTrigger			(FALSE)
+	, m_bBatchSendNotify		(FALSE)
+	, m_bDetachableReceive		(FALSE)
 	, m_soAddr					(AF_UNSPEC, TRUE)
+	, m_iConnTimers				(0)
+	, m_llSendPending			(0)
+	, m_lDetachedBuffers		(0)
 	{
 		ASSERT(m_pListener);
 	}
@@ -245,6 +335,7 @@ public:
 private:
 	EnSendPolicy m_enSendPolicy;
 	EnOnSendSyncPolicy m_enOnSendSyncPolicy;
+	EnDispatchMode m_enDispatchMode;
 	DWORD m_dwMaxConnectionCount;
 	DWORD m_dwWorkerThreadCount;
 	DWORD m_dwSocketBufferSize;
@@ -253,10 +344,24 @@ private:
 	DWORD m_dwFreeBufferObjPool;
 	DWORD m_dwFreeSocketObjHold;
 	DWORD m_dwFreeBufferObjHold;
+	DWORD m_dwFreeSocketObjPrealloc;
+	DWORD m_dwFreeBufferObjPrealloc;
+	DWORD m_dwFreeBufferObjCache;
 	DWORD m_dwKeepAliveTime;
 	DWORD m_dwKeepAliveInterval;
+	DWORD m_dwTimerInterval;
+	DWORD m_dwMaxConnectPeriod;
+	DWORD m_dwSilenceTimeout;
+	DWORD m_dwHandShakeTimeout;
+	DWORD m_dwSendHighWatermark;
+	DWORD m_dwSendLowWatermark;
+	DWORD m_dwMaxSendPending;
 	BOOL  m_bReuseAddress;
 	BOOL  m_bMarkSilence;
+	BOOL  m_bPoolNumaInterleave;
+	BOOL  m_bEdgeTrigger;
+	BOOL  m_bBatchSendNotify;
+	BOOL  m_bDetachableReceive;
 
 private:
 	ITcpAgentListener*		m_pListener;
@@ -275,6 +380,16 @@ private:
 	TAgentSocketObjPtrList	m_lsFreeSocket;
 	TAgentSocketObjPtrQueue	m_lsGCSocket;
 	TReceiveBufferMap		m_rcBufferMap;
+	TReceiveItemMap			m_rcItemMap;
 
+	/* 每个分片一个连接定时轮 */
+	unique_ptr<CConnTimingWheel[]>	m_pConnTimers;
+	int						m_iConnTimers;
 	CIODispatcher			m_ioDispatcher;
+
+	/* 所有连接待发数据总量（只在设置了 MaxSendPending 时统计） */
+	volatile LLONG			m_llSendPending;
+
+	/* 应用程序已分离但尚未归还的接收缓冲区数量 */
+	volatile LONG			m_lDetachedBuffers;
 };
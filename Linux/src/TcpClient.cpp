@@ -77,7 +77,9 @@ BOOL CTcpClient::CheckParams()
 		((int)m_dwFreeBufferPoolSize >= 0)									&&
 		((int)m_dwFreeBufferPoolHold >= 0)									&&
 		((int)m_dwKeepAliveTime >= 1000 || m_dwKeepAliveTime == 0)			&&
-		((int)m_dwKeepAliveInterval >= 1000 || m_dwKeepAliveInterval == 0)	)
+		((int)m_dwKeepAliveInterval >= 1000 || m_dwKeepAliveInterval == 0)	&&
+		((int)m_dwSendHighWatermark >= 0)									&&
+		(m_dwSendHighWatermark == 0 || m_dwSendLowWatermark < m_dwSendHighWatermark)	)
 		return TRUE;
 
 	SetLastError(SE_INVALID_PARAM, __FUNCTION__, ERROR_INVALID_PARAMETER);
@@ -120,7 +122,8 @@ BOOL CTcpClient::CheckStoping()
 			return TRUE;
 		}
 
-		if(!m_thWorker.IsInMyThread())
+		/* 共享 Reactor 的工作线程不等待其它分片完成停止（分片之间互相等待会死锁），直接返回错误 */
+		if(!IsInWorkerThread() && !IsInSharedReactorThread())
 		{
 			while(m_enState != SS_STOPPED)
 				::WaitFor(10);
@@ -229,8 +232,17 @@ BOOL CTcpClient::Stop()
 
 	SetConnected(FALSE);
 
-	WaitForWorkerThreadEnd();
+	/* 在共享 Reactor 的其它分片工作线程中停止时异步解除注册，由客户端组件所在分片的工作线程完成停止 */
+	if(!WaitForWorkerThreadEnd())
+		return TRUE;
+
+	CompleteStop();
+
+	return TRUE;
+}
 
+void CTcpClient::CompleteStop()
+{
 	if(m_ccContext.bFireOnClose)
 		FireClose(m_ccContext.enOperation, m_ccContext.iErrorCode);
 
@@ -243,35 +255,58 @@ BOOL CTcpClient::Stop()
 	}
 
 	Reset();
-
-	return TRUE;
 }
 
 void CTcpClient::Reset()
 {
-	CCriSecLock locallock(m_csSend);
+	{
+		CReentrantCriSecLock locallock(m_csSend);
 
-	m_evSend.Reset();
-	m_evRecv.Reset();
-	m_evStop.Reset();
+		m_evSend.Reset();
+		m_evRecv.Reset();
+		m_evStop.Reset();
 
-	m_lsSend.Clear();
-	m_itPool.Clear();
-	m_rcBuffer.Free();
+		m_lsSend.Clear();
+		m_bSendBlocked = FALSE;
+		m_itPool.Clear();
+		m_rcBuffer.Free();
 
-	m_strHost.Empty();
+		m_strHost.Empty();
 
-	m_usPort	= 0;
-	m_nEvents	= 0;
-	m_bPaused	= FALSE;
-	m_enState	= SS_STOPPED;
+		m_usPort	= 0;
+		m_nEvents	= 0;
+		m_bPaused	= FALSE;
+	}
+
+	/* 必须是停止过程中对本对象的最后一次写入：其它线程的 WaitForStop() 随即返回并可能销毁本对象（包括 m_csSend） */
+	m_enState = SS_STOPPED;
 }
 
-void CTcpClient::WaitForWorkerThreadEnd()
+void CTcpClient::WaitForStop()
 {
-	if(!m_thWorker.IsRunning())
+	if(m_enState == SS_STOPPED)
 		return;
 
+	/* 由其它分片异步完成的停止不能在共享 Reactor 的工作线程中等待，该线程不能销毁其它分片的客户端组件 */
+	ASSERT(!IsInSharedReactorThread());
+
+	while(m_enState != SS_STOPPED)
+		::WaitFor(10);
+}
+
+BOOL CTcpClient::IsInSharedReactorThread()
+{
+	return m_bSharedReactor && CTcpClientReactor::GetInstance().IsReactorThread();
+}
+
+BOOL CTcpClient::WaitForWorkerThreadEnd()
+{
+	if(m_pReactorSlot != nullptr)
+		return DetachReactor();
+
+	if(!m_thWorker.IsRunning())
+		return TRUE;
+
 	if(m_thWorker.IsInMyThread())
 		m_thWorker.Detach();
 	else
@@ -279,13 +314,74 @@ void CTcpClient::WaitForWorkerThreadEnd()
 		m_evStop.Set();
 		m_thWorker.Join();
 	}
+
+	return TRUE;
 }
 
 BOOL CTcpClient::CreateWorkerThread()
 {
+	if(m_bSharedReactor)
+		return AttachReactor();
+
 	return m_thWorker.Start(this, &CTcpClient::WorkerThreadProc);
 }
 
+BOOL CTcpClient::IsInWorkerThread()
+{
+	TReactorSlot* pSlot = m_pReactorSlot;
+
+	if(pSlot != nullptr)
+		return CTcpClientReactor::GetInstance().IsInReactorThread(pSlot);
+
+	return m_thWorker.IsInMyThread();
+}
+
+BOOL CTcpClient::AttachReactor()
+{
+	m_rcBuffer.Malloc(m_dwSocketBufferSize);
+
+	return CTcpClientReactor::GetInstance().Attach(this, m_soClient, (UINT)m_nEvents, m_pReactorSlot);
+}
+
+BOOL CTcpClient::DetachReactor()
+{
+	CTcpClientReactor& reactor	= CTcpClientReactor::GetInstance();
+	TReactorSlot* pSlot			= m_pReactorSlot;
+
+	if(!reactor.IsInReactorThread(pSlot))
+	{
+		/* 其它分片的工作线程不能阻塞等待（两个分片互相停止对方的客户端组件会死锁），由所在分片完成停止 */
+		BOOL bAsync = reactor.IsReactorThread();
+
+		if(reactor.SendCommand(pSlot, DISP_CMD_DETACH, bAsync))
+		{
+			if(bAsync)
+				return FALSE;
+
+			m_evStop.Wait();
+			m_pReactorSlot = nullptr;
+
+			return TRUE;
+		}
+	}
+
+	reactor.Detach(pSlot);
+	m_pReactorSlot = nullptr;
+
+	return TRUE;
+}
+
+UINT CTcpClient::GetReactorEvents()
+{
+	return (UINT)((m_lsSend.IsEmpty() ? 0 : POLLOUT) | (m_bPaused ? 0 : POLLIN) | POLLRDHUP);
+}
+
+void CTcpClient::OnReactorError()
+{
+	if(HasStarted())
+		Stop();
+}
+
 UINT WINAPI CTcpClient::WorkerThreadProc(LPVOID pv)
 {
 	TRACE("---------------> Client Worker Thread 0x%08X started <---------------", SELF_THREAD_ID);
@@ -497,7 +593,14 @@ BOOL CTcpClient::PauseReceive(BOOL bPause)
 	m_bPaused = bPause;
 
 	if(!bPause)
+	{
+		TReactorSlot* pSlot = m_pReactorSlot;
+
+		if(pSlot != nullptr)
+			return CTcpClientReactor::GetInstance().SendCommand(pSlot, DISP_CMD_UNPAUSE);
+
 		return m_evRecv.Set();
+	}
 	
 	return TRUE;
 }
@@ -507,67 +610,134 @@ BOOL CTcpClient::SendData()
 	if(m_lsSend.IsEmpty())
 		return TRUE;
 
-	CCriSecLock locallock(m_csSend);
+	CReentrantCriSecLock locallock(m_csSend);
 
 	if(m_lsSend.IsEmpty())
 		return TRUE;
 
-	BOOL isOK = TRUE;
+	BOOL isOK		= TRUE;
+	BOOL bBlocked	= FALSE;
 
-	while(TRUE)
+	while(!m_lsSend.IsEmpty())
 	{
-		TItemPtr itPtr(m_itPool, m_lsSend.PopFront());
+		isOK = DoSendData(bBlocked);
 
-		if(!itPtr.IsValid())
+		if(!isOK || bBlocked)
 			break;
+	}
 
-		ASSERT(!itPtr->IsEmpty());
+	return isOK;
+}
 
-		isOK = DoSendData(itPtr);
+BOOL CTcpClient::DoSendData(BOOL& bBlocked)
+{
+	iovec iov[MAX_SEND_IOV_COUNT];
+	int iLength	= 0;
+	int iCount	= m_lsSend.Gather(iov, MAX_SEND_IOV_COUNT, iLength);
+	int rc;
 
-		if(!isOK)
-			break;
+	if(iCount > 0)
+		rc = (int)writev(m_soClient, iov, iCount);
+	else
+	{
+		/* 前部为文件区域数据块，使用 sendfile() 直接从文件发送 */
+		TItem* pItem = m_lsSend.Front();
+
+		iLength	= pItem->Size();
+		rc		= (int)pItem->SendFile(m_soClient);
+	}
+
+	ASSERT(iLength > 0);
+
+	if(rc > 0)
+	{
+		if(m_bBatchSendNotify || iCount == 0)
+			NotifySend(nullptr, rc);
+		else
+		{
+			for(int i = 0, remain = rc; remain > 0; i++)
+			{
+				int iSent = min((int)iov[i].iov_len, remain);
+				NotifySend((const BYTE*)iov[i].iov_base, iSent);
+
+				remain -= iSent;
+			}
+		}
+
+		m_lsSend.Reduce(rc);
+		CheckSendWatermark();
 
-		if(!itPtr->IsEmpty())
+		bBlocked = (rc < iLength);
+	}
+	else if(rc == SOCKET_ERROR)
+	{
+		int code = ::WSAGetLastError();
+
+		if(code == ERROR_WOULDBLOCK)
+			bBlocked = TRUE;
+		else
 		{
-			m_lsSend.PushFront(itPtr.Detach());
-			break;
+			m_ccContext.Reset(TRUE, SO_SEND, code);
+			return FALSE;
 		}
 	}
+	else if(iCount == 0)
+	{
+		/* 文件在发送过程中被截断 */
+		m_ccContext.Reset(TRUE, SO_SEND, ERROR_READ_FAULT);
+		return FALSE;
+	}
+	else
+		ASSERT(FALSE);
 
-	return isOK;
+	return TRUE;
 }
 
-BOOL CTcpClient::DoSendData(TItem* pItem)
+void CTcpClient::NotifySend(const BYTE* pData, int iLength)
 {
-	while(!pItem->IsEmpty())
+	if(TRIGGER(FireSend(pData, iLength)) == HR_ERROR)
 	{
-		int rc = (int)write(m_soClient, (char*)pItem->Ptr(), pItem->Size());
+		TRACE("<C-CNNID: %zu> OnSend() event should not return 'HR_ERROR' !!", m_dwConnID);
+		ASSERT(FALSE);
+	}
+}
 
-		if(rc > 0)
-		{
-			if(TRIGGER(FireSend(pItem->Ptr(), rc)) == HR_ERROR)
-			{
-				TRACE("<C-CNNID: %zu> OnSend() event should not return 'HR_ERROR' !!", m_dwConnID);
-				ASSERT(FALSE);
-			}
+void CTcpClient::NotifyWritable(BOOL bWritable)
+{
+	if(TRIGGER(FireWritable(bWritable)) == HR_ERROR)
+	{
+		TRACE("<C-CNNID: %zu> OnWritable() event should not return 'HR_ERROR' !!", m_dwConnID);
+		ASSERT(FALSE);
+	}
+}
 
-			pItem->Reduce(rc);
-		}
-		else if(rc == SOCKET_ERROR)
-		{
-			int code = ::WSAGetLastError();
+/* 待发数据达到高水位时触发 OnWritable(FALSE)，降到低水位以下时触发 OnWritable(TRUE)（在 m_csSend 锁内调用） */
+void CTcpClient::CheckSendWatermark()
+{
+	if(m_dwSendHighWatermark == 0)
+		return;
 
-			if(code == ERROR_WOULDBLOCK)
-				break;
-			else
-			{
-				m_ccContext.Reset(TRUE, SO_SEND, code);
-				return FALSE;
-			}
-		}
-		else
-			ASSERT(FALSE);
+	int iPending = m_lsSend.Length();
+
+	if(!m_bSendBlocked && iPending >= (int)m_dwSendHighWatermark)
+	{
+		m_bSendBlocked = TRUE;
+		NotifyWritable(FALSE);
+	}
+	else if(m_bSendBlocked && iPending <= (int)m_dwSendLowWatermark)
+	{
+		m_bSendBlocked = FALSE;
+		NotifyWritable(TRUE);
+	}
+}
+
+/* 待发数据超过高水位时拒绝发送新的应用数据 */
+BOOL CTcpClient::CheckSendQuota()
+{
+	if(m_bSendBlocked)
+	{
+		::SetLastError(ERROR_WOULDBLOCK);
+		return FALSE;
 	}
 
 	return TRUE;
@@ -596,10 +766,13 @@ BOOL CTcpClient::DoSendPackets(const WSABUF pBuffers[], int iCount)
 	{
 		if(IsConnected())
 		{
-			CCriSecLock locallock(m_csSend);
+			CReentrantCriSecLock locallock(m_csSend);
 
 			if(IsConnected())
+			{
 				result = SendInternal(pBuffers, iCount);
+				CheckSendWatermark();
+			}
 			else
 				result = ERROR_INVALID_STATE;
 		}
@@ -633,11 +806,66 @@ int CTcpClient::SendInternal(const WSABUF pBuffers[], int iCount)
 	}
 
 	if(iPending == 0 && m_lsSend.Length() > 0)
-		m_evSend.Set();
+		ActivateSend();
 
 	return NO_ERROR;
 }
 
+void CTcpClient::ActivateSend()
+{
+	TReactorSlot* pSlot = m_pReactorSlot;
+
+	if(pSlot != nullptr)
+		CTcpClientReactor::GetInstance().SendCommand(pSlot, DISP_CMD_SEND);
+	else
+		m_evSend.Set();
+}
+
+BOOL CTcpClient::SendReference(const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam)
+{
+	ASSERT(pBuffer && iLength > 0);
+
+	int result = NO_ERROR;
+
+	if(pBuffer && iLength > 0)
+	{
+		if(IsConnected())
+		{
+			CReentrantCriSecLock locallock(m_csSend);
+
+			if(!IsConnected())
+				result = ERROR_INVALID_STATE;
+			else if(!CheckSendQuota())
+				result = ::GetLastError();
+			else
+			{
+				/* 缓冲区引用加入发送队列后由发送队列负责调用 fnRelease */
+				BOOL bEmpty = m_lsSend.IsEmpty();
+				m_lsSend.Attach(pBuffer, iLength, fnRelease, pvParam);
+
+				if(bEmpty)
+					ActivateSend();
+
+				CheckSendWatermark();
+			}
+		}
+		else
+			result = ERROR_INVALID_STATE;
+	}
+	else
+		result = ERROR_INVALID_PARAMETER;
+
+	if(result != NO_ERROR)
+	{
+		if(fnRelease != nullptr)
+			fnRelease(pBuffer, iLength, pvParam, FALSE);
+
+		::SetLastError(result);
+	}
+
+	return (result == NO_ERROR);
+}
+
 BOOL CTcpClient::SendSmallFile(LPCTSTR lpszFileName, const LPWSABUF pHead, const LPWSABUF pTail)
 {
 	CFile file;
@@ -655,6 +883,53 @@ BOOL CTcpClient::SendSmallFile(LPCTSTR lpszFileName, const LPWSABUF pHead, const
 	return SendPackets(szBuf, 3);
 }
 
+BOOL CTcpClient::SendFile(LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	CFile file;
+	HRESULT result = ::OpenFileRegion(lpszFileName, file, llOffset, llLength, pHead, pTail);
+
+	if(SUCCEEDED(result))
+	{
+		if(IsConnected())
+		{
+			CReentrantCriSecLock locallock(m_csSend);
+
+			int iHead	= pHead ? (int)pHead->len : 0;
+			int iTail	= pTail ? (int)pTail->len : 0;
+			int iWindow	= (int)MIN(llLength, (LLONG)TItem::MAX_FILE_WINDOW_SIZE);
+
+			if(!IsConnected())
+				result = ERROR_INVALID_STATE;
+			else if(!CheckSendQuota())
+				result = ::GetLastError();
+			/* 发送队列长度为 32 位整数（文件区域每次只占用一个窗口的长度） */
+			else if(iHead + iWindow + iTail > MAX_SEND_FILE_SIZE - m_lsSend.Length())
+				result = ERROR_NOT_ENOUGH_QUOTA;
+			else
+			{
+				/* 文件数据不拷贝到发送队列，由发送队列接管文件并在发送时使用 sendfile() */
+				BOOL bEmpty = m_lsSend.IsEmpty();
+
+				if(iHead > 0) m_lsSend.Cat((const BYTE*)pHead->buf, iHead);
+				if(llLength > 0) m_lsSend.AttachFile(file.Detach(), llOffset, llLength);
+				if(iTail > 0) m_lsSend.Cat((const BYTE*)pTail->buf, iTail);
+
+				if(bEmpty)
+					ActivateSend();
+
+				CheckSendWatermark();
+			}
+		}
+		else
+			result = ERROR_INVALID_STATE;
+	}
+
+	if(result != NO_ERROR)
+		::SetLastError(result);
+
+	return (result == NO_ERROR);
+}
+
 void CTcpClient::SetLastError(EnSocketError code, LPCSTR func, int ec)
 {
 	TRACE("%s --> Error: %d, EC: %d", func, code, ec);
@@ -707,3 +982,190 @@ BOOL CTcpClient::GetRemoteHost(LPCSTR* lpszHost, USHORT* pusPort)
 
 	return !m_strHost.IsEmpty();
 }
+
+// ------------------------------------------------------------------------------------------------------------- //
+
+CTcpClientReactor& CTcpClientReactor::GetInstance()
+{
+	/* 有意不销毁：全局或静态的客户端组件对象可能在静态对象析构阶段才停止，此时 Reactor 必须仍然可用 */
+	static CTcpClientReactor* s_pReactor = new CTcpClientReactor;
+
+	return *s_pReactor;
+}
+
+BOOL CTcpClientReactor::IsReactorThread()
+{
+	if(!m_bStarted)
+		return FALSE;
+
+	const CIODispatcher::CWorkerThread* pWorkers = m_ioDispatcher.GetWorkerThreads();
+
+	for(int i = 0, iCount = m_ioDispatcher.GetShardCount(); i < iCount; i++)
+	{
+		if(pWorkers[i].IsInMyThread())
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+BOOL CTcpClientReactor::Attach(CTcpClient* pClient, SOCKET socket, UINT events, TReactorSlot*& pSlot)
+{
+	if(!m_bStarted)
+	{
+		CCriSecLock locallock(m_csStart);
+
+		if(!m_bStarted)
+		{
+			if(!m_ioDispatcher.Start(this, CIODispatcher::DEF_WORKER_MAX_EVENTS, PROCESSOR_COUNT, 0, TRUE))
+				return FALSE;
+
+			m_bStarted = TRUE;
+		}
+	}
+
+	::ReleaseGCObj(m_lsGCSlot, SLOT_LOCK_TIME);
+
+	int iShard	= m_ioDispatcher.AssignShard();
+	pSlot		= TReactorSlot::Construct(pClient, socket, iShard, events);
+
+	if(m_ioDispatcher.AddFD(iShard, socket, events, pSlot))
+		return TRUE;
+
+	m_ioDispatcher.ReleaseShard(iShard);
+	TReactorSlot::Destruct(pSlot);
+
+	pSlot = nullptr;
+
+	return FALSE;
+}
+
+VOID CTcpClientReactor::Detach(TReactorSlot* pSlot)
+{
+	ASSERT(pSlot->pClient != nullptr);
+
+	if(m_bStarted)
+	{
+		VERIFY(m_ioDispatcher.DelFD(pSlot->shard, pSlot->socket, pSlot));
+		m_ioDispatcher.ReleaseShard(pSlot->shard);
+	}
+
+	pSlot->pClient	= nullptr;
+	pSlot->freeTime	= ::TimeGetTime();
+
+	m_lsGCSlot.PushBack(pSlot);
+}
+
+VOID CTcpClientReactor::AfterProcess(TReactorSlot* pSlot, BOOL rs)
+{
+	CTcpClient* pClient = pSlot->pClient;
+
+	if(pClient == nullptr)
+		return;
+
+	if(!rs)
+	{
+		pClient->OnReactorError();
+		return;
+	}
+
+	UINT events = pClient->GetReactorEvents();
+
+	if(events != pSlot->events)
+	{
+		pSlot->events = events;
+		VERIFY(m_ioDispatcher.ModFD(pSlot->shard, pSlot->socket, events, pSlot));
+	}
+}
+
+BOOL CTcpClientReactor::OnBeforeProcessIo(PVOID pv, UINT events)
+{
+	TReactorSlot* pSlot	= (TReactorSlot*)pv;
+	CTcpClient* pClient	= pSlot->pClient;
+
+	if(pClient == nullptr || !pClient->HasStarted())
+		return FALSE;
+
+	if(!(events & EPOLLERR) && !pClient->IsConnected())
+	{
+		AfterProcess(pSlot, pClient->HandleConnect((SHORT)events));
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+VOID CTcpClientReactor::OnAfterProcessIo(PVOID pv, UINT events, BOOL rs)
+{
+	AfterProcess((TReactorSlot*)pv, rs);
+}
+
+VOID CTcpClientReactor::OnCommand(TDispCommand* pCmd)
+{
+	TReactorSlot* pSlot	= (TReactorSlot*)(pCmd->wParam);
+	CTcpClient* pClient	= pSlot->pClient;
+
+	if(pClient == nullptr)
+		return;
+
+	if(pCmd->type == DISP_CMD_DETACH)
+	{
+		Detach(pSlot);
+
+		/* 异步解除注册时 Stop() 已经返回，在这里完成停止 */
+		if((BOOL)pCmd->lParam)
+		{
+			pClient->m_pReactorSlot = nullptr;
+			pClient->CompleteStop();
+		}
+		else
+			pClient->m_evStop.Set();
+
+		return;
+	}
+
+	if(!pClient->HasStarted())
+		return;
+
+	BOOL rs = TRUE;
+
+	switch(pCmd->type)
+	{
+	case DISP_CMD_SEND:
+		rs = pClient->SendData();
+		break;
+	case DISP_CMD_UNPAUSE:
+		rs = pClient->BeforeUnpause() && pClient->ReadData();
+		break;
+	}
+
+	AfterProcess(pSlot, rs);
+}
+
+BOOL CTcpClientReactor::OnReadyRead(PVOID pv, UINT events)
+{
+	CTcpClient* pClient = ((TReactorSlot*)pv)->pClient;
+
+	return pClient != nullptr && pClient->HandleRead((SHORT)events);
+}
+
+BOOL CTcpClientReactor::OnReadyWrite(PVOID pv, UINT events)
+{
+	CTcpClient* pClient = ((TReactorSlot*)pv)->pClient;
+
+	return pClient != nullptr && pClient->HandleWrite((SHORT)events);
+}
+
+BOOL CTcpClientReactor::OnHungUp(PVOID pv, UINT events)
+{
+	CTcpClient* pClient = ((TReactorSlot*)pv)->pClient;
+
+	return pClient != nullptr && pClient->HandleClose((SHORT)events);
+}
+
+BOOL CTcpClientReactor::OnError(PVOID pv, UINT events)
+{
+	CTcpClient* pClient = ((TReactorSlot*)pv)->pClient;
+
+	return pClient != nullptr && pClient->HandleClose((SHORT)events);
+}
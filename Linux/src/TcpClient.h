@@ -25,15 +25,90 @@
 
 #include "SocketHelper.h"
 #include "./common/GeneralHelper.h"
+#include "./common/IODispatcher.h"
+
+class CTcpClient;
+
+/* 客户端组件在共享 Reactor 中的注册项（客户端组件解除注册后延迟释放，使残留的 IO 事件和命令可以安全地被忽略） */
+struct TReactorSlot
+{
+	CTcpClient*	pClient;
+	SOCKET		socket;
+	int			shard;
+	UINT		events;
+	DWORD		freeTime;
+
+	static TReactorSlot* Construct(CTcpClient* pClient, SOCKET socket, int shard, UINT events)
+		{return new TReactorSlot(pClient, socket, shard, events);}
+
+	static void Destruct(TReactorSlot* pSlot)
+		{if(pSlot) delete pSlot;}
+
+	DWORD GetFreeTime() const {return freeTime;}
+
+	TReactorSlot(CTcpClient* pClient, SOCKET socket, int shard, UINT events)
+	: pClient(pClient), socket(socket), shard(shard), events(events), freeTime(0)
+	{
+	}
+};
+
+/* 共享 Reactor：启用了共享 Reactor 的客户端组件共用进程内的一组分片 IO 工作线程，每个客户端组件固定在一个分片中处理 */
+class CTcpClientReactor : public CIOHandler
+{
+public:
+	/* 注册客户端组件（首次调用时启动 IO 工作线程），pSlot 在 Socket 加入分片前赋值 */
+	BOOL Attach(CTcpClient* pClient, SOCKET socket, UINT events, TReactorSlot*& pSlot);
+	/* 在分片的工作线程中解除注册 */
+	VOID Detach(TReactorSlot* pSlot);
+
+	BOOL SendCommand(TReactorSlot* pSlot, USHORT t, UINT_PTR lp = 0)
+		{return m_ioDispatcher.SendShardCommand(pSlot->shard, t, (UINT_PTR)pSlot, lp);}
+	BOOL IsInReactorThread(TReactorSlot* pSlot)
+		{return m_bStarted && m_ioDispatcher.GetWorkerThreads()[pSlot->shard].IsInMyThread();}
+	/* 当前线程是否为 Reactor 的任意一个工作线程 */
+	BOOL IsReactorThread();
+
+	static CTcpClientReactor& GetInstance();
+
+private:
+	virtual BOOL OnBeforeProcessIo(PVOID pv, UINT events)			override;
+	virtual VOID OnAfterProcessIo(PVOID pv, UINT events, BOOL rs)	override;
+	virtual VOID OnCommand(TDispCommand* pCmd)						override;
+	virtual BOOL OnReadyRead(PVOID pv, UINT events)					override;
+	virtual BOOL OnReadyWrite(PVOID pv, UINT events)				override;
+	virtual BOOL OnHungUp(PVOID pv, UINT events)					override;
+	virtual BOOL OnError(PVOID pv, UINT events)						override;
+
+	/* 处理完客户端组件的 IO 事件或命令后更新监听的事件，处理失败则停止客户端组件 */
+	VOID AfterProcess(TReactorSlot* pSlot, BOOL rs);
+
+private:
+	CTcpClientReactor() : m_bStarted(FALSE) {}
+
+	DECLARE_NO_COPY_CLASS(CTcpClientReactor)
+
+private:
+	/* 已解除注册的注册项的延迟释放时间 */
+	static const DWORD SLOT_LOCK_TIME = 15 * 1000;
+
+	volatile BOOL				m_bStarted;
+	CCriSec						m_csStart;
+	CIODispatcher				m_ioDispatcher;
+	CCASQueue<TReactorSlot>		m_lsGCSlot;
+};
 
 class CTcpClient : public ITcpClient
 {
+	friend class CTcpClientReactor;
+
 public:
 	virtual BOOL Start	(LPCTSTR lpszRemoteAddress, USHORT usPort, BOOL bAsyncConnect = TRUE, LPCTSTR lpszBindAddress = nullptr, USHORT usLocalPort = 0);
 	virtual BOOL Stop	();
 	virtual BOOL Send	(const BYTE* pBuffer, int iLength, int iOffset = 0);
 	virtual BOOL SendSmallFile	(LPCTSTR lpszFileName, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr);
-	virtual BOOL SendPackets	(const WSABUF pBuffers[], int iCount)	{return DoSendPackets(pBuffers, iCount);}
+	virtual BOOL SendFile		(LPCTSTR lpszFileName, LONGLONG llOffset = 0, LONGLONG llLength = 0, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr);
+	virtual BOOL SendPackets	(const WSABUF pBuffers[], int iCount)	{return CheckSendQuota() && DoSendPackets(pBuffers, iCount);}
+	virtual BOOL SendReference	(const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam = nullptr);
 	virtual BOOL PauseReceive	(BOOL bPause = TRUE);
 	virtual BOOL			HasStarted			()	{return m_enState == SS_STARTED || m_enState == SS_STARTING;}
 	virtual EnServiceState	GetState			()	{return m_enState;}
@@ -64,14 +139,22 @@ public:
 	virtual void SetKeepAliveInterval	(DWORD dwKeepAliveInterval)		{m_dwKeepAliveInterval	= dwKeepAliveInterval;}
 	virtual void SetFreeBufferPoolSize	(DWORD dwFreeBufferPoolSize)	{m_dwFreeBufferPoolSize = dwFreeBufferPoolSize;}
 	virtual void SetFreeBufferPoolHold	(DWORD dwFreeBufferPoolHold)	{m_dwFreeBufferPoolHold = dwFreeBufferPoolHold;}
+	virtual void SetSendHighWatermark	(DWORD dwSendHighWatermark)		{m_dwSendHighWatermark	= dwSendHighWatermark;}
+	virtual void SetSendLowWatermark	(DWORD dwSendLowWatermark)		{m_dwSendLowWatermark	= dwSendLowWatermark;}
 	virtual void SetExtra				(PVOID pExtra)					{m_pExtra				= pExtra;}						
+	virtual void SetBatchSendNotify		(BOOL bBatchSendNotify)			{m_bBatchSendNotify		= bBatchSendNotify;}
+	virtual void SetSharedReactor		(BOOL bSharedReactor)			{m_bSharedReactor		= bSharedReactor;}
 
 	virtual DWORD GetSocketBufferSize	()	{return m_dwSocketBufferSize;}
 	virtual DWORD GetKeepAliveTime		()	{return m_dwKeepAliveTime;}
 	virtual DWORD GetKeepAliveInterval	()	{return m_dwKeepAliveInterval;}
 	virtual DWORD GetFreeBufferPoolSize	()	{return m_dwFreeBufferPoolSize;}
 	virtual DWORD GetFreeBufferPoolHold	()	{return m_dwFreeBufferPoolHold;}
+	virtual DWORD GetSendHighWatermark	()	{return m_dwSendHighWatermark;}
+	virtual DWORD GetSendLowWatermark	()	{return m_dwSendLowWatermark;}
 	virtual PVOID GetExtra				()	{return m_pExtra;}
+	virtual BOOL  IsBatchSendNotify		()	{return m_bBatchSendNotify;}
+	virtual BOOL  IsSharedReactor		()	{return m_bSharedReactor;}
 
 protected:
 	virtual EnHandleResult FirePrepareConnect(SOCKET socket)
@@ -86,6 +169,8 @@ protected:
 		{return DoFireHandShake(this);}
 	virtual EnHandleResult FireSend(const BYTE* pData, int iLength)
 		{return DoFireSend(this, pData, iLength);}
+	virtual EnHandleResult FireWritable(BOOL bWritable)
+		{return DoFireWritable(this, bWritable);}
 	virtual EnHandleResult FireReceive(const BYTE* pData, int iLength)
 		{return DoFireReceive(this, pData, iLength);}
 	virtual EnHandleResult FireReceive(int iLength)
@@ -101,6 +186,8 @@ protected:
 		{return m_pListener->OnHandShake(pSender, pSender->GetConnectionID());}
 	virtual EnHandleResult DoFireSend(ITcpClient* pSender, const BYTE* pData, int iLength)
 		{return m_pListener->OnSend(pSender, pSender->GetConnectionID(), pData, iLength);}
+	virtual EnHandleResult DoFireWritable(ITcpClient* pSender, BOOL bWritable)
+		{return m_pListener->OnWritable(pSender, pSender->GetConnectionID(), bWritable);}
 	virtual EnHandleResult DoFireReceive(ITcpClient* pSender, const BYTE* pData, int iLength)
 		{return m_pListener->OnReceive(pSender, pSender->GetConnectionID(), pData, iLength);}
 	virtual EnHandleResult DoFireReceive(ITcpClient* pSender, int iLength)
@@ -117,6 +204,7 @@ protected:
 	virtual void OnWorkerThreadEnd(THR_ID tid) {}
 
 	BOOL DoSendPackets(const WSABUF pBuffers[], int iCount);
+	BOOL CheckSendQuota();
 
 	static BOOL DoSendPackets(CTcpClient* pClient, const WSABUF pBuffers[], int iCount)
 		{return pClient->DoSendPackets(pBuffers, iCount);}
@@ -126,6 +214,8 @@ protected:
 	void SetReserved	(PVOID pReserved)	{m_pReserved = pReserved;}						
 	PVOID GetReserved	()					{return m_pReserved;}
 	BOOL GetRemoteHost	(LPCSTR* lpszHost, USHORT* pusPort = nullptr);
+	/* 等待停止完成（在共享 Reactor 的其它分片工作线程中调用 Stop() 为异步停止，销毁对象前必须等待；不能在共享 Reactor 的工作线程中等待） */
+	void WaitForStop	();
 
 private:
 	void SetRemoteHost	(LPCTSTR lpszHost, USHORT usPort);
@@ -137,12 +227,24 @@ private:
 	BOOL BindClientSocket(const HP_SOCKADDR& addrBind, const HP_SOCKADDR& addrRemote, USHORT usLocalPort);
 	BOOL ConnectToServer(const HP_SOCKADDR& addrRemote, BOOL bAsyncConnect);
 	BOOL CreateWorkerThread();
+	BOOL IsInWorkerThread();
+	BOOL IsInSharedReactorThread();
 	BOOL ProcessNetworkEvent(SHORT events);
 	BOOL ReadData();
 	BOOL SendData();
-	BOOL DoSendData(TItem* pItem);
+	BOOL DoSendData(BOOL& bBlocked);
+	void NotifySend(const BYTE* pData, int iLength);
+	void NotifyWritable(BOOL bWritable);
+	void CheckSendWatermark();
 	int SendInternal(const WSABUF pBuffers[], int iCount);
-	void WaitForWorkerThreadEnd();
+	void ActivateSend();
+	BOOL WaitForWorkerThreadEnd();
+	void CompleteStop();
+
+	BOOL AttachReactor();
+	BOOL DetachReactor();
+	UINT GetReactorEvents();
+	void OnReactorError();
 
 	BOOL HandleConnect	(SHORT events);
 	BOOL HandleClose	(SHORT events);
@@ -159,6 +261,7 @@ public:
 	, m_nEvents				(0)
 	, m_dwConnID			(0)
 	, m_usPort				(0)
+	, m_bSendBlocked		(FALSE)
 	, m_bPaused				(FALSE)
 	, m_bConnected			(FALSE)
 	, m_enLastError			(SE_OK)
@@ -168,8 +271,13 @@ public:
 	, m_dwSocketBufferSize	(DEFAULT_TCP_SOCKET_BUFFER_SIZE)
 	, m_dwFreeBufferPoolSize(DEFAULT_CLIENT_FREE_BUFFER_POOL_SIZE)
 	, m_dwFreeBufferPoolHold(DEFAULT_CLIENT_FREE_BUFFER_POOL_HOLD)
+	, m_dwSendHighWatermark	(0)
+	, m_dwSendLowWatermark	(0)
 	, m_dwKeepAliveTime		(DEFALUT_TCP_KEEPALIVE_TIME)
 	, m_dwKeepAliveInterval	(DEFALUT_TCP_KEEPALIVE_INTERVAL)
+	, m_bBatchSendNotify	(FALSE)
+	, m_bSharedReactor		(FALSE)
+	, m_pReactorSlot		(nullptr)
 	{
 		ASSERT(m_pListener);
 	}
@@ -177,6 +285,7 @@ public:
 	virtual ~CTcpClient()
 	{
 		Stop();
+		WaitForStop();
 	}
 
 private:
@@ -191,8 +300,12 @@ private:
 	DWORD				m_dwSocketBufferSize;
 	DWORD				m_dwFreeBufferPoolSize;
 	DWORD				m_dwFreeBufferPoolHold;
+	DWORD				m_dwSendHighWatermark;
+	DWORD				m_dwSendLowWatermark;
 	DWORD				m_dwKeepAliveTime;
 	DWORD				m_dwKeepAliveInterval;
+	BOOL				m_bBatchSendNotify;
+	BOOL				m_bSharedReactor;
 
 	EnSocketError		m_enLastError;
 	volatile BOOL		m_bConnected;
@@ -212,8 +325,9 @@ protected:
 private:
 	CSpinGuard			m_csState;
 
-	CCriSec				m_csSend;
+	CReentrantCriSec	m_csSend;
 	TItemListExV		m_lsSend;
+	BOOL				m_bSendBlocked;
 
 	CEvt				m_evSend;
 	CEvt				m_evRecv;
@@ -222,4 +336,5 @@ private:
 	volatile BOOL		m_bPaused;
 
 	CThread<CTcpClient, VOID, UINT> m_thWorker;
+	TReactorSlot*		m_pReactorSlot;
 };
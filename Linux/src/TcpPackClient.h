@@ -48,6 +48,27 @@ public:
 		return __super::SendPackets(buffers.get(), iNewCount);
 	}
 
+	virtual BOOL SendFile(LPCTSTR lpszFileName, LONGLONG llOffset = 0, LONGLONG llLength = 0, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr)
+	{
+		/* 数据包需要加上包头，映射文件区域后按普通数据包发送（包长度受 MaxPackSize 限制） */
+		CFile file;
+		CFileMapping fmap;
+		WSABUF szBuf[3];
+
+		HRESULT hr = ::MakeFileRegionPackage(lpszFileName, file, fmap, llOffset, llLength, szBuf, pHead, pTail);
+
+		if(FAILED(hr))
+		{
+			::SetLastError(hr);
+			return FALSE;
+		}
+
+		return SendPackets(szBuf, 3);
+	}
+
+	virtual BOOL SendReference(const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam = nullptr)
+		{return ::ReleaseSendReference(__super::Send(pBuffer, iLength), pBuffer, iLength, fnRelease, pvParam);}
+
 protected:
 	virtual EnHandleResult DoFireReceive(ITcpClient* pSender, const BYTE* pData, int iLength)
 	{
@@ -89,6 +110,8 @@ private:
 
 	friend EnHandleResult ParsePack<>	(CTcpPackClientT* pThis, TPackInfo<TItemListEx>* pInfo, TItemListEx* pBuffer, CTcpPackClientT* pSocket,
 										DWORD dwMaxPackSize, USHORT usPackHeaderFlag);
+	friend EnHandleResult ParsePack<>	(CTcpPackClientT* pThis, TPackInfo<TItemListEx>* pInfo, TItemListEx* pBuffer, CTcpPackClientT* pSocket,
+										DWORD dwMaxPackSize, USHORT usPackHeaderFlag, const BYTE* pData, int iLength);
 
 public:
 	CTcpPackClientT(ITcpClientListener* pListener)
@@ -104,6 +127,7 @@ public:
 	virtual ~CTcpPackClientT()
 	{
 		Stop();
+		__super::WaitForStop();
 	}
 
 private:
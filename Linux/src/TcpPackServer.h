@@ -38,6 +38,8 @@ template<class T> class CTcpPackServerT : public IPackSocket, public T
 	using __super::GetFreeSocketObjLockTime;
 	using __super::GetFreeSocketObjPool;
 	using __super::GetFreeSocketObjHold;
+	using __super::GetFreeSocketObjPrealloc;
+	using __super::IsPoolNumaInterleave;
 	using __super::SetLastError;
 
 public:
@@ -56,6 +58,39 @@ public:
 		return __super::SendPackets(dwConnID, buffers.get(), iNewCount);
 	}
 
+	virtual BOOL SendFile(CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset = 0, LONGLONG llLength = 0, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr)
+	{
+		/* 数据包需要加上包头，映射文件区域后按普通数据包发送（包长度受 MaxPackSize 限制） */
+		CFile file;
+		CFileMapping fmap;
+		WSABUF szBuf[3];
+
+		HRESULT hr = ::MakeFileRegionPackage(lpszFileName, file, fmap, llOffset, llLength, szBuf, pHead, pTail);
+
+		if(FAILED(hr))
+		{
+			::SetLastError(hr);
+			return FALSE;
+		}
+
+		return SendPackets(dwConnID, szBuf, 3);
+	}
+
+	virtual BOOL BroadcastPackets(const CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount)
+	{
+		int iNewCount = iCount + 1;
+		unique_ptr<WSABUF[]> buffers(new WSABUF[iNewCount]);
+
+		DWORD header;
+		if(!::AddPackHeader(pBuffers, iCount, buffers, m_dwMaxPackSize, m_usHeaderFlag, header))
+			return FALSE;
+
+		return __super::BroadcastPackets(pConnIDs, iConnCount, buffers.get(), iNewCount);
+	}
+
+	virtual BOOL SendReference(CONNID dwConnID, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam = nullptr)
+		{return ::ReleaseSendReference(__super::Send(dwConnID, pBuffer, iLength), pBuffer, iLength, fnRelease, pvParam);}
+
 protected:
 	virtual EnHandleResult DoFireHandShake(TSocketObj* pSocketObj)
 	{
@@ -148,6 +183,8 @@ protected:
 		m_bfPool.SetBufferLockTime	(GetFreeSocketObjLockTime());
 		m_bfPool.SetBufferPoolSize	(GetFreeSocketObjPool());
 		m_bfPool.SetBufferPoolHold	(GetFreeSocketObjHold());
+		m_bfPool.SetBufferPoolPrealloc(GetFreeSocketObjPrealloc());
+		m_bfPool.SetNumaInterleave	(IsPoolNumaInterleave());
 
 		m_bfPool.Prepare();
 	}
@@ -164,6 +201,8 @@ private:
 
 	friend EnHandleResult ParsePack<>	(CTcpPackServerT* pThis, TBufferPackInfo* pInfo, TBuffer* pBuffer, TSocketObj* pSocket,
 										DWORD dwMaxPackSize, USHORT usPackHeaderFlag);
+	friend EnHandleResult ParsePack<>	(CTcpPackServerT* pThis, TBufferPackInfo* pInfo, TBuffer* pBuffer, TSocketObj* pSocket,
+										DWORD dwMaxPackSize, USHORT usPackHeaderFlag, const BYTE* pData, int iLength);
 
 public:
 	CTcpPackServerT(ITcpServerListener* pListener)
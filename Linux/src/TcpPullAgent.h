@@ -38,6 +38,8 @@ template<class T> class CTcpPullAgentT : public IPullSocket, public T
 	using __super::GetFreeSocketObjLockTime;
 	using __super::GetFreeSocketObjPool;
 	using __super::GetFreeSocketObjHold;
+	using __super::GetFreeSocketObjPrealloc;
+	using __super::IsPoolNumaInterleave;
 
 public:
 	using __super::Stop;
@@ -113,6 +115,8 @@ protected:
 		m_bfPool.SetBufferLockTime	(GetFreeSocketObjLockTime());
 		m_bfPool.SetBufferPoolSize	(GetFreeSocketObjPool());
 		m_bfPool.SetBufferPoolHold	(GetFreeSocketObjHold());
+		m_bfPool.SetBufferPoolPrealloc(GetFreeSocketObjPrealloc());
+		m_bfPool.SetNumaInterleave	(IsPoolNumaInterleave());
 
 		m_bfPool.Prepare();
 	}
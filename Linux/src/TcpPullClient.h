@@ -71,6 +71,7 @@ public:
 	virtual ~CTcpPullClientT()
 	{
 		Stop();
+		__super::WaitForStop();
 	}
 
 private:
@@ -55,6 +55,8 @@ BOOL CTcpServer::CheckParams()
 {
 	if	((m_enSendPolicy >= SP_PACK && m_enSendPolicy <= SP_DIRECT)								&&
 		(m_enOnSendSyncPolicy >= OSSP_NONE && m_enOnSendSyncPolicy <= OSSP_RECEIVE)				&&
+		(m_enDispatchMode >= DM_SHARED && m_enDispatchMode <= DM_IO_URING)						&&
+		(m_enListenMode >= LM_SINGLE && m_enListenMode <= LM_REUSE_PORT_CPU)					&&
 		((int)m_dwMaxConnectionCount > 0)														&&
 		((int)m_dwWorkerThreadCount > 0 && m_dwWorkerThreadCount <= MAX_WORKER_THREAD_COUNT)	&&
 		((int)m_dwAcceptSocketCount > 0)														&&
@@ -65,8 +67,18 @@ BOOL CTcpServer::CheckParams()
 		((int)m_dwFreeBufferObjPool >= 0)														&&
 		((int)m_dwFreeSocketObjHold >= 0)														&&
 		((int)m_dwFreeBufferObjHold >= 0)														&&
+		((int)m_dwFreeBufferObjCache >= 0)														&&
 		((int)m_dwKeepAliveTime >= 1000 || m_dwKeepAliveTime == 0)								&&
-		((int)m_dwKeepAliveInterval >= 1000 || m_dwKeepAliveInterval == 0)						)
+		((int)m_dwKeepAliveInterval >= 1000 || m_dwKeepAliveInterval == 0)						&&
+		((int)m_dwTimerInterval >= 0)															&&
+		(m_dwMaxConnectPeriod <= MAX_CONNECTION_PERIOD)											&&
+		(m_dwSilenceTimeout <= MAX_CONNECTION_PERIOD)											&&
+		(m_dwHandShakeTimeout <= MAX_CONNECTION_PERIOD)											&&
+		(IsTimerEnabled() || (m_dwMaxConnectPeriod == 0 && m_dwSilenceTimeout == 0 && m_dwHandShakeTimeout == 0))	&&
+		((int)m_dwSendHighWatermark >= 0 && (int)m_dwMaxSendPending >= 0)						&&
+		(m_dwSendHighWatermark == 0 || m_dwSendLowWatermark < m_dwSendHighWatermark)			&&
+		(m_dwFreeSocketObjPrealloc <= m_dwFreeSocketObjPool)									&&
+		(m_dwFreeBufferObjPrealloc <= m_dwFreeBufferObjPool)									)
 		return TRUE;
 
 	SetLastError(SE_INVALID_PARAM, __FUNCTION__, ERROR_INVALID_PARAMETER);
@@ -78,11 +90,28 @@ void CTcpServer::PrepareStart()
 	m_bfActiveSockets.Reset(m_dwMaxConnectionCount);
 	m_lsFreeSocket.Reset(m_dwFreeSocketObjPool);
 
+	m_phSocket.SetNumaInterleave(m_bPoolNumaInterleave);
+
 	m_bfObjPool.SetItemCapacity(m_dwSocketBufferSize);
 	m_bfObjPool.SetPoolSize(m_dwFreeBufferObjPool);
 	m_bfObjPool.SetPoolHold(m_dwFreeBufferObjHold);
+	m_bfObjPool.SetCacheSize(m_dwFreeBufferObjCache);
+	m_bfObjPool.SetPoolPrealloc(m_dwFreeBufferObjPrealloc);
+	m_bfObjPool.SetNumaInterleave(m_bPoolNumaInterleave);
 
 	m_bfObjPool.Prepare();
+
+	PreallocSocketObj();
+
+	/* 每个分片一个定时轮（与分派器的分片一一对应），连接的定时器只在其所属分片的工作线程中到期 */
+	if(IsTimerEnabled())
+	{
+		m_iConnTimers	= (m_enDispatchMode != DM_SHARED) ? (int)m_dwWorkerThreadCount : 1;
+		m_pConnTimers	= make_unique<CConnTimingWheel[]>(m_iConnTimers);
+
+		for(int i = 0; i < m_iConnTimers; i++)
+			VERIFY(m_pConnTimers[i].Init(m_dwTimerInterval));
+	}
 }
 
 BOOL CTcpServer::CheckStarting()
@@ -132,35 +161,75 @@ BOOL CTcpServer::CreateListenSocket(LPCTSTR lpszBindAddress, USHORT usPort)
 
 	if(::sockaddr_A_2_IN(lpszBindAddress, usPort, addr))
 	{
-		m_soListen = socket(addr.family, SOCK_STREAM, IPPROTO_TCP);
+		m_iListens	= IsReusePort() ? (int)m_dwWorkerThreadCount : 1;
+		m_soListens	= make_unique<SOCKET[]>(m_iListens);
+
+		for(int i = 0; i < m_iListens; i++)
+			m_soListens[i] = INVALID_SOCKET;
+
+		isOK		= CreateListenSocket(addr, m_soListens[0]);
+		m_soListen	= m_soListens[0];
 
-		if(m_soListen != INVALID_SOCKET)
+		/* 绑定随机端口时，其余监听 Socket 必须绑定到第一个监听 Socket 实际分配的端口 */
+		if(isOK && m_iListens > 1 && addr.Port() == 0)
 		{
-			::fcntl_SETFL(m_soListen, O_NOATIME | O_NONBLOCK | O_CLOEXEC);
+			socklen_t addrLen = (socklen_t)addr.AddrSize();
+			isOK = (::getsockname(m_soListen, addr.Addr(), &addrLen) != SOCKET_ERROR);
+
+			if(!isOK) SetLastError(SE_SOCKET_BIND, __FUNCTION__, ::WSAGetLastError());
+		}
+
+		for(int i = 1; isOK && i < m_iListens; i++)
+			isOK = CreateListenSocket(addr, m_soListens[i]);
+
+		if(isOK && m_enListenMode == LM_REUSE_PORT_CPU)
+		{
+			/* 内核不支持 SO_ATTACH_REUSEPORT_CBPF 时退化为按四元组哈希分配 */
+			if(IS_HAS_ERROR(::SSO_ReusePortCpuSteering(m_soListen, m_iListens)))
+			{
+				TRACE("SO_ATTACH_REUSEPORT_CBPF fail (%d), fallback to hash steering", ::WSAGetLastError());
+			}
+		}
+	}
+	else
+		SetLastError(SE_SOCKET_CREATE, __FUNCTION__, ::WSAGetLastError());
+
+	return isOK;
+}
+
+BOOL CTcpServer::CreateListenSocket(const HP_SOCKADDR& addr, SOCKET& soListen)
+{
+	BOOL isOK = FALSE;
+
+	soListen = socket(addr.family, SOCK_STREAM, IPPROTO_TCP);
+
+	if(soListen != INVALID_SOCKET)
+	{
+		::fcntl_SETFL(soListen, O_NOATIME | O_NONBLOCK | O_CLOEXEC);
 
-			BOOL bOnOff	= (m_dwKeepAliveTime > 0 && m_dwKeepAliveInterval > 0);
-			VERIFY(IS_NO_ERROR(::SSO_KeepAliveVals(m_soListen, bOnOff, m_dwKeepAliveTime, m_dwKeepAliveInterval)));
-			VERIFY(IS_NO_ERROR(::SSO_ReuseAddress(m_soListen)));
+		BOOL bOnOff	= (m_dwKeepAliveTime > 0 && m_dwKeepAliveInterval > 0);
+		VERIFY(IS_NO_ERROR(::SSO_KeepAliveVals(soListen, bOnOff, m_dwKeepAliveTime, m_dwKeepAliveInterval)));
+		VERIFY(IS_NO_ERROR(::SSO_ReuseAddress(soListen)));
 
-			if(::bind(m_soListen, addr.Addr(), addr.AddrSize()) != SOCKET_ERROR)
+		if(IsReusePort())
+			VERIFY(IS_NO_ERROR(::SSO_ReusePort(soListen)));
+
+		if(::bind(soListen, addr.Addr(), addr.AddrSize()) != SOCKET_ERROR)
+		{
+			if(TRIGGER(FirePrepareListen(soListen)) != HR_ERROR)
 			{
-				if(TRIGGER(FirePrepareListen(m_soListen)) != HR_ERROR)
+				if(::listen(soListen, m_dwSocketListenQueue) != SOCKET_ERROR)
 				{
-					if(::listen(m_soListen, m_dwSocketListenQueue) != SOCKET_ERROR)
-					{
-						isOK = TRUE;
-					}
-					else
-						SetLastError(SE_SOCKET_LISTEN, __FUNCTION__, ::WSAGetLastError());
+					isOK = TRUE;
 				}
 				else
-					SetLastError(SE_SOCKET_PREPARE, __FUNCTION__, ENSURE_ERROR_CANCELLED);
+					SetLastError(SE_SOCKET_LISTEN, __FUNCTION__, ::WSAGetLastError());
 			}
 			else
-				SetLastError(SE_SOCKET_BIND, __FUNCTION__, ::WSAGetLastError());
+				SetLastError(SE_SOCKET_PREPARE, __FUNCTION__, ENSURE_ERROR_CANCELLED);
 		}
 		else
-			SetLastError(SE_SOCKET_CREATE, __FUNCTION__, ::WSAGetLastError());
+			SetLastError(SE_SOCKET_BIND, __FUNCTION__, ::WSAGetLastError());
 	}
 	else
 		SetLastError(SE_SOCKET_CREATE, __FUNCTION__, ::WSAGetLastError());
@@ -170,20 +239,59 @@ BOOL CTcpServer::CreateListenSocket(LPCTSTR lpszBindAddress, USHORT usPort)
 
 BOOL CTcpServer::CreateWorkerThreads()
 {
-	if(!m_ioDispatcher.Start(this, m_dwAcceptSocketCount, m_dwWorkerThreadCount))
+	if(!m_ioDispatcher.Start(this, m_dwAcceptSocketCount, m_dwWorkerThreadCount, m_dwTimerInterval, m_enDispatchMode != DM_SHARED, m_enDispatchMode == DM_IO_URING))
 		return FALSE;
 
+	if(m_enListenMode == LM_REUSE_PORT_CPU)
+		VERIFY(m_ioDispatcher.SetWorkerAffinity());
+
 	const CIODispatcher::CWorkerThread* pWorkerThread = m_ioDispatcher.GetWorkerThreads();
 
 	for(DWORD i = 0; i < m_dwWorkerThreadCount; i++)
+	{
 		m_rcBufferMap[pWorkerThread[i].GetThreadID()] = new CBufferPtr(m_dwSocketBufferSize);
 
+		if(m_bDetachableReceive)
+			m_rcItemMap[pWorkerThread[i].GetThreadID()] = nullptr;
+	}
+
+	if(m_ioDispatcher.IsIoUring())
+		SetupRecvBuffers();
+
 	return TRUE;
 }
 
 BOOL CTcpServer::StartAccept()
 {
-	return m_ioDispatcher.AddFD(m_soListen, _EPOLL_READ_EVENTS | EPOLLET, TO_PVOID(&m_soListen));
+	/* io_uring 模式下（内核支持时）以 multishot accept 请求接受新连接：单监听 Socket 由所有分片共同接受，端口复用模式下每个分片接受自己的监听 Socket */
+	if(IsRecvBufferSelect())
+	{
+		int iCount = (m_iListens == 1) ? m_ioDispatcher.GetShardCount() : m_iListens;
+
+		for(int i = 0; i < iCount; i++)
+		{
+			int iListen = (m_iListens == 1) ? 0 : i;
+
+			if(!m_ioDispatcher.PostAccept(i, m_soListens[iListen], TO_PVOID(&m_soListens[iListen])))
+				return FALSE;
+		}
+
+		return TRUE;
+	}
+
+	if(m_iListens == 1)
+		return m_ioDispatcher.AddSharedFD(m_soListen, _EPOLL_READ_EVENTS | EPOLLET, TO_PVOID(&m_soListens[0]));
+
+	/* 端口复用模式：分片模式下每个分片只注册自己的监听 Socket，共享模式下所有监听 Socket 注册到同一个 EPOLL */
+	for(int i = 0; i < m_iListens; i++)
+	{
+		int iShard = m_ioDispatcher.IsSharded() ? i : 0;
+
+		if(!m_ioDispatcher.AddFD(iShard, m_soListens[i], _EPOLL_READ_EVENTS | EPOLLET, TO_PVOID(&m_soListens[i])))
+			return FALSE;
+	}
+
+	return TRUE;
 }
 
 BOOL CTcpServer::Stop()
@@ -202,6 +310,7 @@ BOOL CTcpServer::Stop()
 	FireShutdown();
 
 	ReleaseFreeSocket();
+	WaitForDetachedBufferRelease();
 
 	Reset();
 
@@ -212,7 +321,23 @@ void CTcpServer::CloseListenSocket()
 {
 	if(m_soListen != INVALID_SOCKET)
 	{
-		::ManualCloseSocket(m_soListen);
+		for(int i = 0; i < m_iListens; i++)
+		{
+			if(m_soListens[i] == INVALID_SOCKET)
+				continue;
+
+			if(m_ioDispatcher.IsIoUring())
+			{
+				if(m_iListens == 1)
+					m_ioDispatcher.DelSharedFD(m_soListens[i], TO_PVOID(&m_soListens[i]));
+				else
+					m_ioDispatcher.DelFD(i, m_soListens[i], TO_PVOID(&m_soListens[i]));
+			}
+
+			::ManualCloseSocket(m_soListens[i]);
+			m_soListens[i] = INVALID_SOCKET;
+		}
+
 		m_soListen = INVALID_SOCKET;
 
 		::WaitFor(100);
@@ -239,10 +364,25 @@ void CTcpServer::WaitForWorkerThreadEnd()
 	m_ioDispatcher.Stop();
 }
 
+void CTcpServer::WaitForDetachedBufferRelease()
+{
+	/* 已分离的接收缓冲区占用 m_bfObjPool 的内存，必须全部归还后才能清理缓冲池 */
+	if(m_lDetachedBuffers > 0)
+	{
+		TRACE("CTcpServer(0x%p) wait for %d detached receive buffer(s) to be released", this, m_lDetachedBuffers);
+
+		while(m_lDetachedBuffers > 0)
+			::WaitFor(10);
+	}
+}
+
 void CTcpServer::ReleaseClientSocket()
 {
 	VERIFY(m_bfActiveSockets.IsEmpty());
 	m_bfActiveSockets.Reset();
+
+	for(int i = 0; i < m_iConnTimers; i++)
+		m_pConnTimers[i].Clear();
 }
 
 void CTcpServer::ReleaseFreeSocket()
@@ -261,12 +401,30 @@ void CTcpServer::ReleaseFreeSocket()
 
 void CTcpServer::Reset()
 {
+	for(TReceiveItemMapI it = m_rcItemMap.begin(), end = m_rcItemMap.end(); it != end; ++it)
+	{
+		if(it->second != nullptr)
+			m_bfObjPool.PutFreeItem(it->second);
+	}
+
+	m_rcItemMap.clear();
+
+	ReleaseRecvBuffers();
+
 	m_phSocket.Reset();
 	m_bfObjPool.Clear();
 
 	::ClearPtrMap(m_rcBufferMap);
 
-	m_enState = SS_STOPPED;
+	/* 工作线程结束后才能释放监听 Socket 数组（其元素地址作为监听 Socket 的事件参数） */
+	m_soListens.reset();
+	m_iListens = 0;
+
+	m_pConnTimers.reset();
+	m_iConnTimers	= 0;
+
+	m_llSendPending	= 0;
+	m_enState		= SS_STOPPED;
 }
 
 TSocketObj* CTcpServer::GetFreeSocketObj(CONNID dwConnID, SOCKET soClient)
@@ -276,7 +434,8 @@ TSocketObj* CTcpServer::GetFreeSocketObj(CONNID dwConnID, SOCKET soClient)
 
 	if(m_lsFreeSocket.TryLock(&pSocketObj, dwIndex))
 	{
-		if(::GetTimeGap32(pSocketObj->freeTime) >= m_dwFreeSocketObjLockTime)
+		/* io_uring 模式下还要等待已关闭连接尚未完成的收发请求结束 */
+		if(::GetTimeGap32(pSocketObj->freeTime) >= m_dwFreeSocketObjLockTime && !pSocketObj->IsIoPosted())
 			VERIFY(m_lsFreeSocket.ReleaseLock(nullptr, dwIndex));
 		else
 		{
@@ -296,6 +455,21 @@ TSocketObj* CTcpServer::CreateSocketObj()
 	return TSocketObj::Construct(m_phSocket, m_bfObjPool);
 }
 
+void CTcpServer::PreallocSocketObj()
+{
+	/* 预先创建的 Socket 缓存对象释放时间提前一个锁定周期，可以立即被获取使用 */
+	DWORD dwPrealloc = min(m_dwFreeSocketObjPrealloc, m_dwFreeSocketObjPool);
+	DWORD dwFreeTime = ::TimeGetTime() - m_dwFreeSocketObjLockTime;
+
+	for(DWORD i = 0; i < dwPrealloc; i++)
+	{
+		TSocketObj* pSocketObj	= CreateSocketObj();
+		pSocketObj->freeTime	= dwFreeTime;
+
+		VERIFY(m_lsFreeSocket.TryPut(pSocketObj));
+	}
+}
+
 void CTcpServer::DeleteSocketObj(TSocketObj* pSocketObj)
 {
 	TSocketObj::Destruct(pSocketObj);
@@ -307,9 +481,25 @@ void CTcpServer::AddFreeSocketObj(TSocketObj* pSocketObj, EnSocketCloseFlag enFl
 		return;
 
 	CloseClientSocketObj(pSocketObj, enFlag, enOperation, iErrorCode);
+	KillTimers(pSocketObj);
+
+	/* 接收请求尚未完成时由请求完成处理回收接收数据块 */
+	if(!pSocketObj->rcvPosted)
+		ReleaseReceiveItem(pSocketObj);
 
+	m_ioDispatcher.ReleaseShard(pSocketObj->shard);
 	m_bfActiveSockets.Remove(pSocketObj->connID);
-	TSocketObj::Release(pSocketObj);
+
+	if(!IsSendPendingLimited())
+		TSocketObj::Release(pSocketObj);
+	else
+	{
+		/* 在 csSend 锁内扣减剩余待发数据，避免与并发的发送操作竞争导致统计偏差 */
+		CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+		::InterlockedExchangeSub(&m_llSendPending, (LLONG)pSocketObj->Pending());
+		TSocketObj::Release(pSocketObj);
+	}
 
 	ReleaseGCSocketObj();
 
@@ -319,7 +509,8 @@ void CTcpServer::AddFreeSocketObj(TSocketObj* pSocketObj, EnSocketCloseFlag enFl
 
 void CTcpServer::ReleaseGCSocketObj(BOOL bForce)
 {
-	::ReleaseGCObj(m_lsGCSocket, m_dwFreeSocketObjLockTime, bForce);
+	/* io_uring 模式下还要等待已关闭连接尚未完成的收发请求结束（请求完成时会访问连接对象） */
+	::ReleaseGCObj(m_lsGCSocket, m_dwFreeSocketObjLockTime, bForce, &TSocketObj::IsIoIdle);
 }
 
 BOOL CTcpServer::InvalidSocketObj(TSocketObj* pSocketObj)
@@ -338,6 +529,9 @@ void CTcpServer::AddClientSocketObj(CONNID dwConnID, TSocketObj* pSocketObj, con
 	pSocketObj->SetConnected();
 
 	VERIFY(m_bfActiveSockets.ReleaseLock(dwConnID, pSocketObj));
+
+	if(IsNeedCheckTimeout())
+		HandleTimeout(pSocketObj);
 }
 
 TSocketObj* CTcpServer::FindSocketObj(CONNID dwConnID)
@@ -362,6 +556,9 @@ void CTcpServer::CloseClientSocketObj(TSocketObj* pSocketObj, EnSocketCloseFlag
 	SOCKET socket = pSocketObj->socket;
 	pSocketObj->socket = INVALID_SOCKET;
 
+	if(m_ioDispatcher.IsIoUring())
+		m_ioDispatcher.DelFD(pSocketObj->shard, socket, pSocketObj);
+
 	::ManualCloseSocket(socket, iShutdownFlag);
 }
 
@@ -592,7 +789,7 @@ BOOL CTcpServer::Disconnect(CONNID dwConnID, BOOL bForce)
 		return FALSE;
 	}
 
-	return m_ioDispatcher.SendCommand(DISP_CMD_DISCONNECT, dwConnID, bForce);
+	return m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_DISCONNECT, dwConnID, bForce);
 }
 
 BOOL CTcpServer::DisconnectLongConnections(DWORD dwPeriod, BOOL bForce)
@@ -639,6 +836,80 @@ BOOL CTcpServer::DisconnectSilenceConnections(DWORD dwPeriod, BOOL bForce)
 	return TRUE;
 }
 
+BOOL CTcpServer::SetConnectionTimer(CONNID dwConnID, DWORD dwTimeout, Fn_ConnectionTimer fnTimer, PVOID pvParam)
+{
+	if(!IsTimerEnabled() || !HasStarted())
+	{
+		::SetLastError(ERROR_INVALID_STATE);
+		return FALSE;
+	}
+
+	if(dwTimeout == 0 || dwTimeout > MAX_CONNECTION_PERIOD || fnTimer == nullptr)
+	{
+		::SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	TSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(!TSocketObj::IsValid(pSocketObj))
+	{
+		::SetLastError(ERROR_OBJECT_NOT_FOUND);
+		return FALSE;
+	}
+
+	TConnTimer* pTimer = &pSocketObj->userTimer;
+
+	GetConnTimer(pSocketObj).Cancel(pTimer);
+
+	pTimer->fnTimer = fnTimer;
+	pTimer->pvParam = pvParam;
+
+	return ArmTimer(pSocketObj, pTimer, dwTimeout);
+}
+
+BOOL CTcpServer::KillConnectionTimer(CONNID dwConnID)
+{
+	TSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(!TSocketObj::IsValid(pSocketObj))
+	{
+		::SetLastError(ERROR_OBJECT_NOT_FOUND);
+		return FALSE;
+	}
+
+	if(!GetConnTimer(pSocketObj).Cancel(&pSocketObj->userTimer))
+	{
+		::SetLastError(ERROR_INVALID_STATE);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+BOOL CTcpServer::ArmTimer(TSocketObj* pSocketObj, TConnTimer* pTimer, DWORD dwTimeout)
+{
+	GetConnTimer(pSocketObj).Arm(pTimer, dwTimeout);
+
+	/* 关闭连接时先使连接失效再取消定时器，如果设置定时器期间连接已失效则由这里取消定时器 */
+	if(TSocketObj::IsValid(pSocketObj))
+		return TRUE;
+
+	GetConnTimer(pSocketObj).Cancel(pTimer);
+	::SetLastError(ERROR_OBJECT_NOT_FOUND);
+
+	return FALSE;
+}
+
+VOID CTcpServer::KillTimers(TSocketObj* pSocketObj)
+{
+	if(!IsTimerEnabled())
+		return;
+
+	GetConnTimer(pSocketObj).Cancel(&pSocketObj->sysTimer);
+	GetConnTimer(pSocketObj).Cancel(&pSocketObj->userTimer);
+}
+
 BOOL CTcpServer::PauseReceive(CONNID dwConnID, BOOL bPause)
 {
 	TSocketObj* pSocketObj = FindSocketObj(dwConnID);
@@ -655,16 +926,18 @@ BOOL CTcpServer::PauseReceive(CONNID dwConnID, BOOL bPause)
 	pSocketObj->paused = bPause;
 
 	if(!bPause)
-		return m_ioDispatcher.SendCommand(DISP_CMD_UNPAUSE, pSocketObj->connID);
+		return m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_UNPAUSE, pSocketObj->connID);
 
 	return TRUE;
 }
 
 BOOL CTcpServer::OnBeforeProcessIo(PVOID pv, UINT events)
 {
-	if(pv == &m_soListen)
+	int iListen = GetListenIndex(pv);
+
+	if(iListen >= 0)
 	{
-		HandleAccept(events);
+		HandleAccept(iListen, events);
 		return FALSE;
 	}
 
@@ -676,11 +949,17 @@ BOOL CTcpServer::OnBeforeProcessIo(PVOID pv, UINT events)
 	if(events & _EPOLL_ALL_ERROR_EVENTS)
 		pSocketObj->SetConnected(FALSE);
 
+	if(m_ioDispatcher.IsSharded())
+		return TRUE;
+
+	if(m_bEdgeTrigger && !pSocketObj->AcquireIo(events))
+		return FALSE;
+
 	pSocketObj->csIo.lock();
 
 	if(!TSocketObj::IsValid(pSocketObj))
 	{
-		pSocketObj->csIo.unlock();
+		UnlockIo(pSocketObj);
 		return FALSE;
 	}
 
@@ -691,15 +970,45 @@ VOID CTcpServer::OnAfterProcessIo(PVOID pv, UINT events, BOOL rs)
 {
 	TSocketObj* pSocketObj = (TSocketObj*)(pv);
 
-	if(TSocketObj::IsValid(pSocketObj))
+	/* io_uring 模式下连接以完成方式收发数据，不需要重新注册 IO 事件 */
+	if(TSocketObj::IsValid(pSocketObj) && !m_ioDispatcher.IsIoUring())
 	{
 		ASSERT(rs && !(events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)));
 
-		UINT evts = (pSocketObj->IsPending() ? EPOLLOUT : 0) | (pSocketObj->IsPaused() ? 0 : EPOLLIN);
-		m_ioDispatcher.ModFD(pSocketObj->socket, evts | EPOLLRDHUP | EPOLLONESHOT, pSocketObj);
+		UINT evts = GetIoEvents(pSocketObj);
+
+		if(!m_bEdgeTrigger || evts != pSocketObj->ioEvents)
+		{
+			pSocketObj->ioEvents = evts;
+			m_ioDispatcher.ModFD(pSocketObj->shard, pSocketObj->socket, evts, pSocketObj);
+		}
 	}
 
+	if(!m_ioDispatcher.IsSharded())
+		UnlockIo(pSocketObj);
+}
+
+UINT CTcpServer::GetIoEvents(TSocketObj* pSocketObj)
+{
+	UINT evts = (pSocketObj->IsPaused() ? 0 : EPOLLIN) | EPOLLRDHUP;
+
+	if(m_bEdgeTrigger)
+		return evts | EPOLLOUT | EPOLLET;
+
+	return evts | (pSocketObj->IsPending() ? EPOLLOUT : 0) | EPOLLONESHOT;
+}
+
+VOID CTcpServer::UnlockIo(TSocketObj* pSocketObj)
+{
 	pSocketObj->csIo.unlock();
+
+	if(!m_bEdgeTrigger)
+		return;
+
+	UINT evts = pSocketObj->ReleaseIo();
+
+	if(evts != 0 && TSocketObj::IsValid(pSocketObj))
+		VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_IO, pSocketObj->connID, evts));
 }
 
 VOID CTcpServer::OnCommand(TDispCommand* pCmd)
@@ -709,6 +1018,12 @@ VOID CTcpServer::OnCommand(TDispCommand* pCmd)
 	case DISP_CMD_SEND:
 		HandleCmdSend((CONNID)(pCmd->wParam));
 		break;
+	case DISP_CMD_RECEIVE:
+		HandleCmdReceive((CONNID)(pCmd->wParam));
+		break;
+	case DISP_CMD_IO:
+		HandleCmdIo((CONNID)(pCmd->wParam), (UINT)(pCmd->lParam));
+		break;
 	case DISP_CMD_UNPAUSE:
 		HandleCmdUnpause((CONNID)(pCmd->wParam));
 		break;
@@ -718,14 +1033,94 @@ VOID CTcpServer::OnCommand(TDispCommand* pCmd)
 	}
 }
 
+VOID CTcpServer::OnIoComplete(PVOID pv, int op, int res, int iBufferID)
+{
+	TSocketObj* pSocketObj = (TSocketObj*)(pv);
+
+	if(op == DISP_IO_OP_RECV)
+		HandleReceiveComplete(pSocketObj, res, iBufferID);
+	else if(op == DISP_IO_OP_SEND)
+		HandleSendComplete(pSocketObj, res);
+	else if(op == DISP_IO_OP_ACCEPT)
+		HandleAcceptComplete(GetListenIndex(pv), res);
+	else
+		ASSERT(FALSE);
+}
+
+VOID CTcpServer::OnTimer(int iShard, LLONG llExpirations)
+{
+	ASSERT(iShard >= 0 && iShard < m_iConnTimers);
+
+	/* 定时把空闲线程缓存槽中的内存块归还共享缓存池 */
+	if(iShard == 0)
+		m_bfObjPool.FlushIdleCache();
+
+	TConnTimerList timers;
+
+	if(m_pConnTimers[iShard].Advance(timers) == 0)
+		return;
+
+	for(size_t i = 0; i < timers.size(); i++)
+	{
+		const TConnTimer& timer = timers[i];
+		TSocketObj* pSocketObj	= FindSocketObj(timer.connID);
+
+		if(!TSocketObj::IsValid(pSocketObj))
+			continue;
+
+		if(timer.fnTimer == nullptr)
+			HandleTimeout(pSocketObj);
+		else
+			timer.fnTimer(timer.connID, timer.pvParam);
+	}
+}
+
+VOID CTcpServer::HandleTimeout(TSocketObj* pSocketObj)
+{
+	DWORD dwRemain;
+	DWORD dwSilenceTimeout	 = m_bMarkSilence ? m_dwSilenceTimeout : 0;
+	DWORD dwHandShakeTimeout = IsHandShaked(pSocketObj) ? 0 : m_dwHandShakeTimeout;
+
+	if(pSocketObj->IsTimeout(m_dwMaxConnectPeriod, dwSilenceTimeout, dwHandShakeTimeout, dwRemain))
+		Disconnect(pSocketObj->connID);
+	else if(dwRemain > 0)
+		ArmTimer(pSocketObj, &pSocketObj->sysTimer, dwRemain);
+}
+
 VOID CTcpServer::HandleCmdSend(CONNID dwConnID)
 {
 	TSocketObj* pSocketObj = FindSocketObj(dwConnID);
 
-	if(TSocketObj::IsValid(pSocketObj) && pSocketObj->IsPending())
+	if(!TSocketObj::IsValid(pSocketObj) || (!pSocketObj->IsPending() && !pSocketObj->IsNotifyPending()))
+		return;
+
+	if(m_ioDispatcher.IsIoUring())
+		PostSend(pSocketObj);
+	else
 		m_ioDispatcher.ProcessIo(pSocketObj, EPOLLOUT);
 }
 
+VOID CTcpServer::HandleCmdReceive(CONNID dwConnID)
+{
+	TSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(!TSocketObj::IsValid(pSocketObj) || pSocketObj->IsPaused())
+		return;
+
+	if(m_ioDispatcher.IsIoUring())
+		PostReceive(pSocketObj);
+	else
+		m_ioDispatcher.ProcessIo(pSocketObj, EPOLLIN);
+}
+
+VOID CTcpServer::HandleCmdIo(CONNID dwConnID, UINT events)
+{
+	TSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(TSocketObj::IsValid(pSocketObj))
+		m_ioDispatcher.ProcessIo(pSocketObj, events);
+}
+
 VOID CTcpServer::HandleCmdUnpause(CONNID dwConnID)
 {
 	TSocketObj* pSocketObj = FindSocketObj(dwConnID);
@@ -734,7 +1129,12 @@ VOID CTcpServer::HandleCmdUnpause(CONNID dwConnID)
 		return;
 
 	if(BeforeUnpause(pSocketObj))
-		m_ioDispatcher.ProcessIo(pSocketObj, EPOLLIN);
+	{
+		if(m_ioDispatcher.IsIoUring())
+			ResumeReceive(pSocketObj);
+		else
+			m_ioDispatcher.ProcessIo(pSocketObj, EPOLLIN);
+	}
 	else
 		AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_RECEIVE, ENSURE_ERROR_CANCELLED);
 }
@@ -754,6 +1154,10 @@ BOOL CTcpServer::OnReadyRead(PVOID pv, UINT events)
 
 BOOL CTcpServer::OnReadyWrite(PVOID pv, UINT events)
 {
+	/* io_uring 模式下只有发送文件区域数据块阻塞时才会等待可写事件 */
+	if(m_ioDispatcher.IsIoUring())
+		return PostSend((TSocketObj*)pv);
+
 	return HandleSend((TSocketObj*)pv, RETRIVE_EVENT_FLAG_H(events));
 }
 
@@ -793,7 +1197,7 @@ BOOL CTcpServer::HandleClose(TSocketObj* pSocketObj, EnSocketCloseFlag enFlag, U
 	return TRUE;
 }
 
-BOOL CTcpServer::HandleAccept(UINT events)
+BOOL CTcpServer::HandleAccept(int iListen, UINT events)
 {
 	if(events & _EPOLL_ALL_ERROR_EVENTS)
 	{
@@ -806,7 +1210,7 @@ BOOL CTcpServer::HandleAccept(UINT events)
 		HP_SOCKADDR addr;
 
 		socklen_t addrLen	= (socklen_t)addr.AddrSize();
-		SOCKET soClient		= ::accept(m_soListen, addr.Addr(), &addrLen);
+		SOCKET soClient		= ::accept(m_soListens[iListen], addr.Addr(), &addrLen);
 
 		if(soClient == INVALID_SOCKET)
 		{
@@ -824,29 +1228,77 @@ BOOL CTcpServer::HandleAccept(UINT events)
 
 		VERIFY(::fcntl_SETFL(soClient, O_NOATIME | O_NONBLOCK | O_CLOEXEC));
 
-		CONNID dwConnID = 0;
+		AcceptClient(iListen, soClient, addr);
+	}
 
-		if(!m_bfActiveSockets.AcquireLock(dwConnID))
-		{
-			::ManualCloseSocket(soClient, SHUT_RDWR);
-			continue;
-		}
+	return TRUE;
+}
 
-		TSocketObj* pSocketObj = GetFreeSocketObj(dwConnID, soClient);
+VOID CTcpServer::HandleAcceptComplete(int iListen, int res)
+{
+	ASSERT(iListen >= 0);
 
-		AddClientSocketObj(dwConnID, pSocketObj, addr);
+	if(res < 0)
+	{
+		int code = -res;
 
-		if(TRIGGER(FireAccept(pSocketObj)) == HR_ERROR)
-		{
-			AddFreeSocketObj(pSocketObj, SCF_NONE);
-			continue;
-		}
+		if(code == ERROR_CONNABORTED || code == ERROR_CANCELLED || code == ERROR_HANDLES_CLOSED || code == EBADF || !HasStarted())
+			return;
 
-		UINT evts = (pSocketObj->IsPending() ? EPOLLOUT : 0) | (pSocketObj->IsPaused() ? 0 : EPOLLIN);
-		VERIFY(m_ioDispatcher.AddFD(pSocketObj->socket, evts | EPOLLRDHUP | EPOLLONESHOT, pSocketObj));
+		ERROR_EXIT2(EXIT_CODE_SOFTWARE, code);
 	}
 
-	return TRUE;
+	SOCKET soClient = (SOCKET)res;
+
+	/* 关闭监听 Socket 时尚未取消的 accept 请求仍可能接受新连接 */
+	if(!HasStarted())
+	{
+		::ManualCloseSocket(soClient, SHUT_RDWR);
+		return;
+	}
+
+	HP_SOCKADDR addr;
+	socklen_t addrLen = (socklen_t)addr.AddrSize();
+
+	if(IS_HAS_ERROR(::getpeername(soClient, addr.Addr(), &addrLen)))
+	{
+		::ManualCloseSocket(soClient, SHUT_RDWR);
+		return;
+	}
+
+	VERIFY(::fcntl_SETFL(soClient, O_NOATIME | O_NONBLOCK | O_CLOEXEC));
+
+	AcceptClient(iListen, soClient, addr);
+}
+
+BOOL CTcpServer::AcceptClient(int iListen, SOCKET soClient, const HP_SOCKADDR& addr)
+{
+	CONNID dwConnID = 0;
+
+	if(!m_bfActiveSockets.AcquireLock(dwConnID))
+	{
+		::ManualCloseSocket(soClient, SHUT_RDWR);
+		return FALSE;
+	}
+
+	TSocketObj* pSocketObj = GetFreeSocketObj(dwConnID, soClient);
+	/* 端口复用的分片模式下新连接绑定到接受它的工作线程 */
+	pSocketObj->shard	   = m_ioDispatcher.AssignShard((m_iListens > 1 && m_ioDispatcher.IsSharded()) ? iListen : -1);
+
+	AddClientSocketObj(dwConnID, pSocketObj, addr);
+
+	if(TRIGGER(FireAccept(pSocketObj)) == HR_ERROR)
+	{
+		AddFreeSocketObj(pSocketObj, SCF_NONE);
+		return FALSE;
+	}
+
+	/* io_uring 模式下接收请求只能由连接所属分片的工作线程提交 */
+	if(m_ioDispatcher.IsIoUring())
+		return VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_RECEIVE, dwConnID));
+
+	pSocketObj->ioEvents = GetIoEvents(pSocketObj);
+	return VERIFY(m_ioDispatcher.AddFD(pSocketObj->shard, pSocketObj->socket, pSocketObj->ioEvents, pSocketObj));
 }
 
 BOOL CTcpServer::HandleReceive(TSocketObj* pSocketObj, int flag)
@@ -855,22 +1307,40 @@ BOOL CTcpServer::HandleReceive(TSocketObj* pSocketObj, int flag)
 
 	if(m_bMarkSilence) pSocketObj->activeTime = ::TimeGetTime();
 
-	CBufferPtr& buffer = *(m_rcBufferMap[SELF_THREAD_ID]);
+	CBufferPtr& buffer	= *(m_rcBufferMap[SELF_THREAD_ID]);
+	TItem** ppItem		= m_bDetachableReceive ? &m_rcItemMap[SELF_THREAD_ID] : nullptr;
 
-	int reads = flag ? -1 : MAX_CONTINUE_READS;
+	int i		= 0;
+	int reads	= flag ? -1 : MAX_CONTINUE_READS;
 
-	for(int i = 0; i < reads || reads < 0; i++)
+	for(; i < reads || reads < 0; i++)
 	{
 		if(pSocketObj->paused)
 			break;
 
-		int rc = (int)read(pSocketObj->socket, buffer.Ptr(), buffer.Size());
+		BYTE* pBuffer	= buffer.Ptr();
+		int iBufferSize	= (int)buffer.Size();
 
-		if(rc > 0)
+		/* 可分离接收模式直接读入数据块，OnReceive 事件中可通过 DetachReceiveBuffer() 取走该数据块 */
+		if(ppItem != nullptr)
 		{
-			if(TRIGGER(FireReceive(pSocketObj, buffer.Ptr(), rc)) == HR_ERROR)
-			{
-				TRACE("<C-CNNID: %zu> OnReceive() event return 'HR_ERROR', connection will be closed !", pSocketObj->connID);
+			if(*ppItem == nullptr)
+				*ppItem = m_bfObjPool.PickFreeItem();
+
+			pBuffer		= (*ppItem)->Ptr();
+			iBufferSize	= (*ppItem)->Capacity();
+		}
+
+		int rc = (int)read(pSocketObj->socket, pBuffer, iBufferSize);
+
+		if(rc > 0)
+		{
+			if(ppItem != nullptr)
+				(*ppItem)->Reset(0, rc);
+
+			if(TRIGGER(FireReceive(pSocketObj, pBuffer, rc)) == HR_ERROR)
+			{
+				TRACE("<C-CNNID: %zu> OnReceive() event return 'HR_ERROR', connection will be closed !", pSocketObj->connID);
 
 				AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_RECEIVE, ENSURE_ERROR_CANCELLED);
 				return FALSE;
@@ -895,6 +1365,9 @@ BOOL CTcpServer::HandleReceive(TSocketObj* pSocketObj, int flag)
 		}
 	}
 
+	if(i == reads && m_bEdgeTrigger)
+		VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_RECEIVE, pSocketObj->connID));
+
 	return TRUE;
 }
 
@@ -902,76 +1375,485 @@ BOOL CTcpServer::HandleSend(TSocketObj* pSocketObj, int flag)
 {
 	ASSERT(TSocketObj::IsValid(pSocketObj));
 
-	if(!pSocketObj->IsPending())
+	if(!pSocketObj->IsPending() && !pSocketObj->IsNotifyPending())
 		return TRUE;
 
 	CReentrantCriSecLock locallock(pSocketObj->csSend);
 
+	if(pSocketObj->IsNotifyPending())
+		FlushSendNotify(pSocketObj);
+
 	if(!pSocketObj->IsPending())
 		return TRUE;
 
-	BOOL isOK = TRUE;
+	BOOL isOK		= TRUE;
+	BOOL bBlocked	= FALSE;
 
-	int writes = flag ? -1 : MAX_CONTINUE_WRITES;
-	TBufferObjList& sndBuff = pSocketObj->sndBuff;
+	int i		= 0;
+	int writes	= flag ? -1 : MAX_CONTINUE_WRITES;
 
-	for(int i = 0; i < writes || writes < 0; i++)
+	for(; i < writes || writes < 0; i++)
 	{
-		TItemPtr itPtr(sndBuff, sndBuff.PopFront());
+		if(!pSocketObj->IsPending())
+			break;
 
-		if(!itPtr.IsValid())
+		isOK = SendItems(pSocketObj, bBlocked);
+
+		if(!isOK || bBlocked)
 			break;
+	}
 
-		ASSERT(!itPtr->IsEmpty());
+	if(i == writes && m_bEdgeTrigger && pSocketObj->IsPending())
+		VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_SEND, pSocketObj->connID));
 
-		isOK = SendItem(pSocketObj, itPtr);
+	return isOK;
+}
 
-		if(!isOK)
-			break;
+BOOL CTcpServer::SendItems(TSocketObj* pSocketObj, BOOL& bBlocked)
+{
+	TBufferObjList& sndBuff = pSocketObj->sndBuff;
+
+	iovec iov[MAX_SEND_IOV_COUNT];
+	int iLength	= 0;
+	int iCount	= sndBuff.Gather(iov, MAX_SEND_IOV_COUNT, iLength);
+	int rc;
+
+	if(iCount > 0)
+		rc = (int)writev(pSocketObj->socket, iov, iCount);
+	else
+	{
+		/* 前部为文件区域数据块，使用 sendfile() 直接从文件发送 */
+		TItem* pItem = sndBuff.Front();
+
+		iLength	= pItem->Size();
+		rc		= (int)pItem->SendFile(pSocketObj->socket);
+	}
+
+	ASSERT(iLength > 0);
 
-		if(!itPtr->IsEmpty())
+	if(rc > 0)
+	{
+		if(iCount > 0)
+			NotifySend(pSocketObj, iov, rc);
+		else
+			NotifySend(pSocketObj, (const BYTE*)nullptr, rc);
+
+		/* 文件区域数据块移动到下一个窗口时发送队列长度会增加，按净减少量计算 */
+		int iPending = pSocketObj->Pending();
+
+		sndBuff.Reduce(rc);
+		ReduceSendPending(pSocketObj, iPending - pSocketObj->Pending());
+
+		bBlocked = (rc < iLength);
+	}
+	else if(rc == SOCKET_ERROR)
+	{
+		int code = ::WSAGetLastError();
+
+		if(code == ERROR_WOULDBLOCK)
+			bBlocked = TRUE;
+		else
 		{
-			sndBuff.PushFront(itPtr.Detach());
-			break;
+			AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_SEND, code);
+			return FALSE;
 		}
 	}
+	else if(iCount == 0)
+	{
+		/* 文件在发送过程中被截断 */
+		AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_SEND, ERROR_READ_FAULT);
+		return FALSE;
+	}
+	else
+		ASSERT(FALSE);
 
-	return isOK;
+	return TRUE;
 }
 
-BOOL CTcpServer::SendItem(TSocketObj* pSocketObj, TItem* pItem)
+/*
+* io_uring 模式下连接以完成方式收发数据：
+* 
+* 1. 每个连接同一时刻最多只有一个接收请求，请求完成后触发 OnReceive 事件再提交下一个接收请求；
+*    内核支持缓冲区环时由内核从分片的缓冲区环中选择数据块（空闲连接不占用接收数据块），缓冲区环为空（-ENOBUFS）时改用连接独占的接收数据块重新提交；
+*    否则内核直接把数据写入连接独占的接收数据块
+* 2. 发送缓冲区前部的数据块作为一个发送请求提交，请求完成后才从发送缓冲区移除已发送的数据，
+*    因此请求期间 Pending() 大于 0，直接发送模式不会在调用线程中越过该请求写入 Socket
+* 3. 暂停接收期间完成的接收请求的数据保留在接收数据块中，恢复接收时先触发 OnReceive 事件再提交新的接收请求
+* 4. 文件区域数据块仍使用 sendfile() 发送，Socket 发送缓冲区已满时以一次性 poll 请求等待可写
+* 5. 连接关闭时（EPOLL_CTL_DEL）取消尚未完成的请求，收发请求完成前连接对象不会被复用
+*/
+BOOL CTcpServer::PostReceive(TSocketObj* pSocketObj, BOOL bSelectBuffer)
+{
+	if(!TSocketObj::IsValid(pSocketObj) || pSocketObj->rcvPosted || pSocketObj->IsPaused())
+		return TRUE;
+
+	BYTE* pBuffer	= nullptr;
+	int iLength		= 0;
+
+	if(bSelectBuffer && IsRecvBufferSelect())
+		ReleaseReceiveItem(pSocketObj);
+	else
+	{
+		if(pSocketObj->rcvItem == nullptr)
+			pSocketObj->rcvItem = m_bfObjPool.PickFreeItem();
+
+		TItem* pItem = pSocketObj->rcvItem;
+		pItem->Reset();
+
+		pBuffer = pItem->Ptr();
+		iLength = pItem->Capacity();
+	}
+
+	if(!m_ioDispatcher.PostRecv(pSocketObj->shard, pSocketObj->socket, pBuffer, iLength, pSocketObj))
+	{
+		AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_RECEIVE, ::GetLastError());
+		return FALSE;
+	}
+
+	pSocketObj->rcvPosted = TRUE;
+
+	return TRUE;
+}
+
+BOOL CTcpServer::ResumeReceive(TSocketObj* pSocketObj)
 {
-	while(!pItem->IsEmpty())
+	if(pSocketObj->IsPaused())
+		return TRUE;
+
+	TItem* pItem = pSocketObj->rcvItem;
+
+	if(!pSocketObj->rcvPosted && pItem != nullptr && !pItem->IsEmpty())
 	{
-		int rc = (int)write(pSocketObj->socket, pItem->Ptr(), pItem->Size());
+		if(!FireReceiveItem(pSocketObj))
+			return FALSE;
+	}
 
-		if(rc > 0)
+	return PostReceive(pSocketObj);
+}
+
+BOOL CTcpServer::FireReceiveItem(TSocketObj* pSocketObj)
+{
+	TItem* pItem	= pSocketObj->rcvItem;
+	TItem** ppItem	= m_bDetachableReceive ? &m_rcItemMap[SELF_THREAD_ID] : nullptr;
+
+	/* 可分离接收模式下 OnReceive 事件中可通过 DetachReceiveBuffer() 取走接收数据块 */
+	if(ppItem != nullptr)
+	{
+		ASSERT(*ppItem == nullptr);
+		*ppItem = pItem;
+	}
+
+	EnHandleResult rs = TRIGGER(FireReceive(pSocketObj, pItem->Ptr(), pItem->Size()));
+
+	if(ppItem != nullptr && *ppItem == nullptr)
+		pSocketObj->rcvItem = nullptr;
+	else
+	{
+		pItem->Reset();
+
+		if(ppItem != nullptr)
+			*ppItem = nullptr;
+	}
+
+	if(rs == HR_ERROR)
+	{
+		TRACE("<C-CNNID: %zu> OnReceive() event return 'HR_ERROR', connection will be closed !", pSocketObj->connID);
+
+		AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_RECEIVE, ENSURE_ERROR_CANCELLED);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+VOID CTcpServer::HandleReceiveComplete(TSocketObj* pSocketObj, int res, int iBufferID)
+{
+	ASSERT(pSocketObj->rcvPosted);
+
+	if(iBufferID >= 0)
+	{
+		ASSERT(pSocketObj->rcvItem == nullptr);
+		pSocketObj->rcvItem = TakeRecvBuffer(pSocketObj->shard, iBufferID);
+	}
+
+	if(!TSocketObj::IsValid(pSocketObj))
+	{
+		/* 先回收接收数据块再清除请求标志，清除标志后连接对象即可被复用 */
+		ReleaseReceiveItem(pSocketObj);
+		::InterlockedExchange(&pSocketObj->rcvPosted, FALSE);
+
+		return;
+	}
+
+	pSocketObj->rcvPosted = FALSE;
+
+	if(res == -ENOBUFS)
+		PostReceive(pSocketObj, FALSE);
+	else if(res > 0)
+	{
+		if(m_bMarkSilence) pSocketObj->activeTime = ::TimeGetTime();
+
+		pSocketObj->rcvItem->Reset(0, res);
+
+		if(pSocketObj->IsPaused() || !FireReceiveItem(pSocketObj))
+			return;
+
+		PostReceive(pSocketObj);
+	}
+	else if(res == 0)
+		AddFreeSocketObj(pSocketObj, SCF_CLOSE, SO_RECEIVE, SE_OK);
+	else
+		AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_RECEIVE, -res);
+}
+
+VOID CTcpServer::ReleaseReceiveItem(TSocketObj* pSocketObj)
+{
+	if(pSocketObj->rcvItem != nullptr)
+	{
+		m_bfObjPool.PutFreeItem(pSocketObj->rcvItem);
+		pSocketObj->rcvItem = nullptr;
+	}
+}
+
+VOID CTcpServer::SetupRecvBuffers()
+{
+	int iShards = m_ioDispatcher.GetShardCount();
+
+	/* 内核不支持缓冲区环（5.19 以前）时连接使用独占的接收数据块，并以 poll 请求模拟监听 Socket 的 EPOLL 注册 */
+	for(int i = 0; i < iShards; i++)
+	{
+		if(!m_ioDispatcher.SetupRecvBuffers(i, URING_RECV_BUFFER_COUNT))
+			return;
+	}
+
+	m_iRecvBuffers		= URING_RECV_BUFFER_COUNT;
+	m_iRecvBufferShards	= iShards;
+	m_pRecvBuffers = make_unique<TItem*[]>(iShards * m_iRecvBuffers);
+
+	for(int i = 0; i < iShards; i++)
+	{
+		for(int j = 0; j < m_iRecvBuffers; j++)
 		{
-			if(TRIGGER(FireSend(pSocketObj, pItem->Ptr(), rc)) == HR_ERROR)
+			TItem* pItem = m_bfObjPool.PickFreeItem();
+			m_pRecvBuffers[i * m_iRecvBuffers + j] = pItem;
+
+			m_ioDispatcher.ProvideRecvBuffer(i, pItem->Ptr(), pItem->Capacity(), j);
+		}
+	}
+}
+
+VOID CTcpServer::ReleaseRecvBuffers()
+{
+	if(!m_pRecvBuffers)
+		return;
+
+	int iCount = m_iRecvBufferShards * m_iRecvBuffers;
+
+	for(int i = 0; i < iCount; i++)
+		m_bfObjPool.PutFreeItem(m_pRecvBuffers[i]);
+
+	m_pRecvBuffers.reset();
+	m_iRecvBuffers		= 0;
+	m_iRecvBufferShards	= 0;
+}
+
+TItem* CTcpServer::TakeRecvBuffer(int iShard, int iBufferID)
+{
+	ASSERT(iBufferID < m_iRecvBuffers);
+
+	/* 被选择的数据块转为连接的接收数据块，同时放入新的数据块补充缓冲区环 */
+	TItem*& pSlot	= m_pRecvBuffers[iShard * m_iRecvBuffers + iBufferID];
+	TItem* pItem	= pSlot;
+	pSlot			= m_bfObjPool.PickFreeItem();
+
+	m_ioDispatcher.ProvideRecvBuffer(iShard, pSlot->Ptr(), pSlot->Capacity(), iBufferID);
+
+	return pItem;
+}
+
+BOOL CTcpServer::PostSend(TSocketObj* pSocketObj)
+{
+	CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+	if(pSocketObj->IsNotifyPending())
+		FlushSendNotify(pSocketObj);
+
+	while(TSocketObj::IsValid(pSocketObj) && !pSocketObj->sndPosted && pSocketObj->IsPending())
+	{
+		TUringSendMsg* pMsg	= pSocketObj->GetSendMsg();
+		int iLength			= 0;
+		int iCount			= pSocketObj->sndBuff.Gather(pMsg->iov, MAX_URING_SEND_IOV_COUNT, iLength);
+
+		if(iCount > 0)
+		{
+			msghdr& msg = pMsg->msg;
+
+			ZeroObject(msg);
+			msg.msg_iov		= pMsg->iov;
+			msg.msg_iovlen	= iCount;
+
+			if(!m_ioDispatcher.PostSend(pSocketObj->shard, pSocketObj->socket, &msg, pSocketObj))
 			{
-				TRACE("<C-CNNID: %zu> OnSend() event should not return 'HR_ERROR' !!", pSocketObj->connID);
-				ASSERT(FALSE);
+				AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_SEND, ::GetLastError());
+				return FALSE;
 			}
 
-			pItem->Reduce(rc);
+			pSocketObj->sndPosted = TRUE;
+			break;
 		}
-		else if(rc == SOCKET_ERROR)
-		{
-			int code = ::WSAGetLastError();
 
-			if(code == ERROR_WOULDBLOCK)
-				break;
+		/* 前部为文件区域数据块 */
+		BOOL bBlocked = FALSE;
 
-			AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_SEND, code);
+		if(!SendItems(pSocketObj, bBlocked))
 			return FALSE;
+
+		if(bBlocked)
+		{
+			VERIFY(m_ioDispatcher.ModFD(pSocketObj->shard, pSocketObj->socket, EPOLLOUT | EPOLLONESHOT, pSocketObj));
+			break;
 		}
-		else
-			ASSERT(FALSE);
 	}
 
 	return TRUE;
 }
 
+VOID CTcpServer::HandleSendComplete(TSocketObj* pSocketObj, int res)
+{
+	ASSERT(pSocketObj->sndPosted);
+
+	CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+	if(!TSocketObj::IsValid(pSocketObj))
+	{
+		::InterlockedExchange(&pSocketObj->sndPosted, FALSE);
+		return;
+	}
+
+	pSocketObj->sndPosted = FALSE;
+
+	if(res < 0)
+	{
+		AddFreeSocketObj(pSocketObj, SCF_ERROR, SO_SEND, -res);
+		return;
+	}
+
+	if(res > 0)
+	{
+		NotifySend(pSocketObj, pSocketObj->sndMsg->iov, res);
+
+		pSocketObj->sndBuff.Reduce(res);
+		ReduceSendPending(pSocketObj, res);
+	}
+
+	PostSend(pSocketObj);
+}
+
+void CTcpServer::NotifySend(TSocketObj* pSocketObj, const iovec iov[], int iSent)
+{
+	if(m_bBatchSendNotify)
+		NotifySend(pSocketObj, (const BYTE*)nullptr, iSent);
+	else
+	{
+		for(int i = 0; iSent > 0; i++)
+		{
+			int iLength = min((int)iov[i].iov_len, iSent);
+			NotifySend(pSocketObj, (const BYTE*)iov[i].iov_base, iLength);
+
+			iSent -= iLength;
+		}
+	}
+}
+
+/* 直接发送的数据全部写入 Socket 后，在调用线程中释放发送锁后触发 OnSend 事件 */
+void CTcpServer::NotifyDirectSend(TSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int iSent)
+{
+	if(!TSocketObj::IsValid(pSocketObj))
+		return;
+
+	if(m_bBatchSendNotify)
+		NotifySend(pSocketObj, (const BYTE*)nullptr, iSent);
+	else
+	{
+		for(int i = 0; i < iCount; i++)
+		{
+			if(pBuffers[i].len > 0)
+				NotifySend(pSocketObj, (const BYTE*)pBuffers[i].buf, (int)pBuffers[i].len);
+		}
+	}
+}
+
+/* 直接发送只写入部分数据时，已发送部分只记录长度，由工作线程在发送剩余数据前触发 OnSend 事件（pData 为 nullptr） */
+void CTcpServer::FlushSendNotify(TSocketObj* pSocketObj)
+{
+	int iLength = pSocketObj->sndNotifyLen;
+	pSocketObj->sndNotifyLen = 0;
+
+	NotifySend(pSocketObj, (const BYTE*)nullptr, iLength);
+}
+
+void CTcpServer::NotifySend(TSocketObj* pSocketObj, const BYTE* pData, int iLength)
+{
+	if(TRIGGER(FireSend(pSocketObj, pData, iLength)) == HR_ERROR)
+	{
+		TRACE("<C-CNNID: %zu> OnSend() event should not return 'HR_ERROR' !!", pSocketObj->connID);
+		ASSERT(FALSE);
+	}
+}
+
+void CTcpServer::NotifyWritable(TSocketObj* pSocketObj, BOOL bWritable)
+{
+	if(TRIGGER(FireWritable(pSocketObj, bWritable)) == HR_ERROR)
+	{
+		TRACE("<S-CNNID: %zu> OnWritable() event should not return 'HR_ERROR' !!", pSocketObj->connID);
+		ASSERT(FALSE);
+	}
+}
+
+/* 检查是否允许发送新的应用数据：待发数据超过高水位或总量超过 MaxSendPending 时拒绝发送 */
+BOOL CTcpServer::CheckSendQuota(TSocketObj* pSocketObj)
+{
+	int result = NO_ERROR;
+
+	if(pSocketObj->sndBlocked)
+		result = ERROR_WOULDBLOCK;
+	else if(IsSendPendingLimited() && m_llSendPending >= (LLONG)m_dwMaxSendPending)
+		result = ERROR_NOT_ENOUGH_QUOTA;
+
+	if(result != NO_ERROR)
+		::SetLastError(result);
+
+	return (result == NO_ERROR);
+}
+
+/* 统计新加入发送缓冲区的数据（iPending 为加入前的待发数据长度），达到高水位时触发 OnWritable(FALSE)（在 csSend 锁内调用） */
+void CTcpServer::AddSendPending(TSocketObj* pSocketObj, int iPending)
+{
+	int iCurPending = pSocketObj->Pending();
+
+	if(IsSendPendingLimited() && iCurPending != iPending)
+		::InterlockedExchangeAdd(&m_llSendPending, (LLONG)(iCurPending - iPending));
+
+	if(m_dwSendHighWatermark > 0 && !pSocketObj->sndBlocked && iCurPending >= (int)m_dwSendHighWatermark)
+	{
+		pSocketObj->sndBlocked = TRUE;
+		NotifyWritable(pSocketObj, FALSE);
+	}
+}
+
+/* 统计已从发送缓冲区发出的数据，降到低水位以下时触发 OnWritable(TRUE)（在 csSend 锁内调用） */
+void CTcpServer::ReduceSendPending(TSocketObj* pSocketObj, int iLength)
+{
+	if(IsSendPendingLimited())
+		::InterlockedExchangeSub(&m_llSendPending, (LLONG)iLength);
+
+	if(pSocketObj->sndBlocked && pSocketObj->Pending() <= (int)m_dwSendLowWatermark)
+	{
+		pSocketObj->sndBlocked = FALSE;
+		NotifyWritable(pSocketObj, TRUE);
+	}
+}
+
 BOOL CTcpServer::Send(CONNID dwConnID, const BYTE* pBuffer, int iLength, int iOffset)
 {
 	ASSERT(pBuffer && iLength > 0);
@@ -997,6 +1879,9 @@ BOOL CTcpServer::DoSendPackets(CONNID dwConnID, const WSABUF pBuffers[], int iCo
 		return FALSE;
 	}
 
+	if(!CheckSendQuota(pSocketObj))
+		return FALSE;
+
 	return DoSendPackets(pSocketObj, pBuffers, iCount);
 }
 
@@ -1004,30 +1889,42 @@ BOOL CTcpServer::DoSendPackets(TSocketObj* pSocketObj, const WSABUF pBuffers[],
 {
 	ASSERT(pSocketObj && pBuffers && iCount > 0);
 
-	int result = NO_ERROR;
+	int result	= NO_ERROR;
+	int iDirect	= 0;
 
 	if(pBuffers && iCount > 0)
 	{
 		CReentrantCriSecLock locallock(pSocketObj->csSend);
 
-		if(TSocketObj::IsValid(pSocketObj))
-			result = SendInternal(pSocketObj, pBuffers, iCount);
-		else
+		if(!TSocketObj::IsValid(pSocketObj))
 			result = ERROR_OBJECT_NOT_FOUND;
+		else
+		{
+			int iPending = pSocketObj->Pending();
+
+			result = SendInternal(pSocketObj, pBuffers, iCount, iDirect);
+			AddSendPending(pSocketObj, iPending);
+		}
 	}
 	else
 		result = ERROR_INVALID_PARAMETER;
 
+	if(iDirect > 0)
+		NotifyDirectSend(pSocketObj, pBuffers, iCount, iDirect);
+
 	if(result != NO_ERROR)
 		::SetLastError(result);
 
 	return (result == NO_ERROR);
 }
 
-int CTcpServer::SendInternal(TSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount)
+int CTcpServer::SendInternal(TSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int& iDirect)
 {
 	int iPending = pSocketObj->Pending();
 
+	if(iPending == 0 && m_enSendPolicy == SP_DIRECT && iCount <= MAX_SEND_IOV_COUNT)
+		return SendDirect(pSocketObj, pBuffers, iCount, iDirect);
+
 	for(int i = 0; i < iCount; i++)
 	{
 		int iBufLen = pBuffers[i].len;
@@ -1043,13 +1940,279 @@ int CTcpServer::SendInternal(TSocketObj* pSocketObj, const WSABUF pBuffers[], in
 
 	if(iPending == 0 && pSocketObj->IsPending())
 	{
-		if(!m_ioDispatcher.SendCommand(DISP_CMD_SEND, pSocketObj->connID))
+		if(!m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_SEND, pSocketObj->connID))
 			return ::GetLastError();
 	}
 
 	return NO_ERROR;
 }
 
+int CTcpServer::SendDirect(TSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int& iDirect)
+{
+	iovec iov[MAX_SEND_IOV_COUNT];
+	int iLength	= 0;
+	int iVecs	= 0;
+
+	for(int i = 0; i < iCount; i++)
+	{
+		int iBufLen = pBuffers[i].len;
+
+		if(iBufLen > 0)
+		{
+			ASSERT(pBuffers[i].buf);
+
+			iov[iVecs].iov_base	= pBuffers[i].buf;
+			iov[iVecs].iov_len	= iBufLen;
+
+			iLength += iBufLen;
+			++iVecs;
+		}
+	}
+
+	if(iVecs == 0)
+		return NO_ERROR;
+
+	int rc = (int)writev(pSocketObj->socket, iov, iVecs);
+
+	if(rc == SOCKET_ERROR)
+	{
+		int code = ::WSAGetLastError();
+
+		if(code != ERROR_WOULDBLOCK)
+			return code;
+
+		rc = 0;
+	}
+
+	/* 已有未触发的 OnSend 事件时，工作线程尚未处理的 DISP_CMD_SEND 命令会一并处理本次发送 */
+	BOOL bPost = !pSocketObj->IsNotifyPending();
+
+	if(rc == iLength && bPost)
+	{
+		iDirect = rc;
+		return NO_ERROR;
+	}
+
+	pSocketObj->sndNotifyLen += rc;
+
+	for(int i = 0, iSkip = rc; i < iVecs; i++)
+	{
+		int iBufLen = (int)iov[i].iov_len;
+
+		if(iSkip >= iBufLen)
+			iSkip -= iBufLen;
+		else
+		{
+			pSocketObj->sndBuff.Cat((const BYTE*)iov[i].iov_base + iSkip, iBufLen - iSkip);
+			iSkip = 0;
+		}
+	}
+
+	if(bPost && !m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_SEND, pSocketObj->connID))
+		return ::GetLastError();
+
+	return NO_ERROR;
+}
+
+BOOL CTcpServer::SendReference(CONNID dwConnID, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam)
+{
+	ASSERT(pBuffer && iLength > 0);
+
+	int result	= NO_ERROR;
+	int iDirect	= 0;
+
+	if(pBuffer && iLength > 0)
+	{
+		TSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+		if(!TSocketObj::IsValid(pSocketObj))
+			result = ERROR_OBJECT_NOT_FOUND;
+		else
+		{
+			{
+				CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+				if(!TSocketObj::IsValid(pSocketObj))
+					result = ERROR_OBJECT_NOT_FOUND;
+				else if(!CheckSendQuota(pSocketObj))
+					result = ::GetLastError();
+				else
+				{
+					int iPending = pSocketObj->Pending();
+
+					result = SendReference(pSocketObj, pBuffer, iLength, fnRelease, pvParam, iDirect);
+					AddSendPending(pSocketObj, iPending);
+				}
+			}
+
+			if(iDirect > 0)
+			{
+				WSABUF buffer;
+				buffer.len = iLength;
+				buffer.buf = (BYTE*)pBuffer;
+
+				NotifyDirectSend(pSocketObj, &buffer, 1, iDirect);
+
+				if(fnRelease != nullptr)
+					fnRelease(pBuffer, iLength, pvParam, TRUE);
+			}
+		}
+	}
+	else
+		result = ERROR_INVALID_PARAMETER;
+
+	if(result != NO_ERROR)
+	{
+		if(fnRelease != nullptr)
+			fnRelease(pBuffer, iLength, pvParam, FALSE);
+
+		::SetLastError(result);
+	}
+
+	return (result == NO_ERROR);
+}
+
+int CTcpServer::SendReference(TSocketObj* pSocketObj, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam, int& iDirect)
+{
+	int iPending = pSocketObj->Pending();
+	int iSent	 = 0;
+
+	if(iPending == 0 && m_enSendPolicy == SP_DIRECT)
+	{
+		iovec iov;
+		iov.iov_base = (PVOID)pBuffer;
+		iov.iov_len	 = iLength;
+
+		int rc = (int)writev(pSocketObj->socket, &iov, 1);
+
+		if(rc == SOCKET_ERROR)
+		{
+			int code = ::WSAGetLastError();
+
+			if(code != ERROR_WOULDBLOCK)
+				return code;
+		}
+		else if(rc > 0)
+		{
+			/* 全部发送完成后由调用者释放锁后触发 OnSend 事件并调用 fnRelease */
+			if(rc == iLength && !pSocketObj->IsNotifyPending())
+			{
+				iDirect = rc;
+				return NO_ERROR;
+			}
+
+			iSent = rc;
+			pSocketObj->sndNotifyLen += rc;
+		}
+	}
+
+	/* 缓冲区引用加入发送队列后由发送队列负责调用 fnRelease */
+	pSocketObj->sndBuff.Attach(pBuffer, iLength, fnRelease, pvParam);
+
+	if(iSent > 0)
+		pSocketObj->sndBuff.Reduce(iSent);
+
+	if(iPending == 0)
+		VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_SEND, pSocketObj->connID));
+
+	return NO_ERROR;
+}
+
+BOOL CTcpServer::Broadcast(const CONNID pConnIDs[], int iConnCount, const BYTE* pBuffer, int iLength)
+{
+	ASSERT(pBuffer && iLength > 0);
+
+	WSABUF buffer;
+	buffer.len = iLength;
+	buffer.buf = (BYTE*)pBuffer;
+
+	return BroadcastPackets(pConnIDs, iConnCount, &buffer, 1);
+}
+
+BOOL CTcpServer::BroadcastPackets(const CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount)
+{
+	ASSERT(pConnIDs && iConnCount > 0 && pBuffers && iCount > 0);
+
+	int iLength = 0;
+
+	for(int i = 0; pBuffers && i < iCount; i++)
+		iLength += (int)pBuffers[i].len;
+
+	if(!pConnIDs || iConnCount <= 0 || iLength <= 0)
+	{
+		::SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	TSharedItem* pShared = TSharedItem::Construct(m_bfObjPool.GetPrivateHeap(), iLength);
+	BYTE* pData			 = pShared->Ptr();
+
+	for(int i = 0; i < iCount; i++)
+	{
+		if(pBuffers[i].len > 0)
+		{
+			memcpy(pData, pBuffers[i].buf, pBuffers[i].len);
+			pData += pBuffers[i].len;
+		}
+	}
+
+	int result = NO_ERROR;
+
+	for(int i = 0; i < iConnCount; i++)
+	{
+		pShared->AddRef();
+
+		if(!CTcpServer::SendReference(pConnIDs[i], pShared->Ptr(), iLength, TSharedItem::ReleaseRef, pShared))
+			result = ::GetLastError();
+	}
+
+	pShared->Release();
+
+	if(result != NO_ERROR)
+		::SetLastError(result);
+
+	return (result == NO_ERROR);
+}
+
+BOOL CTcpServer::DetachReceiveBuffer(const BYTE* pData, int iLength, PVOID* ppBuffer)
+{
+	ASSERT(pData && iLength > 0 && ppBuffer);
+
+	TReceiveItemMapI it = m_rcItemMap.find(SELF_THREAD_ID);
+
+	/* 只能在 OnReceive 事件中分离，并且 OnReceive 事件的数据必须是未经加工的完整接收数据 */
+	if(it == m_rcItemMap.end() || it->second == nullptr || it->second->Ptr() != pData || it->second->Size() != iLength)
+	{
+		::SetLastError(ERROR_INVALID_STATE);
+		return FALSE;
+	}
+
+	*ppBuffer	= it->second;
+	it->second	= nullptr;
+
+	::InterlockedIncrement(&m_lDetachedBuffers);
+
+	return TRUE;
+}
+
+BOOL CTcpServer::ReleaseReceiveBuffer(PVOID pBuffer)
+{
+	ASSERT(pBuffer);
+
+	if(pBuffer == nullptr)
+	{
+		::SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	m_bfObjPool.PutFreeItem((TItem*)pBuffer);
+
+	/* 计数最后递减：Stop() 在计数归零之后才会清理缓冲池 */
+	::InterlockedDecrement(&m_lDetachedBuffers);
+
+	return TRUE;
+}
+
 BOOL CTcpServer::SendSmallFile(CONNID dwConnID, LPCTSTR lpszFileName, const LPWSABUF pHead, const LPWSABUF pTail)
 {
 	CFile file;
@@ -1066,3 +2229,62 @@ BOOL CTcpServer::SendSmallFile(CONNID dwConnID, LPCTSTR lpszFileName, const LPWS
 
 	return SendPackets(dwConnID, szBuf, 3);
 }
+
+BOOL CTcpServer::SendFile(CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset, LONGLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	CFile file;
+	HRESULT result = ::OpenFileRegion(lpszFileName, file, llOffset, llLength, pHead, pTail);
+
+	if(SUCCEEDED(result))
+	{
+		TSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+		if(!TSocketObj::IsValid(pSocketObj))
+			result = ERROR_OBJECT_NOT_FOUND;
+		else
+		{
+			CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+			if(!TSocketObj::IsValid(pSocketObj))
+				result = ERROR_OBJECT_NOT_FOUND;
+			else if(!CheckSendQuota(pSocketObj))
+				result = ::GetLastError();
+			else
+			{
+				int iPending = pSocketObj->Pending();
+
+				result = SendFileRegion(pSocketObj, file, llOffset, llLength, pHead, pTail);
+				AddSendPending(pSocketObj, iPending);
+			}
+		}
+	}
+
+	if(result != NO_ERROR)
+		::SetLastError(result);
+
+	return (result == NO_ERROR);
+}
+
+int CTcpServer::SendFileRegion(TSocketObj* pSocketObj, CFile& file, LLONG llOffset, LLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail)
+{
+	int iPending	= pSocketObj->Pending();
+	int iHead		= pHead ? (int)pHead->len : 0;
+	int iTail		= pTail ? (int)pTail->len : 0;
+	int iWindow		= (int)MIN(llLength, (LLONG)TItem::MAX_FILE_WINDOW_SIZE);
+
+	/* 发送队列长度为 32 位整数（文件区域每次只占用一个窗口的长度） */
+	if(iHead + iWindow + iTail > MAX_SEND_FILE_SIZE - iPending)
+		return ERROR_NOT_ENOUGH_QUOTA;
+
+	/* 文件数据不拷贝到发送队列，由发送队列接管文件并在发送时使用 sendfile() */
+	TBufferObjList& sndBuff = pSocketObj->sndBuff;
+
+	if(iHead > 0) sndBuff.Cat((const BYTE*)pHead->buf, iHead);
+	if(llLength > 0) sndBuff.AttachFile(file.Detach(), llOffset, llLength);
+	if(iTail > 0) sndBuff.Cat((const BYTE*)pTail->buf, iTail);
+
+	if(iPending == 0)
+		VERIFY(m_ioDispatcher.SendShardCommand(pSocketObj->shard, DISP_CMD_SEND, pSocketObj->connID));
+
+	return NO_ERROR;
+}
@@ -34,13 +34,21 @@ public:
 	virtual BOOL Stop	();
 	virtual BOOL Send	(CONNID dwConnID, const BYTE* pBuffer, int iLength, int iOffset = 0);
 	virtual BOOL SendSmallFile	(CONNID dwConnID, LPCTSTR lpszFileName, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr);
+	virtual BOOL SendFile		(CONNID dwConnID, LPCTSTR lpszFileName, LONGLONG llOffset = 0, LONGLONG llLength = 0, const LPWSABUF pHead = nullptr, const LPWSABUF pTail = nullptr);
 	virtual BOOL SendPackets	(CONNID dwConnID, const WSABUF pBuffers[], int iCount)	{return DoSendPackets(dwConnID, pBuffers, iCount);}
+	virtual BOOL SendReference	(CONNID dwConnID, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam = nullptr);
+	virtual BOOL Broadcast		(const CONNID pConnIDs[], int iConnCount, const BYTE* pBuffer, int iLength);
+	virtual BOOL BroadcastPackets	(const CONNID pConnIDs[], int iConnCount, const WSABUF pBuffers[], int iCount);
+	virtual BOOL DetachReceiveBuffer	(const BYTE* pData, int iLength, PVOID* ppBuffer);
+	virtual BOOL ReleaseReceiveBuffer	(PVOID pBuffer);
 	virtual BOOL PauseReceive	(CONNID dwConnID, BOOL bPause = TRUE);
 	virtual BOOL			HasStarted					()	{return m_enState == SS_STARTED || m_enState == SS_STARTING;}
 	virtual EnServiceState	GetState					()	{return m_enState;}
 	virtual BOOL			Disconnect					(CONNID dwConnID, BOOL bForce = TRUE);
 	virtual BOOL			DisconnectLongConnections	(DWORD dwPeriod, BOOL bForce = TRUE);
 	virtual BOOL			DisconnectSilenceConnections(DWORD dwPeriod, BOOL bForce = TRUE);
+	virtual BOOL			SetConnectionTimer			(CONNID dwConnID, DWORD dwTimeout, Fn_ConnectionTimer fnTimer, PVOID pvParam = nullptr);
+	virtual BOOL			KillConnectionTimer			(CONNID dwConnID);
 	virtual BOOL			GetListenAddress			(TCHAR lpszAddress[], int& iAddressLen, USHORT& usPort);
 	virtual BOOL			GetLocalAddress				(CONNID dwConnID, TCHAR lpszAddress[], int& iAddressLen, USHORT& usPort);
 	virtual BOOL			GetRemoteAddress			(CONNID dwConnID, TCHAR lpszAddress[], int& iAddressLen, USHORT& usPort);
@@ -48,6 +56,7 @@ public:
 	virtual BOOL IsConnected			(CONNID dwConnID);
 	virtual BOOL IsPauseReceive			(CONNID dwConnID, BOOL& bPaused);
 	virtual BOOL GetPendingDataLength	(CONNID dwConnID, int& iPending);
+	virtual void GetFreeBufferObjCacheStat	(ULONGLONG& ullHits, ULONGLONG& ullMisses)	{m_bfObjPool.GetCacheStat(ullHits, ullMisses);}
 	virtual DWORD GetConnectionCount	();
 	virtual BOOL GetAllConnectionIDs	(CONNID pIDs[], DWORD& dwCount);
 	virtual BOOL GetConnectPeriod		(CONNID dwConnID, DWORD& dwPeriod);
@@ -59,6 +68,8 @@ private:
 	virtual BOOL OnBeforeProcessIo(PVOID pv, UINT events)			override;
 	virtual VOID OnAfterProcessIo(PVOID pv, UINT events, BOOL rs)	override;
 	virtual VOID OnCommand(TDispCommand* pCmd)						override;
+	virtual VOID OnTimer(int iShard, LLONG llExpirations)			override;
+	virtual VOID OnIoComplete(PVOID pv, int op, int res, int iBufferID)	override;
 	virtual BOOL OnReadyRead(PVOID pv, UINT events)					override;
 	virtual BOOL OnReadyWrite(PVOID pv, UINT events)				override;
 	virtual BOOL OnHungUp(PVOID pv, UINT events)					override;
@@ -83,6 +94,8 @@ public:
 
 	virtual void SetSendPolicy				(EnSendPolicy enSendPolicy)				{m_enSendPolicy			= enSendPolicy;}
 	virtual void SetOnSendSyncPolicy		(EnOnSendSyncPolicy enOnSendSyncPolicy)	{m_enOnSendSyncPolicy	= enOnSendSyncPolicy;}
+	virtual void SetDispatchMode			(EnDispatchMode enDispatchMode)			{m_enDispatchMode		= enDispatchMode;}
+	virtual void SetListenMode				(EnListenMode enListenMode)				{m_enListenMode			= enListenMode;}
 	virtual void SetMaxConnectionCount		(DWORD dwMaxConnectionCount)	{m_dwMaxConnectionCount		= dwMaxConnectionCount;}
 	virtual void SetWorkerThreadCount		(DWORD dwWorkerThreadCount)		{m_dwWorkerThreadCount		= dwWorkerThreadCount;}
 	virtual void SetSocketListenQueue		(DWORD dwSocketListenQueue)		{m_dwSocketListenQueue		= dwSocketListenQueue;}
@@ -93,12 +106,28 @@ public:
 	virtual void SetFreeBufferObjPool		(DWORD dwFreeBufferObjPool)		{m_dwFreeBufferObjPool		= dwFreeBufferObjPool;}
 	virtual void SetFreeSocketObjHold		(DWORD dwFreeSocketObjHold)		{m_dwFreeSocketObjHold		= dwFreeSocketObjHold;}
 	virtual void SetFreeBufferObjHold		(DWORD dwFreeBufferObjHold)		{m_dwFreeBufferObjHold		= dwFreeBufferObjHold;}
+	virtual void SetFreeSocketObjPrealloc	(DWORD dwFreeSocketObjPrealloc)	{m_dwFreeSocketObjPrealloc	= dwFreeSocketObjPrealloc;}
+	virtual void SetFreeBufferObjPrealloc	(DWORD dwFreeBufferObjPrealloc)	{m_dwFreeBufferObjPrealloc	= dwFreeBufferObjPrealloc;}
+	virtual void SetFreeBufferObjCache		(DWORD dwFreeBufferObjCache)	{m_dwFreeBufferObjCache		= dwFreeBufferObjCache;}
+	virtual void SetPoolNumaInterleave		(BOOL bPoolNumaInterleave)		{m_bPoolNumaInterleave		= bPoolNumaInterleave;}
 	virtual void SetKeepAliveTime			(DWORD dwKeepAliveTime)			{m_dwKeepAliveTime			= dwKeepAliveTime;}
 	virtual void SetKeepAliveInterval		(DWORD dwKeepAliveInterval)		{m_dwKeepAliveInterval		= dwKeepAliveInterval;}
 	virtual void SetMarkSilence				(BOOL bMarkSilence)				{m_bMarkSilence				= bMarkSilence;}
+	virtual void SetEdgeTrigger				(BOOL bEdgeTrigger)				{m_bEdgeTrigger				= bEdgeTrigger;}
+	virtual void SetBatchSendNotify			(BOOL bBatchSendNotify)			{m_bBatchSendNotify			= bBatchSendNotify;}
+	virtual void SetDetachableReceive		(BOOL bDetachableReceive)		{m_bDetachableReceive		= bDetachableReceive;}
+	virtual void SetTimerInterval			(DWORD dwTimerInterval)			{m_dwTimerInterval			= dwTimerInterval;}
+	virtual void SetMaxConnectPeriod		(DWORD dwMaxConnectPeriod)		{m_dwMaxConnectPeriod		= dwMaxConnectPeriod;}
+	virtual void SetSilenceTimeout			(DWORD dwSilenceTimeout)		{m_dwSilenceTimeout			= dwSilenceTimeout;}
+	virtual void SetHandShakeTimeout		(DWORD dwHandShakeTimeout)		{m_dwHandShakeTimeout		= dwHandShakeTimeout;}
+	virtual void SetSendHighWatermark		(DWORD dwSendHighWatermark)		{m_dwSendHighWatermark		= dwSendHighWatermark;}
+	virtual void SetSendLowWatermark		(DWORD dwSendLowWatermark)		{m_dwSendLowWatermark		= dwSendLowWatermark;}
+	virtual void SetMaxSendPending			(DWORD dwMaxSendPending)		{m_dwMaxSendPending			= dwMaxSendPending;}
 
 	virtual EnSendPolicy GetSendPolicy				()	{return m_enSendPolicy;}
 	virtual EnOnSendSyncPolicy GetOnSendSyncPolicy	()	{return m_enOnSendSyncPolicy;}
+	virtual EnDispatchMode GetDispatchMode			()	{return m_enDispatchMode;}
+	virtual EnListenMode GetListenMode				()	{return m_enListenMode;}
 	virtual DWORD GetMaxConnectionCount		()	{return m_dwMaxConnectionCount;}
 	virtual DWORD GetWorkerThreadCount		()	{return m_dwWorkerThreadCount;}
 	virtual DWORD GetSocketListenQueue		()	{return m_dwSocketListenQueue;}
@@ -109,9 +138,23 @@ public:
 	virtual DWORD GetFreeBufferObjPool		()	{return m_dwFreeBufferObjPool;}
 	virtual DWORD GetFreeSocketObjHold		()	{return m_dwFreeSocketObjHold;}
 	virtual DWORD GetFreeBufferObjHold		()	{return m_dwFreeBufferObjHold;}
+	virtual DWORD GetFreeSocketObjPrealloc	()	{return m_dwFreeSocketObjPrealloc;}
+	virtual DWORD GetFreeBufferObjPrealloc	()	{return m_dwFreeBufferObjPrealloc;}
+	virtual DWORD GetFreeBufferObjCache		()	{return m_dwFreeBufferObjCache;}
+	virtual BOOL  IsPoolNumaInterleave		()	{return m_bPoolNumaInterleave;}
 	virtual DWORD GetKeepAliveTime			()	{return m_dwKeepAliveTime;}
 	virtual DWORD GetKeepAliveInterval		()	{return m_dwKeepAliveInterval;}
 	virtual BOOL  IsMarkSilence				()	{return m_bMarkSilence;}
+	virtual BOOL  IsEdgeTrigger				()	{return m_bEdgeTrigger;}
+	virtual BOOL  IsBatchSendNotify			()	{return m_bBatchSendNotify;}
+	virtual BOOL  IsDetachableReceive		()	{return m_bDetachableReceive;}
+	virtual DWORD GetTimerInterval			()	{return m_dwTimerInterval;}
+	virtual DWORD GetMaxConnectPeriod		()	{return m_dwMaxConnectPeriod;}
+	virtual DWORD GetSilenceTimeout			()	{return m_dwSilenceTimeout;}
+	virtual DWORD GetHandShakeTimeout		()	{return m_dwHandShakeTimeout;}
+	virtual DWORD GetSendHighWatermark		()	{return m_dwSendHighWatermark;}
+	virtual DWORD GetSendLowWatermark		()	{return m_dwSendLowWatermark;}
+	virtual DWORD GetMaxSendPending			()	{return m_dwMaxSendPending;}
 
 protected:
 	virtual EnHandleResult FirePrepareListen(SOCKET soListen)
@@ -130,6 +173,8 @@ protected:
 		{return DoFireReceive(pSocketObj, iLength);}
 	virtual EnHandleResult FireSend(TSocketObj* pSocketObj, const BYTE* pData, int iLength)
 		{return DoFireSend(pSocketObj, pData, iLength);}
+	virtual EnHandleResult FireWritable(TSocketObj* pSocketObj, BOOL bWritable)
+		{return DoFireWritable(pSocketObj, bWritable);}
 	virtual EnHandleResult FireClose(TSocketObj* pSocketObj, EnSocketOperation enOperation, int iErrorCode)
 		{return DoFireClose(pSocketObj, enOperation, iErrorCode);}
 	virtual EnHandleResult FireShutdown()
@@ -147,6 +192,8 @@ protected:
 		{return m_pListener->OnReceive(this, pSocketObj->connID, iLength);}
 	virtual EnHandleResult DoFireSend(TSocketObj* pSocketObj, const BYTE* pData, int iLength)
 		{return m_pListener->OnSend(this, pSocketObj->connID, pData, iLength);}
+	virtual EnHandleResult DoFireWritable(TSocketObj* pSocketObj, BOOL bWritable)
+		{return m_pListener->OnWritable(this, pSocketObj->connID, bWritable);}
 	virtual EnHandleResult DoFireClose(TSocketObj* pSocketObj, EnSocketOperation enOperation, int iErrorCode)
 		{return m_pListener->OnClose(this, pSocketObj->connID, enOperation, iErrorCode);}
 	virtual EnHandleResult DoFireShutdown()
@@ -158,10 +205,12 @@ protected:
 	virtual void Reset();
 
 	virtual BOOL BeforeUnpause(TSocketObj* pSocketObj) {return TRUE;}
+	virtual BOOL IsHandShaked(TSocketObj* pSocketObj) {return TRUE;}
 	virtual void OnWorkerThreadEnd(THR_ID tid) {}
 
 	BOOL DoSendPackets(CONNID dwConnID, const WSABUF pBuffers[], int iCount);
 	BOOL DoSendPackets(TSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount);
+	BOOL CheckSendQuota(TSocketObj* pSocketObj);
 	TSocketObj* FindSocketObj(CONNID dwConnID);
 
 protected:
@@ -180,6 +229,7 @@ private:
 	BOOL CheckStarting();
 	BOOL CheckStoping();
 	BOOL CreateListenSocket(LPCTSTR lpszBindAddress, USHORT usPort);
+	BOOL CreateListenSocket(const HP_SOCKADDR& addr, SOCKET& soListen);
 	BOOL CreateWorkerThreads();
 	BOOL StartAccept();
 
@@ -189,9 +239,11 @@ private:
 	void ReleaseClientSocket();
 	void ReleaseFreeSocket();
 	void WaitForWorkerThreadEnd();
+	void WaitForDetachedBufferRelease();
 
 	TSocketObj* GetFreeSocketObj(CONNID dwConnID, SOCKET soClient);
 	TSocketObj* CreateSocketObj();
+	void PreallocSocketObj();
 	void AddFreeSocketObj	(TSocketObj* pSocketObj, EnSocketCloseFlag enFlag = SCF_NONE, EnSocketOperation enOperation = SO_UNKNOWN, int iErrorCode = 0);
 	void DeleteSocketObj	(TSocketObj* pSocketObj);
 	BOOL InvalidSocketObj	(TSocketObj* pSocketObj);
@@ -201,24 +253,68 @@ private:
 
 private:
 	VOID HandleCmdSend		(CONNID dwConnID);
+	VOID HandleCmdReceive	(CONNID dwConnID);
+	VOID HandleCmdIo		(CONNID dwConnID, UINT events);
 	VOID HandleCmdUnpause	(CONNID dwConnID);
 	VOID HandleCmdDisconnect(CONNID dwConnID, BOOL bForce);
-	BOOL HandleAccept		(UINT events);
+	VOID HandleTimeout		(TSocketObj* pSocketObj);
+	BOOL HandleAccept		(int iListen, UINT events);
+	VOID HandleAcceptComplete(int iListen, int res);
+	BOOL AcceptClient		(int iListen, SOCKET soClient, const HP_SOCKADDR& addr);
 	BOOL HandleReceive		(TSocketObj* pSocketObj, int flag);
 	BOOL HandleSend			(TSocketObj* pSocketObj, int flag);
 	BOOL HandleClose		(TSocketObj* pSocketObj, EnSocketCloseFlag enFlag, UINT events);
 
-	int SendInternal	(TSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount);
-	BOOL SendItem		(TSocketObj* pSocketObj, TItem* pItem);
+	BOOL PostReceive			(TSocketObj* pSocketObj, BOOL bSelectBuffer = TRUE);
+	BOOL PostSend				(TSocketObj* pSocketObj);
+	BOOL ResumeReceive			(TSocketObj* pSocketObj);
+	BOOL FireReceiveItem		(TSocketObj* pSocketObj);
+	VOID HandleReceiveComplete	(TSocketObj* pSocketObj, int res, int iBufferID);
+	VOID HandleSendComplete		(TSocketObj* pSocketObj, int res);
+	VOID ReleaseReceiveItem		(TSocketObj* pSocketObj);
+	VOID SetupRecvBuffers		();
+	VOID ReleaseRecvBuffers		();
+	TItem* TakeRecvBuffer		(int iShard, int iBufferID);
+	BOOL IsRecvBufferSelect		()	{return m_pRecvBuffers != nullptr;}
+
+	int SendInternal	(TSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int& iDirect);
+	int SendDirect		(TSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int& iDirect);
+	int SendReference	(TSocketObj* pSocketObj, const BYTE* pBuffer, int iLength, Fn_SendRelease fnRelease, PVOID pvParam, int& iDirect);
+	int SendFileRegion	(TSocketObj* pSocketObj, CFile& file, LLONG llOffset, LLONG llLength, const LPWSABUF pHead, const LPWSABUF pTail);
+	BOOL SendItems		(TSocketObj* pSocketObj, BOOL& bBlocked);
+	void FlushSendNotify(TSocketObj* pSocketObj);
+	void NotifyDirectSend	(TSocketObj* pSocketObj, const WSABUF pBuffers[], int iCount, int iSent);
+	void NotifySend		(TSocketObj* pSocketObj, const iovec iov[], int iSent);
+	void NotifySend		(TSocketObj* pSocketObj, const BYTE* pData, int iLength);
+	void NotifyWritable	(TSocketObj* pSocketObj, BOOL bWritable);
+
+	void AddSendPending		(TSocketObj* pSocketObj, int iPending);
+	void ReduceSendPending	(TSocketObj* pSocketObj, int iLength);
+	BOOL IsSendPendingLimited	()	{return m_dwMaxSendPending > 0;}
+
+	UINT GetIoEvents	(TSocketObj* pSocketObj);
+	VOID UnlockIo		(TSocketObj* pSocketObj);
+
+	BOOL ArmTimer		(TSocketObj* pSocketObj, TConnTimer* pTimer, DWORD dwTimeout);
+	VOID KillTimers		(TSocketObj* pSocketObj);
+	BOOL IsTimerEnabled	()	{return m_dwTimerInterval > 0;}
+	CConnTimingWheel& GetConnTimer	(TSocketObj* pSocketObj)	{return m_pConnTimers[pSocketObj->shard];}
+	BOOL IsNeedCheckTimeout	()	{return IsTimerEnabled() && (m_dwMaxConnectPeriod > 0 || m_dwSilenceTimeout > 0 || m_dwHandShakeTimeout > 0);}
+
+	int GetListenIndex	(PVOID pv)	{return (m_soListens && pv >= &m_soListens[0] && pv < &m_soListens[m_iListens]) ? (int)((SOCKET*)pv - &m_soListens[0]) : -1;}
+	BOOL IsReusePort	()			{return m_enListenMode != LM_SINGLE;}
 
 public:
 	CTcpServer(ITcpServerListener* pListener)
 	: m_pListener				(pListener)
 	, m_soListen				(INVALID_SOCKET)
+	, m_iListens				(0)
 	, m_enLastError				(SE_OK)
 	, m_enState					(SS_STOPPED)
 	, m_enSendPolicy			(SP_PACK)
 	, m_enOnSendSyncPolicy		(OSSP_NONE)
+	, m_enDispatchMode			(DM_SHARED)
+	, m_enListenMode			(LM_SINGLE)
 	, m_dwMaxConnectionCount	(DEFAULT_MAX_CONNECTION_COUNT)
 	, m_dwWorkerThreadCount		(DEFAULT_WORKER_THREAD_COUNT)
 	, m_dwSocketListenQueue		(DEFAULT_TCP_SERVER_SOCKET_LISTEN_QUEUE)
@@ -229,9 +325,28 @@ public:
 	, m_dwFreeBufferObjPool		(DEFAULT_FREE_BUFFEROBJ_POOL)
 	, m_dwFreeSocketObjHold		(DEFAULT_FREE_SOCKETOBJ_HOLD)
 	, m_dwFreeBufferObjHold		(DEFAULT_FREE_BUFFEROBJ_HOLD)
+	, m_dwFreeSocketObjPrealloc	(0)
+	, m_dwFreeBufferObjPrealloc	(0)
+	, m_dwFreeBufferObjCache	(DEFAULT_FREE_BUFFEROBJ_CACHE)
 	, m_dwKeepAliveTime			(DEFALUT_TCP_KEEPALIVE_TIME)
 	, m_dwKeepAliveInterval		(DEFALUT_TCP_KEEPALIVE_INTERVAL)
+	, m_dwTimerInterval			(DEFAULT_TIMER_INTERVAL)
+	, m_dwMaxConnectPeriod		(0)
+	, m_dwSilenceTimeout		(0)
+	, m_dwHandShakeTimeout		(0)
+	, m_dwSendHighWatermark		(0)
+	, m_dwSendLowWatermark		(0)
+	, m_dwMaxSendPending		(0)
 	, m_bMarkSilence			(TRUE)
+	, m_bPoolNumaInterleave		(FALSE)
+	, m_bEdgeTrigger			(FALSE)
+	, m_bBatchSendNotify		(FALSE)
+	, m_bDetachableReceive		(FALSE)
+	, m_iConnTimers				(0)
+	, m_iRecvBuffers			(0)
+	, m_iRecvBufferShards		(0)
+	, m_llSendPending			(0)
+	, m_lDetachedBuffers		(0)
 	{
 		ASSERT(m_pListener);
 	}
@@ -244,6 +359,8 @@ public:
 private:
 	EnSendPolicy m_enSendPolicy;
 	EnOnSendSyncPolicy m_enOnSendSyncPolicy;
+	EnDispatchMode m_enDispatchMode;
+	EnListenMode m_enListenMode;
 	DWORD m_dwMaxConnectionCount;
 	DWORD m_dwWorkerThreadCount;
 	DWORD m_dwSocketListenQueue;
@@ -254,13 +371,30 @@ private:
 	DWORD m_dwFreeBufferObjPool;
 	DWORD m_dwFreeSocketObjHold;
 	DWORD m_dwFreeBufferObjHold;
+	DWORD m_dwFreeSocketObjPrealloc;
+	DWORD m_dwFreeBufferObjPrealloc;
+	DWORD m_dwFreeBufferObjCache;
 	DWORD m_dwKeepAliveTime;
 	DWORD m_dwKeepAliveInterval;
+	DWORD m_dwTimerInterval;
+	DWORD m_dwMaxConnectPeriod;
+	DWORD m_dwSilenceTimeout;
+	DWORD m_dwHandShakeTimeout;
+	DWORD m_dwSendHighWatermark;
+	DWORD m_dwSendLowWatermark;
+	DWORD m_dwMaxSendPending;
 	BOOL  m_bMarkSilence;
+	BOOL  m_bPoolNumaInterleave;
+	BOOL  m_bEdgeTrigger;
+	BOOL  m_bBatchSendNotify;
+	BOOL  m_bDetachableReceive;
 
 private:
 	ITcpServerListener*	m_pListener;
+	/* m_soListen 为第一个监听 Socket，端口复用模式下 m_soListens 包含每个工作线程的监听 Socket */
 	SOCKET				m_soListen;
+	unique_ptr<SOCKET[]>	m_soListens;
+	int					m_iListens;
 	EnServiceState		m_enState;
 	EnSocketError		m_enLastError;
 
@@ -274,6 +408,21 @@ private:
 	TSocketObjPtrList	m_lsFreeSocket;
 	TSocketObjPtrQueue	m_lsGCSocket;
 	TReceiveBufferMap	m_rcBufferMap;
+	TReceiveItemMap		m_rcItemMap;
 
+	/* 每个分片一个连接定时轮 */
+	unique_ptr<CConnTimingWheel[]>	m_pConnTimers;
+	int					m_iConnTimers;
 	CIODispatcher		m_ioDispatcher;
+
+	/* io_uring 模式下每个分片接收缓冲区环中的数据块（按 分片 * m_iRecvBuffers + 缓冲区 ID 存放） */
+	unique_ptr<TItem*[]>	m_pRecvBuffers;
+	int					m_iRecvBuffers;
+	int					m_iRecvBufferShards;
+
+	/* 所有连接待发数据总量（只在设置了 MaxSendPending 时统计） */
+	volatile LLONG		m_llSendPending;
+
+	/* 应用程序已分离但尚未归还的接收缓冲区数量 */
+	volatile LONG		m_lDetachedBuffers;
 };
@@ -78,7 +78,9 @@ BOOL CUdpCast::CheckParams()
 		((int)m_dwFreeBufferPoolSize >= 0)								&&
 		((int)m_dwFreeBufferPoolHold >= 0)								&&
 		(m_enCastMode >= CM_MULTICAST && m_enCastMode <= CM_BROADCAST)	&&
-		(m_iMCTtl >= 0 && m_iMCTtl <= 255)								)
+		(m_iMCTtl >= 0 && m_iMCTtl <= 255)								&&
+		((int)m_dwSendHighWatermark >= 0)								&&
+		(m_dwSendHighWatermark == 0 || m_dwSendLowWatermark < m_dwSendHighWatermark)	)
 		return TRUE;
 
 	SetLastError(SE_INVALID_PARAM, __FUNCTION__, ERROR_INVALID_PARAMETER);
@@ -306,13 +308,14 @@ BOOL CUdpCast::Stop()
 
 void CUdpCast::Reset()
 {
-	CCriSecLock locallock(m_csSend);
+	CReentrantCriSecLock locallock(m_csSend);
 
 	m_evSend.Reset();
 	m_evRecv.Reset();
 	m_evStop.Reset();
 
 	m_lsSend.Clear();
+	m_bSendBlocked = FALSE;
 	m_itPool.Clear();
 	m_rcBuffer.Free();
 
@@ -538,7 +541,7 @@ BOOL CUdpCast::SendData()
 	if(m_lsSend.IsEmpty())
 		return TRUE;
 
-	CCriSecLock locallock(m_csSend);
+	CReentrantCriSecLock locallock(m_csSend);
 
 	if(m_lsSend.IsEmpty())
 		return TRUE;
@@ -566,6 +569,9 @@ BOOL CUdpCast::SendData()
 		}
 	}
 
+	if(isOK)
+		CheckSendWatermark();
+
 	return isOK;
 }
 
@@ -677,10 +683,12 @@ BOOL CUdpCast::SendPackets(const WSABUF pBuffers[], int iCount)
 
 int CUdpCast::SendInternal(TItemPtr& itPtr)
 {
-	CCriSecLock locallock(m_csSend);
+	CReentrantCriSecLock locallock(m_csSend);
 
 	if(!IsConnected())
 		return ERROR_INVALID_STATE;
+	if(m_bSendBlocked)
+		return ERROR_WOULDBLOCK;
 
 	BOOL isPending = !m_lsSend.IsEmpty();
 
@@ -688,9 +696,40 @@ int CUdpCast::SendInternal(TItemPtr& itPtr)
 
 	if(!isPending) m_evSend.Set();
 
+	CheckSendWatermark();
+
 	return NO_ERROR;
 }
 
+void CUdpCast::NotifyWritable(BOOL bWritable)
+{
+	if(TRIGGER(FireWritable(bWritable)) == HR_ERROR)
+	{
+		TRACE("<C-CNNID: %zu> OnWritable() event should not return 'HR_ERROR' !!", m_dwConnID);
+		ASSERT(FALSE);
+	}
+}
+
+/* 待发数据达到高水位时触发 OnWritable(FALSE)，降到低水位以下时触发 OnWritable(TRUE)（在 m_csSend 锁内调用） */
+void CUdpCast::CheckSendWatermark()
+{
+	if(m_dwSendHighWatermark == 0)
+		return;
+
+	int iPending = m_lsSend.Length();
+
+	if(!m_bSendBlocked && iPending >= (int)m_dwSendHighWatermark)
+	{
+		m_bSendBlocked = TRUE;
+		NotifyWritable(FALSE);
+	}
+	else if(m_bSendBlocked && iPending <= (int)m_dwSendLowWatermark)
+	{
+		m_bSendBlocked = FALSE;
+		NotifyWritable(TRUE);
+	}
+}
+
 void CUdpCast::SetLastError(EnSocketError code, LPCSTR func, int ec)
 {
 	TRACE("%s --> Error: %d, EC: %d", func, code, ec);
@@ -51,7 +51,9 @@ public:
 
 	virtual void SetMaxDatagramSize		(DWORD dwMaxDatagramSize)		{m_dwMaxDatagramSize	= dwMaxDatagramSize;}
 	virtual void SetFreeBufferPoolSize	(DWORD dwFreeBufferPoolSize)	{m_dwFreeBufferPoolSize	= dwFreeBufferPoolSize;}
-	virtual void SetFreeBufferPoolHold	(DWORD dwFreeBufferPoolHold)	{m_dwFreeBufferPoolHold	= dwFreeBufferPoolHold;}
+	virtual void SetFreeBufferPoolHold	(DWORD dwFreeBufferPoolHold)	{m_dwFreeBufferPoolHold = dwFreeBufferPoolHold;}
+	virtual void SetSendHighWatermark	(DWORD dwSendHighWatermark)		{m_dwSendHighWatermark	= dwSendHighWatermark;}
+	virtual void SetSendLowWatermark	(DWORD dwSendLowWatermark)		{m_dwSendLowWatermark	= dwSendLowWatermark;}
 	virtual void SetReuseAddress		(BOOL bReuseAddress)			{m_bReuseAddress		= bReuseAddress;}
 	virtual void SetCastMode			(EnCastMode enCastMode)			{m_enCastMode			= enCastMode;}
 	virtual void SetMultiCastTtl		(int iMCTtl)					{m_iMCTtl				= iMCTtl;}
@@ -61,6 +63,8 @@ public:
 	virtual DWORD GetMaxDatagramSize	()	{return m_dwMaxDatagramSize;}
 	virtual DWORD GetFreeBufferPoolSize	()	{return m_dwFreeBufferPoolSize;}
 	virtual DWORD GetFreeBufferPoolHold	()	{return m_dwFreeBufferPoolHold;}
+	virtual DWORD GetSendHighWatermark	()	{return m_dwSendHighWatermark;}
+	virtual DWORD GetSendLowWatermark	()	{return m_dwSendLowWatermark;}
 	virtual BOOL  IsReuseAddress		()	{return m_bReuseAddress;}
 	virtual EnCastMode GetCastMode		()	{return m_enCastMode;}
 	virtual int GetMultiCastTtl			()	{return m_iMCTtl;}
@@ -86,6 +90,8 @@ protected:
 		{return m_pListener->OnHandShake(this, m_dwConnID);}
 	virtual EnHandleResult FireSend(const BYTE* pData, int iLength)
 		{return m_pListener->OnSend(this, m_dwConnID, pData, iLength);}
+	virtual EnHandleResult FireWritable(BOOL bWritable)
+		{return m_pListener->OnWritable(this, m_dwConnID, bWritable);}
 	virtual EnHandleResult FireReceive(const BYTE* pData, int iLength)
 		{return m_pListener->OnReceive(this, m_dwConnID, pData, iLength);}
 	virtual EnHandleResult FireReceive(int iLength)
@@ -121,6 +127,8 @@ private:
 	BOOL SendData();
 	BOOL DoSendData(TItem* pItem);
 	int SendInternal(TItemPtr& itPtr);
+	void NotifyWritable(BOOL bWritable);
+	void CheckSendWatermark();
 	void WaitForWorkerThreadEnd();
 
 	BOOL HandleClose(SHORT events);
@@ -139,6 +147,7 @@ public:
 	, m_nSendEvents			(0)
 	, m_dwConnID			(0)
 	, m_usPort				(0)
+	, m_bSendBlocked		(FALSE)
 	, m_bPaused				(FALSE)
 	, m_bConnected			(FALSE)
 	, m_enLastError			(SE_OK)
@@ -148,6 +157,8 @@ public:
 	, m_dwMaxDatagramSize	(DEFAULT_UDP_MAX_DATAGRAM_SIZE)
 	, m_dwFreeBufferPoolSize(DEFAULT_CLIENT_FREE_BUFFER_POOL_SIZE)
 	, m_dwFreeBufferPoolHold(DEFAULT_CLIENT_FREE_BUFFER_POOL_HOLD)
+	, m_dwSendHighWatermark	(0)
+	, m_dwSendLowWatermark	(0)
 	, m_bReuseAddress		(FALSE)
 	, m_iMCTtl				(1)
 	, m_bMCLoop				(FALSE)
@@ -177,6 +188,8 @@ private:
 	DWORD				m_dwMaxDatagramSize;
 	DWORD				m_dwFreeBufferPoolSize;
 	DWORD				m_dwFreeBufferPoolHold;
+	DWORD				m_dwSendHighWatermark;
+	DWORD				m_dwSendLowWatermark;
 
 	int					m_iMCTtl;
 	BOOL				m_bMCLoop;
@@ -203,8 +216,9 @@ protected:
 private:
 	CSpinGuard			m_csState;
 
-	CCriSec				m_csSend;
+	CReentrantCriSec	m_csSend;
 	TItemListExV		m_lsSend;
+	BOOL				m_bSendBlocked;
 
 	CEvt				m_evSend;
 	CEvt				m_evRecv;
@@ -74,7 +74,9 @@ BOOL CUdpClient::CheckParams()
 		((int)m_dwFreeBufferPoolSize >= 0)	&&
 		((int)m_dwFreeBufferPoolHold >= 0)	&&
 		((int)m_dwDetectAttempts >= 0)		&&
-		((int)m_dwDetectInterval >= 0)		)
+		((int)m_dwDetectInterval >= 0)		&&
+		((int)m_dwSendHighWatermark >= 0)	&&
+		(m_dwSendHighWatermark == 0 || m_dwSendLowWatermark < m_dwSendHighWatermark)	)
 		return TRUE;
 
 	SetLastError(SE_INVALID_PARAM, __FUNCTION__, ERROR_INVALID_PARAMETER);
@@ -244,7 +246,7 @@ BOOL CUdpClient::Stop()
 
 void CUdpClient::Reset()
 {
-	CCriSecLock locallock(m_csSend);
+	CReentrantCriSecLock locallock(m_csSend);
 
 	m_evSend.Reset();
 	m_evRecv.Reset();
@@ -252,6 +254,7 @@ void CUdpClient::Reset()
 	m_evDetect.Set(0, 0);
 
 	m_lsSend.Clear();
+	m_bSendBlocked = FALSE;
 	m_itPool.Clear();
 	m_rcBuffer.Free();
 
@@ -541,7 +544,7 @@ BOOL CUdpClient::SendData()
 	if(m_lsSend.IsEmpty())
 		return TRUE;
 
-	CCriSecLock locallock(m_csSend);
+	CReentrantCriSecLock locallock(m_csSend);
 
 	if(m_lsSend.IsEmpty())
 		return TRUE;
@@ -569,6 +572,9 @@ BOOL CUdpClient::SendData()
 		}
 	}
 
+	if(isOK)
+		CheckSendWatermark();
+
 	return isOK;
 }
 
@@ -680,10 +686,12 @@ BOOL CUdpClient::SendPackets(const WSABUF pBuffers[], int iCount)
 
 int CUdpClient::SendInternal(TItemPtr& itPtr)
 {
-	CCriSecLock locallock(m_csSend);
+	CReentrantCriSecLock locallock(m_csSend);
 
 	if(!IsConnected())
 		return ERROR_INVALID_STATE;
+	if(m_bSendBlocked)
+		return ERROR_WOULDBLOCK;
 
 	BOOL isPending = !m_lsSend.IsEmpty();
 
@@ -691,9 +699,40 @@ int CUdpClient::SendInternal(TItemPtr& itPtr)
 
 	if(!isPending) m_evSend.Set();
 
+	CheckSendWatermark();
+
 	return NO_ERROR;
 }
 
+void CUdpClient::NotifyWritable(BOOL bWritable)
+{
+	if(TRIGGER(FireWritable(bWritable)) == HR_ERROR)
+	{
+		TRACE("<C-CNNID: %zu> OnWritable() event should not return 'HR_ERROR' !!", m_dwConnID);
+		ASSERT(FALSE);
+	}
+}
+
+/* 待发数据达到高水位时触发 OnWritable(FALSE)，降到低水位以下时触发 OnWritable(TRUE)（在 m_csSend 锁内调用） */
+void CUdpClient::CheckSendWatermark()
+{
+	if(m_dwSendHighWatermark == 0)
+		return;
+
+	int iPending = m_lsSend.Length();
+
+	if(!m_bSendBlocked && iPending >= (int)m_dwSendHighWatermark)
+	{
+		m_bSendBlocked = TRUE;
+		NotifyWritable(FALSE);
+	}
+	else if(m_bSendBlocked && iPending <= (int)m_dwSendLowWatermark)
+	{
+		m_bSendBlocked = FALSE;
+		NotifyWritable(TRUE);
+	}
+}
+
 void CUdpClient::SetLastError(EnSocketError code, LPCSTR func, int ec)
 {
 	TRACE("%s --> Error: %d, EC: %d", func, code, ec);
@@ -54,6 +54,8 @@ public:
 	virtual void SetDetectInterval		(DWORD dwDetectInterval)		{m_dwDetectInterval		= dwDetectInterval;}
 	virtual void SetFreeBufferPoolSize	(DWORD dwFreeBufferPoolSize)	{m_dwFreeBufferPoolSize = dwFreeBufferPoolSize;}
 	virtual void SetFreeBufferPoolHold	(DWORD dwFreeBufferPoolHold)	{m_dwFreeBufferPoolHold = dwFreeBufferPoolHold;}
+	virtual void SetSendHighWatermark	(DWORD dwSendHighWatermark)		{m_dwSendHighWatermark	= dwSendHighWatermark;}
+	virtual void SetSendLowWatermark	(DWORD dwSendLowWatermark)		{m_dwSendLowWatermark	= dwSendLowWatermark;}
 	virtual void SetExtra				(PVOID pExtra)					{m_pExtra				= pExtra;}						
 
 	virtual DWORD GetMaxDatagramSize	()	{return m_dwMaxDatagramSize;}
@@ -61,6 +63,8 @@ public:
 	virtual DWORD GetDetectInterval		()	{return m_dwDetectInterval;}
 	virtual DWORD GetFreeBufferPoolSize	()	{return m_dwFreeBufferPoolSize;}
 	virtual DWORD GetFreeBufferPoolHold	()	{return m_dwFreeBufferPoolHold;}
+	virtual DWORD GetSendHighWatermark	()	{return m_dwSendHighWatermark;}
+	virtual DWORD GetSendLowWatermark	()	{return m_dwSendLowWatermark;}
 	virtual PVOID GetExtra				()	{return m_pExtra;}
 
 protected:
@@ -76,6 +80,8 @@ protected:
 		{return m_pListener->OnHandShake(this, m_dwConnID);}
 	virtual EnHandleResult FireSend(const BYTE* pData, int iLength)
 		{return m_pListener->OnSend(this, m_dwConnID, pData, iLength);}
+	virtual EnHandleResult FireWritable(BOOL bWritable)
+		{return m_pListener->OnWritable(this, m_dwConnID, bWritable);}
 	virtual EnHandleResult FireReceive(const BYTE* pData, int iLength)
 		{return m_pListener->OnReceive(this, m_dwConnID, pData, iLength);}
 	virtual EnHandleResult FireReceive(int iLength)
@@ -110,6 +116,8 @@ private:
 	BOOL SendData();
 	BOOL DoSendData(TItem* pItem);
 	int SendInternal(TItemPtr& itPtr);
+	void NotifyWritable(BOOL bWritable);
+	void CheckSendWatermark();
 	void WaitForWorkerThreadEnd();
 
 	BOOL HandleConnect	(SHORT events);
@@ -131,6 +139,7 @@ public:
 	, m_nEvents				(0)
 	, m_dwConnID			(0)
 	, m_usPort				(0)
+	, m_bSendBlocked		(FALSE)
 	, m_bPaused				(FALSE)
 	, m_bConnected			(FALSE)
 	, m_enLastError			(SE_OK)
@@ -141,6 +150,8 @@ public:
 	, m_dwMaxDatagramSize	(DEFAULT_UDP_MAX_DATAGRAM_SIZE)
 	, m_dwFreeBufferPoolSize(DEFAULT_CLIENT_FREE_BUFFER_POOL_SIZE)
 	, m_dwFreeBufferPoolHold(DEFAULT_CLIENT_FREE_BUFFER_POOL_HOLD)
+	, m_dwSendHighWatermark	(0)
+	, m_dwSendLowWatermark	(0)
 	, m_dwDetectAttempts	(DEFAULT_UDP_DETECT_ATTEMPTS)
 	, m_dwDetectInterval	(DEFAULT_UDP_DETECT_INTERVAL)
 	{
@@ -163,6 +174,8 @@ private:
 	DWORD				m_dwMaxDatagramSize;
 	DWORD				m_dwFreeBufferPoolSize;
 	DWORD				m_dwFreeBufferPoolHold;
+	DWORD				m_dwSendHighWatermark;
+	DWORD				m_dwSendLowWatermark;
 	DWORD				m_dwDetectAttempts;
 	DWORD				m_dwDetectInterval;
 
@@ -184,8 +197,9 @@ protected:
 private:
 	CSpinGuard			m_csState;
 
-	CCriSec				m_csSend;
+	CReentrantCriSec	m_csSend;
 	TItemListExV		m_lsSend;
+	BOOL				m_bSendBlocked;
 
 	CEvt				m_evSend;
 	CEvt				m_evRecv;
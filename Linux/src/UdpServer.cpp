@@ -62,6 +62,7 @@ BOOL CUdpServer::CheckParams()
 {
 	if	((m_enSendPolicy >= SP_PACK && m_enSendPolicy <= SP_DIRECT)								&&
 		(m_enOnSendSyncPolicy >= OSSP_NONE && m_enOnSendSyncPolicy <= OSSP_CLOSE)				&&
+		(m_enListenMode >= LM_SINGLE && m_enListenMode <= LM_REUSE_PORT_CPU)					&&
 		((int)m_dwMaxConnectionCount > 0)														&&
 		((int)m_dwWorkerThreadCount > 0 && m_dwWorkerThreadCount <= MAX_WORKER_THREAD_COUNT)	&&
 		((int)m_dwFreeSocketObjLockTime >= 0)													&&
@@ -69,10 +70,22 @@ BOOL CUdpServer::CheckParams()
 		((int)m_dwFreeBufferObjPool >= 0)														&&
 		((int)m_dwFreeSocketObjHold >= 0)														&&
 		((int)m_dwFreeBufferObjHold >= 0)														&&
+		((int)m_dwFreeBufferObjCache >= 0)														&&
 		((int)m_dwMaxDatagramSize > 0)															&&
 		((int)m_dwPostReceiveCount > 0)															&&
+		((int)m_dwReceiveBatchCount > 0 && m_dwReceiveBatchCount <= MAX_UDP_BATCH_COUNT)		&&
+		((int)m_dwSendBatchCount > 0 && m_dwSendBatchCount <= MAX_UDP_BATCH_COUNT)				&&
 		((int)m_dwDetectAttempts >= 0)															&&
-		((int)m_dwDetectInterval >= 0)															)
+		((int)m_dwDetectInterval >= 0 && m_dwDetectInterval <= MAX_CONNECTION_PERIOD / 1000)	&&
+		((int)m_dwTimerInterval >= 0)															&&
+		(m_dwMaxConnectPeriod <= MAX_CONNECTION_PERIOD)											&&
+		(m_dwSilenceTimeout <= MAX_CONNECTION_PERIOD)											&&
+		(m_dwHandShakeTimeout <= MAX_CONNECTION_PERIOD)											&&
+		(IsTimerEnabled() || (m_dwMaxConnectPeriod == 0 && m_dwSilenceTimeout == 0 && m_dwHandShakeTimeout == 0))	&&
+		((int)m_dwSendHighWatermark >= 0 && (int)m_dwMaxSendPending >= 0)						&&
+		(m_dwSendHighWatermark == 0 || m_dwSendLowWatermark < m_dwSendHighWatermark)			&&
+		(m_dwFreeSocketObjPrealloc <= m_dwFreeSocketObjPool)									&&
+		(m_dwFreeBufferObjPrealloc <= m_dwFreeBufferObjPool)									)
 		return TRUE;
 
 	SetLastError(SE_INVALID_PARAM, __FUNCTION__, ERROR_INVALID_PARAMETER);
@@ -84,11 +97,21 @@ void CUdpServer::PrepareStart()
 	m_bfActiveSockets.Reset(m_dwMaxConnectionCount);
 	m_lsFreeSocket.Reset(m_dwFreeSocketObjPool);
 
+	m_phSocket.SetNumaInterleave(m_bPoolNumaInterleave);
+
 	m_bfObjPool.SetItemCapacity(m_dwMaxDatagramSize);
 	m_bfObjPool.SetPoolSize(m_dwFreeBufferObjPool);
 	m_bfObjPool.SetPoolHold(m_dwFreeBufferObjHold);
+	m_bfObjPool.SetCacheSize(m_dwFreeBufferObjCache);
+	m_bfObjPool.SetPoolPrealloc(m_dwFreeBufferObjPrealloc);
+	m_bfObjPool.SetNumaInterleave(m_bPoolNumaInterleave);
 
 	m_bfObjPool.Prepare();
+
+	PreallocSocketObj();
+
+	if(IsTimerEnabled())
+		VERIFY(m_twConnTimer.Init(m_dwTimerInterval));
 }
 
 BOOL CUdpServer::CheckStarting()
@@ -138,24 +161,64 @@ BOOL CUdpServer::CreateListenSocket(LPCTSTR lpszBindAddress, USHORT usPort)
 
 	if(::sockaddr_A_2_IN(lpszBindAddress, usPort, addr))
 	{
-		m_soListen = socket(addr.family, SOCK_DGRAM, IPPROTO_UDP);
+		m_iListens	= IsReusePort() ? (int)m_dwWorkerThreadCount : 1;
+		m_soListens	= make_unique<SOCKET[]>(m_iListens);
 
-		if(m_soListen != INVALID_SOCKET)
+		for(int i = 0; i < m_iListens; i++)
+			m_soListens[i] = INVALID_SOCKET;
+
+		isOK		= CreateListenSocket(addr, m_soListens[0]);
+		m_soListen	= m_soListens[0];
+
+		/* 绑定随机端口时，其余监听 Socket 必须绑定到第一个监听 Socket 实际分配的端口 */
+		if(isOK && m_iListens > 1 && addr.Port() == 0)
 		{
-			::fcntl_SETFL(m_soListen, O_NOATIME | O_NONBLOCK | O_CLOEXEC);
+			socklen_t addrLen = (socklen_t)addr.AddrSize();
+			isOK = (::getsockname(m_soListen, addr.Addr(), &addrLen) != SOCKET_ERROR);
 
-			if(::bind(m_soListen, addr.Addr(), addr.AddrSize()) != SOCKET_ERROR)
+			if(!isOK) SetLastError(SE_SOCKET_BIND, __FUNCTION__, ::WSAGetLastError());
+		}
+
+		for(int i = 1; isOK && i < m_iListens; i++)
+			isOK = CreateListenSocket(addr, m_soListens[i]);
+
+		if(isOK && m_enListenMode == LM_REUSE_PORT_CPU)
+		{
+			/* 内核不支持 SO_ATTACH_REUSEPORT_CBPF 时退化为按四元组哈希分配 */
+			if(IS_HAS_ERROR(::SSO_ReusePortCpuSteering(m_soListen, m_iListens)))
 			{
-				if(TRIGGER(FirePrepareListen(m_soListen)) != HR_ERROR)
-					isOK = TRUE;
-				else
-					SetLastError(SE_SOCKET_PREPARE, __FUNCTION__, ENSURE_ERROR_CANCELLED);
+				TRACE("SO_ATTACH_REUSEPORT_CBPF fail (%d), fallback to hash steering", ::WSAGetLastError());
 			}
+		}
+	}
+	else
+		SetLastError(SE_SOCKET_CREATE, __FUNCTION__, ::WSAGetLastError());
+
+	return isOK;
+}
+
+BOOL CUdpServer::CreateListenSocket(const HP_SOCKADDR& addr, SOCKET& soListen)
+{
+	BOOL isOK = FALSE;
+
+	soListen = socket(addr.family, SOCK_DGRAM, IPPROTO_UDP);
+
+	if(soListen != INVALID_SOCKET)
+	{
+		::fcntl_SETFL(soListen, O_NOATIME | O_NONBLOCK | O_CLOEXEC);
+
+		if(IsReusePort())
+			VERIFY(IS_NO_ERROR(::SSO_ReusePort(soListen)));
+
+		if(::bind(soListen, addr.Addr(), addr.AddrSize()) != SOCKET_ERROR)
+		{
+			if(TRIGGER(FirePrepareListen(soListen)) != HR_ERROR)
+				isOK = TRUE;
 			else
-				SetLastError(SE_SOCKET_BIND, __FUNCTION__, ::WSAGetLastError());
+				SetLastError(SE_SOCKET_PREPARE, __FUNCTION__, ENSURE_ERROR_CANCELLED);
 		}
 		else
-			SetLastError(SE_SOCKET_CREATE, __FUNCTION__, ::WSAGetLastError());
+			SetLastError(SE_SOCKET_BIND, __FUNCTION__, ::WSAGetLastError());
 	}
 	else
 		SetLastError(SE_SOCKET_CREATE, __FUNCTION__, ::WSAGetLastError());
@@ -165,12 +228,20 @@ BOOL CUdpServer::CreateListenSocket(LPCTSTR lpszBindAddress, USHORT usPort)
 
 BOOL CUdpServer::CreateWorkerThreads()
 {
-	return m_ioDispatcher.Start(this, m_dwPostReceiveCount, m_dwWorkerThreadCount);
+	/* 端口复用模式下使用分片分派，每个工作线程独占一个监听 Socket */
+	if(!m_ioDispatcher.Start(this, m_dwPostReceiveCount, m_dwWorkerThreadCount, m_dwTimerInterval, IsReusePort()))
+		return FALSE;
+
+	if(m_enListenMode == LM_REUSE_PORT_CPU)
+		VERIFY(m_ioDispatcher.SetWorkerAffinity());
+
+	return TRUE;
 }
 
 BOOL CUdpServer::CreateDetectorThread()
 {
-	if(!IsNeedRunDetector())
+	/* 启用定时器时由连接定时器检测连接，不再创建监测线程 */
+	if(!IsNeedRunDetector() || IsTimerEnabled())
 		return TRUE;
 		
 	return m_thDetector.Start(this, &CUdpServer::DetecotrThreadProc);
@@ -178,7 +249,13 @@ BOOL CUdpServer::CreateDetectorThread()
 
 BOOL CUdpServer::StartAccept()
 {
-	return m_ioDispatcher.AddFD(m_soListen, _EPOLL_READ_EVENTS | EPOLLET, TO_PVOID(&m_soListen));
+	for(int i = 0; i < m_iListens; i++)
+	{
+		if(!m_ioDispatcher.AddFD(i, m_soListens[i], _EPOLL_READ_EVENTS | EPOLLET, TO_PVOID(&m_soListens[i])))
+			return FALSE;
+	}
+
+	return TRUE;
 }
 
 BOOL CUdpServer::Stop()
@@ -209,7 +286,15 @@ void CUdpServer::CloseListenSocket()
 {
 	if(m_soListen != INVALID_SOCKET)
 	{
-		::ManualCloseSocket(m_soListen);
+		for(int i = 0; i < m_iListens; i++)
+		{
+			if(m_soListens[i] == INVALID_SOCKET)
+				continue;
+
+			::ManualCloseSocket(m_soListens[i]);
+			m_soListens[i] = INVALID_SOCKET;
+		}
+
 		m_soListen = INVALID_SOCKET;
 
 		::WaitFor(100);
@@ -251,6 +336,8 @@ void CUdpServer::ReleaseClientSocket()
 	VERIFY(m_bfActiveSockets.IsEmpty());
 	m_bfActiveSockets.Reset();
 
+	m_twConnTimer.Clear();
+
 	CWriteLock locallock(m_csClientSocket);
 	m_mpClientAddr.clear();
 }
@@ -275,7 +362,13 @@ void CUdpServer::Reset()
 	m_bfObjPool.Clear();
 	m_quSend.UnsafeClear();
 
-	m_enState = SS_STOPPED;
+	/* 工作线程结束后才能释放监听 Socket 数组（其元素地址作为监听 Socket 的事件参数） */
+	m_soListens.reset();
+	m_iListens = 0;
+
+	m_bBatchSending	= FALSE;
+	m_llSendPending	= 0;
+	m_enState		= SS_STOPPED;
 }
 
 TUdpSocketObj* CUdpServer::GetFreeSocketObj(CONNID dwConnID)
@@ -305,6 +398,21 @@ TUdpSocketObj* CUdpServer::CreateSocketObj()
 	return TUdpSocketObj::Construct(m_phSocket, m_bfObjPool);
 }
 
+void CUdpServer::PreallocSocketObj()
+{
+	/* 预先创建的 Socket 缓存对象释放时间提前一个锁定周期，可以立即被获取使用 */
+	DWORD dwPrealloc = min(m_dwFreeSocketObjPrealloc, m_dwFreeSocketObjPool);
+	DWORD dwFreeTime = ::TimeGetTime() - m_dwFreeSocketObjLockTime;
+
+	for(DWORD i = 0; i < dwPrealloc; i++)
+	{
+		TUdpSocketObj* pSocketObj	= CreateSocketObj();
+		pSocketObj->freeTime		= dwFreeTime;
+
+		VERIFY(m_lsFreeSocket.TryPut(pSocketObj));
+	}
+}
+
 void CUdpServer::DeleteSocketObj(TUdpSocketObj* pSocketObj)
 {
 	TUdpSocketObj::Destruct(pSocketObj);
@@ -316,6 +424,7 @@ void CUdpServer::AddFreeSocketObj(TUdpSocketObj* pSocketObj, EnSocketCloseFlag e
 		return;
 
 	CloseClientSocketObj(pSocketObj, enFlag, enOperation, iErrorCode);
+	KillTimers(pSocketObj);
 
 	{
 		m_bfActiveSockets.Remove(pSocketObj->connID);
@@ -324,7 +433,16 @@ void CUdpServer::AddFreeSocketObj(TUdpSocketObj* pSocketObj, EnSocketCloseFlag e
 		m_mpClientAddr.erase(&pSocketObj->remoteAddr);
 	}
 
-	TUdpSocketObj::Release(pSocketObj);
+	if(!IsSendPendingLimited())
+		TUdpSocketObj::Release(pSocketObj);
+	else
+	{
+		/* 在 csSend 锁内扣减剩余待发数据，避免与并发的发送操作竞争导致统计偏差 */
+		CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+		::InterlockedExchangeSub(&m_llSendPending, (LLONG)pSocketObj->Pending());
+		TUdpSocketObj::Release(pSocketObj);
+	}
 
 	ReleaseGCSocketObj();
 
@@ -348,14 +466,20 @@ void CUdpServer::AddClientSocketObj(CONNID dwConnID, TUdpSocketObj* pSocketObj,
 
 	pSocketObj->connTime	= ::TimeGetTime();
 	pSocketObj->activeTime	= pSocketObj->connTime;
+	pSocketObj->detectTime	= pSocketObj->connTime + m_dwDetectInterval * 1000;
 
 	remoteAddr.Copy(pSocketObj->remoteAddr);
 	pSocketObj->SetConnected();
 
 	VERIFY(m_bfActiveSockets.ReleaseLock(dwConnID, pSocketObj));
 
-	CWriteLock locallock(m_csClientSocket);
-	m_mpClientAddr[&pSocketObj->remoteAddr]	= dwConnID;
+	{
+		CWriteLock locallock(m_csClientSocket);
+		m_mpClientAddr[&pSocketObj->remoteAddr]	= dwConnID;
+	}
+
+	if(IsNeedCheckTimeout())
+		HandleTimeout(pSocketObj);
 }
 
 TUdpSocketObj* CUdpServer::FindSocketObj(CONNID dwConnID)
@@ -661,6 +785,80 @@ BOOL CUdpServer::DisconnectSilenceConnections(DWORD dwPeriod, BOOL bForce)
 	return TRUE;
 }
 
+BOOL CUdpServer::SetConnectionTimer(CONNID dwConnID, DWORD dwTimeout, Fn_ConnectionTimer fnTimer, PVOID pvParam)
+{
+	if(!IsTimerEnabled() || !HasStarted())
+	{
+		::SetLastError(ERROR_INVALID_STATE);
+		return FALSE;
+	}
+
+	if(dwTimeout == 0 || dwTimeout > MAX_CONNECTION_PERIOD || fnTimer == nullptr)
+	{
+		::SetLastError(ERROR_INVALID_PARAMETER);
+		return FALSE;
+	}
+
+	TUdpSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(!TUdpSocketObj::IsValid(pSocketObj))
+	{
+		::SetLastError(ERROR_OBJECT_NOT_FOUND);
+		return FALSE;
+	}
+
+	TConnTimer* pTimer = &pSocketObj->userTimer;
+
+	m_twConnTimer.Cancel(pTimer);
+
+	pTimer->fnTimer = fnTimer;
+	pTimer->pvParam = pvParam;
+
+	return ArmTimer(pSocketObj, pTimer, dwTimeout);
+}
+
+BOOL CUdpServer::KillConnectionTimer(CONNID dwConnID)
+{
+	TUdpSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+	if(!TUdpSocketObj::IsValid(pSocketObj))
+	{
+		::SetLastError(ERROR_OBJECT_NOT_FOUND);
+		return FALSE;
+	}
+
+	if(!m_twConnTimer.Cancel(&pSocketObj->userTimer))
+	{
+		::SetLastError(ERROR_INVALID_STATE);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+BOOL CUdpServer::ArmTimer(TUdpSocketObj* pSocketObj, TConnTimer* pTimer, DWORD dwTimeout)
+{
+	m_twConnTimer.Arm(pTimer, dwTimeout);
+
+	/* 关闭连接时先使连接失效再取消定时器，如果设置定时器期间连接已失效则由这里取消定时器 */
+	if(TUdpSocketObj::IsValid(pSocketObj))
+		return TRUE;
+
+	m_twConnTimer.Cancel(pTimer);
+	::SetLastError(ERROR_OBJECT_NOT_FOUND);
+
+	return FALSE;
+}
+
+VOID CUdpServer::KillTimers(TUdpSocketObj* pSocketObj)
+{
+	if(!IsTimerEnabled())
+		return;
+
+	m_twConnTimer.Cancel(&pSocketObj->sysTimer);
+	m_twConnTimer.Cancel(&pSocketObj->userTimer);
+}
+
 BOOL CUdpServer::PauseReceive(CONNID dwConnID, BOOL bPause)
 {
 	::SetLastError(ERROR_CALL_NOT_IMPLEMENTED);
@@ -669,7 +867,7 @@ BOOL CUdpServer::PauseReceive(CONNID dwConnID, BOOL bPause)
 
 BOOL CUdpServer::OnBeforeProcessIo(PVOID pv, UINT events)
 {
-	ASSERT(pv == &m_soListen);
+	ASSERT(GetListenIndex(pv) >= 0);
 
 	return TRUE;
 }
@@ -695,9 +893,74 @@ VOID CUdpServer::OnCommand(TDispCommand* pCmd)
 	}
 }
 
+VOID CUdpServer::OnTimer(int iShard, LLONG llExpirations)
+{
+	/* UDP 连接不绑定分片，所有分片的定时事件共同推进同一个定时轮（已推进过的刻度不会重复处理） */
+	/* 定时把空闲线程缓存槽中的内存块归还共享缓存池 */
+	if(iShard == 0)
+		m_bfObjPool.FlushIdleCache();
+
+	TConnTimerList timers;
+
+	if(m_twConnTimer.Advance(timers) == 0)
+		return;
+
+	for(size_t i = 0; i < timers.size(); i++)
+	{
+		const TConnTimer& timer		= timers[i];
+		TUdpSocketObj* pSocketObj	= FindSocketObj(timer.connID);
+
+		if(!TUdpSocketObj::IsValid(pSocketObj))
+			continue;
+
+		if(timer.fnTimer == nullptr)
+			HandleTimeout(pSocketObj);
+		else
+			timer.fnTimer(timer.connID, timer.pvParam);
+	}
+}
+
+VOID CUdpServer::HandleTimeout(TUdpSocketObj* pSocketObj)
+{
+	DWORD dwRemain;
+	DWORD dwSilenceTimeout = m_bMarkSilence ? m_dwSilenceTimeout : 0;
+
+	if(pSocketObj->IsTimeout(m_dwMaxConnectPeriod, dwSilenceTimeout, 0, dwRemain))
+	{
+		Disconnect(pSocketObj->connID);
+		return;
+	}
+
+	if(IsNeedRunDetector())
+	{
+		DWORD now = ::TimeGetTime();
+
+		if((int)(now - pSocketObj->detectTime) >= 0)
+		{
+			if(pSocketObj->detectFails >= m_dwDetectAttempts)
+			{
+				VERIFY(m_ioDispatcher.SendCommand(DISP_CMD_DISCONNECT, pSocketObj->connID, TRUE));
+				return;
+			}
+
+			::InterlockedIncrement(&pSocketObj->detectFails);
+			pSocketObj->detectTime = now + m_dwDetectInterval * 1000;
+		}
+
+		TUdpSocketObj::CheckTimeout(now, pSocketObj->detectTime - now, now, dwRemain);
+	}
+
+	if(dwRemain > 0)
+		ArmTimer(pSocketObj, &pSocketObj->sysTimer, dwRemain);
+}
+
 VOID CUdpServer::HandleCmdSend(CONNID dwConnID, int flag)
 {
-	DoSend(dwConnID, flag);
+	/* 批量发送模式下连接 ID 为 0 的发送命令表示合并发送 m_quSend 中所有连接的待发送数据 */
+	if(dwConnID == 0)
+		DoBatchSend();
+	else
+		DoSend(dwConnID, flag);
 }
 
 VOID CUdpServer::HandleCmdReceive(CONNID dwConnID, int flag)
@@ -712,7 +975,7 @@ VOID CUdpServer::HandleCmdDisconnect(CONNID dwConnID, BOOL bForce)
 
 BOOL CUdpServer::OnReadyRead(PVOID pv, UINT events)
 {
-	return HandleReceive(RETRIVE_EVENT_FLAG_H(events));
+	return HandleReceive(*(SOCKET*)pv, RETRIVE_EVENT_FLAG_H(events));
 }
 
 BOOL CUdpServer::OnReadyWrite(PVOID pv, UINT events)
@@ -739,13 +1002,20 @@ BOOL CUdpServer::HandleClose()
 {
 	VERIFY(!HasStarted());
 
-	m_ioDispatcher.DelFD(m_soListen);
+	for(int i = 0; i < m_iListens; i++)
+		m_ioDispatcher.DelFD(i, m_soListens[i]);
 
 	return FALSE;
 }
 
-BOOL CUdpServer::HandleReceive(int flag)
+BOOL CUdpServer::HandleReceive(SOCKET soListen, int flag)
 {
+	if(IsBatchReceive())
+		return HandleBatchReceive(soListen, flag);
+
+	TDispCommand cmds[MAX_CONTINUE_READS];
+	int iCmds = 0;
+
 	while(TRUE)
 	{
 		HP_SOCKADDR addr;
@@ -754,7 +1024,7 @@ BOOL CUdpServer::HandleReceive(int flag)
 		TItemPtr itPtr(m_bfObjPool, m_bfObjPool.PickFreeItem());
 		int iBufferLen = itPtr->Capacity();
 
-		int rc = (int)recvfrom(m_soListen, itPtr->Ptr(), iBufferLen, MSG_TRUNC, addr.Addr(), &dwAddrLen);
+		int rc = (int)recvfrom(soListen, itPtr->Ptr(), iBufferLen, MSG_TRUNC, addr.Addr(), &dwAddrLen);
 
 		if(rc >= 0)
 		{
@@ -791,7 +1061,17 @@ BOOL CUdpServer::HandleReceive(int flag)
 				pSocketObj->recvQueue.PushBack(itPtr.Detach());
 			}
 
-			VERIFY(m_ioDispatcher.SendCommand(DISP_CMD_RECEIVE, dwConnID, flag));
+			/* 同一连接的连续数据报只需一个接收命令（DoReceive() 会在数据未处理完时重新投递） */
+			if(iCmds > 0 && cmds[iCmds - 1].wParam == dwConnID)
+				continue;
+
+			cmds[iCmds++] = TDispCommand(DISP_CMD_RECEIVE, dwConnID, flag);
+
+			if(iCmds == MAX_CONTINUE_READS)
+			{
+				VERIFY(m_ioDispatcher.SendCommands(cmds, iCmds));
+				iCmds = 0;
+			}
 		}
 		else
 		{
@@ -802,9 +1082,130 @@ BOOL CUdpServer::HandleReceive(int flag)
 		}
 	}
 
+	VERIFY(m_ioDispatcher.SendCommands(cmds, iCmds));
+
 	return TRUE;
 }
 
+BOOL CUdpServer::HandleBatchReceive(SOCKET soListen, int flag)
+{
+	const int iBatch = (int)m_dwReceiveBatchCount;
+
+	mmsghdr msgs[MAX_UDP_BATCH_COUNT];
+	iovec iovs[MAX_UDP_BATCH_COUNT];
+	HP_SOCKADDR addrs[MAX_UDP_BATCH_COUNT];
+	TItem* items[MAX_UDP_BATCH_COUNT];
+	TDispCommand cmds[MAX_UDP_BATCH_COUNT];
+
+	for(int i = 0; i < iBatch; i++)
+	{
+		items[i] = m_bfObjPool.PickFreeItem();
+
+		iovs[i].iov_base = items[i]->Ptr();
+		iovs[i].iov_len	 = items[i]->Capacity();
+
+		ZeroObject(msgs[i]);
+
+		msgs[i].msg_hdr.msg_name	= addrs[i].Addr();
+		msgs[i].msg_hdr.msg_iov		= &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen	= 1;
+	}
+
+	BOOL isOK			= TRUE;
+	CONNID dwLastID		= 0;
+	HP_SOCKADDR addrLast;
+
+	while(TRUE)
+	{
+		for(int i = 0; i < iBatch; i++)
+			msgs[i].msg_hdr.msg_namelen = (socklen_t)addrs[i].AddrSize(AF_INET6);
+
+		int rc = (int)recvmmsg(soListen, msgs, iBatch, MSG_TRUNC, nullptr);
+
+		if(rc == SOCKET_ERROR)
+		{
+			BREAK_WOULDBLOCK_ERROR();
+
+			HandleClose();
+			isOK = FALSE;
+
+			break;
+		}
+
+		int iCmds = 0;
+
+		for(int i = 0; i < rc; i++)
+		{
+			HP_SOCKADDR& addr = addrs[i];
+			int iLength		  = (int)msgs[i].msg_len;
+
+			/* 连续数据报通常来自同一地址，命中时省去一次地址哈希表查找 */
+			CONNID dwConnID = (dwLastID != 0 && addr.EqualTo(addrLast)) ? dwLastID : FindConnectionID(&addr);
+
+			if(dwConnID == 0)
+			{
+				if((dwConnID = HandleAccept(addr)) == 0)
+					continue;
+			}
+
+			if(dwConnID != dwLastID)
+			{
+				dwLastID = dwConnID;
+				addr.Copy(addrLast);
+			}
+
+			if(iLength > (int)iovs[i].iov_len)
+				continue;
+
+			TUdpSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+			if(!TUdpSocketObj::IsValid(pSocketObj))
+			{
+				dwLastID = 0;
+				continue;
+			}
+
+			if(iLength == 0)
+			{
+				HandleZeroBytes(pSocketObj);
+				continue;
+			}
+
+			{
+				CReadLock locallock(pSocketObj->lcIo);
+
+				if(!TUdpSocketObj::IsValid(pSocketObj))
+					continue;
+
+				items[i]->Increase(iLength);
+				pSocketObj->recvQueue.PushBack(items[i]);
+			}
+
+			items[i]		 = m_bfObjPool.PickFreeItem();
+			iovs[i].iov_base = items[i]->Ptr();
+
+			/* 按连接合并接收命令，每个连接在一批数据报中只投递一个接收命令 */
+			int j = iCmds - 1;
+
+			for(; j >= 0; j--)
+			{
+				if(cmds[j].wParam == dwConnID)
+					break;
+			}
+
+			if(j < 0)
+				cmds[iCmds++] = TDispCommand(DISP_CMD_RECEIVE, dwConnID, flag);
+		}
+
+		VERIFY(m_ioDispatcher.SendCommands(cmds, iCmds));
+	}
+
+	for(int i = 0; i < iBatch; i++)
+		m_bfObjPool.PutFreeItem(items[i]);
+
+	return isOK;
+}
+
 CONNID CUdpServer::HandleAccept(HP_SOCKADDR& addr)
 {
 	CONNID dwConnID				= 0;
@@ -892,12 +1293,33 @@ BOOL CUdpServer::DoReceive(CONNID dwConnID, int flag)
 
 BOOL CUdpServer::HandleSend(int flag)
 {
-	m_ioDispatcher.ModFD(m_soListen, _EPOLL_READ_EVENTS | EPOLLET, TO_PVOID(&m_soListen));
+	m_ioDispatcher.ModFD(m_soListen, _EPOLL_READ_EVENTS | EPOLLET, TO_PVOID(&m_soListens[0]));
 
-	CONNID dwConnID = 0;
+	/* 批量发送模式下 m_bBatchSending 仍由阻塞前的 DoBatchSend() 持有，直接投递合并发送命令 */
+	if(IsBatchSend())
+	{
+		ASSERT(m_bBatchSending);
+
+		VERIFY(m_ioDispatcher.SendCommand(DISP_CMD_SEND));
+		return TRUE;
+	}
+
+	TDispCommand cmds[MAX_CONTINUE_WRITES];
+	int iCmds		= 0;
+	CONNID dwConnID	= 0;
 
 	while(m_quSend.PopFront(&dwConnID))
-		VERIFY(m_ioDispatcher.SendCommand(DISP_CMD_SEND, dwConnID));
+	{
+		cmds[iCmds++] = TDispCommand(DISP_CMD_SEND, dwConnID);
+
+		if(iCmds == MAX_CONTINUE_WRITES)
+		{
+			VERIFY(m_ioDispatcher.SendCommands(cmds, iCmds));
+			iCmds = 0;
+		}
+	}
+
+	VERIFY(m_ioDispatcher.SendCommands(cmds, iCmds));
 
 	return TRUE;
 }
@@ -939,10 +1361,12 @@ BOOL CUdpServer::DoSend(CONNID dwConnID, int flag)
 			sndBuff.PushFront(itPtr.Detach());
 			m_quSend.PushBack(dwConnID);
 
-			m_ioDispatcher.ModFD(m_soListen, EPOLLOUT | _EPOLL_READ_EVENTS | EPOLLET, TO_PVOID(&m_soListen));
+			m_ioDispatcher.ModFD(m_soListen, EPOLLOUT | _EPOLL_READ_EVENTS | EPOLLET, TO_PVOID(&m_soListens[0]));
 
 			break;
 		}
+
+		ReduceSendPending(pSocketObj, itPtr->Size());
 	}
 
 	if(!bBlocked && !sndBuff.IsEmpty())
@@ -980,6 +1404,171 @@ BOOL CUdpServer::SendItem(TUdpSocketObj* pSocketObj, TItem* pItem, BOOL& bBlocke
 	return TRUE;
 }
 
+BOOL CUdpServer::DoBatchSend()
+{
+	ASSERT(m_bBatchSending);
+
+	const int iBatch = (int)m_dwSendBatchCount;
+
+	mmsghdr msgs[MAX_UDP_BATCH_COUNT];
+	iovec iovs[MAX_UDP_BATCH_COUNT];
+	HP_SOCKADDR addrs[MAX_UDP_BATCH_COUNT];
+	TItem* items[MAX_UDP_BATCH_COUNT];
+	CONNID ids[MAX_UDP_BATCH_COUNT];
+
+	for(int i = 0; i < MAX_CONTINUE_WRITES; i++)
+	{
+		int iCount		= 0;
+		CONNID dwConnID	= 0;
+
+		/* 从多个连接的发送缓冲区中收集数据报（同一连接的数据报保持原有顺序） */
+		while(iCount < iBatch && m_quSend.PopFront(&dwConnID))
+		{
+			TUdpSocketObj* pSocketObj = FindSocketObj(dwConnID);
+
+			if(!TUdpSocketObj::IsValid(pSocketObj))
+				continue;
+
+			CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+			if(!TUdpSocketObj::IsValid(pSocketObj))
+				continue;
+
+			TBufferObjList& sndBuff = pSocketObj->sndBuff;
+
+			while(iCount < iBatch)
+			{
+				TItem* pItem = sndBuff.PopFront();
+
+				if(pItem == nullptr)
+					break;
+
+				ASSERT(!pItem->IsEmpty());
+
+				items[iCount]	= pItem;
+				ids[iCount]		= dwConnID;
+
+				/* 数据报取出后即不再计入待发数据，发送失败时由 RestoreBatchSend() 重新计入 */
+				ReduceSendPending(pSocketObj, pItem->Size());
+
+				pSocketObj->remoteAddr.Copy(addrs[iCount]);
+
+				iovs[iCount].iov_base	= pItem->Ptr();
+				iovs[iCount].iov_len	= pItem->Size();
+
+				ZeroObject(msgs[iCount]);
+
+				msgs[iCount].msg_hdr.msg_name		= addrs[iCount].Addr();
+				msgs[iCount].msg_hdr.msg_namelen	= (socklen_t)addrs[iCount].AddrSize();
+				msgs[iCount].msg_hdr.msg_iov		= &iovs[iCount];
+				msgs[iCount].msg_hdr.msg_iovlen		= 1;
+
+				++iCount;
+			}
+
+			if(!sndBuff.IsEmpty())
+				m_quSend.PushBack(dwConnID);
+		}
+
+		if(iCount == 0)
+		{
+			/* 释放发送权后再次检查队列，避免与 SendInternal() 竞争导致数据滞留 */
+			__atomic_store_n(&m_bBatchSending, FALSE, memory_order_seq_cst);
+
+			if(m_quSend.IsEmpty() || ::InterlockedExchange(&m_bBatchSending, TRUE))
+				return TRUE;
+
+			continue;
+		}
+
+		int iSent					= 0;
+		TUdpSocketObj* pSocketObj	= nullptr;
+
+		while(iSent < iCount)
+		{
+			int rc = (int)sendmmsg(m_soListen, msgs + iSent, iCount - iSent, 0);
+
+			if(rc == SOCKET_ERROR)
+			{
+				int code = ::WSAGetLastError();
+
+				if(code == ERROR_WOULDBLOCK)
+				{
+					RestoreBatchSend(items + iSent, ids + iSent, iCount - iSent);
+					m_ioDispatcher.ModFD(m_soListen, EPOLLOUT | _EPOLL_READ_EVENTS | EPOLLET, TO_PVOID(&m_soListens[0]));
+
+					return TRUE;
+				}
+
+				for(int j = iSent; j < iCount; j++)
+					m_bfObjPool.PutFreeItem(items[j]);
+
+				__atomic_store_n(&m_bBatchSending, FALSE, memory_order_seq_cst);
+				HandleClose();
+
+				return FALSE;
+			}
+
+			for(int j = iSent; j < iSent + rc; j++)
+			{
+				TItem* pItem = items[j];
+
+				ASSERT((int)msgs[j].msg_len == pItem->Size());
+
+				if(pSocketObj == nullptr || pSocketObj->connID != ids[j])
+					pSocketObj = FindSocketObj(ids[j]);
+
+				if(TUdpSocketObj::IsValid(pSocketObj) && TRIGGER(FireSend(pSocketObj, pItem->Ptr(), pItem->Size())) == HR_ERROR)
+				{
+					TRACE("<C-CNNID: %zu> OnSend() event should not return 'HR_ERROR' !!", pSocketObj->connID);
+					ASSERT(FALSE);
+				}
+
+				m_bfObjPool.PutFreeItem(pItem);
+			}
+
+			iSent += rc;
+		}
+	}
+
+	/* 连续发送次数达到上限，保持发送权并重新投递命令，让出工作线程 */
+	VERIFY(m_ioDispatcher.SendCommand(DISP_CMD_SEND));
+
+	return TRUE;
+}
+
+void CUdpServer::RestoreBatchSend(TItem* pItems[], const CONNID ids[], int iCount)
+{
+	/* 逆序放回各连接发送缓冲区的头部，以保持同一连接的数据报顺序 */
+	for(int i = iCount - 1; i >= 0; i--)
+	{
+		TItem* pItem			  = pItems[i];
+		TUdpSocketObj* pSocketObj = FindSocketObj(ids[i]);
+
+		if(TUdpSocketObj::IsValid(pSocketObj))
+		{
+			CReentrantCriSecLock locallock(pSocketObj->csSend);
+
+			if(TUdpSocketObj::IsValid(pSocketObj))
+			{
+				TBufferObjList& sndBuff = pSocketObj->sndBuff;
+				BOOL bEmpty				= sndBuff.IsEmpty();
+				int iPending			= pSocketObj->Pending();
+
+				sndBuff.PushFront(pItem);
+				AddSendPending(pSocketObj, iPending);
+
+				/* 发送缓冲区非空时该连接已在 m_quSend 中 */
+				if(bEmpty) m_quSend.PushBack(ids[i]);
+
+				continue;
+			}
+		}
+
+		m_bfObjPool.PutFreeItem(pItem);
+	}
+}
+
 BOOL CUdpServer::Send(CONNID dwConnID, const BYTE* pBuffer, int iLength, int iOffset)
 {
 	ASSERT(pBuffer && iLength > 0 && iLength <= (int)m_dwMaxDatagramSize);
@@ -1071,17 +1660,83 @@ int CUdpServer::SendInternal(TUdpSocketObj* pSocketObj, TItemPtr& itPtr)
 		if(!TUdpSocketObj::IsValid(pSocketObj))
 			return ERROR_OBJECT_NOT_FOUND;
 
-		bPending = pSocketObj->IsPending();
+		int result = CheckSendQuota(pSocketObj);
+
+		if(result != NO_ERROR)
+			return result;
+
+		int iPending = pSocketObj->Pending();
+		bPending	 = (iPending > 0);
 
 		pSocketObj->sndBuff.PushBack(itPtr.Detach());
+		AddSendPending(pSocketObj, iPending);
 	}
 
 	if(!bPending)
-		VERIFY(m_ioDispatcher.SendCommand(DISP_CMD_SEND, pSocketObj->connID));
+	{
+		if(!IsBatchSend())
+			VERIFY(m_ioDispatcher.SendCommand(DISP_CMD_SEND, pSocketObj->connID));
+		else
+		{
+			m_quSend.PushBack(pSocketObj->connID);
+
+			if(!::InterlockedExchange(&m_bBatchSending, TRUE))
+				VERIFY(m_ioDispatcher.SendCommand(DISP_CMD_SEND));
+		}
+	}
 
 	return NO_ERROR;
 }
 
+void CUdpServer::NotifyWritable(TUdpSocketObj* pSocketObj, BOOL bWritable)
+{
+	if(TRIGGER(FireWritable(pSocketObj, bWritable)) == HR_ERROR)
+	{
+		TRACE("<S-CNNID: %zu> OnWritable() event should not return 'HR_ERROR' !!", pSocketObj->connID);
+		ASSERT(FALSE);
+	}
+}
+
+/* 检查是否允许发送新的数据报：待发数据超过高水位或总量超过 MaxSendPending 时拒绝发送（在 csSend 锁内调用） */
+int CUdpServer::CheckSendQuota(TUdpSocketObj* pSocketObj)
+{
+	if(pSocketObj->sndBlocked)
+		return ERROR_WOULDBLOCK;
+
+	if(IsSendPendingLimited() && m_llSendPending >= (LLONG)m_dwMaxSendPending)
+		return ERROR_NOT_ENOUGH_QUOTA;
+
+	return NO_ERROR;
+}
+
+/* 统计新加入发送缓冲区的数据（iPending 为加入前的待发数据长度），达到高水位时触发 OnWritable(FALSE)（在 csSend 锁内调用） */
+void CUdpServer::AddSendPending(TUdpSocketObj* pSocketObj, int iPending)
+{
+	int iCurPending = pSocketObj->Pending();
+
+	if(IsSendPendingLimited() && iCurPending != iPending)
+		::InterlockedExchangeAdd(&m_llSendPending, (LLONG)(iCurPending - iPending));
+
+	if(m_dwSendHighWatermark > 0 && !pSocketObj->sndBlocked && iCurPending >= (int)m_dwSendHighWatermark)
+	{
+		pSocketObj->sndBlocked = TRUE;
+		NotifyWritable(pSocketObj, FALSE);
+	}
+}
+
+/* 统计已从发送缓冲区取出的数据，降到低水位以下时触发 OnWritable(TRUE)（在 csSend 锁内调用） */
+void CUdpServer::ReduceSendPending(TUdpSocketObj* pSocketObj, int iLength)
+{
+	if(IsSendPendingLimited())
+		::InterlockedExchangeSub(&m_llSendPending, (LLONG)iLength);
+
+	if(pSocketObj->sndBlocked && pSocketObj->Pending() <= (int)m_dwSendLowWatermark)
+	{
+		pSocketObj->sndBlocked = FALSE;
+		NotifyWritable(pSocketObj, TRUE);
+	}
+}
+
 UINT WINAPI CUdpServer::DetecotrThreadProc(LPVOID pv)
 {
 	ASSERT(IsNeedRunDetector());
@@ -43,6 +43,8 @@ public:
 	virtual BOOL			Disconnect					(CONNID dwConnID, BOOL bForce = TRUE);
 	virtual BOOL			DisconnectLongConnections	(DWORD dwPeriod, BOOL bForce = TRUE);
 	virtual BOOL			DisconnectSilenceConnections(DWORD dwPeriod, BOOL bForce = TRUE);
+	virtual BOOL			SetConnectionTimer			(CONNID dwConnID, DWORD dwTimeout, Fn_ConnectionTimer fnTimer, PVOID pvParam = nullptr);
+	virtual BOOL			KillConnectionTimer			(CONNID dwConnID);
 	virtual BOOL			GetListenAddress			(TCHAR lpszAddress[], int& iAddressLen, USHORT& usPort);
 	virtual BOOL			GetLocalAddress				(CONNID dwConnID, TCHAR lpszAddress[], int& iAddressLen, USHORT& usPort);
 	virtual BOOL			GetRemoteAddress			(CONNID dwConnID, TCHAR lpszAddress[], int& iAddressLen, USHORT& usPort);
@@ -50,6 +52,7 @@ public:
 	virtual BOOL IsConnected			(CONNID dwConnID);
 	virtual BOOL IsPauseReceive			(CONNID dwConnID, BOOL& bPaused);
 	virtual BOOL GetPendingDataLength	(CONNID dwConnID, int& iPending);
+	virtual void GetFreeBufferObjCacheStat	(ULONGLONG& ullHits, ULONGLONG& ullMisses)	{m_bfObjPool.GetCacheStat(ullHits, ullMisses);}
 	virtual DWORD GetConnectionCount	();
 	virtual BOOL GetAllConnectionIDs	(CONNID pIDs[], DWORD& dwCount);
 	virtual BOOL GetConnectPeriod		(CONNID dwConnID, DWORD& dwPeriod);
@@ -61,6 +64,7 @@ private:
 	virtual BOOL OnBeforeProcessIo(PVOID pv, UINT events)			override;
 	virtual VOID OnAfterProcessIo(PVOID pv, UINT events, BOOL rs)	override;
 	virtual VOID OnCommand(TDispCommand* pCmd)						override;
+	virtual VOID OnTimer(int iShard, LLONG llExpirations)			override;
 	virtual BOOL OnReadyRead(PVOID pv, UINT events)					override;
 	virtual BOOL OnReadyWrite(PVOID pv, UINT events)				override;
 	virtual BOOL OnHungUp(PVOID pv, UINT events)					override;
@@ -75,6 +79,7 @@ public:
 
 	virtual void SetSendPolicy				(EnSendPolicy enSendPolicy)				{m_enSendPolicy			= enSendPolicy;}
 	virtual void SetOnSendSyncPolicy		(EnOnSendSyncPolicy enOnSendSyncPolicy)	{m_enOnSendSyncPolicy	= enOnSendSyncPolicy;}
+	virtual void SetListenMode				(EnListenMode enListenMode)				{m_enListenMode			= enListenMode;}
 	virtual void SetMaxConnectionCount		(DWORD dwMaxConnectionCount)	{m_dwMaxConnectionCount		= dwMaxConnectionCount;}
 	virtual void SetWorkerThreadCount		(DWORD dwWorkerThreadCount)		{m_dwWorkerThreadCount		= dwWorkerThreadCount;}
 	virtual void SetFreeSocketObjLockTime	(DWORD dwFreeSocketObjLockTime)	{m_dwFreeSocketObjLockTime	= dwFreeSocketObjLockTime;}
@@ -82,14 +87,28 @@ public:
 	virtual void SetFreeBufferObjPool		(DWORD dwFreeBufferObjPool)		{m_dwFreeBufferObjPool		= dwFreeBufferObjPool;}
 	virtual void SetFreeSocketObjHold		(DWORD dwFreeSocketObjHold)		{m_dwFreeSocketObjHold		= dwFreeSocketObjHold;}
 	virtual void SetFreeBufferObjHold		(DWORD dwFreeBufferObjHold)		{m_dwFreeBufferObjHold		= dwFreeBufferObjHold;}
+	virtual void SetFreeSocketObjPrealloc	(DWORD dwFreeSocketObjPrealloc)	{m_dwFreeSocketObjPrealloc	= dwFreeSocketObjPrealloc;}
+	virtual void SetFreeBufferObjPrealloc	(DWORD dwFreeBufferObjPrealloc)	{m_dwFreeBufferObjPrealloc	= dwFreeBufferObjPrealloc;}
+	virtual void SetFreeBufferObjCache		(DWORD dwFreeBufferObjCache)	{m_dwFreeBufferObjCache		= dwFreeBufferObjCache;}
+	virtual void SetPoolNumaInterleave		(BOOL bPoolNumaInterleave)		{m_bPoolNumaInterleave		= bPoolNumaInterleave;}
 	virtual void SetMaxDatagramSize			(DWORD dwMaxDatagramSize)		{m_dwMaxDatagramSize		= dwMaxDatagramSize;}
 	virtual void SetPostReceiveCount		(DWORD dwPostReceiveCount)		{m_dwPostReceiveCount		= dwPostReceiveCount;}
+	virtual void SetReceiveBatchCount		(DWORD dwReceiveBatchCount)		{m_dwReceiveBatchCount		= dwReceiveBatchCount;}
+	virtual void SetSendBatchCount			(DWORD dwSendBatchCount)		{m_dwSendBatchCount			= dwSendBatchCount;}
 	virtual void SetDetectAttempts			(DWORD dwDetectAttempts)		{m_dwDetectAttempts			= dwDetectAttempts;}
 	virtual void SetDetectInterval			(DWORD dwDetectInterval)		{m_dwDetectInterval			= dwDetectInterval;}
 	virtual void SetMarkSilence				(BOOL bMarkSilence)				{m_bMarkSilence				= bMarkSilence;}
+	virtual void SetTimerInterval			(DWORD dwTimerInterval)			{m_dwTimerInterval			= dwTimerInterval;}
+	virtual void SetMaxConnectPeriod		(DWORD dwMaxConnectPeriod)		{m_dwMaxConnectPeriod		= dwMaxConnectPeriod;}
+	virtual void SetSilenceTimeout			(DWORD dwSilenceTimeout)		{m_dwSilenceTimeout			= dwSilenceTimeout;}
+	virtual void SetHandShakeTimeout		(DWORD dwHandShakeTimeout)		{m_dwHandShakeTimeout		= dwHandShakeTimeout;}
+	virtual void SetSendHighWatermark		(DWORD dwSendHighWatermark)		{m_dwSendHighWatermark		= dwSendHighWatermark;}
+	virtual void SetSendLowWatermark		(DWORD dwSendLowWatermark)		{m_dwSendLowWatermark		= dwSendLowWatermark;}
+	virtual void SetMaxSendPending			(DWORD dwMaxSendPending)		{m_dwMaxSendPending			= dwMaxSendPending;}
 
 	virtual EnSendPolicy GetSendPolicy				()	{return m_enSendPolicy;}
 	virtual EnOnSendSyncPolicy GetOnSendSyncPolicy	()	{return m_enOnSendSyncPolicy;}
+	virtual EnListenMode GetListenMode				()	{return m_enListenMode;}
 	virtual DWORD GetMaxConnectionCount		()	{return m_dwMaxConnectionCount;}
 	virtual DWORD GetWorkerThreadCount		()	{return m_dwWorkerThreadCount;}
 	virtual DWORD GetFreeSocketObjLockTime	()	{return m_dwFreeSocketObjLockTime;}
@@ -97,11 +116,24 @@ public:
 	virtual DWORD GetFreeBufferObjPool		()	{return m_dwFreeBufferObjPool;}
 	virtual DWORD GetFreeSocketObjHold		()	{return m_dwFreeSocketObjHold;}
 	virtual DWORD GetFreeBufferObjHold		()	{return m_dwFreeBufferObjHold;}
+	virtual DWORD GetFreeSocketObjPrealloc	()	{return m_dwFreeSocketObjPrealloc;}
+	virtual DWORD GetFreeBufferObjPrealloc	()	{return m_dwFreeBufferObjPrealloc;}
+	virtual DWORD GetFreeBufferObjCache		()	{return m_dwFreeBufferObjCache;}
+	virtual BOOL  IsPoolNumaInterleave		()	{return m_bPoolNumaInterleave;}
 	virtual DWORD GetMaxDatagramSize		()	{return m_dwMaxDatagramSize;}
 	virtual DWORD GetPostReceiveCount		()	{return m_dwPostReceiveCount;}
+	virtual DWORD GetReceiveBatchCount		()	{return m_dwReceiveBatchCount;}
+	virtual DWORD GetSendBatchCount			()	{return m_dwSendBatchCount;}
 	virtual DWORD GetDetectAttempts			()	{return m_dwDetectAttempts;}
 	virtual DWORD GetDetectInterval			()	{return m_dwDetectInterval;}
 	virtual BOOL  IsMarkSilence				()	{return m_bMarkSilence;}
+	virtual DWORD GetTimerInterval			()	{return m_dwTimerInterval;}
+	virtual DWORD GetMaxConnectPeriod		()	{return m_dwMaxConnectPeriod;}
+	virtual DWORD GetSilenceTimeout			()	{return m_dwSilenceTimeout;}
+	virtual DWORD GetHandShakeTimeout		()	{return m_dwHandShakeTimeout;}
+	virtual DWORD GetSendHighWatermark		()	{return m_dwSendHighWatermark;}
+	virtual DWORD GetSendLowWatermark		()	{return m_dwSendLowWatermark;}
+	virtual DWORD GetMaxSendPending			()	{return m_dwMaxSendPending;}
 
 protected:
 	virtual EnHandleResult FirePrepareListen(SOCKET soListen)
@@ -120,6 +152,8 @@ protected:
 		{return m_pListener->OnReceive(this, pSocketObj->connID, iLength);}
 	virtual EnHandleResult FireSend(TUdpSocketObj* pSocketObj, const BYTE* pData, int iLength)
 		{return m_pListener->OnSend(this, pSocketObj->connID, pData, iLength);}
+	virtual EnHandleResult FireWritable(TUdpSocketObj* pSocketObj, BOOL bWritable)
+		{return m_pListener->OnWritable(this, pSocketObj->connID, bWritable);}
 	virtual EnHandleResult FireClose(TUdpSocketObj* pSocketObj, EnSocketOperation enOperation, int iErrorCode)
 		{return m_pListener->OnClose(this, pSocketObj->connID, enOperation, iErrorCode);}
 	virtual EnHandleResult FireShutdown()
@@ -153,6 +187,7 @@ private:
 	BOOL CheckStarting();
 	BOOL CheckStoping();
 	BOOL CreateListenSocket(LPCTSTR lpszBindAddress, USHORT usPort);
+	BOOL CreateListenSocket(const HP_SOCKADDR& addr, SOCKET& soListen);
 	BOOL CreateWorkerThreads();
 	BOOL CreateDetectorThread();
 	BOOL StartAccept();
@@ -168,6 +203,7 @@ private:
 	TUdpSocketObj* FindSocketObj(CONNID dwConnID);
 	TUdpSocketObj* GetFreeSocketObj(CONNID dwConnID);
 	TUdpSocketObj* CreateSocketObj();
+	void PreallocSocketObj();
 	CONNID FindConnectionID(const HP_SOCKADDR* pAddr);
 	void AddFreeSocketObj(TUdpSocketObj* pSocketObj, EnSocketCloseFlag enFlag = SCF_NONE, EnSocketOperation enOperation = SO_UNKNOWN, int iErrorCode = 0);
 	void DeleteSocketObj(TUdpSocketObj* pSocketObj);
@@ -181,8 +217,10 @@ private:
 	VOID HandleCmdSend		(CONNID dwConnID, int flag);
 	VOID HandleCmdReceive	(CONNID dwConnID, int flag);
 	VOID HandleCmdDisconnect(CONNID dwConnID, BOOL bForce);
+	VOID HandleTimeout		(TUdpSocketObj* pSocketObj);
 	CONNID HandleAccept		(HP_SOCKADDR& addr);
-	BOOL HandleReceive		(int flag = 0);
+	BOOL HandleReceive		(SOCKET soListen, int flag = 0);
+	BOOL HandleBatchReceive	(SOCKET soListen, int flag = 0);
 	BOOL HandleSend			(int flag = 0);
 	BOOL HandleClose		();
 	void HandleZeroBytes	(TUdpSocketObj* pSocketObj);
@@ -191,7 +229,26 @@ private:
 	BOOL DoSend			(CONNID dwConnID, int flag = 0);
 	BOOL DoReceive		(CONNID dwConnID, int flag = 0);
 	BOOL SendItem		(TUdpSocketObj* pSocketObj, TItem* pItem, BOOL& bBlocked);
+	BOOL DoBatchSend	();
+	void RestoreBatchSend(TItem* pItems[], const CONNID ids[], int iCount);
+	void NotifyWritable	(TUdpSocketObj* pSocketObj, BOOL bWritable);
 
+	int  CheckSendQuota		(TUdpSocketObj* pSocketObj);
+	void AddSendPending		(TUdpSocketObj* pSocketObj, int iPending);
+	void ReduceSendPending	(TUdpSocketObj* pSocketObj, int iLength);
+	BOOL IsSendPendingLimited	()	{return m_dwMaxSendPending > 0;}
+
+	BOOL IsBatchReceive	() {return m_dwReceiveBatchCount > 1;}
+	BOOL IsBatchSend	() {return m_dwSendBatchCount > 1;}
+
+	int GetListenIndex	(PVOID pv)	{return (m_soListens && pv >= &m_soListens[0] && pv < &m_soListens[m_iListens]) ? (int)((SOCKET*)pv - &m_soListens[0]) : -1;}
+	BOOL IsReusePort	()			{return m_enListenMode != LM_SINGLE;}
+
+
+	BOOL ArmTimer		(TUdpSocketObj* pSocketObj, TConnTimer* pTimer, DWORD dwTimeout);
+	VOID KillTimers		(TUdpSocketObj* pSocketObj);
+	BOOL IsTimerEnabled	()	{return m_dwTimerInterval > 0;}
+	BOOL IsNeedCheckTimeout	()	{return IsTimerEnabled() && (m_dwMaxConnectPeriod > 0 || m_dwSilenceTimeout > 0 || IsNeedRunDetector());}
 
 	void DetectConnections	();
 	BOOL IsNeedRunDetector	() {return m_dwDetectAttempts > 0 && m_dwDetectInterval > 0;}
@@ -200,10 +257,12 @@ public:
 	CUdpServer(IUdpServerListener* pListener)
 	: m_pListener				(pListener)
 	, m_soListen				(INVALID_SOCKET)
+	, m_iListens				(0)
 	, m_enLastError				(SE_OK)
 	, m_enState					(SS_STOPPED)
 	, m_enSendPolicy			(SP_PACK)
 	, m_enOnSendSyncPolicy		(OSSP_NONE)
+	, m_enListenMode			(LM_SINGLE)
 	, m_dwMaxConnectionCount	(DEFAULT_MAX_CONNECTION_COUNT)
 	, m_dwWorkerThreadCount		(DEFAULT_WORKER_THREAD_COUNT)
 	, m_dwFreeSocketObjLockTime	(DEFAULT_FREE_SOCKETOBJ_LOCK_TIME)
@@ -211,11 +270,26 @@ public:
 	, m_dwFreeBufferObjPool		(DEFAULT_FREE_BUFFEROBJ_POOL)
 	, m_dwFreeSocketObjHold		(DEFAULT_FREE_SOCKETOBJ_HOLD)
 	, m_dwFreeBufferObjHold		(DEFAULT_FREE_BUFFEROBJ_HOLD)
+	, m_dwFreeSocketObjPrealloc	(0)
+	, m_dwFreeBufferObjPrealloc	(0)
+	, m_dwFreeBufferObjCache	(DEFAULT_FREE_BUFFEROBJ_CACHE)
 	, m_dwMaxDatagramSize		(DEFAULT_UDP_MAX_DATAGRAM_SIZE)
 	, m_dwPostReceiveCount		(DEFAULT_UDP_POST_RECEIVE_COUNT)
+	, m_dwReceiveBatchCount		(DEFAULT_UDP_RECEIVE_BATCH_COUNT)
+	, m_dwSendBatchCount		(DEFAULT_UDP_SEND_BATCH_COUNT)
 	, m_dwDetectAttempts		(DEFAULT_UDP_DETECT_ATTEMPTS)
 	, m_dwDetectInterval		(DEFAULT_UDP_DETECT_INTERVAL)
+	, m_dwTimerInterval			(DEFAULT_TIMER_INTERVAL)
+	, m_dwMaxConnectPeriod		(0)
+	, m_dwSilenceTimeout		(0)
+	, m_dwHandShakeTimeout		(0)
+	, m_dwSendHighWatermark		(0)
+	, m_dwSendLowWatermark		(0)
+	, m_dwMaxSendPending		(0)
 	, m_bMarkSilence			(TRUE)
+	, m_bPoolNumaInterleave		(FALSE)
+	, m_bBatchSending			(FALSE)
+	, m_llSendPending			(0)
 	{
 		ASSERT(m_pListener);
 	}
@@ -228,6 +302,7 @@ public:
 private:
 	EnSendPolicy m_enSendPolicy;
 	EnOnSendSyncPolicy m_enOnSendSyncPolicy;
+	EnListenMode m_enListenMode;
 	DWORD m_dwMaxConnectionCount;
 	DWORD m_dwWorkerThreadCount;
 	DWORD m_dwFreeSocketObjLockTime;
@@ -235,15 +310,31 @@ private:
 	DWORD m_dwFreeBufferObjPool;
 	DWORD m_dwFreeSocketObjHold;
 	DWORD m_dwFreeBufferObjHold;
+	DWORD m_dwFreeSocketObjPrealloc;
+	DWORD m_dwFreeBufferObjPrealloc;
+	DWORD m_dwFreeBufferObjCache;
 	DWORD m_dwMaxDatagramSize;
 	DWORD m_dwPostReceiveCount;
+	DWORD m_dwReceiveBatchCount;
+	DWORD m_dwSendBatchCount;
 	DWORD m_dwDetectAttempts;
 	DWORD m_dwDetectInterval;
+	DWORD m_dwTimerInterval;
+	DWORD m_dwMaxConnectPeriod;
+	DWORD m_dwSilenceTimeout;
+	DWORD m_dwHandShakeTimeout;
+	DWORD m_dwSendHighWatermark;
+	DWORD m_dwSendLowWatermark;
+	DWORD m_dwMaxSendPending;
 	BOOL  m_bMarkSilence;
+	BOOL  m_bPoolNumaInterleave;
 
 private:
 	IUdpServerListener*		m_pListener;
+	/* m_soListen 为第一个监听 Socket（用于发送数据），端口复用模式下 m_soListens 包含每个工作线程的监听 Socket */
 	SOCKET					m_soListen;
+	unique_ptr<SOCKET[]>	m_soListens;
+	int						m_iListens;
 	EnServiceState			m_enState;
 	EnSocketError			m_enLastError;
 
@@ -266,6 +357,11 @@ private:
 	TUdpSocketObjPtrQueue	m_lsGCSocket;
 
 	CSendQueue				m_quSend;
+	volatile BOOL			m_bBatchSending;
 
+	CConnTimingWheel		m_twConnTimer;
 	CIODispatcher			m_ioDispatcher;
+
+	/* 所有连接待发数据总量（只在设置了 MaxSendPending 时统计） */
+	volatile LLONG			m_llSendPending;
 };
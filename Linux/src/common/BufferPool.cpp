@@ -25,7 +25,10 @@
 #include "SysHelper.h"
 #include "FuncHelper.h"
 
+#include <sys/sendfile.h>
+
 const DWORD TItem::DEFAULT_ITEM_CAPACITY			= DEFAULT_BUFFER_SIZE;
+const int TItem::MAX_FILE_WINDOW_SIZE			= 0x40000000;
 const DWORD CBufferPool::DEFAULT_MAX_CACHE_SIZE		= 0;
 const DWORD CBufferPool::DEFAULT_ITEM_CAPACITY		= CItemPool::DEFAULT_ITEM_CAPACITY;
 const DWORD CBufferPool::DEFAULT_ITEM_POOL_SIZE		= CItemPool::DEFAULT_POOL_SIZE;
@@ -45,10 +48,78 @@ TItem* TItem::Construct(CPrivateHeap& heap, int capacity, BYTE* pData, int lengt
 	return ::ConstructObject(pItem, heap, pHead, capacity, pData, length);
 }
 
+TItem* TItem::Construct(CPrivateHeap& heap, const BYTE* pData, int length, Fn_Release fnRelease, PVOID pvParam)
+{
+	ASSERT(pData != nullptr && length > 0);
+
+	TItem* pItem	= (TItem*)heap.Alloc(sizeof(TItem));
+	BYTE* pHead		= (BYTE*)pData;
+
+	return ::ConstructObject(pItem, heap, pHead, length, fnRelease, pvParam);
+}
+
+TItem* TItem::ConstructFile(CPrivateHeap& heap, FD fd, LLONG llOffset, LLONG llLength)
+{
+	ASSERT(IS_VALID_FD(fd) && llOffset >= 0 && llLength > 0);
+
+	TItem* pItem			= (TItem*)heap.Alloc(sizeof(TItem) + sizeof(TFileRegion));
+	TFileRegion* pRegion	= (TFileRegion*)(pItem + 1);
+	int length				= (int)MIN(llLength, (LLONG)MAX_FILE_WINDOW_SIZE);
+
+	pRegion->fd				= fd;
+	pRegion->offset			= llOffset;
+	pRegion->remain			= llLength - length;
+
+	BYTE* pHead				= nullptr;
+	Fn_Release fnRelease	= ReleaseFile;
+	PVOID pvParam			= pRegion;
+
+	return ::ConstructObject(pItem, heap, pHead, length, fnRelease, pvParam);
+}
+
+VOID TItem::ReleaseFile(const BYTE* pData, int length, PVOID pvParam, BOOL bCompleted)
+{
+	ASSERT(pvParam != nullptr);
+
+	close(((TFileRegion*)pvParam)->fd);
+}
+
+SSIZE_T TItem::SendFile(FD fdOut) const
+{
+	ASSERT(IsFile());
+
+	const TFileRegion* pRegion = (const TFileRegion*)pvParam;
+	off_t offset = (off_t)(pRegion->offset + (begin - head));
+
+	return sendfile(fdOut, pRegion->fd, &offset, Size());
+}
+
+int TItem::NextFileWindow()
+{
+	ASSERT(IsFile() && IsEmpty());
+
+	TFileRegion* pRegion = (TFileRegion*)pvParam;
+
+	if(pRegion->remain == 0)
+		return 0;
+
+	int length			 = (int)MIN(pRegion->remain, (LLONG)MAX_FILE_WINDOW_SIZE);
+	pRegion->offset		+= capacity;
+	pRegion->remain		-= length;
+	capacity			 = length;
+	begin				 = head;
+	end					 = head + length;
+
+	return length;
+}
+
 void TItem::Destruct(TItem* pItem)
 {
 	ASSERT(pItem != nullptr);
 
+	if(pItem->IsReference() && pItem->fnRelease != nullptr)
+		pItem->fnRelease(pItem->head, pItem->capacity, pItem->pvParam, pItem->IsEmpty());
+
 	CPrivateHeap& heap = pItem->heap;
 	::DestructObject(pItem);
 	heap.Free(pItem);
@@ -77,7 +148,7 @@ int TItem::Cat(const TItem& other)
 
 int TItem::Fetch(BYTE* pData, int length)
 {
-	ASSERT(pData != nullptr && length > 0);
+	ASSERT(pData != nullptr && length > 0 && !IsFile());
 
 	int fetch = MIN(Size(), length);
 	memcpy(pData, begin, fetch);
@@ -88,7 +159,7 @@ int TItem::Fetch(BYTE* pData, int length)
 
 int TItem::Peek(BYTE* pData, int length)
 {
-	ASSERT(pData != nullptr && length > 0);
+	ASSERT(pData != nullptr && length > 0 && !IsFile());
 
 	int peek = MIN(Size(), length);
 	memcpy(pData, begin, peek);
@@ -209,9 +280,10 @@ int TItemList::Peek(BYTE* pData, int length)
 	return length - remain;
 }
 
-int TItemList::Reduce(int length)
+int TItemList::Reduce(int length, int* pExpand)
 {
 	int remain = length;
+	int expand = 0;
 
 	while(remain > 0 && Size() > 0)
 	{
@@ -219,17 +291,80 @@ int TItemList::Reduce(int length)
 		remain		-= pItem->Reduce(remain);
 
 		if(pItem->IsEmpty())
-			itPool.PutFreeItem(PopFront());
+		{
+			int iWindow = pItem->IsFile() ? pItem->NextFileWindow() : 0;
+
+			if(iWindow > 0)
+				expand += iWindow;
+			else
+				itPool.PutFreeItem(PopFront());
+		}
 	}
 
+	if(pExpand != nullptr)
+		*pExpand = expand;
+
 	return length - remain;
 }
 
+int TItemList::Gather(iovec iov[], int iCount, int& iLength) const
+{
+	int i		 = 0;
+	TItem* pItem = Front();
+
+	for(iLength = 0; i < iCount && pItem != nullptr && !pItem->IsFile(); i++, pItem = pItem->next)
+	{
+		iov[i].iov_base	 = pItem->Ptr();
+		iov[i].iov_len	 = pItem->Size();
+		iLength			+= pItem->Size();
+	}
+
+	return i;
+}
+
 void TItemList::Release()
 {
 	itPool.PutFreeItem(*this);
 }
 
+int TItemList::Attach(const BYTE* pData, int length, TItem::Fn_Release fnRelease, PVOID pvParam)
+{
+	PushBack(TItem::Construct(itPool.GetPrivateHeap(), pData, length, fnRelease, pvParam));
+	return length;
+}
+
+int TItemList::AttachFile(FD fd, LLONG llOffset, LLONG llLength)
+{
+	TItem* pItem = TItem::ConstructFile(itPool.GetPrivateHeap(), fd, llOffset, llLength);
+	PushBack(pItem);
+
+	return pItem->Size();
+}
+
+TSharedItem* TSharedItem::Construct(CPrivateHeap& heap, int length)
+{
+	ASSERT(length > 0);
+
+	TSharedItem* pItem = (TSharedItem*)heap.Alloc(sizeof(TSharedItem) + length);
+	return ::ConstructObject(pItem, heap, length);
+}
+
+void TSharedItem::Destruct(TSharedItem* pItem)
+{
+	ASSERT(pItem != nullptr);
+
+	CPrivateHeap& heap = pItem->heap;
+	::DestructObject(pItem);
+	heap.Free(pItem);
+}
+
+VOID TSharedItem::ReleaseRef(const BYTE* pData, int length, PVOID pvParam, BOOL bCompleted)
+{
+	ASSERT(pvParam != nullptr && pData == ((TSharedItem*)pvParam)->Ptr());
+
+	((TSharedItem*)pvParam)->Release();
+}
+
 TBuffer* TBuffer::Construct(CBufferPool& pool, ULONG_PTR dwID)
 {
 	ASSERT(dwID != 0);
@@ -399,6 +534,19 @@ void CBufferPool::Prepare()
 
 	m_bfCache.Reset(m_dwMaxCacheSize);
 	m_lsFreeBuffer.Reset(m_dwBufferPoolSize);
+
+	/* 预先创建的 TBuffer 释放时间提前一个锁定周期，可以立即被获取使用 */
+	DWORD dwPrealloc = min(m_dwBufferPoolPrealloc, m_dwBufferPoolSize);
+
+	for(DWORD i = 0; i < dwPrealloc; i++)
+	{
+		TBuffer* pBuffer = TBuffer::Construct(*this, (ULONG_PTR)-1);
+
+		pBuffer->Reset();
+		pBuffer->freeTime -= m_dwBufferLockTime;
+
+		VERIFY(m_lsFreeBuffer.TryPut(pBuffer));
+	}
 }
 
 void CBufferPool::Clear()
@@ -30,6 +30,8 @@
 #include "PrivateHeap.h"
 #include "CriSec.h"
 
+#include <sys/uio.h>
+
 struct TItem
 {
 	template<typename T> friend struct	TSimpleList;
@@ -54,6 +56,19 @@ public:
 	int			Capacity()	const	{return capacity;}
 	bool		IsEmpty	()	const	{return Size()	 == 0;}
 	bool		IsFull	()	const	{return Remain() == 0;}
+	/* 是否引用外部缓冲区（外部缓冲区数据块不回收到对象池，销毁时调用释放函数） */
+	bool		IsReference()	const	{return head != (const BYTE*)(this + 1);}
+	/* 是否文件区域数据块（数据不在内存中，Ptr() 无效，只能通过 SendFile() 发送） */
+	bool		IsFile	()	const	{return head == nullptr;}
+
+	/* 使用 sendfile() 把文件区域数据块的数据发送到 fdOut，返回值与 sendfile() 相同（不修改数据块，由调用方根据发送结果调用 Reduce()） */
+	SSIZE_T		SendFile(FD fdOut) const;
+	/* 文件区域数据块的当前窗口发送完后移动到下一个窗口，返回新窗口的长度（区域已全部发送时返回 0） */
+	int			NextFileWindow();
+
+public:
+	/* 外部缓冲区释放函数（bCompleted 为 true 表示缓冲区数据已全部被取走） */
+	typedef VOID (CALLBACK *Fn_Release)(const BYTE* pData, int length, PVOID pvParam, BOOL bCompleted);
 
 public:
 	operator		BYTE*	()			{return Ptr();}
@@ -65,25 +80,58 @@ public:
 							BYTE*	pData		= nullptr,
 							int		length		= 0);
 
+	/* 创建引用外部缓冲区的数据块（不拷贝数据，数据块销毁时调用 fnRelease 通知外部缓冲区不再被引用） */
+	static TItem* Construct(CPrivateHeap& heap,
+							const BYTE*	pData,
+							int			length,
+							Fn_Release	fnRelease,
+							PVOID		pvParam		= nullptr);
+
+	/*
+	* 创建文件区域数据块（不读取文件数据，数据块接管 fd 并在销毁时关闭）：
+	* 数据块的 head 为 nullptr，begin / end 为相对于当前窗口起始位置的偏移，从而复用 Size() / Reduce() 等数据长度操作；
+	* 区域长度超过 MAX_FILE_WINDOW_SIZE 时分成多个窗口，数据块每次只呈现一个窗口的长度（保持 32 位的数据长度）
+	*/
+	static TItem* ConstructFile(CPrivateHeap& heap, FD fd, LLONG llOffset, LLONG llLength);
+
 	static void Destruct(TItem* pItem);
 
+private:
+	struct TFileRegion
+	{
+		FD		fd;
+		LLONG	offset;
+		/* 当前窗口之后尚未呈现的区域长度 */
+		LLONG	remain;
+	};
+
+	static VOID CALLBACK ReleaseFile(const BYTE* pData, int length, PVOID pvParam, BOOL bCompleted);
+
 private:
 	friend TItem* ConstructObject<>(TItem*, CPrivateHeap&, BYTE*&, int&, BYTE*&, int&);
+	friend TItem* ConstructObject<>(TItem*, CPrivateHeap&, BYTE*&, int&, Fn_Release&, PVOID&);
 	friend void DestructObject<>(TItem*);
 
 	TItem(CPrivateHeap& hp, BYTE* pHead, int cap = DEFAULT_ITEM_CAPACITY, BYTE* pData = nullptr, int length = 0)
-	: heap(hp), head(pHead), begin(pHead), end(pHead), capacity(cap), next(nullptr), last(nullptr)
+	: heap(hp), head(pHead), begin(pHead), end(pHead), capacity(cap), next(nullptr), last(nullptr), fnRelease(nullptr), pvParam(nullptr)
 	{
 		if(pData != nullptr && length != 0)
 			Cat(pData, length);
 	}
 
+	TItem(CPrivateHeap& hp, BYTE* pData, int length, Fn_Release fnRel, PVOID pvPar)
+	: heap(hp), head(pData), begin(pData), end(pData + length), capacity(length), next(nullptr), last(nullptr), fnRelease(fnRel), pvParam(pvPar)
+	{
+	}
+
 	~TItem() {}
 
 	DECLARE_NO_COPY_CLASS(TItem)
 
 public:
 	static const DWORD DEFAULT_ITEM_CAPACITY;
+	/* 文件区域数据块的最大窗口长度 */
+	static const int MAX_FILE_WINDOW_SIZE;
 
 private:
 	CPrivateHeap& heap;
@@ -96,6 +144,9 @@ private:
 	BYTE*	head;
 	BYTE*	begin;
 	BYTE*	end;
+
+	Fn_Release	fnRelease;
+	PVOID		pvParam;
 };
 
 template<class T> struct TSimpleList
@@ -251,14 +302,49 @@ private:
 	T*	pBack;
 };
 
+/* 当前线程的序号（线程首次调用时分配，用于把线程固定映射到缓存槽） */
+inline UINT GetThreadSequence()
+{
+	static volatile UINT s_uiSeq			= 0;
+	static thread_local const UINT t_uiSeq	= ::InterlockedIncrement(&s_uiSeq);
+
+	return t_uiSeq;
+}
+
 template<class T> class CNodePoolT
 {
+private:
+
+	/*
+	* 线程缓存槽（magazine）：线程按线程序号固定映射到一个缓存槽，优先在缓存槽中存取 T，
+	* 缓存槽为空或已满时才与共享的 m_lsFreeItem 批量交换，避免所有线程竞争 m_lsFreeItem 的序号计数器；
+	* 缓存槽的容量计入对象池大小，空闲的缓存槽由 FlushIdleCache() 归还共享空闲队列
+	*/
+	struct TMagazine
+	{
+		CSpinGuard	cs;
+		DWORD		count;
+		T**			items;
+		ULLONG		hits;
+		ULLONG		misses;
+		ULLONG		ops;
+		ULLONG		mark;
+
+		char		pack[CACHE_LINE];
+
+		TMagazine() : count(0), items(nullptr), hits(0), misses(0), ops(0), mark(0) {}
+	};
+
 public:
 	void PutFreeItem(T* pItem)
 	{
 		ASSERT(pItem != nullptr);
 
-		if(!m_lsFreeItem.TryPut(pItem))
+		if(pItem->IsReference())
+			T::Destruct(pItem);
+		else if(m_pMagazines)
+			PutCachedItem(pItem);
+		else if(!m_lsFreeItem.TryPut(pItem))
 			T::Destruct(pItem);
 	}
 
@@ -276,7 +362,7 @@ public:
 	{
 		T* pItem = nullptr;
 
-		if(m_lsFreeItem.TryGet(&pItem))
+		if(m_pMagazines ? PickCachedItem(&pItem) : m_lsFreeItem.TryGet(&pItem))
 			pItem->Reset();
 		else
 			pItem = T::Construct(m_heap, m_dwItemCapacity);
@@ -286,11 +372,62 @@ public:
 
 	void Prepare()
 	{
-		m_lsFreeItem.Reset(m_dwPoolSize);
+		if(m_dwCacheSize > 0)
+		{
+			DWORD dwCount = 1;
+
+			while(dwCount < (DWORD)PROCESSOR_COUNT * 2)
+				dwCount <<= 1;
+
+			/* 缓存槽中的对象计入对象池大小：所有缓存槽最多占用对象池的一半，其余留给共享空闲队列 */
+			m_dwMagazineSize = min(m_dwCacheSize, m_dwPoolSize / 2 / dwCount);
+
+			if(m_dwMagazineSize > 0)
+			{
+				m_dwMagazines	= dwCount;
+				m_pMagazines	= make_unique<TMagazine[]>(m_dwMagazines);
+				m_pMagItems		= make_unique<T*[]>(m_dwMagazines * m_dwMagazineSize);
+
+				for(DWORD i = 0; i < m_dwMagazines; i++)
+					m_pMagazines[i].items = &m_pMagItems[i * m_dwMagazineSize];
+
+				m_dwCacheCheckTime = ::TimeGetTime();
+			}
+		}
+
+		m_lsFreeItem.Reset(m_dwPoolSize - m_dwMagazines * m_dwMagazineSize);
+
+		/* 预先创建对象放入空闲队列，并写入数据缓冲区使其物理内存在启动阶段就绪，避免首批连接触发缺页 */
+		DWORD dwPrealloc = min(m_dwPoolPrealloc, m_lsFreeItem.Size());
+
+		for(DWORD i = 0; i < dwPrealloc; i++)
+		{
+			T* pItem = T::Construct(m_heap, m_dwItemCapacity);
+			memset(pItem->head, 0, pItem->capacity);
+
+			VERIFY(m_lsFreeItem.TryPut(pItem));
+		}
 	}
 
 	void Clear()
 	{
+		if(m_pMagazines)
+		{
+			for(DWORD i = 0; i < m_dwMagazines; i++)
+			{
+				TMagazine& mag = m_pMagazines[i];
+
+				while(mag.count > 0)
+					T::Destruct(mag.items[--mag.count]);
+			}
+
+			m_pMagazines.reset();
+			m_pMagItems.reset();
+
+			m_dwMagazines	 = 0;
+			m_dwMagazineSize = 0;
+		}
+
 		T* pItem = nullptr;
 
 		while(m_lsFreeItem.TryGet(&pItem))
@@ -299,16 +436,124 @@ public:
 		VERIFY(m_lsFreeItem.IsEmpty());
 		m_lsFreeItem.Reset();
 
-		m_heap.Reset();
+		/* 仍有数据块未归还时私有堆无法重置（内存区保留到私有堆销毁） */
+		if(!m_heap.Reset())
+		{
+			TRACE("CNodePoolT(0x%p) clear with items in use", this);
+		}
+	}
+
+	/* 获取线程缓存槽的命中和未命中次数（未命中时从 m_lsFreeItem 批量补充） */
+	void GetCacheStat(ULLONG& ullHits, ULLONG& ullMisses)
+	{
+		ullHits		= 0;
+		ullMisses	= 0;
+
+		for(DWORD i = 0; i < m_dwMagazines; i++)
+		{
+			ullHits		+= m_pMagazines[i].hits;
+			ullMisses	+= m_pMagazines[i].misses;
+		}
+	}
+
+	/*
+	* 把空闲缓存槽中的对象全部归还共享空闲队列，避免不再活动的线程长期占用对象：
+	* 由组件的定时器周期调用，每 DEFAULT_CACHE_IDLE_TIME 毫秒检查一次，期间没有被存取过的缓存槽视为空闲
+	*/
+	void FlushIdleCache()
+	{
+		if(m_dwMagazines == 0 || ::GetTimeGap32(m_dwCacheCheckTime) < DEFAULT_CACHE_IDLE_TIME)
+			return;
+
+		m_dwCacheCheckTime = ::TimeGetTime();
+
+		for(DWORD i = 0; i < m_dwMagazines; i++)
+		{
+			TMagazine& mag = m_pMagazines[i];
+			CSpinLock locallock(mag.cs);
+
+			if(mag.ops == mag.mark && mag.count > 0)
+			{
+				FlushMagazine(mag, mag.count);
+				++mag.ops;
+			}
+
+			mag.mark = mag.ops;
+		}
+	}
+
+private:
+	TMagazine& GetMagazine() {return m_pMagazines[::GetThreadSequence() & (m_dwMagazines - 1)];}
+
+	BOOL PickCachedItem(T** ppItem)
+	{
+		TMagazine& mag = GetMagazine();
+		CSpinLock locallock(mag.cs);
+
+		++mag.ops;
+
+		if(mag.count > 0)
+			++mag.hits;
+		else
+		{
+			++mag.misses;
+
+			DWORD dwBatch = max(m_dwMagazineSize / 2, (DWORD)1);
+
+			while(mag.count < dwBatch && m_lsFreeItem.TryGet(&mag.items[mag.count]))
+				++mag.count;
+
+			if(mag.count == 0)
+				return FALSE;
+		}
+
+		*ppItem = mag.items[--mag.count];
+
+		return TRUE;
+	}
+
+	void PutCachedItem(T* pItem)
+	{
+		TMagazine& mag = GetMagazine();
+		CSpinLock locallock(mag.cs);
+
+		++mag.ops;
+
+		if(mag.count == m_dwMagazineSize)
+			FlushMagazine(mag, max(m_dwMagazineSize / 2, (DWORD)1));
+
+		mag.items[mag.count++] = pItem;
+	}
+
+	/* 把缓存槽底部的 dwBatch 个对象归还共享空闲队列（队列已满时销毁），调用方持有缓存槽的锁 */
+	void FlushMagazine(TMagazine& mag, DWORD dwBatch)
+	{
+		for(DWORD i = 0; i < dwBatch; i++)
+		{
+			if(!m_lsFreeItem.TryPut(mag.items[i]))
+				T::Destruct(mag.items[i]);
+		}
+
+		mag.count -= dwBatch;
+		memmove(mag.items, mag.items + dwBatch, mag.count * sizeof(T*));
 	}
 
 public:
 	void SetItemCapacity(DWORD dwItemCapacity)	{m_dwItemCapacity	= dwItemCapacity;}
 	void SetPoolSize	(DWORD dwPoolSize)		{m_dwPoolSize		= dwPoolSize;}
 	void SetPoolHold	(DWORD dwPoolHold)		{m_dwPoolHold		= dwPoolHold;}
+	/* 设置每个线程缓存槽的容量（0 则不使用线程缓存槽，必须在 Prepare() 之前设置；实际容量受对象池大小限制） */
+	void SetCacheSize	(DWORD dwCacheSize)		{m_dwCacheSize		= dwCacheSize;}
+	/* 设置 Prepare() 时预先创建的对象数量（不超过对象池大小） */
+	void SetPoolPrealloc(DWORD dwPoolPrealloc)	{m_dwPoolPrealloc	= dwPoolPrealloc;}
+	/* 设置对象池内存是否在各 NUMA 节点间交错分配（必须在 Prepare() 之前设置） */
+	void SetNumaInterleave(BOOL bInterleave)	{m_heap.SetNumaInterleave(bInterleave);}
 	DWORD GetItemCapacity	()					{return m_dwItemCapacity;}
 	DWORD GetPoolSize		()					{return m_dwPoolSize;}
 	DWORD GetPoolHold		()					{return m_dwPoolHold;}
+	DWORD GetCacheSize		()					{return m_dwCacheSize;}
+	DWORD GetPoolPrealloc	()					{return m_dwPoolPrealloc;}
+	BOOL IsNumaInterleave	()					{return m_heap.IsNumaInterleave();}
 
 	CPrivateHeap& GetPrivateHeap()				{return m_heap;}
 
@@ -319,6 +564,11 @@ public:
 				: m_dwPoolSize(dwPoolSize)
 				, m_dwPoolHold(dwPoolHold)
 				, m_dwItemCapacity(dwItemCapacity)
+				, m_dwCacheSize(0)
+				, m_dwPoolPrealloc(0)
+				, m_dwMagazines(0)
+				, m_dwMagazineSize(0)
+				, m_dwCacheCheckTime(0)
 	{
 	}
 
@@ -330,6 +580,7 @@ public:
 	static const DWORD DEFAULT_ITEM_CAPACITY;
 	static const DWORD DEFAULT_POOL_SIZE;
 	static const DWORD DEFAULT_POOL_HOLD;
+	static const DWORD DEFAULT_CACHE_IDLE_TIME;
 
 private:
 	CPrivateHeap	m_heap;
@@ -337,13 +588,22 @@ private:
 	DWORD			m_dwItemCapacity;
 	DWORD			m_dwPoolSize;
 	DWORD			m_dwPoolHold;
+	DWORD			m_dwCacheSize;
+	DWORD			m_dwPoolPrealloc;
 
 	CRingPool<T>	m_lsFreeItem;
+
+	DWORD					m_dwMagazines;
+	DWORD					m_dwMagazineSize;
+	DWORD					m_dwCacheCheckTime;
+	unique_ptr<TMagazine[]>	m_pMagazines;
+	unique_ptr<T*[]>		m_pMagItems;
 };
 
 template<class T> const DWORD CNodePoolT<T>::DEFAULT_ITEM_CAPACITY	= TItem::DEFAULT_ITEM_CAPACITY;
 template<class T> const DWORD CNodePoolT<T>::DEFAULT_POOL_SIZE		= 1200;
 template<class T> const DWORD CNodePoolT<T>::DEFAULT_POOL_HOLD		= 1200;
+template<class T> const DWORD CNodePoolT<T>::DEFAULT_CACHE_IDLE_TIME	= 1000;
 
 using CItemPool = CNodePoolT<TItem>;
 
@@ -358,9 +618,21 @@ public:
 	int Cat		(const TItemList& other);
 	int Fetch	(BYTE* pData, int length);
 	int Peek	(BYTE* pData, int length);
-	int Reduce	(int length);
+	/* 文件区域数据块移动到下一个窗口时 pExpand 返回列表增加的数据长度 */
+	int Reduce	(int length, int* pExpand = nullptr);
 	void Release();
 
+	/* 把外部缓冲区以引用方式追加到尾部（不拷贝数据，数据被取走或列表释放时调用 fnRelease） */
+	int Attach	(const BYTE* pData, int length, TItem::Fn_Release fnRelease, PVOID pvParam = nullptr);
+	/* 把文件区域追加到尾部（列表接管 fd，只能用于发送队列，发送时使用 sendfile()），返回第一个窗口的长度 */
+	int AttachFile(FD fd, LLONG llOffset, LLONG llLength);
+
+	/*
+	* 把前部（最多 iCount 个）数据块填充到 iovec 数组（用于 writev() 批量发送），返回填充的数据块数量，iLength 返回数据总长度
+	* （遇到文件区域数据块时停止，前部为文件区域数据块时返回 0）
+	*/
+	int Gather	(iovec iov[], int iCount, int& iLength) const;
+
 public:
 	TItemList(CItemPool& pool) : itPool(pool)
 	{
@@ -466,6 +738,22 @@ public:
 		return cat;
 	}
 
+	int Attach(const BYTE* pData, int length, TItem::Fn_Release fnRelease, PVOID pvParam = nullptr)
+	{
+		int cat = __super::Attach(pData, length, fnRelease, pvParam);
+		this->length += cat;
+
+		return cat;
+	}
+
+	int AttachFile(FD fd, LLONG llOffset, LLONG llLength)
+	{
+		int cat = __super::AttachFile(fd, llOffset, llLength);
+		this->length += cat;
+
+		return cat;
+	}
+
 	int Fetch(BYTE* pData, int length)
 	{
 		int fetch	  = __super::Fetch(pData, length);
@@ -476,8 +764,9 @@ public:
 
 	int Reduce(int length)
 	{
-		int reduce	  = __super::Reduce(length);
-		this->length -= reduce;
+		int expand	  = 0;
+		int reduce	  = __super::Reduce(length, &expand);
+		this->length += expand - reduce;
 
 		return reduce;
 	}
@@ -568,6 +857,37 @@ private:
 	TItem*		m_pItem;
 };
 
+/* 引用计数的只读共享数据块（同一份数据发送给多个连接时，每个连接以引用方式把它加入发送队列，最后一个引用释放时销毁） */
+struct TSharedItem
+{
+public:
+	static TSharedItem* Construct(CPrivateHeap& heap, int length);
+	static void Destruct(TSharedItem* pItem);
+
+	/* 引用释放函数（与 TItem::Fn_Release 兼容，pvParam 为 TSharedItem 对象） */
+	static VOID CALLBACK ReleaseRef(const BYTE* pData, int length, PVOID pvParam, BOOL bCompleted);
+
+	void AddRef()	{::InterlockedIncrement(&ref);}
+	void Release()	{if(::InterlockedDecrement(&ref) == 0) Destruct(this);}
+
+	BYTE*	Ptr	()			{return (BYTE*)(this + 1);}
+	int		Size()	const	{return length;}
+
+private:
+	friend TSharedItem* ConstructObject<>(TSharedItem*, CPrivateHeap&, int&);
+	friend void DestructObject<>(TSharedItem*);
+
+	TSharedItem(CPrivateHeap& hp, int len) : heap(hp), ref(1), length(len) {}
+	~TSharedItem() {ASSERT(ref == 0);}
+
+	DECLARE_NO_COPY_CLASS(TSharedItem)
+
+private:
+	CPrivateHeap&	heap;
+	volatile int	ref;
+	int				length;
+};
+
 class CBufferPool;
 
 struct TBuffer
@@ -661,6 +981,12 @@ public:
 	void SetBufferPoolSize	(DWORD dwBufferPoolSize)	{m_dwBufferPoolSize	= dwBufferPoolSize;}
 	void SetBufferPoolHold	(DWORD dwBufferPoolHold)	{m_dwBufferPoolHold	= dwBufferPoolHold;}
 
+	/* 设置 Prepare() 时预先创建的 TBuffer 和 TItem 数量（分别不超过各自的对象池大小） */
+	void SetBufferPoolPrealloc	(DWORD dwBufferPoolPrealloc)	{m_dwBufferPoolPrealloc = dwBufferPoolPrealloc;}
+	void SetItemPoolPrealloc	(DWORD dwItemPoolPrealloc)		{m_itPool.SetPoolPrealloc(dwItemPoolPrealloc);}
+	/* 设置缓冲池内存是否在各 NUMA 节点间交错分配（必须在 Prepare() 之前设置） */
+	void SetNumaInterleave		(BOOL bInterleave)				{m_heap.SetNumaInterleave(bInterleave); m_itPool.SetNumaInterleave(bInterleave);}
+
 	DWORD GetItemCapacity	()							{return m_itPool.GetItemCapacity();}
 	DWORD GetItemPoolSize	()							{return m_itPool.GetPoolSize();}
 	DWORD GetItemPoolHold	()							{return m_itPool.GetPoolHold();}
@@ -670,6 +996,10 @@ public:
 	DWORD GetBufferPoolSize	()							{return m_dwBufferPoolSize;}
 	DWORD GetBufferPoolHold	()							{return m_dwBufferPoolHold;}
 
+	DWORD GetBufferPoolPrealloc	()						{return m_dwBufferPoolPrealloc;}
+	DWORD GetItemPoolPrealloc	()						{return m_itPool.GetPoolPrealloc();}
+	BOOL IsNumaInterleave		()						{return m_heap.IsNumaInterleave();}
+
 	TBuffer* operator []	(ULONG_PTR dwID)			{return FindCacheBuffer(dwID);}
 
 public:
@@ -681,6 +1011,7 @@ public:
 	, m_dwBufferPoolHold(dwPoolHold)
 	, m_dwBufferLockTime(dwLockTime)
 	, m_dwMaxCacheSize(dwMaxCacheSize)
+	, m_dwBufferPoolPrealloc(0)
 	{
 
 	}
@@ -707,6 +1038,7 @@ private:
 	DWORD			m_dwBufferLockTime;
 	DWORD			m_dwBufferPoolSize;
 	DWORD			m_dwBufferPoolHold;
+	DWORD			m_dwBufferPoolPrealloc;
 
 	CPrivateHeap	m_heap;
 	CItemPool		m_itPool;
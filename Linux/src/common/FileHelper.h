@@ -29,6 +29,7 @@
 #include <unistd.h>
 #include <sys/uio.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 
 #define INVALID_MAP_ADDR	((PBYTE)(MAP_FAILED))
 
@@ -62,6 +63,9 @@ public:
 	BOOL IsValid()	{return IS_VALID_FD(m_fd);}
 	operator FD ()	{return m_fd;}
 
+	/* 交出文件描述符的所有权（本对象不再关闭该文件） */
+	FD Detach()		{FD fd = m_fd; m_fd = INVALID_FD; return fd;}
+
 	BOOL IsExist()	{return IsValid();}
 
 	BOOL IsDirectory();
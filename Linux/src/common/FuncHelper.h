@@ -334,6 +334,12 @@ inline T InterlockedCompareExchange(volatile T* _Tgt, T _Value, T _Exp, BOOL _bW
 	return _Exp;
 }
 
+template<typename T, typename V>
+inline T InterlockedExchange(volatile T* _Tgt, V _Value, memory_order m = memory_order_seq_cst)
+{
+	return __atomic_exchange_n(_Tgt, (T)_Value, m);
+}
+
 template<typename T, typename V, typename E, typename = enable_if_t<is_same<decay_t<T>, decay_t<V>>::value && is_same<decay_t<V>, decay_t<E>>::value>>
 inline V* InterlockedCompareExchangePointer(volatile T** _Tgt, V* _Value, E* _Exp, BOOL _bWeek = FALSE, memory_order m1 = memory_order_seq_cst, memory_order m2 = memory_order_seq_cst)
 {
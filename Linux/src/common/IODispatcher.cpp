@@ -27,7 +27,22 @@
 #include <signal.h>
 #include <pthread.h>
 
-BOOL CIODispatcher::Start(IIOHandler* pHandler, int iWorkerMaxEvents, int iWorkers, LLONG llTimerInterval)
+/* io_uring 模式下 multishot poll 的 user_data 标志位（注册对象地址至少按 4 字节对齐） */
+#define _URING_MULTISHOT_FLAG		((UINT64)0x01)
+/* io_uring 模式下 poll 更新/删除请求的 user_data 标志位（请求成功时不产生完成事件，失败时据此重试） */
+#define _URING_CONTROL_FLAG			((UINT64)0x02)
+/* io_uring 模式下完成式收发请求的 user_data 标志位（用户态地址不超过 56 位，高 8 位存放标志位和请求类型） */
+#define _URING_COMPLETION_FLAG		((UINT64)1 << 63)
+#define _URING_OP_SHIFT				56
+#define _URING_PTR_MASK				(((UINT64)1 << _URING_OP_SHIFT) - 1)
+#define _URING_IO_USER_DATA(pv, op)	((UINT64)(UINT_PTR)(pv) | _URING_COMPLETION_FLAG | ((UINT64)(op) << _URING_OP_SHIFT))
+#define _URING_POLL_EVENTS(mask)	((mask) & ~(EPOLLONESHOT | EPOLLET | EPOLLEXCLUSIVE))
+/* io_uring 模式下跨线程提交 multishot accept 请求的内部操作类型（EPOLL_CTL_XXX 以外的值） */
+#define _URING_CTL_ACCEPT			0
+#define _URING_MIN_ENTRIES			256
+#define _URING_MAX_ENTRIES			4096
+
+BOOL CIODispatcher::Start(IIOHandler* pHandler, int iWorkerMaxEvents, int iWorkers, LLONG llTimerInterval, BOOL bSharded, BOOL bIoUring)
 {
 	ASSERT_CHECK_EINVAL(pHandler && iWorkerMaxEvents >= 0 && iWorkers >= 0);
 	CHECK_ERROR(!HasStarted(), ERROR_INVALID_STATE);
@@ -35,46 +50,55 @@ BOOL CIODispatcher::Start(IIOHandler* pHandler, int iWorkerMaxEvents, int iWorke
 	if(iWorkerMaxEvents == 0)	iWorkerMaxEvents = DEF_WORKER_MAX_EVENTS;
 	if(iWorkers == 0)			iWorkers = DEFAULT_WORKER_THREAD_COUNT;
 
+	/* io_uring 的提交队列由分片的工作线程独占，因此 io_uring 模式总是分片的 */
+	m_bIoUring	 = bIoUring && CIOUring::IsSupported();
+	m_bSharded	 = bSharded || m_bIoUring;
 	m_iMaxEvents = iWorkerMaxEvents;
 	m_iWorkers	 = iWorkers;
+	m_iShards	 = m_bSharded ? iWorkers : 1;
 	m_pHandler	 = pHandler;
+	m_pShards	 = make_unique<TDispShard[]>(m_iShards);
 
-	m_epoll = epoll_create1(EPOLL_CLOEXEC);
-	CHECK_ERROR_FD(m_epoll);
-
-	m_evCmd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
-
-	if(IS_INVALID_FD(m_evCmd))
-		goto START_ERROR;
-
-	if(!VERIFY(AddFD(m_evCmd, EPOLLIN | EPOLLET, &m_evCmd)))
-		goto START_ERROR;
+	for(int i = 0; i < m_iShards; i++)
+	{
+		if(!CreateShard(m_pShards[i]))
+			goto START_ERROR;
+	}
 
 	m_evExit = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC | EFD_SEMAPHORE);
 
 	if(IS_INVALID_FD(m_evExit))
 		goto START_ERROR;
 
-	if(!VERIFY(AddFD(m_evExit, EPOLLIN, &m_evExit)))
-		goto START_ERROR;
-
-	if(llTimerInterval > 0)
+	for(int i = 0; i < m_iShards; i++)
 	{
-		m_evTimer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);;
-
-		if(IS_INVALID_FD(m_evTimer))
+		if(!VERIFY(AddFD(i, m_evExit, EPOLLIN, &m_evExit)))
 			goto START_ERROR;
+	}
 
+	/* 每个分片拥有独立的定时器，定时事件在分片自己的工作线程中处理 */
+	if(llTimerInterval > 0)
+	{
 		itimerspec its;
 
 		::MillisecondToTimespec(llTimerInterval, its.it_value);
 		::MillisecondToTimespec(llTimerInterval, its.it_interval);
 
-		if(!VERIFY_IS_NO_ERROR(timerfd_settime(m_evTimer, 0, &its, nullptr)))
-			goto START_ERROR;
+		for(int i = 0; i < m_iShards; i++)
+		{
+			TDispShard& shard = m_pShards[i];
 
-		if(!VERIFY(AddFD(m_evTimer, EPOLLIN | EPOLLET, &m_evTimer)))
-			goto START_ERROR;
+			shard.evTimer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+			if(IS_INVALID_FD(shard.evTimer))
+				goto START_ERROR;
+
+			if(!VERIFY_IS_NO_ERROR(timerfd_settime(shard.evTimer, 0, &its, nullptr)))
+				goto START_ERROR;
+
+			if(!VERIFY(AddFD(i, shard.evTimer, EPOLLIN | EPOLLET, &shard.evTimer)))
+				goto START_ERROR;
+		}
 	}
 
 	sigset_t ss;
@@ -87,8 +111,11 @@ BOOL CIODispatcher::Start(IIOHandler* pHandler, int iWorkerMaxEvents, int iWorke
 
 	for(int i = 0; i < m_iWorkers; i++)
 	{
-		if(!VERIFY(m_pWorkers[i].Start(this, &CIODispatcher::WorkerProc)))
+		if(!VERIFY(m_pWorkers[i].Start(this, &CIODispatcher::WorkerProc, (PVOID)&m_pShards[i % m_iShards])))
 			goto START_ERROR;
+
+		if(m_bIoUring)
+			m_pShards[i].owner = m_pWorkers[i].GetThreadID();
 	}
 
 	return TRUE;
@@ -98,6 +125,78 @@ START_ERROR:
 	return FALSE;
 }
 
+BOOL CIODispatcher::CreateShard(TDispShard& shard)
+{
+	shard.cmds.Reset(COMMAND_RING_SIZE);
+
+	if(m_bIoUring)
+	{
+		UINT uiEntries = (UINT)min(max(m_iMaxEvents * 4, _URING_MIN_ENTRIES), _URING_MAX_ENTRIES);
+
+		if(!shard.ring.Setup(uiEntries))
+			return FALSE;
+
+		shard.evCmd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+		if(IS_INVALID_FD(shard.evCmd))
+			return FALSE;
+
+		return UringCtlFD(shard, shard.evCmd, EPOLL_CTL_ADD, EPOLLIN | EPOLLET, &shard.evCmd);
+	}
+
+	shard.epoll = epoll_create1(EPOLL_CLOEXEC);
+
+	if(IS_INVALID_FD(shard.epoll))
+		return FALSE;
+
+	shard.evCmd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if(IS_INVALID_FD(shard.evCmd))
+		return FALSE;
+
+	epoll_event evt = {EPOLLIN | EPOLLET, &shard.evCmd};
+
+	return VERIFY_IS_NO_ERROR(epoll_ctl(shard.epoll, EPOLL_CTL_ADD, shard.evCmd, &evt));
+}
+
+BOOL CIODispatcher::CloseShard(TDispShard& shard)
+{
+	BOOL isOK = TRUE;
+
+	TDispCommand cmd;
+
+	while(PopCommand(shard, cmd))
+	{
+		if(cmd.type == CMD_URING_CTL)
+			delete (TUringCtl*)(cmd.lParam);
+	}
+
+	if(IS_VALID_FD(shard.evCmd))
+		isOK &= IS_NO_ERROR(close(shard.evCmd));
+
+	if(IS_VALID_FD(shard.evTimer))
+		isOK &= IS_NO_ERROR(close(shard.evTimer));
+
+	if(IS_VALID_FD(shard.epoll))
+		isOK &= IS_NO_ERROR(close(shard.epoll));
+
+	if(shard.ring.IsValid())
+		isOK &= shard.ring.Close();
+
+	shard.polls.clear();
+	shard.accepts.clear();
+
+	shard.evCmd		= INVALID_FD;
+	shard.evTimer	= INVALID_FD;
+	shard.epoll		= INVALID_FD;
+	shard.load		= 0;
+	shard.notify	= FALSE;
+	shard.owner		= 0;
+	shard.pvFired	= nullptr;
+
+	return isOK;
+}
+
 BOOL CIODispatcher::Stop(BOOL bCheck)
 {
 	if(bCheck) CHECK_ERROR(HasStarted(), ERROR_INVALID_STATE);
@@ -112,28 +211,15 @@ BOOL CIODispatcher::Stop(BOOL bCheck)
 			isOK &= m_pWorkers[i].Join();
 	}
 
-	if(!m_queue.IsEmpty())
+	if(m_pShards)
 	{
-		TDispCommand* pCmd = nullptr;
-
-		while(m_queue.PopFront(&pCmd))
-			TDispCommand::Destruct(pCmd);
-
-		VERIFY(m_queue.IsEmpty());
+		for(int i = 0; i < m_iShards; i++)
+			isOK &= CloseShard(m_pShards[i]);
 	}
 
 	if(IS_VALID_FD(m_evExit))
 		isOK &= IS_NO_ERROR(close(m_evExit));
 
-	if(IS_VALID_FD(m_evCmd))
-		isOK &= IS_NO_ERROR(close(m_evCmd));
-
-	if(IS_VALID_FD(m_evTimer))
-		isOK &= IS_NO_ERROR(close(m_evTimer));
-
-	if(IS_VALID_FD(m_epoll))
-		isOK &= IS_NO_ERROR(close(m_epoll));
-
 	Reset();
 
 	return isOK;
@@ -143,39 +229,342 @@ VOID CIODispatcher::Reset()
 {
 	m_iWorkers	= 0;
 	m_iMaxEvents= 0;
+	m_iShards	= 0;
+	m_bSharded	= FALSE;
+	m_bIoUring	= FALSE;
+	m_iNextShard= 0;
 	m_pHandler	= nullptr;
 	m_pWorkers	= nullptr;
-	m_epoll		= INVALID_FD;
-	m_evCmd		= INVALID_FD;
+	m_pShards	= nullptr;
 	m_evExit	= INVALID_FD;
-	m_evTimer	= INVALID_FD;
 }
 
 BOOL CIODispatcher::SendCommand(USHORT t, UINT_PTR wp, UINT_PTR lp)
 {
-	return SendCommand(TDispCommand::Construct(t, wp, lp));
+	return SendShardCommand(NextShard(), t, wp, lp);
 }
 
-BOOL CIODispatcher::SendCommand(TDispCommand* pCmd)
+BOOL CIODispatcher::SendShardCommand(int iShard, USHORT t, UINT_PTR wp, UINT_PTR lp)
 {
-	m_queue.PushBack(pCmd);
-	return VERIFY_IS_NO_ERROR(eventfd_write(m_evCmd, 1));
+	ASSERT(iShard >= 0 && iShard < m_iShards);
+
+	TDispShard& shard = m_pShards[iShard];
+
+	PushCommand(shard, TDispCommand(t, wp, lp));
+	return NotifyShard(shard);
+}
+
+BOOL CIODispatcher::SendCommands(const TDispCommand cmds[], int iCount)
+{
+	return SendShardCommands(NextShard(), cmds, iCount);
+}
+
+BOOL CIODispatcher::SendShardCommands(int iShard, const TDispCommand cmds[], int iCount)
+{
+	ASSERT(iShard >= 0 && iShard < m_iShards);
+
+	if(iCount <= 0)
+		return TRUE;
+
+	TDispShard& shard = m_pShards[iShard];
+
+	for(int i = 0; i < iCount; i++)
+		PushCommand(shard, cmds[i]);
+
+	return NotifyShard(shard);
+}
+
+/*
+* 命令优先写入环形队列，环形队列已满或溢出队列非空时写入溢出队列，
+* 工作线程先读环形队列再读溢出队列，从而保证同一线程发送的命令按顺序处理
+*/
+VOID CIODispatcher::PushCommand(TDispShard& shard, const TDispCommand& cmd)
+{
+	if(!shard.overflow.IsEmpty() || !shard.cmds.TryPushBack(cmd))
+		shard.overflow.PushBack(cmd);
 }
 
-BOOL CIODispatcher::CtlFD(FD fd, int op, UINT mask, PVOID pv)
+BOOL CIODispatcher::PopCommand(TDispShard& shard, TDispCommand& cmd)
 {
+	return shard.cmds.PopFront(&cmd) || shard.overflow.PopFront(&cmd);
+}
+
+/* 只有工作线程已开始处理前一次唤醒后才再次写入 evCmd */
+BOOL CIODispatcher::NotifyShard(TDispShard& shard)
+{
+	if(::InterlockedExchange(&shard.notify, TRUE))
+		return TRUE;
+
+	return VERIFY_IS_NO_ERROR(eventfd_write(shard.evCmd, 1));
+}
+
+BOOL CIODispatcher::CtlFD(int iShard, FD fd, int op, UINT mask, PVOID pv)
+{
+	ASSERT(iShard >= 0 && iShard < m_iShards);
+
+	TDispShard& shard = m_pShards[iShard];
+
+	if(m_bIoUring)
+	{
+		ASSERT(pv != nullptr);
+
+		/* 提交队列只能由分片的工作线程写入，其它线程的注册操作通过命令队列转交（保持与其它命令的先后顺序） */
+		if(m_pWorkers && !::IsSelfThread(shard.owner))
+			return SendShardCommand(iShard, CMD_URING_CTL, (UINT_PTR)pv, (UINT_PTR)(new TUringCtl(fd, op, mask)));
+
+		return UringCtlFD(shard, fd, op, mask, pv);
+	}
+
 	epoll_event evt = {mask, pv};
-	return IS_NO_ERROR(epoll_ctl(m_epoll, op, fd, &evt));
+	return IS_NO_ERROR(epoll_ctl(shard.epoll, op, fd, &evt));
+}
+
+/*
+* io_uring 模式下以 poll 请求模拟 EPOLL 注册：
+* 
+* 1. 带 EPOLLONESHOT 的注册对应一次性 poll 请求；否则对应常驻的 multishot poll 请求
+* 2. 一次性 poll 触发后由 OnAfterProcessIo() 重新注册（EPOLL_CTL_MOD），此时直接提交新的 poll 请求；
+*    其它情形的 EPOLL_CTL_MOD 使用 poll 更新请求，若 poll 请求已触发则由其完成事件负责重新注册
+* 3. 所有请求只写入提交队列，由工作线程在下一次等待完成事件时一次性提交
+* 4. poll 请求的唤醒处理尚未完成时，内核会以 -EALREADY 拒绝对它的更新/删除请求，此时按最新的注册记录重试
+* 5. EPOLL_CTL_DEL 同时取消 pv 的完成式请求，被取消的请求仍会以 -ECANCELED 触发 OnIoComplete()；
+*    请求在提交时才解析 FD，因此 EPOLL_CTL_DEL 立即提交所有请求，调用者随后才能关闭 FD
+*/
+BOOL CIODispatcher::UringCtlFD(TDispShard& shard, FD fd, int op, UINT mask, PVOID pv)
+{
+	CIOUring& ring	= shard.ring;
+	UINT events		= _URING_POLL_EVENTS(mask);
+	BOOL bMulti		= !(mask & EPOLLONESHOT);
+	BOOL bFired		= (pv == shard.pvFired);
+	UINT64 ud		= (UINT64)(UINT_PTR)pv;
+	UINT64 udMulti	= ud | _URING_MULTISHOT_FLAG;
+
+	if(bFired) shard.pvFired = nullptr;
+
+	auto it			= shard.polls.find(pv);
+	BOOL bExist		= (it != shard.polls.end());
+	BOOL bWasMulti	= (bExist && it->second.multi);
+
+	if(op == EPOLL_CTL_MOD && bExist && bWasMulti == bMulti && !bFired)
+	{
+		it->second.events = events;
+
+		UINT64 udTarget = bMulti ? udMulti : ud;
+		return ring.PrepPollUpdate(udTarget, events, bMulti, udTarget | _URING_CONTROL_FLAG);
+	}
+
+	if(bExist)
+	{
+		shard.polls.erase(it);
+
+		if(bWasMulti || !bFired)
+		{
+			UINT64 udTarget = bWasMulti ? udMulti : ud;
+
+			if(!ring.PrepPollRemove(udTarget, udTarget | _URING_CONTROL_FLAG))
+				return FALSE;
+		}
+	}
+
+	if(op == EPOLL_CTL_DEL)
+	{
+		if(!ring.PrepCancel(_URING_IO_USER_DATA(pv, DISP_IO_OP_RECV)) || !ring.PrepCancel(_URING_IO_USER_DATA(pv, DISP_IO_OP_SEND)))
+			return FALSE;
+
+		if(shard.accepts.erase(pv) > 0 && !ring.PrepCancel(_URING_IO_USER_DATA(pv, DISP_IO_OP_ACCEPT)))
+			return FALSE;
+
+		/* 请求在提交时才解析 FD，必须在调用者关闭 FD 之前提交，以免请求作用于复用该 FD 的新连接 */
+		return !IS_HAS_ERROR(ring.Submit());
+	}
+
+	shard.polls.emplace(pv, TUringPoll {fd, events, bMulti});
+
+	return ring.PrepPollAdd(fd, events, bMulti ? udMulti : ud, bMulti);
+}
+
+BOOL CIODispatcher::UringRearm(TDispShard& shard, PVOID pv)
+{
+	auto it = shard.polls.find(pv);
+
+	if(it == shard.polls.end() || !it->second.multi)
+		return FALSE;
+
+	return shard.ring.PrepPollAdd(it->second.fd, it->second.events, (UINT64)(UINT_PTR)pv | _URING_MULTISHOT_FLAG, TRUE);
+}
+
+BOOL CIODispatcher::UringRetryCtl(TDispShard& shard, UINT64 ud)
+{
+	BOOL bMulti	= (ud & _URING_MULTISHOT_FLAG);
+	auto it		= shard.polls.find((PVOID)(UINT_PTR)(ud & ~_URING_MULTISHOT_FLAG));
+
+	/* 注册记录仍与目标 poll 请求对应则重试更新（使用最新的关注事件），否则重试删除 */
+	if(it != shard.polls.end() && it->second.multi == bMulti)
+		return shard.ring.PrepPollUpdate(ud, it->second.events, bMulti, ud | _URING_CONTROL_FLAG);
+
+	return shard.ring.PrepPollRemove(ud, ud | _URING_CONTROL_FLAG);
+}
+
+BOOL CIODispatcher::PostRecv(int iShard, FD fd, PVOID pBuffer, int iLength, PVOID pv)
+{
+	ASSERT(m_bIoUring && iShard >= 0 && iShard < m_iShards);
+
+	TDispShard& shard = m_pShards[iShard];
+	ASSERT(::IsSelfThread(shard.owner));
+
+	return shard.ring.PrepRecv(fd, pBuffer, (UINT)iLength, 0, _URING_IO_USER_DATA(pv, DISP_IO_OP_RECV));
+}
+
+BOOL CIODispatcher::PostSend(int iShard, FD fd, const msghdr* pMsg, PVOID pv)
+{
+	ASSERT(m_bIoUring && iShard >= 0 && iShard < m_iShards);
+
+	TDispShard& shard = m_pShards[iShard];
+	ASSERT(::IsSelfThread(shard.owner));
+
+	return shard.ring.PrepSendMsg(fd, pMsg, MSG_NOSIGNAL, _URING_IO_USER_DATA(pv, DISP_IO_OP_SEND));
+}
+
+BOOL CIODispatcher::SetupRecvBuffers(int iShard, int iCount)
+{
+	ASSERT(m_bIoUring && iShard >= 0 && iShard < m_iShards);
+
+	return m_pShards[iShard].ring.SetupBufRing((UINT)iCount);
+}
+
+VOID CIODispatcher::ProvideRecvBuffer(int iShard, PVOID pBuffer, int iLength, int iBufferID)
+{
+	ASSERT(m_bIoUring && iShard >= 0 && iShard < m_iShards);
+
+	m_pShards[iShard].ring.ProvideBuffer(pBuffer, (UINT)iLength, (USHORT)iBufferID);
+}
+
+BOOL CIODispatcher::PostAccept(int iShard, FD fd, PVOID pv)
+{
+	ASSERT(m_bIoUring && iShard >= 0 && iShard < m_iShards);
+
+	TDispShard& shard = m_pShards[iShard];
+
+	if(m_pWorkers && !::IsSelfThread(shard.owner))
+		return SendShardCommand(iShard, CMD_URING_CTL, (UINT_PTR)pv, (UINT_PTR)(new TUringCtl(fd, _URING_CTL_ACCEPT, 0)));
+
+	return UringAccept(shard, fd, pv);
+}
+
+BOOL CIODispatcher::UringAccept(TDispShard& shard, FD fd, PVOID pv)
+{
+	shard.accepts[pv] = fd;
+
+	return shard.ring.PrepAcceptMulti(fd, SOCK_NONBLOCK | SOCK_CLOEXEC, _URING_IO_USER_DATA(pv, DISP_IO_OP_ACCEPT));
+}
+
+BOOL CIODispatcher::AddSharedFD(FD fd, UINT mask, PVOID pv)
+{
+	if(m_iShards > 1 && !m_bIoUring)
+		mask = (mask & (EPOLLIN | EPOLLOUT | EPOLLET)) | EPOLLEXCLUSIVE;
+
+	for(int i = 0; i < m_iShards; i++)
+	{
+		if(!AddFD(i, fd, mask, pv))
+		{
+			EXECUTE_RESTORE_ERROR(DelSharedFD(fd, pv));
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+BOOL CIODispatcher::DelSharedFD(FD fd, PVOID pv)
+{
+	BOOL isOK = TRUE;
+
+	for(int i = 0; i < m_iShards; i++)
+		isOK &= DelFD(i, fd, pv);
+
+	return isOK;
+}
+
+int CIODispatcher::AssignShard(int iPrefer)
+{
+	if(iPrefer >= 0 && iPrefer < m_iShards)
+	{
+		InterlockedIncrement(&m_pShards[iPrefer].load);
+		return iPrefer;
+	}
+
+	if(m_iShards == 1)
+	{
+		InterlockedIncrement(&m_pShards[0].load);
+		return 0;
+	}
+
+	int iStart	= NextShard();
+	int iShard	= iStart;
+	int iLoad	= m_pShards[iStart].load;
+
+	for(int i = 1; i < m_iShards && iLoad > 0; i++)
+	{
+		int j = (iStart + i) % m_iShards;
+		int l = m_pShards[j].load;
+
+		if(l < iLoad)
+		{
+			iShard	= j;
+			iLoad	= l;
+		}
+	}
+
+	InterlockedIncrement(&m_pShards[iShard].load);
+
+	return iShard;
+}
+
+VOID CIODispatcher::ReleaseShard(int iShard)
+{
+	ASSERT(iShard >= 0 && iShard < m_iShards);
+
+	InterlockedDecrement(&m_pShards[iShard].load);
+}
+
+BOOL CIODispatcher::SetWorkerAffinity()
+{
+	CHECK_ERROR(HasStarted(), ERROR_INVALID_STATE);
+
+	int iCpus = (int)PROCESSOR_COUNT;
+
+	for(int i = 0; i < m_iWorkers; i++)
+	{
+		cpu_set_t cs;
+
+		CPU_ZERO(&cs);
+		CPU_SET(i % iCpus, &cs);
+
+		int rs = pthread_setaffinity_np(m_pWorkers[i].GetThreadID(), sizeof(cs), &cs);
+
+		if(rs != NO_ERROR)
+		{
+			::SetLastError(rs);
+			return FALSE;
+		}
+	}
+
+	return TRUE;
 }
 
 int CIODispatcher::WorkerProc(PVOID pv)
 {
+	TDispShard* pShard					= (TDispShard*)pv;
+
+	if(m_bIoUring)
+		return UringWorkerProc(pShard);
+
 	BOOL bRun							= TRUE;
 	unique_ptr<epoll_event[]> pEvents	= make_unique<epoll_event[]>(m_iMaxEvents);
 
 	while(bRun)
 	{
-		int rs = NO_EINTR_INT(epoll_pwait(m_epoll, pEvents.get(), m_iMaxEvents, INFINITE, nullptr));
+		int rs = NO_EINTR_INT(epoll_pwait(pShard->epoll, pEvents.get(), m_iMaxEvents, INFINITE, nullptr));
 
 		if(rs <= TIMEOUT)
 			ERROR_ABORT();
@@ -185,10 +574,10 @@ int CIODispatcher::WorkerProc(PVOID pv)
 			UINT events	= pEvents[i].events;
 			PVOID ptr	= pEvents[i].data.ptr;
 
-			if(ptr == &m_evCmd)
-				ProcessCommand(events);
-			else if(ptr == &m_evTimer)
-				ProcessTimer(events);
+			if(ptr == &pShard->evCmd)
+				ProcessCommand(pShard, events);
+			else if(ptr == &pShard->evTimer)
+				ProcessTimer(pShard, events);
 			else if(ptr == &m_evExit)
 				bRun = ProcessExit(events);
 			else
@@ -201,7 +590,93 @@ int CIODispatcher::WorkerProc(PVOID pv)
 	return 0;
 }
 
-BOOL CIODispatcher::ProcessCommand(UINT events)
+int CIODispatcher::UringWorkerProc(TDispShard* pShard)
+{
+	CIOUring& ring	= pShard->ring;
+	BOOL bRun		= TRUE;
+
+	while(bRun)
+	{
+		if(IS_HAS_ERROR(ring.Submit(1)))
+			ERROR_ABORT();
+
+		for(int i = 0; i < m_iMaxEvents; i++)
+		{
+			io_uring_cqe* pCqe = ring.PeekCqe();
+
+			if(pCqe == nullptr)
+				break;
+
+			UINT64 ud	= pCqe->user_data;
+			int res		= pCqe->res;
+			UINT flags	= pCqe->flags;
+
+			ring.SeenCqe();
+
+			if(ud == 0)
+				continue;
+
+			if(ud & _URING_COMPLETION_FLAG)
+			{
+				PVOID ptr	= (PVOID)(UINT_PTR)(ud & _URING_PTR_MASK);
+				int op		= (int)((ud & ~_URING_COMPLETION_FLAG) >> _URING_OP_SHIFT);
+				int bid		= (flags & IORING_CQE_F_BUFFER) ? (int)(flags >> IORING_CQE_BUFFER_SHIFT) : -1;
+
+				/* multishot accept 请求被内核终止（如：完成队列溢出）后重新提交，已被 EPOLL_CTL_DEL 取消的除外 */
+				if(op == DISP_IO_OP_ACCEPT && !(flags & IORING_CQE_F_MORE) && res != -ECANCELED)
+				{
+					auto it = pShard->accepts.find(ptr);
+
+					if(it != pShard->accepts.end())
+						VERIFY(UringAccept(*pShard, it->second, ptr));
+				}
+
+				m_pHandler->OnIoComplete(ptr, op, res, bid);
+				continue;
+			}
+
+			if(ud & _URING_CONTROL_FLAG)
+			{
+				if(res == -EALREADY)
+					VERIFY(UringRetryCtl(*pShard, ud & ~_URING_CONTROL_FLAG));
+
+				continue;
+			}
+
+			BOOL bMulti	= (ud & _URING_MULTISHOT_FLAG);
+			PVOID ptr	= (PVOID)(UINT_PTR)(ud & ~_URING_MULTISHOT_FLAG);
+
+			if(bMulti && !(flags & IORING_CQE_F_MORE) && res != -ECANCELED)
+				VERIFY(UringRearm(*pShard, ptr));
+
+			if(res < 0)
+				continue;
+
+			UINT events = (UINT)res;
+
+			if(ptr == &pShard->evCmd)
+				ProcessCommand(pShard, events);
+			else if(ptr == &pShard->evTimer)
+				ProcessTimer(pShard, events);
+			else if(ptr == &m_evExit)
+			{
+				if(bRun) bRun = ProcessExit(events);
+			}
+			else
+			{
+				pShard->pvFired = bMulti ? nullptr : ptr;
+				ProcessIo(ptr, events);
+				pShard->pvFired = nullptr;
+			}
+		}
+	}
+
+	m_pHandler->OnDispatchThreadEnd(SELF_THREAD_ID);
+
+	return 0;
+}
+
+BOOL CIODispatcher::ProcessCommand(TDispShard* pShard, UINT events)
 {
 	if(events & _EPOLL_ALL_ERROR_EVENTS)
 		ERROR_ABORT();
@@ -213,18 +688,31 @@ BOOL CIODispatcher::ProcessCommand(UINT events)
 
 	eventfd_t v;
 
-	int rs = eventfd_read(m_evCmd, &v);
+	int rs = eventfd_read(pShard->evCmd, &v);
 
 	if(IS_NO_ERROR(rs))
 	{
 		ASSERT(v > 0);
 
-		TDispCommand* pCmd = nullptr;
+		__atomic_store_n(&pShard->notify, FALSE, memory_order_seq_cst);
+
+		TDispCommand cmd;
 
-		while(m_queue.PopFront(&pCmd))
+		while(PopCommand(*pShard, cmd))
 		{
-			m_pHandler->OnCommand(pCmd);
-			TDispCommand::Destruct(pCmd);
+			if(cmd.type == CMD_URING_CTL)
+			{
+				TUringCtl* pCtl = (TUringCtl*)(cmd.lParam);
+
+				if(pCtl->op == _URING_CTL_ACCEPT)
+					VERIFY(UringAccept(*pShard, pCtl->fd, (PVOID)(cmd.wParam)));
+				else
+					VERIFY(UringCtlFD(*pShard, pCtl->fd, pCtl->op, pCtl->mask, (PVOID)(cmd.wParam)));
+
+				delete pCtl;
+			}
+			else
+				m_pHandler->OnCommand(&cmd);
 		}
 	}
 	else if(IS_HAS_ERROR(rs))
@@ -237,7 +725,7 @@ BOOL CIODispatcher::ProcessCommand(UINT events)
 	return isOK;
 }
 
-BOOL CIODispatcher::ProcessTimer(UINT events)
+BOOL CIODispatcher::ProcessTimer(TDispShard* pShard, UINT events)
 {
 	static const SSIZE_T SIZE = sizeof(LLONG);
 
@@ -250,8 +738,8 @@ BOOL CIODispatcher::ProcessTimer(UINT events)
 	BOOL isOK = TRUE;
 	LLONG llExpirations;
 
-	if(read(m_evTimer, &llExpirations, SIZE) == SIZE)
-		m_pHandler->OnTimer(llExpirations);
+	if(read(pShard->evTimer, &llExpirations, SIZE) == SIZE)
+		m_pHandler->OnTimer((int)(pShard - m_pShards.get()), llExpirations);
 	else
 	{
 		ASSERT(IS_WOULDBLOCK_ERROR());
@@ -27,12 +27,14 @@
 #include "Singleton.h"
 #include "RingBuffer.h"
 #include "Thread.h"
+#include "IOUring.h"
 
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <sys/timerfd.h>
 
 #include <memory>
+#include <unordered_map>
 
 using namespace std;
 
@@ -56,27 +58,28 @@ using namespace std;
 #define RETRIVE_EVENT_FLAG_RW(evt)	(RETRIVE_EVENT_FLAG_R(evt) | RETRIVE_EVENT_FLAG_W(evt))
 #define RETRIVE_EVENT_FLAG_H(evt)	((evt) & (_EPOLL_HUNGUP_EVENTS) ? DISP_EVENT_FLAG_H : 0)
 
+/* io_uring 模式下完成式请求的类型 */
+#define DISP_IO_OP_RECV				1
+#define DISP_IO_OP_SEND				2
+#define DISP_IO_OP_ACCEPT			3
+
+#ifndef EPOLLEXCLUSIVE
+	#define EPOLLEXCLUSIVE			(1u << 28)
+#endif
+
 // ------------------------------------------------------------------------------------------------------------------------------------------------------- //
 
+/* 分派命令（按值存放在分片的命令环形队列中，不单独分配内存） */
 struct TDispCommand
 {
 	USHORT	 type;
 	UINT_PTR wParam;
 	UINT_PTR lParam;
 
-	static TDispCommand* Construct(USHORT t, UINT_PTR wp = 0, UINT_PTR lp = 0)
-		{return new TDispCommand(t, wp, lp);}
-
-	static VOID Destruct(TDispCommand* p)
-		{if(p) delete p;}
-
-private:
-	TDispCommand(USHORT t, UINT_PTR wp = 0, UINT_PTR lp = 0)
+	TDispCommand(USHORT t = 0, UINT_PTR wp = 0, UINT_PTR lp = 0)
 	: type(t), wParam(wp), lParam(lp)
 	{
 	}
-
-	~TDispCommand() = default;
 };
 
 // ------------------------------------------------------------------------------------------------------------------------------------------------------- //
@@ -86,7 +89,10 @@ class IIOHandler
 public:
 
 	virtual VOID OnCommand(TDispCommand* pCmd)						= 0;
-	virtual VOID OnTimer(LLONG llExpirations)						= 0;
+	/* 分片的定时器到期（在该分片的工作线程中触发） */
+	virtual VOID OnTimer(int iShard, LLONG llExpirations)			= 0;
+	/* io_uring 模式下完成式请求完成（在提交请求的工作线程中触发，res 为请求结果或负的错误码，iBufferID 为从接收缓冲区环中选择的缓冲区 ID，没有选择缓冲区时为 -1） */
+	virtual VOID OnIoComplete(PVOID pv, int op, int res, int iBufferID)	= 0;
 
 	virtual BOOL OnBeforeProcessIo(PVOID pv, UINT events)			= 0;
 	virtual VOID OnAfterProcessIo(PVOID pv, UINT events, BOOL rs)	= 0;
@@ -106,7 +112,8 @@ class CIOHandler : public IIOHandler
 {
 public:
 	virtual VOID OnCommand(TDispCommand* pCmd)						override {}
-	virtual VOID OnTimer(LLONG llExpirations)						override {}
+	virtual VOID OnTimer(int iShard, LLONG llExpirations)			override {}
+	virtual VOID OnIoComplete(PVOID pv, int op, int res, int iBufferID)	override {}
 
 	virtual BOOL OnBeforeProcessIo(PVOID pv, UINT events)			override {return TRUE;}
 	virtual VOID OnAfterProcessIo(PVOID pv, UINT events, BOOL rs)	override {}
@@ -120,47 +127,147 @@ class CIODispatcher
 {
 public:
 	static const int DEF_WORKER_MAX_EVENTS	= 64;
+	/* 每个分片的命令环形队列容量（队列满时命令转入溢出队列） */
+	static const DWORD COMMAND_RING_SIZE	= 4096;
+	/* io_uring 模式下用于跨线程提交 FD 注册操作的内部命令（IIOHandler 的命令类型不能使用该值） */
+	static const USHORT CMD_URING_CTL		= 0xFFFF;
 
-	using CCommandQueue	= CCASQueue<TDispCommand>;
+	using CCommandRing	= CCASRing<TDispCommand>;
+	using CCommandQueue	= CCASSimpleQueue<TDispCommand>;
 	using CWorkerThread	= CThread<CIODispatcher, VOID, int>;
 
-public:
-	BOOL Start(IIOHandler* pHandler, int iWorkerMaxEvents = DEF_WORKER_MAX_EVENTS, int iWorkers = 0, LLONG llTimerInterval = 0);
-	BOOL Stop(BOOL bCheck = TRUE);
+private:
 
-	BOOL SendCommand(TDispCommand* pCmd);
-	BOOL SendCommand(USHORT t, UINT_PTR wp = 0, UINT_PTR lp = 0);
+	/* io_uring 模式下的 poll 注册，用于 multishot poll 被内核终止后重新注册，以及重试失败的 poll 更新/删除请求 */
+	struct TUringPoll
+	{
+		FD		fd;
+		UINT	events;
+		BOOL	multi;
+	};
 
-	template<class _List, typename = enable_if_t<is_same<remove_reference_t<typename _List::reference>, TDispCommand*>::value>>
-	BOOL SendCommands(const _List& cmds)
+	/* io_uring 模式下跨线程提交的 FD 注册操作 */
+	struct TUringCtl
 	{
-		size_t size = cmds.size();
-		if(size == 0) return FALSE;
+		FD		fd;
+		int		op;
+		UINT	mask;
 
-		for(auto it = cmds.begin(), end = cmds.end(); it != end; ++it)
-			m_queue.PushBack(*it);
+		TUringCtl(FD f, int o, UINT m) : fd(f), op(o), mask(m) {}
+	};
 
-		return VERIFY_IS_NO_ERROR(eventfd_write(m_evCmd, size));
-	}
+	/* 分派分片：共享模式下所有工作线程共用一个分片，分片模式下每个工作线程独占一个分片 */
+	struct TDispShard
+	{
+		FD				epoll;
+		FD				evCmd;
+		FD				evTimer;
+		volatile int	load;
+		/* 是否已写入 evCmd 而工作线程尚未开始处理（用于合并唤醒） */
+		volatile BOOL	notify;
+		CCommandRing	cmds;
+		CCommandQueue	overflow;
+
+		char			pack[CACHE_LINE];
+
+		/* io_uring 模式 */
+		CIOUring		ring;
+		THR_ID			owner;
+		PVOID			pvFired;
+		unordered_map<PVOID, TUringPoll> polls;
+		unordered_map<PVOID, FD>		 accepts;
+
+		TDispShard() : epoll(INVALID_FD), evCmd(INVALID_FD), evTimer(INVALID_FD), load(0), notify(FALSE), owner(0), pvFired(nullptr) {}
+	};
+
+public:
+	BOOL Start(IIOHandler* pHandler, int iWorkerMaxEvents = DEF_WORKER_MAX_EVENTS, int iWorkers = 0, LLONG llTimerInterval = 0, BOOL bSharded = FALSE, BOOL bIoUring = FALSE);
+	BOOL Stop(BOOL bCheck = TRUE);
 
-	BOOL AddFD(FD fd, UINT mask, PVOID pv)	{return CtlFD(fd, EPOLL_CTL_ADD, mask, pv);}
-	BOOL ModFD(FD fd, UINT mask, PVOID pv)	{return CtlFD(fd, EPOLL_CTL_MOD, mask, pv);}
-	BOOL DelFD(FD fd)						{return CtlFD(fd, EPOLL_CTL_DEL, 0, nullptr);}
-	BOOL CtlFD(FD fd, int op, UINT mask, PVOID pv);
+	BOOL SendCommand(USHORT t, UINT_PTR wp = 0, UINT_PTR lp = 0);
+	BOOL SendShardCommand(int iShard, USHORT t, UINT_PTR wp = 0, UINT_PTR lp = 0);
+
+	/* 批量发送命令（只唤醒一次工作线程） */
+	BOOL SendCommands(const TDispCommand cmds[], int iCount);
+	BOOL SendShardCommands(int iShard, const TDispCommand cmds[], int iCount);
+
+	BOOL AddFD(FD fd, UINT mask, PVOID pv)				{return CtlFD(0, fd, EPOLL_CTL_ADD, mask, pv);}
+	BOOL ModFD(FD fd, UINT mask, PVOID pv)				{return CtlFD(0, fd, EPOLL_CTL_MOD, mask, pv);}
+	BOOL DelFD(FD fd)									{return CtlFD(0, fd, EPOLL_CTL_DEL, 0, nullptr);}
+	BOOL CtlFD(FD fd, int op, UINT mask, PVOID pv)		{return CtlFD(0, fd, op, mask, pv);}
+
+	BOOL AddFD(int iShard, FD fd, UINT mask, PVOID pv)	{return CtlFD(iShard, fd, EPOLL_CTL_ADD, mask, pv);}
+	BOOL ModFD(int iShard, FD fd, UINT mask, PVOID pv)	{return CtlFD(iShard, fd, EPOLL_CTL_MOD, mask, pv);}
+	BOOL DelFD(int iShard, FD fd, PVOID pv = nullptr)	{return CtlFD(iShard, fd, EPOLL_CTL_DEL, 0, pv);}
+	/* io_uring 模式下 EPOLL_CTL_DEL 同时取消 pv 尚未完成的完成式收发请求 */
+	BOOL CtlFD(int iShard, FD fd, int op, UINT mask, PVOID pv);
+
+	/*
+	* io_uring 模式下提交完成式收发请求（只能在分片的工作线程中调用），请求完成时触发 IIOHandler::OnIoComplete()；
+	* 每个 pv 同一时刻最多只能有一个同类型的请求，请求完成前 pBuffer / pMsg 指向的内存必须保持有效
+	*/
+	BOOL PostRecv(int iShard, FD fd, PVOID pBuffer, int iLength, PVOID pv);
+	BOOL PostSend(int iShard, FD fd, const msghdr* pMsg, PVOID pv);
+
+	/*
+	* io_uring 模式下为分片注册接收缓冲区环（内核 5.19 起支持，不支持时返回 FALSE），iCount 必须是 2 的幂；
+	* 缓冲区由 ProvideRecvBuffer() 放入缓冲区环（只能在分片的工作线程中调用，或在提交任何选择缓冲区的接收请求之前调用），
+	* PostRecv() 的 pBuffer 为 nullptr 时由内核从缓冲区环中选择缓冲区，OnIoComplete() 的 iBufferID 指出被选择的缓冲区，
+	* 缓冲区环为空时接收请求以 -ENOBUFS 完成
+	*/
+	BOOL SetupRecvBuffers(int iShard, int iCount);
+	VOID ProvideRecvBuffer(int iShard, PVOID pBuffer, int iLength, int iBufferID);
+
+	/*
+	* io_uring 模式下在分片中提交 multishot accept 请求（内核 5.19 起支持，与接收缓冲区环相同），
+	* 每个新连接触发一次 OnIoComplete()（res 为新连接的 Socket），请求被内核终止后自动重新提交，EPOLL_CTL_DEL 时取消
+	*/
+	BOOL PostAccept(int iShard, FD fd, PVOID pv);
+
+	/* 在所有分片中注册 FD（如：监听 Socket），分片模式下使用 EPOLLEXCLUSIVE 避免惊群 */
+	BOOL AddSharedFD(FD fd, UINT mask, PVOID pv);
+	/* 从所有分片中移除 FD（io_uring 模式下必须指定注册时的 pv） */
+	BOOL DelSharedFD(FD fd, PVOID pv = nullptr);
+
+	/* 为新连接分配分片（负载最小者优先，负载相同时轮询；iPrefer 有效时直接使用该分片） */
+	int AssignShard(int iPrefer = -1);
+	/* 释放连接占用的分片负载 */
+	VOID ReleaseShard(int iShard);
+
+	/* 把第 i 个工作线程绑定到第 (i % CPU 数量) 个 CPU */
+	BOOL SetWorkerAffinity();
 
 	BOOL ProcessIo(PVOID pv, UINT events);
 
 private:
 	int WorkerProc(PVOID pv = nullptr);
 	BOOL ProcessExit(UINT events);
-	BOOL ProcessTimer(UINT events);
-	BOOL ProcessCommand(UINT events);
+	BOOL ProcessTimer(TDispShard* pShard, UINT events);
+	BOOL ProcessCommand(TDispShard* pShard, UINT events);
+
+	VOID PushCommand(TDispShard& shard, const TDispCommand& cmd);
+	BOOL PopCommand(TDispShard& shard, TDispCommand& cmd);
+	BOOL NotifyShard(TDispShard& shard);
 	BOOL DoProcessIo(PVOID pv, UINT events);
+
+	int UringWorkerProc(TDispShard* pShard);
+	BOOL UringCtlFD(TDispShard& shard, FD fd, int op, UINT mask, PVOID pv);
+	BOOL UringRearm(TDispShard& shard, PVOID pv);
+	BOOL UringRetryCtl(TDispShard& shard, UINT64 ud);
+	BOOL UringAccept(TDispShard& shard, FD fd, PVOID pv);
+
+	BOOL CreateShard(TDispShard& shard);
+	BOOL CloseShard(TDispShard& shard);
+	int NextShard() {return (m_iShards == 1) ? 0 : (int)((UINT)InterlockedIncrement(&m_iNextShard) % (UINT)m_iShards);}
 	
 	VOID Reset();
 
 public:
-	BOOL HasStarted()	{return m_pHandler && m_pWorkers;}
+	BOOL HasStarted()		{return m_pHandler && m_pWorkers;}
+	BOOL IsSharded()		{return m_bSharded;}
+	BOOL IsIoUring()		{return m_bIoUring;}
+	int GetShardCount()		{return m_iShards;}
+	int GetShardLoad(int iShard) {return (iShard >= 0 && iShard < m_iShards) ? m_pShards[iShard].load : 0;}
 	const CWorkerThread* GetWorkerThreads() {return m_pWorkers.get();}
 
 	CIODispatcher()		{Reset();}
@@ -168,13 +275,14 @@ public:
 
 private:
 	IIOHandler*	m_pHandler;
-	FD			m_epoll;
-	FD			m_evCmd;
 	FD			m_evExit;
-	FD			m_evTimer;
 	int			m_iWorkers;
 	int			m_iMaxEvents;
+	int			m_iShards;
+	BOOL		m_bSharded;
+	BOOL		m_bIoUring;
 
-	CCommandQueue				m_queue;
+	volatile int				m_iNextShard;
+	unique_ptr<TDispShard[]>	m_pShards;
 	unique_ptr<CWorkerThread[]>	m_pWorkers;
 };
@@ -0,0 +1,462 @@
+﻿/*
+* Copyright: JessMA Open Source (ldcsaa@gmail.com)
+*
+* Author	: Bruce Liang
+* Website	: http://www.jessma.org
+* Project	: https://github.com/ldcsaa
+* Blog		: http://www.cnblogs.com/ldcsaa
+* Wiki		: http://www.oschina.net/p/hp-socket
+* QQ Group	: 75375912, 44636872
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "IOUring.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifndef IORING_FEAT_RSRC_TAGS
+	#define IORING_FEAT_RSRC_TAGS	(1U << 10)
+#endif
+
+#ifndef IORING_FEAT_CQE_SKIP
+	#define IORING_FEAT_CQE_SKIP	(1U << 11)
+#endif
+
+#ifndef IOSQE_CQE_SKIP_SUCCESS
+	#define IOSQE_CQE_SKIP_SUCCESS	(1U << 6)
+#endif
+
+#ifndef IORING_ACCEPT_MULTISHOT
+	#define IORING_ACCEPT_MULTISHOT	(1U << 0)
+#endif
+
+/* 缓冲区环的注册命令及数据结构（内核 5.19 起可用，旧版本头文件中没有定义） */
+#define _IORING_REGISTER_PBUF_RING	22
+#define _IORING_BUF_GROUP_ID		0
+
+struct TUringBuf
+{
+	UINT64	addr;
+	UINT	len;
+	USHORT	bid;
+	USHORT	resv;	/* 第一个元素的 resv 字段是缓冲区环的 tail */
+};
+
+struct TUringBufReg
+{
+	UINT64	ring_addr;
+	UINT	ring_entries;
+	USHORT	bgid;
+	USHORT	flags;
+	UINT64	resv[3];
+};
+
+/* multishot poll 及 poll 更新自 5.13 起可用，以同版本引入的 IORING_FEAT_RSRC_TAGS 作为判断依据 */
+#define _IORING_REQUIRED_FEATURES	(IORING_FEAT_NODROP | IORING_FEAT_RSRC_TAGS)
+
+static inline int io_uring_setup(UINT entries, io_uring_params* p)
+{
+	return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static inline int io_uring_register(FD fd, UINT opcode, PVOID arg, UINT nr_args)
+{
+	return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static inline int io_uring_enter(FD fd, UINT to_submit, UINT min_complete, UINT flags)
+{
+	return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+BOOL CIOUring::IsSupported()
+{
+	static int s_iSupported = -1;
+
+	if(s_iSupported < 0)
+	{
+		io_uring_params params;
+		ZeroObject(params);
+
+		FD fd = io_uring_setup(2, &params);
+
+		if(IS_INVALID_FD(fd))
+			s_iSupported = 0;
+		else
+		{
+			s_iSupported = ((params.features & _IORING_REQUIRED_FEATURES) == _IORING_REQUIRED_FEATURES) ? 1 : 0;
+			close(fd);
+		}
+	}
+
+	return (BOOL)s_iSupported;
+}
+
+BOOL CIOUring::Setup(UINT uiEntries)
+{
+	ASSERT_CHECK_EINVAL(uiEntries > 0);
+	CHECK_ERROR(!IsValid(), ERROR_INVALID_STATE);
+
+	io_uring_params params;
+	ZeroObject(params);
+
+	params.flags		= IORING_SETUP_CQSIZE;
+	params.cq_entries	= uiEntries * 4;
+
+	m_fd = io_uring_setup(uiEntries, &params);
+
+	if(IS_INVALID_FD(m_fd))
+		return FALSE;
+
+	m_uiFeatures = params.features;
+
+	if((m_uiFeatures & _IORING_REQUIRED_FEATURES) != _IORING_REQUIRED_FEATURES)
+	{
+		::SetLastError(ERROR_NOT_SUPPORTED);
+		goto SETUP_ERROR;
+	}
+
+	m_sizeSqRing = params.sq_off.array + params.sq_entries * sizeof(UINT);
+	m_sizeCqRing = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+	if(m_uiFeatures & IORING_FEAT_SINGLE_MMAP)
+		m_sizeSqRing = m_sizeCqRing = (m_sizeSqRing > m_sizeCqRing ? m_sizeSqRing : m_sizeCqRing);
+
+	m_pSqRing = mmap(nullptr, m_sizeSqRing, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+
+	if(m_pSqRing == MAP_FAILED)
+	{
+		m_pSqRing = nullptr;
+		goto SETUP_ERROR;
+	}
+
+	if(m_uiFeatures & IORING_FEAT_SINGLE_MMAP)
+		m_pCqRing = m_pSqRing;
+	else
+	{
+		m_pCqRing = mmap(nullptr, m_sizeCqRing, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+
+		if(m_pCqRing == MAP_FAILED)
+		{
+			m_pCqRing = nullptr;
+			goto SETUP_ERROR;
+		}
+	}
+
+	m_sizeSqes	= params.sq_entries * sizeof(io_uring_sqe);
+	m_pSqes		= (io_uring_sqe*)mmap(nullptr, m_sizeSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+
+	if(m_pSqes == MAP_FAILED)
+	{
+		m_pSqes = nullptr;
+		goto SETUP_ERROR;
+	}
+
+	{
+		BYTE* pSq = (BYTE*)m_pSqRing;
+		BYTE* pCq = (BYTE*)m_pCqRing;
+
+		m_pSqHead		= (UINT*)(pSq + params.sq_off.head);
+		m_pSqTail		= (UINT*)(pSq + params.sq_off.tail);
+		m_uiSqMask		= *(UINT*)(pSq + params.sq_off.ring_mask);
+		m_uiSqEntries	= params.sq_entries;
+		m_uiSqTail		= *m_pSqTail;
+
+		UINT* pArray	= (UINT*)(pSq + params.sq_off.array);
+
+		for(UINT i = 0; i < m_uiSqEntries; i++)
+			pArray[i] = i;
+
+		m_pCqHead		= (UINT*)(pCq + params.cq_off.head);
+		m_pCqTail		= (UINT*)(pCq + params.cq_off.tail);
+		m_uiCqMask		= *(UINT*)(pCq + params.cq_off.ring_mask);
+		m_pCqes			= (io_uring_cqe*)(pCq + params.cq_off.cqes);
+		m_uiCqHead		= *m_pCqHead;
+	}
+
+	return TRUE;
+
+SETUP_ERROR:
+	EXECUTE_RESTORE_ERROR(Close());
+	return FALSE;
+}
+
+BOOL CIOUring::Close()
+{
+	CHECK_ERROR(IsValid(), ERROR_INVALID_STATE);
+
+	BOOL isOK = TRUE;
+
+	if(m_pSqes)
+		isOK &= IS_NO_ERROR(munmap(m_pSqes, m_sizeSqes));
+
+	if(m_pCqRing && m_pCqRing != m_pSqRing)
+		isOK &= IS_NO_ERROR(munmap(m_pCqRing, m_sizeCqRing));
+
+	if(m_pSqRing)
+		isOK &= IS_NO_ERROR(munmap(m_pSqRing, m_sizeSqRing));
+
+	isOK &= IS_NO_ERROR(close(m_fd));
+
+	if(m_pBufRing)
+		isOK &= IS_NO_ERROR(munmap(m_pBufRing, m_sizeBufRing));
+
+	Reset();
+
+	return isOK;
+}
+
+VOID CIOUring::Reset()
+{
+	m_fd			= INVALID_FD;
+	m_uiFeatures	= 0;
+	m_pSqRing		= nullptr;
+	m_sizeSqRing	= 0;
+	m_pCqRing		= nullptr;
+	m_sizeCqRing	= 0;
+	m_pSqes			= nullptr;
+	m_sizeSqes		= 0;
+	m_pSqHead		= nullptr;
+	m_pSqTail		= nullptr;
+	m_uiSqTail		= 0;
+	m_uiSqMask		= 0;
+	m_uiSqEntries	= 0;
+	m_pCqHead		= nullptr;
+	m_pCqTail		= nullptr;
+	m_uiCqHead		= 0;
+	m_uiCqMask		= 0;
+	m_pCqes			= nullptr;
+	m_pBufRing		= nullptr;
+	m_sizeBufRing	= 0;
+	m_uiBufMask		= 0;
+	m_usBufTail		= 0;
+}
+
+BOOL CIOUring::SetupBufRing(UINT uiEntries)
+{
+	ASSERT_CHECK_EINVAL(uiEntries > 0 && uiEntries <= 32768 && (uiEntries & (uiEntries - 1)) == 0);
+	CHECK_ERROR(IsValid() && !HasBufRing(), ERROR_INVALID_STATE);
+
+	SIZE_T sizePage	= (SIZE_T)sysconf(_SC_PAGESIZE);
+	SIZE_T sizeRing	= ((uiEntries * sizeof(TUringBuf) + sizePage - 1) / sizePage) * sizePage;
+	PVOID pRing		= mmap(nullptr, sizeRing, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if(pRing == MAP_FAILED)
+		return FALSE;
+
+	TUringBufReg reg;
+	ZeroObject(reg);
+
+	reg.ring_addr		= (UINT64)(UINT_PTR)pRing;
+	reg.ring_entries	= uiEntries;
+	reg.bgid			= _IORING_BUF_GROUP_ID;
+
+	if(IS_HAS_ERROR(io_uring_register(m_fd, _IORING_REGISTER_PBUF_RING, &reg, 1)))
+	{
+		EXECUTE_RESTORE_ERROR(munmap(pRing, sizeRing));
+		return FALSE;
+	}
+
+	m_pBufRing		= pRing;
+	m_sizeBufRing	= sizeRing;
+	m_uiBufMask		= uiEntries - 1;
+	m_usBufTail		= 0;
+
+	return TRUE;
+}
+
+VOID CIOUring::ProvideBuffer(PVOID pBuffer, UINT uiLength, USHORT usBufferID)
+{
+	ASSERT(HasBufRing());
+
+	TUringBuf* pBufs	= (TUringBuf*)m_pBufRing;
+	TUringBuf& buf		= pBufs[m_usBufTail & m_uiBufMask];
+
+	buf.addr	= (UINT64)(UINT_PTR)pBuffer;
+	buf.len		= uiLength;
+	buf.bid		= usBufferID;
+
+	__atomic_store_n(&pBufs[0].resv, ++m_usBufTail, __ATOMIC_RELEASE);
+}
+
+io_uring_sqe* CIOUring::GetSqe()
+{
+	if(GetPending() >= m_uiSqEntries)
+	{
+		Submit();
+
+		if(GetPending() >= m_uiSqEntries)
+		{
+			::SetLastError(ERROR_AGAIN);
+			return nullptr;
+		}
+	}
+
+	io_uring_sqe* pSqe = &m_pSqes[m_uiSqTail++ & m_uiSqMask];
+	ZeroObject(*pSqe);
+
+	return pSqe;
+}
+
+int CIOUring::Submit(int iWaitNr)
+{
+	UINT uiSubmit = GetPending();
+
+	if(iWaitNr > 0 && PeekCqe() != nullptr)
+		iWaitNr = 0;
+
+	if(uiSubmit == 0 && iWaitNr == 0)
+		return 0;
+
+	__atomic_store_n(m_pSqTail, m_uiSqTail, __ATOMIC_RELEASE);
+
+	UINT uiFlags = (iWaitNr > 0) ? IORING_ENTER_GETEVENTS : 0;
+	int rs		 = NO_EINTR_INT(io_uring_enter(m_fd, uiSubmit, (UINT)iWaitNr, uiFlags));
+
+	if(IS_HAS_ERROR(rs) && (IS_ERROR(EAGAIN) || IS_ERROR(EBUSY)))
+		rs = 0;
+
+	return rs;
+}
+
+BOOL CIOUring::PrepPollAdd(FD fd, UINT events, UINT64 ullUserData, BOOL bMultiShot)
+{
+	io_uring_sqe* pSqe = GetSqe();
+
+	if(pSqe == nullptr)
+		return FALSE;
+
+	pSqe->opcode		= IORING_OP_POLL_ADD;
+	pSqe->fd			= fd;
+	pSqe->poll32_events	= events;
+	pSqe->len			= bMultiShot ? IORING_POLL_ADD_MULTI : 0;
+	pSqe->user_data		= ullUserData;
+
+	return TRUE;
+}
+
+BOOL CIOUring::PrepPollUpdate(UINT64 ullTarget, UINT events, BOOL bMultiShot, UINT64 ullUserData)
+{
+	io_uring_sqe* pSqe = GetSqe();
+
+	if(pSqe == nullptr)
+		return FALSE;
+
+	pSqe->opcode		= IORING_OP_POLL_REMOVE;
+	pSqe->fd			= INVALID_FD;
+	pSqe->addr			= ullTarget;
+	pSqe->poll32_events	= events;
+	pSqe->len			= IORING_POLL_UPDATE_EVENTS | (bMultiShot ? IORING_POLL_ADD_MULTI : 0);
+	pSqe->user_data		= ullUserData;
+
+	if(m_uiFeatures & IORING_FEAT_CQE_SKIP)
+		pSqe->flags		= IOSQE_CQE_SKIP_SUCCESS;
+
+	return TRUE;
+}
+
+BOOL CIOUring::PrepPollRemove(UINT64 ullTarget, UINT64 ullUserData)
+{
+	io_uring_sqe* pSqe = GetSqe();
+
+	if(pSqe == nullptr)
+		return FALSE;
+
+	pSqe->opcode		= IORING_OP_POLL_REMOVE;
+	pSqe->fd			= INVALID_FD;
+	pSqe->addr			= ullTarget;
+	pSqe->user_data		= ullUserData;
+
+	if(m_uiFeatures & IORING_FEAT_CQE_SKIP)
+		pSqe->flags		= IOSQE_CQE_SKIP_SUCCESS;
+
+	return TRUE;
+}
+
+BOOL CIOUring::PrepRecv(FD fd, PVOID pBuffer, UINT uiLength, int iFlags, UINT64 ullUserData)
+{
+	io_uring_sqe* pSqe = GetSqe();
+
+	if(pSqe == nullptr)
+		return FALSE;
+
+	pSqe->opcode		= IORING_OP_RECV;
+	pSqe->fd			= fd;
+	pSqe->addr			= (UINT64)(UINT_PTR)pBuffer;
+	pSqe->len			= uiLength;
+	pSqe->msg_flags		= (UINT)iFlags;
+	pSqe->user_data		= ullUserData;
+
+	if(pBuffer == nullptr)
+	{
+		ASSERT(HasBufRing());
+
+		pSqe->flags		= IOSQE_BUFFER_SELECT;
+		pSqe->buf_group	= _IORING_BUF_GROUP_ID;
+	}
+
+	return TRUE;
+}
+
+BOOL CIOUring::PrepSendMsg(FD fd, const msghdr* pMsg, int iFlags, UINT64 ullUserData)
+{
+	io_uring_sqe* pSqe = GetSqe();
+
+	if(pSqe == nullptr)
+		return FALSE;
+
+	pSqe->opcode		= IORING_OP_SENDMSG;
+	pSqe->fd			= fd;
+	pSqe->addr			= (UINT64)(UINT_PTR)pMsg;
+	pSqe->len			= 1;
+	pSqe->msg_flags		= (UINT)iFlags;
+	pSqe->user_data		= ullUserData;
+
+	return TRUE;
+}
+
+BOOL CIOUring::PrepCancel(UINT64 ullTarget, UINT64 ullUserData)
+{
+	io_uring_sqe* pSqe = GetSqe();
+
+	if(pSqe == nullptr)
+		return FALSE;
+
+	pSqe->opcode		= IORING_OP_ASYNC_CANCEL;
+	pSqe->fd			= INVALID_FD;
+	pSqe->addr			= ullTarget;
+	pSqe->user_data		= ullUserData;
+
+	if(m_uiFeatures & IORING_FEAT_CQE_SKIP)
+		pSqe->flags		= IOSQE_CQE_SKIP_SUCCESS;
+
+	return TRUE;
+}
+
+BOOL CIOUring::PrepAcceptMulti(FD fd, int iFlags, UINT64 ullUserData)
+{
+	io_uring_sqe* pSqe = GetSqe();
+
+	if(pSqe == nullptr)
+		return FALSE;
+
+	pSqe->opcode		= IORING_OP_ACCEPT;
+	pSqe->fd			= fd;
+	pSqe->accept_flags	= (UINT)iFlags;
+	pSqe->ioprio		= IORING_ACCEPT_MULTISHOT;
+	pSqe->user_data		= ullUserData;
+
+	return TRUE;
+}
@@ -0,0 +1,125 @@
+﻿/*
+* Copyright: JessMA Open Source (ldcsaa@gmail.com)
+*
+* Author	: Bruce Liang
+* Website	: http://www.jessma.org
+* Project	: https://github.com/ldcsaa
+* Blog		: http://www.cnblogs.com/ldcsaa
+* Wiki		: http://www.oschina.net/p/hp-socket
+* QQ Group	: 75375912, 44636872
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include "GlobalDef.h"
+#include "Singleton.h"
+#include "FuncHelper.h"
+
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+/*
+* io_uring 实例的轻量封装（直接使用系统调用，不依赖 liburing）
+*
+* 提交队列（SQ）只允许单个线程写入，完成队列（CQ）只允许单个线程读取，
+* 调用者负责保证线程约束（CIODispatcher 中由分片的工作线程独占）
+*/
+class CIOUring
+{
+public:
+	/* 检测当前内核是否支持本封装所需的 io_uring 特性（multishot poll、poll 更新等） */
+	static BOOL IsSupported();
+
+	BOOL Setup(UINT uiEntries);
+	BOOL Close();
+
+	/* 获取空闲 SQE，SQ 已满时先提交已有的 SQE */
+	io_uring_sqe* GetSqe();
+
+	/* 提交所有未提交的 SQE，iWaitNr > 0 时阻塞等待至少 iWaitNr 个完成事件 */
+	int Submit(int iWaitNr = 0);
+
+	/* 读取下一个完成事件，没有则返回 nullptr */
+	io_uring_cqe* PeekCqe()
+	{
+		UINT uiTail = __atomic_load_n(m_pCqTail, __ATOMIC_ACQUIRE);
+		return (m_uiCqHead != uiTail) ? &m_pCqes[m_uiCqHead & m_uiCqMask] : nullptr;
+	}
+
+	/* 释放 PeekCqe() 返回的完成事件 */
+	void SeenCqe()
+	{
+		__atomic_store_n(m_pCqHead, ++m_uiCqHead, __ATOMIC_RELEASE);
+	}
+
+	/* ullTarget 为目标 poll 请求的 user_data，ullUserData 为更新/删除请求本身的 user_data（请求成功时不产生完成事件） */
+	BOOL PrepPollAdd(FD fd, UINT events, UINT64 ullUserData, BOOL bMultiShot);
+	BOOL PrepPollUpdate(UINT64 ullTarget, UINT events, BOOL bMultiShot, UINT64 ullUserData = 0);
+	BOOL PrepPollRemove(UINT64 ullTarget, UINT64 ullUserData = 0);
+
+	/* 完成式收发请求：请求完成前 pBuffer / pMsg 指向的内存必须保持有效（pBuffer 为 nullptr 时由内核从缓冲区环中选择缓冲区） */
+	BOOL PrepRecv(FD fd, PVOID pBuffer, UINT uiLength, int iFlags, UINT64 ullUserData);
+	BOOL PrepSendMsg(FD fd, const msghdr* pMsg, int iFlags, UINT64 ullUserData);
+	/* 取消 user_data 为 ullTarget 的请求（被取消的请求以 -ECANCELED 完成） */
+	BOOL PrepCancel(UINT64 ullTarget, UINT64 ullUserData = 0);
+	/* multishot accept 请求：每个新连接产生一个完成事件（res 为新连接的 Socket），完成事件不带 IORING_CQE_F_MORE 标志时请求已终止 */
+	BOOL PrepAcceptMulti(FD fd, int iFlags, UINT64 ullUserData);
+
+	/* 注册接收缓冲区环（内核 5.19 起支持，同一版本起支持 multishot accept），uiEntries 必须是 2 的幂 */
+	BOOL SetupBufRing(UINT uiEntries);
+	/* 把缓冲区放入缓冲区环（只能由提交队列的写入线程调用），完成事件的 IORING_CQE_F_BUFFER 标志表示请求使用了环中的缓冲区 */
+	VOID ProvideBuffer(PVOID pBuffer, UINT uiLength, USHORT usBufferID);
+
+public:
+	BOOL IsValid()			{return IS_VALID_FD(m_fd);}
+	BOOL HasBufRing()		{return m_pBufRing != nullptr;}
+	UINT GetPending()		{return m_uiSqTail - __atomic_load_n(m_pSqHead, __ATOMIC_ACQUIRE);}
+
+	CIOUring()	{Reset();}
+	~CIOUring()	{if(IsValid()) Close();}
+
+	DECLARE_NO_COPY_CLASS(CIOUring)
+
+private:
+	VOID Reset();
+
+private:
+	FD				m_fd;
+	UINT			m_uiFeatures;
+
+	PVOID			m_pSqRing;
+	SIZE_T			m_sizeSqRing;
+	PVOID			m_pCqRing;
+	SIZE_T			m_sizeCqRing;
+	io_uring_sqe*	m_pSqes;
+	SIZE_T			m_sizeSqes;
+
+	UINT*			m_pSqHead;
+	UINT*			m_pSqTail;
+	UINT			m_uiSqTail;
+	UINT			m_uiSqMask;
+	UINT			m_uiSqEntries;
+
+	UINT*			m_pCqHead;
+	UINT*			m_pCqTail;
+	UINT			m_uiCqHead;
+	UINT			m_uiCqMask;
+	io_uring_cqe*	m_pCqes;
+
+	PVOID			m_pBufRing;
+	SIZE_T			m_sizeBufRing;
+	UINT			m_uiBufMask;
+	USHORT			m_usBufTail;
+};
@@ -0,0 +1,706 @@
+﻿/*
+* Copyright: JessMA Open Source (ldcsaa@gmail.com)
+*
+* Author	: Bruce Liang
+* Website	: http://www.jessma.org
+* Project	: https://github.com/ldcsaa
+* Blog		: http://www.cnblogs.com/ldcsaa
+* Wiki		: http://www.oschina.net/p/hp-socket
+* QQ Group	: 75375912, 44636872
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "PrivateHeap.h"
+#include "FuncHelper.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#define HEAP_ALIGN_SIZE		16
+#define SLAB_HEADER_SIZE	64
+
+const SIZE_T CPrivateHeapImpl::MAX_SLAB_BLOCK_SIZE;
+const SIZE_T CPrivateHeapImpl::SLAB_UNIT;
+const SIZE_T CPrivateHeapImpl::DEFAULT_CHUNK_SIZE;
+const SIZE_T CPrivateHeapImpl::HUGE_PAGE_SIZE;
+const SIZE_T CPrivateHeapImpl::MAX_LARGE_CACHE_SIZE;
+
+volatile DWORD CPrivateHeapImpl::sm_dwDefaultOptions = 0;
+
+static inline SIZE_T AlignUp(SIZE_T dwSize, SIZE_T dwAlign)
+{
+	return (dwSize + dwAlign - 1) & ~(dwAlign - 1);
+}
+
+static inline SIZE_T AlignDown(SIZE_T dwSize, SIZE_T dwAlign)
+{
+	return dwSize & ~(dwAlign - 1);
+}
+
+CPrivateHeapImpl::CPrivateHeapImpl(DWORD dwOptions, SIZE_T dwInitSize, SIZE_T dwMaxSize)
+: m_bNoSerialize(dwOptions & HEAP_NO_SERIALIZE)
+, m_bHugeTLB	(dwOptions & HEAP_CREATE_HUGE_PAGES)
+, m_bTHP		(dwOptions & HEAP_CREATE_TRANSPARENT_HUGE_PAGES)
+, m_bNumaInterleave(dwOptions & HEAP_CREATE_NUMA_INTERLEAVE)
+, m_dwMaxSize	(dwMaxSize)
+, m_pChunks		(nullptr)
+, m_pClasses	(nullptr)
+, m_pFreeSlabs	(nullptr)
+, m_pLargeBlocks(nullptr)
+, m_pLargeClasses(nullptr)
+, m_dwLargeCached(0)
+{
+	m_dwChunkSize = AlignUp(max(dwInitSize, DEFAULT_CHUNK_SIZE), (m_bHugeTLB || m_bTHP) ? HUGE_PAGE_SIZE : (SIZE_T)SysGetPageSize());
+
+	ZeroObject(m_stat);
+}
+
+CPrivateHeapImpl::~CPrivateHeapImpl()
+{
+	if(m_stat.blocks != 0)
+	{
+		TRACE("CPrivateHeapImpl(0x%p) destroyed with %zu blocks in use", this, m_stat.blocks);
+	}
+
+	ReleaseAll();
+}
+
+PVOID CPrivateHeapImpl::Alloc(SIZE_T dwSize, DWORD dwFlags)
+{
+	SIZE_T dwBlockSize = BlockSize(dwSize);
+	PVOID pv		   = nullptr;
+
+	if(dwBlockSize > MAX_SLAB_BLOCK_SIZE)
+		pv = AllocLarge(dwBlockSize);
+	else
+	{
+		Lock();
+		pv = DoAlloc(dwBlockSize);
+		Unlock();
+	}
+
+	if(pv && (dwFlags & HEAP_ZERO_MEMORY))
+		ZeroMemory(pv, dwSize);
+
+	return pv;
+}
+
+PVOID CPrivateHeapImpl::ReAlloc(PVOID pvMemory, SIZE_T dwSize, DWORD dwFlags)
+{
+	if(pvMemory == nullptr)
+		return Alloc(dwSize, dwFlags);
+
+	SIZE_T dwOldSize = Size(pvMemory);
+
+	if(dwSize <= dwOldSize && dwSize > 0)
+		return pvMemory;
+
+	PVOID pv = (dwSize > 0) ? Alloc(dwSize) : nullptr;
+
+	if(pv != nullptr)
+	{
+		memcpy(pv, pvMemory, dwOldSize);
+
+		if(dwFlags & HEAP_ZERO_MEMORY)
+			ZeroMemory((BYTE*)pv + dwOldSize, dwSize - dwOldSize);
+	}
+
+	Free(pvMemory);
+
+	return pv;
+}
+
+BOOL CPrivateHeapImpl::Free(PVOID pvMemory, DWORD dwFlags)
+{
+	if(pvMemory == nullptr)
+		return FALSE;
+
+	TBlockHeader* pHeader = (TBlockHeader*)pvMemory - 1;
+
+	if(pHeader->slab == nullptr)
+		FreeLarge(pHeader);
+	else
+	{
+		Lock();
+		DoFree(pHeader);
+		Unlock();
+	}
+
+	return TRUE;
+}
+
+SIZE_T CPrivateHeapImpl::Size(PVOID pvMemory, DWORD dwFlags)
+{
+	ASSERT(pvMemory != nullptr);
+
+	return ((TBlockHeader*)pvMemory - 1)->size - sizeof(TBlockHeader);
+}
+
+PVOID CPrivateHeapImpl::DoAlloc(SIZE_T dwBlockSize)
+{
+	TSizeClass* pClass = GetSizeClass(dwBlockSize);
+
+	if(pClass == nullptr)
+		return nullptr;
+
+	TBlockHeader* pHeader = nullptr;
+
+	if(pClass->frees != nullptr)
+	{
+		TFreeBlock* pFree	= pClass->frees;
+		pClass->frees		= pFree->next;
+		pHeader				= (TBlockHeader*)pFree - 1;
+	}
+	else
+	{
+		if((pClass->bump == nullptr || pClass->bump + dwBlockSize > pClass->limit) && NewSlab(pClass) == nullptr)
+			return nullptr;
+
+		pHeader			= (TBlockHeader*)pClass->bump;
+		pHeader->slab	= pClass->slabs;
+		pHeader->size	= dwBlockSize;
+		pClass->bump   += dwBlockSize;
+	}
+
+	++(pHeader->slab->live);
+
+	++m_stat.blocks;
+	++m_stat.allocs;
+	m_stat.used += pHeader->size;
+
+	return pHeader + 1;
+}
+
+void CPrivateHeapImpl::DoFree(TBlockHeader* pHeader)
+{
+	TSlab* pSlab = pHeader->slab;
+
+	ASSERT(pSlab->live > 0);
+
+	--m_stat.blocks;
+	++m_stat.frees;
+	m_stat.used -= pHeader->size;
+
+	TSizeClass* pClass	= pSlab->cls;
+	TFreeBlock* pFree	= (TFreeBlock*)(pHeader + 1);
+
+	pFree->next		= pClass->frees;
+	pClass->frees	= pFree;
+
+	--(pSlab->live);
+}
+
+PVOID CPrivateHeapImpl::AllocLarge(SIZE_T dwBlockSize)
+{
+	SIZE_T dwMapSize	= AlignUp(ClassSize(dwBlockSize + sizeof(TLargeBlock)), (SIZE_T)SysGetPageSize());
+	TLargeBlock* pBlock	= nullptr;
+
+	Lock();
+
+	TLargeClass* pClass = GetLargeClass(dwMapSize);
+
+	if(pClass != nullptr && pClass->frees != nullptr)
+	{
+		pBlock			 = pClass->frees;
+		pClass->frees	 = pBlock->next;
+		m_dwLargeCached -= dwMapSize;
+	}
+	else
+	{
+		/* 先占用配额，在锁外映射内存 */
+		if(pClass == nullptr || !CheckMaxSize(dwMapSize))
+		{
+			Unlock();
+			return nullptr;
+		}
+
+		m_stat.reserved	 += dwMapSize;
+		m_stat.committed += dwMapSize;
+
+		Unlock();
+
+		SIZE_T dwSize	= dwMapSize;
+		pBlock			= (TLargeBlock*)MapMemory(dwSize, FALSE);
+
+		ASSERT(pBlock == nullptr || dwSize == dwMapSize);
+
+		Lock();
+
+		if(pBlock == nullptr)
+		{
+			m_stat.reserved	 -= dwMapSize;
+			m_stat.committed -= dwMapSize;
+
+			Unlock();
+			::SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+
+			return nullptr;
+		}
+	}
+
+	TBlockHeader* pHeader = (TBlockHeader*)(pBlock + 1);
+
+	pHeader->slab	= nullptr;
+	pHeader->size	= dwMapSize - sizeof(TLargeBlock);
+
+	LinkLarge(pBlock);
+
+	++m_stat.blocks;
+	++m_stat.allocs;
+	m_stat.used += pHeader->size;
+
+	Unlock();
+
+	return pHeader + 1;
+}
+
+void CPrivateHeapImpl::FreeLarge(TBlockHeader* pHeader)
+{
+	TLargeBlock* pBlock	= (TLargeBlock*)pHeader - 1;
+	SIZE_T dwMapSize	= pHeader->size + sizeof(TLargeBlock);
+	BOOL bCache			= FALSE;
+
+	Lock();
+
+	UnlinkLarge(pBlock);
+
+	--m_stat.blocks;
+	++m_stat.frees;
+	m_stat.used -= pHeader->size;
+
+	if(m_dwLargeCached + dwMapSize <= MAX_LARGE_CACHE_SIZE)
+	{
+		TLargeClass* pClass = GetLargeClass(dwMapSize);
+
+		if(pClass != nullptr)
+		{
+			pBlock->next	 = pClass->frees;
+			pClass->frees	 = pBlock;
+			m_dwLargeCached += dwMapSize;
+			bCache			 = TRUE;
+		}
+	}
+
+	if(!bCache)
+	{
+		m_stat.reserved	 -= dwMapSize;
+		m_stat.committed -= dwMapSize;
+	}
+
+	Unlock();
+
+	if(!bCache)
+		VERIFY(UnmapMemory((BYTE*)pBlock, dwMapSize));
+}
+
+void CPrivateHeapImpl::LinkLarge(TLargeBlock* pBlock)
+{
+	pBlock->prev = nullptr;
+	pBlock->next = m_pLargeBlocks;
+
+	if(m_pLargeBlocks != nullptr)
+		m_pLargeBlocks->prev = pBlock;
+
+	m_pLargeBlocks = pBlock;
+}
+
+void CPrivateHeapImpl::UnlinkLarge(TLargeBlock* pBlock)
+{
+	if(pBlock->prev != nullptr)
+		pBlock->prev->next = pBlock->next;
+	else
+		m_pLargeBlocks = pBlock->next;
+
+	if(pBlock->next != nullptr)
+		pBlock->next->prev = pBlock->prev;
+}
+
+CPrivateHeapImpl::TLargeClass* CPrivateHeapImpl::GetLargeClass(SIZE_T dwMapSize)
+{
+	TLargeClass** ppClass = &m_pLargeClasses;
+
+	for(TLargeClass* pClass = m_pLargeClasses; pClass != nullptr; ppClass = &pClass->next, pClass = pClass->next)
+	{
+		if(pClass->size == dwMapSize)
+		{
+			if(pClass != m_pLargeClasses)
+			{
+				*ppClass		= pClass->next;
+				pClass->next	= m_pLargeClasses;
+				m_pLargeClasses	= pClass;
+			}
+
+			return pClass;
+		}
+	}
+
+	TLargeClass* pClass = new TLargeClass;
+
+	pClass->size	= dwMapSize;
+	pClass->next	= m_pLargeClasses;
+	pClass->frees	= nullptr;
+
+	m_pLargeClasses = pClass;
+
+	return pClass;
+}
+
+CPrivateHeapImpl::TSizeClass* CPrivateHeapImpl::GetSizeClass(SIZE_T dwBlockSize)
+{
+	TSizeClass** ppClass = &m_pClasses;
+
+	for(TSizeClass* pClass = m_pClasses; pClass != nullptr; ppClass = &pClass->next, pClass = pClass->next)
+	{
+		if(pClass->size == dwBlockSize)
+		{
+			if(pClass != m_pClasses)
+			{
+				*ppClass		= pClass->next;
+				pClass->next	= m_pClasses;
+				m_pClasses		= pClass;
+			}
+
+			return pClass;
+		}
+	}
+
+	TSizeClass* pClass = new TSizeClass;
+
+	pClass->size	= dwBlockSize;
+	pClass->next	= m_pClasses;
+	pClass->slabs	= nullptr;
+	pClass->frees	= nullptr;
+	pClass->bump	= nullptr;
+	pClass->limit	= nullptr;
+
+	m_pClasses = pClass;
+	++m_stat.classes;
+
+	return pClass;
+}
+
+SIZE_T CPrivateHeapImpl::BlockSize(SIZE_T dwSize)
+{
+	return ClassSize(AlignUp(dwSize, HEAP_ALIGN_SIZE) + sizeof(TBlockHeader));
+}
+
+SIZE_T CPrivateHeapImpl::ClassSize(SIZE_T dwBlockSize)
+{
+	if(dwBlockSize <= 256)
+		return dwBlockSize;
+
+	/* 每个 2 的幂区间划分为 16 个尺寸类别，内部碎片不超过 1/16 */
+	SIZE_T dwPower = (SIZE_T)1 << (sizeof(SIZE_T) * 8 - 1 - __builtin_clzl(dwBlockSize));
+
+	return AlignUp(dwBlockSize, dwPower >> 4);
+}
+
+SIZE_T CPrivateHeapImpl::SlabSize(SIZE_T dwBlockSize)
+{
+	return AlignUp(max(SLAB_UNIT, SLAB_HEADER_SIZE + dwBlockSize * 8), SLAB_UNIT);
+}
+
+CPrivateHeapImpl::TSlab* CPrivateHeapImpl::NewSlab(TSizeClass* pClass)
+{
+	SIZE_T dwSlabSize	= SlabSize(pClass->size);
+	TSlab* pSlab		= nullptr;
+
+	for(TSlab** ppSlab = &m_pFreeSlabs; *ppSlab != nullptr; ppSlab = &(*ppSlab)->next)
+	{
+		if((*ppSlab)->size == dwSlabSize)
+		{
+			pSlab	= *ppSlab;
+			*ppSlab	= pSlab->next;
+
+			break;
+		}
+	}
+
+	if(pSlab == nullptr)
+	{
+		TChunk* pChunk = m_pChunks;
+
+		if(pChunk == nullptr || pChunk->bump + dwSlabSize > pChunk->limit)
+		{
+			SIZE_T dwChunkSize = max(m_dwChunkSize, AlignUp(SLAB_HEADER_SIZE + dwSlabSize, SLAB_UNIT));
+
+			if(!CheckMaxSize(dwChunkSize))
+				return nullptr;
+
+			pChunk = (TChunk*)MapMemory(dwChunkSize, TRUE);
+
+			if(pChunk == nullptr)
+				return nullptr;
+
+			pChunk->next	= m_pChunks;
+			pChunk->size	= dwChunkSize;
+			pChunk->bump	= (BYTE*)pChunk + SLAB_HEADER_SIZE;
+			pChunk->limit	= (BYTE*)pChunk + dwChunkSize;
+
+			m_pChunks			= pChunk;
+			m_stat.reserved	   += dwChunkSize;
+		}
+
+		pSlab			= (TSlab*)pChunk->bump;
+		pSlab->size		= dwSlabSize;
+		pChunk->bump   += dwSlabSize;
+	}
+
+	pSlab->cls		= pClass;
+	pSlab->live		= 0;
+	pSlab->next		= pClass->slabs;
+	pClass->slabs	= pSlab;
+	pClass->bump	= (BYTE*)pSlab + SLAB_HEADER_SIZE;
+	pClass->limit	= (BYTE*)pSlab + dwSlabSize;
+
+	++m_stat.slabs;
+	m_stat.committed += dwSlabSize;
+
+	return pSlab;
+}
+
+SIZE_T CPrivateHeapImpl::Compact(DWORD dwFlags)
+{
+	SIZE_T dwPageSize	= (SIZE_T)SysGetPageSize();
+	SIZE_T dwReleased	= 0;
+
+	TLargeBlock* pLarges = nullptr;
+
+	Lock();
+
+	for(TLargeClass* pClass = m_pLargeClasses; pClass != nullptr; pClass = pClass->next)
+	{
+		while(pClass->frees != nullptr)
+		{
+			TLargeBlock* pBlock	= pClass->frees;
+			pClass->frees		= pBlock->next;
+
+			pBlock->next	= pLarges;
+			pLarges			= pBlock;
+		}
+	}
+
+	m_stat.reserved	 -= m_dwLargeCached;
+	m_stat.committed -= m_dwLargeCached;
+	m_dwLargeCached	  = 0;
+
+	for(TSizeClass* pClass = m_pClasses; pClass != nullptr; pClass = pClass->next)
+	{
+		for(TFreeBlock** ppFree = &pClass->frees; *ppFree != nullptr;)
+		{
+			if(((TBlockHeader*)(*ppFree) - 1)->slab->live == 0)
+				*ppFree = (*ppFree)->next;
+			else
+				ppFree = &(*ppFree)->next;
+		}
+
+		for(TSlab** ppSlab = &pClass->slabs; *ppSlab != nullptr;)
+		{
+			TSlab* pSlab = *ppSlab;
+
+			if(pSlab->live != 0)
+			{
+				ppSlab = &pSlab->next;
+				continue;
+			}
+
+			if(pClass->bump >= (BYTE*)pSlab && pClass->bump <= (BYTE*)pSlab + pSlab->size)
+				pClass->bump = pClass->limit = nullptr;
+
+			*ppSlab			= pSlab->next;
+			pSlab->cls		= nullptr;
+			pSlab->next		= m_pFreeSlabs;
+			m_pFreeSlabs	= pSlab;
+
+			SIZE_T dwBegin	= AlignUp((SIZE_T)pSlab + SLAB_HEADER_SIZE, dwPageSize);
+			SIZE_T dwEnd	= AlignDown((SIZE_T)pSlab + pSlab->size, dwPageSize);
+
+			if(dwEnd > dwBegin && IS_NO_ERROR(madvise((PVOID)dwBegin, dwEnd - dwBegin, MADV_DONTNEED)))
+				dwReleased += dwEnd - dwBegin;
+
+			--m_stat.slabs;
+			m_stat.committed -= pSlab->size;
+		}
+	}
+
+	Unlock();
+
+	while(pLarges != nullptr)
+	{
+		TLargeBlock* pBlock	= pLarges;
+		SIZE_T dwMapSize	= ((TBlockHeader*)(pBlock + 1))->size + sizeof(TLargeBlock);
+		pLarges				= pBlock->next;
+
+		VERIFY(UnmapMemory((BYTE*)pBlock, dwMapSize));
+		dwReleased += dwMapSize;
+	}
+
+	return dwReleased;
+}
+
+BOOL CPrivateHeapImpl::GetStat(TPrivateHeapStat& stat)
+{
+	Lock();
+	stat = m_stat;
+	Unlock();
+
+	return TRUE;
+}
+
+BOOL CPrivateHeapImpl::Reset()
+{
+	Lock();
+
+	BOOL isOK = (m_stat.blocks == 0);
+
+	if(isOK)
+		ReleaseAll();
+	else
+		::SetLastError(ERROR_INVALID_STATE);
+
+	Unlock();
+
+	return isOK;
+}
+
+void CPrivateHeapImpl::ReleaseAll()
+{
+	while(m_pClasses != nullptr)
+	{
+		TSizeClass* pClass	= m_pClasses;
+		m_pClasses			= pClass->next;
+
+		delete pClass;
+	}
+
+	while(m_pLargeClasses != nullptr)
+	{
+		TLargeClass* pClass	= m_pLargeClasses;
+		m_pLargeClasses		= pClass->next;
+
+		while(pClass->frees != nullptr)
+		{
+			TLargeBlock* pBlock	= pClass->frees;
+			pClass->frees		= pBlock->next;
+
+			VERIFY(UnmapMemory((BYTE*)pBlock, pClass->size));
+		}
+
+		delete pClass;
+	}
+
+	while(m_pLargeBlocks != nullptr)
+	{
+		TLargeBlock* pBlock	= m_pLargeBlocks;
+		m_pLargeBlocks		= pBlock->next;
+
+		VERIFY(UnmapMemory((BYTE*)pBlock, ((TBlockHeader*)(pBlock + 1))->size + sizeof(TLargeBlock)));
+	}
+
+	while(m_pChunks != nullptr)
+	{
+		TChunk* pChunk	= m_pChunks;
+		m_pChunks		= pChunk->next;
+
+		VERIFY(UnmapMemory((BYTE*)pChunk, pChunk->size));
+	}
+
+	m_pFreeSlabs	= nullptr;
+	m_dwLargeCached	= 0;
+
+	ZeroObject(m_stat);
+}
+
+BOOL CPrivateHeapImpl::CheckMaxSize(SIZE_T dwSize)
+{
+	if(m_dwMaxSize == 0 || m_stat.reserved + dwSize <= m_dwMaxSize)
+		return TRUE;
+
+	::SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+	return FALSE;
+}
+
+BYTE* CPrivateHeapImpl::MapMemory(SIZE_T& dwSize, BOOL bChunk)
+{
+	int iProt	= PROT_READ | PROT_WRITE;
+	int iFlag	= MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+	BYTE* pv	= nullptr;
+
+	if(bChunk && m_bHugeTLB)
+	{
+		SIZE_T dwHugeSize = AlignUp(dwSize, HUGE_PAGE_SIZE);
+
+		pv = (BYTE*)mmap(nullptr, dwHugeSize, iProt, iFlag | MAP_HUGETLB, -1, 0);
+
+		if(pv != MAP_FAILED)
+		{
+			dwSize = dwHugeSize;
+			BindMemory(pv, dwSize);
+
+			return pv;
+		}
+	}
+
+	dwSize = AlignUp(dwSize, (SIZE_T)SysGetPageSize());
+
+	if(bChunk && m_bTHP)
+	{
+		/* 按大页对齐映射，以便内核使用透明大页 */
+		SIZE_T dwMapSize = dwSize + HUGE_PAGE_SIZE;
+
+		pv = (BYTE*)mmap(nullptr, dwMapSize, iProt, iFlag, -1, 0);
+
+		if(pv == MAP_FAILED)
+			return nullptr;
+
+		BYTE* pAligned	= (BYTE*)AlignUp((SIZE_T)pv, HUGE_PAGE_SIZE);
+		SIZE_T dwHead	= pAligned - pv;
+		SIZE_T dwTail	= dwMapSize - dwHead - dwSize;
+
+		if(dwHead > 0) munmap(pv, dwHead);
+		if(dwTail > 0) munmap(pAligned + dwSize, dwTail);
+
+		pv = pAligned;
+
+		madvise(pv, dwSize, MADV_HUGEPAGE);
+	}
+	else
+	{
+		pv = (BYTE*)mmap(nullptr, dwSize, iProt, iFlag, -1, 0);
+
+		if(pv == MAP_FAILED)
+			return nullptr;
+	}
+
+	BindMemory(pv, dwSize);
+
+	return pv;
+}
+
+void CPrivateHeapImpl::BindMemory(BYTE* pv, SIZE_T dwSize)
+{
+	if(!m_bNumaInterleave)
+		return;
+
+	/* 节点掩码中不存在的节点由内核忽略；内核不支持 NUMA 或节点数较少时 mbind() 失败，内存按默认策略分配 */
+	ULONG_PTR ulNodeMask = (ULONG_PTR)-1;
+	syscall(SYS_mbind, pv, dwSize, MPOL_INTERLEAVE, &ulNodeMask, sizeof(ulNodeMask) * 8, 0);
+}
+
+BOOL CPrivateHeapImpl::UnmapMemory(BYTE* pv, SIZE_T dwSize)
+{
+	return IS_NO_ERROR(munmap(pv, dwSize));
+}
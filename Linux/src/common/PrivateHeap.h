@@ -25,10 +25,31 @@
 
 #include "GlobalDef.h"
 #include "Singleton.h"
+#include "CriSec.h"
 
 #include <malloc.h>
 
-#define HEAP_ZERO_MEMORY	0x08     
+#define HEAP_NO_SERIALIZE						0x00000001
+#define HEAP_ZERO_MEMORY						0x08     
+/* 私有堆选项：使用 MAP_HUGETLB 大页映射内存区（系统未预留大页时回退为普通页） */
+#define HEAP_CREATE_HUGE_PAGES					0x00100000
+/* 私有堆选项：对内存区使用 MADV_HUGEPAGE 建议内核使用透明大页 */
+#define HEAP_CREATE_TRANSPARENT_HUGE_PAGES		0x00200000
+/* 私有堆选项：内存区按 MPOL_INTERLEAVE 策略在各 NUMA 节点间交错分配（单节点系统无影响） */
+#define HEAP_CREATE_NUMA_INTERLEAVE				0x00400000
+
+/* 私有堆统计信息 */
+struct TPrivateHeapStat
+{
+	SIZE_T	reserved;	// 已映射的内存区大小
+	SIZE_T	committed;	// 已划分给 slab 和大内存块的内存大小
+	SIZE_T	used;		// 已分配内存块的总大小
+	SIZE_T	blocks;		// 已分配内存块数量
+	SIZE_T	classes;	// 尺寸类别数量
+	SIZE_T	slabs;		// 正在使用的 slab 数量
+	ULLONG	allocs;		// 累计分配次数
+	ULLONG	frees;		// 累计释放次数
+};
 
 class CGlobalHeapImpl
 {
@@ -69,9 +90,14 @@ public:
 	SIZE_T Compact	(DWORD dwFlags = 0)					{return -1;}
 	SIZE_T Size		(PVOID pvMemory, DWORD dwFlags = 0)	{return _msize(pvMemory);}
 
+	BOOL GetStat(TPrivateHeapStat& stat)	{ZeroObject(stat); return FALSE;}
+
 	BOOL IsValid()	{return TRUE;}
 	BOOL Reset()	{return TRUE;}
 
+	void SetNumaInterleave(BOOL bInterleave)	{}
+	BOOL IsNumaInterleave()						{return FALSE;}
+
 public:
 	CGlobalHeapImpl	(DWORD dwOptions = 0, SIZE_T dwInitSize = 0, SIZE_T dwMaxSize = 0) {}
 	~CGlobalHeapImpl()	{}
@@ -79,8 +105,162 @@ public:
 	DECLARE_NO_COPY_CLASS(CGlobalHeapImpl)
 };
 
+/*
+* 基于 slab 的私有堆
+*
+* 1、内存从 mmap() 映射的内存区（chunk）中划分，每个私有堆的内存与其它私有堆和全局堆隔离
+* 2、不超过 MAX_SLAB_BLOCK_SIZE 的内存块按尺寸类别（256 字节以下按 16 字节对齐，以上每个 2 的幂区间划分为 16 个类别）
+*	 从该类别的 slab 中分配，对象池中同类对象的尺寸相同，因此同类对象总是位于相同类别的 slab 中；更大的内存块使用 mmap() 单独映射
+* 3、大内存块释放后按尺寸类别缓存（总量不超过 MAX_LARGE_CACHE_SIZE）留待重用，mmap() / munmap() 均在锁外执行
+* 4、Compact() 把完全空闲的 slab 归还给内核（MADV_DONTNEED）并留待重用，同时解除缓存的大内存块映射；Reset() 在所有内存块都已释放时归还全部内存区
+*/
+class CPrivateHeapImpl
+{
+public:
+	/* 单个 slab 中划分的内存块（含块头）最大尺寸，超过则单独映射 */
+	static const SIZE_T MAX_SLAB_BLOCK_SIZE	= 64 * 1024;
+	/* slab 尺寸的单位 */
+	static const SIZE_T SLAB_UNIT			= 64 * 1024;
+	/* 内存区默认尺寸（使用大页时按 2MB 对齐） */
+	static const SIZE_T DEFAULT_CHUNK_SIZE	= 1024 * 1024;
+	static const SIZE_T HUGE_PAGE_SIZE		= 2 * 1024 * 1024;
+	/* 缓存的空闲大内存块总量上限 */
+	static const SIZE_T MAX_LARGE_CACHE_SIZE	= 8 * 1024 * 1024;
+
+private:
+	struct TSizeClass;
+
+	struct TSlab
+	{
+		TSizeClass*	cls;
+		TSlab*		next;
+		SIZE_T		size;
+		SIZE_T		live;
+	};
+
+	struct TBlockHeader
+	{
+		TSlab*		slab;	// 大内存块为 nullptr
+		SIZE_T		size;	// 内存块（含块头）尺寸
+	};
+
+	struct TFreeBlock
+	{
+		TFreeBlock*	next;
+	};
+
+	struct TSizeClass
+	{
+		SIZE_T		size;
+		TSizeClass*	next;
+		TSlab*		slabs;
+		TFreeBlock*	frees;
+		BYTE*		bump;
+		BYTE*		limit;
+	};
+
+	/* 大内存块的映射头，位于 TBlockHeader 之前 */
+	struct TLargeBlock
+	{
+		TLargeBlock*	prev;
+		TLargeBlock*	next;
+	};
+
+	struct TLargeClass
+	{
+		SIZE_T			size;	// 映射尺寸
+		TLargeClass*	next;
+		TLargeBlock*	frees;
+	};
+
+	struct TChunk
+	{
+		TChunk*		next;
+		SIZE_T		size;
+		BYTE*		bump;
+		BYTE*		limit;
+	};
+
+public:
+	PVOID Alloc(SIZE_T dwSize, DWORD dwFlags = 0);
+	PVOID ReAlloc(PVOID pvMemory, SIZE_T dwSize, DWORD dwFlags = 0);
+	BOOL Free(PVOID pvMemory, DWORD dwFlags = 0);
+
+	/* 归还完全空闲的 slab，返回归还的内存大小 */
+	SIZE_T Compact(DWORD dwFlags = 0);
+	SIZE_T Size(PVOID pvMemory, DWORD dwFlags = 0);
+
+	BOOL GetStat(TPrivateHeapStat& stat);
+
+	BOOL IsValid()	{return TRUE;}
+	/* 所有内存块都已释放时归还全部内存区，否则返回 FALSE 并保留内存区 */
+	BOOL Reset();
+
+	/* 设置之后映射的内存区是否在各 NUMA 节点间交错分配 */
+	void SetNumaInterleave(BOOL bInterleave)	{m_bNumaInterleave = bInterleave;}
+	BOOL IsNumaInterleave()						{return m_bNumaInterleave;}
+
+	/* 设置默认构造的私有堆使用的选项（如：HEAP_CREATE_HUGE_PAGES） */
+	static void SetDefaultOptions(DWORD dwOptions)	{sm_dwDefaultOptions = dwOptions;}
+	static DWORD GetDefaultOptions()				{return sm_dwDefaultOptions;}
+
+private:
+	PVOID DoAlloc(SIZE_T dwBlockSize);
+	void DoFree(TBlockHeader* pHeader);
+	PVOID AllocLarge(SIZE_T dwBlockSize);
+	void FreeLarge(TBlockHeader* pHeader);
+	void ReleaseAll();
+
+	TSizeClass* GetSizeClass(SIZE_T dwBlockSize);
+	TLargeClass* GetLargeClass(SIZE_T dwMapSize);
+	void LinkLarge(TLargeBlock* pBlock);
+	void UnlinkLarge(TLargeBlock* pBlock);
+	TSlab* NewSlab(TSizeClass* pClass);
+	BYTE* MapMemory(SIZE_T& dwSize, BOOL bChunk);
+	void BindMemory(BYTE* pv, SIZE_T dwSize);
+	BOOL UnmapMemory(BYTE* pv, SIZE_T dwSize);
+	BOOL CheckMaxSize(SIZE_T dwSize);
+
+	void Lock()		{if(!m_bNoSerialize) m_cs.lock();}
+	void Unlock()	{if(!m_bNoSerialize) m_cs.unlock();}
+
+	static SIZE_T BlockSize(SIZE_T dwSize);
+	static SIZE_T ClassSize(SIZE_T dwBlockSize);
+	static SIZE_T SlabSize(SIZE_T dwBlockSize);
+
+public:
+	CPrivateHeapImpl(DWORD dwOptions = sm_dwDefaultOptions, SIZE_T dwInitSize = 0, SIZE_T dwMaxSize = 0);
+	~CPrivateHeapImpl();
+
+	DECLARE_NO_COPY_CLASS(CPrivateHeapImpl)
+
+private:
+	static volatile DWORD sm_dwDefaultOptions;
+
+	CCriSec			m_cs;
+	BOOL			m_bNoSerialize;
+	BOOL			m_bHugeTLB;
+	BOOL			m_bTHP;
+	BOOL			m_bNumaInterleave;
+	SIZE_T			m_dwChunkSize;
+	SIZE_T			m_dwMaxSize;
+
+	TChunk*			m_pChunks;
+	TSizeClass*		m_pClasses;
+	TSlab*			m_pFreeSlabs;
+	TLargeBlock*	m_pLargeBlocks;
+	TLargeClass*	m_pLargeClasses;
+	SIZE_T			m_dwLargeCached;
+
+	TPrivateHeapStat m_stat;
+};
+
 #if !defined (_USE_CUSTOM_PRIVATE_HEAP)
-	using CPrivateHeap = CGlobalHeapImpl;
+	#if defined (_USE_GLOBAL_PRIVATE_HEAP)
+		using CPrivateHeap = CGlobalHeapImpl;
+	#else
+		using CPrivateHeap = CPrivateHeapImpl;
+	#endif
 #endif
 
 template<class T> class CPrivateHeapBuffer
@@ -1691,11 +1691,173 @@ private:
 	volatile DWORD m_dwCheckTime;
 };
 
+// ------------------------------------------------------------------------------------------------------------- //
+
+/*
+* 固定容量的无锁环形队列（多生产者、多消费者，元素按值存储，不分配内存）
+* 
+* 每个槽位带有序号：序号等于写入位置时可写，等于写入位置 + 1 时可读，
+* 读出后序号推进一圈，生产者和消费者之间只通过槽位序号同步
+*/
+template <class T> class CCASRing
+{
+private:
+
+	struct TCell
+	{
+		volatile DWORD	seq;
+		T				tValue;
+	};
+
+public:
+
+	/* 写入元素，队列已满则返回 FALSE */
+	BOOL TryPushBack(const T& tVal)
+	{
+		ASSERT(IsValid());
+
+		TCell* pCell	= nullptr;
+		DWORD seqPut	= m_seqPut;
+
+		while(true)
+		{
+			pCell		= m_pCells + (seqPut & m_dwMask);
+			int iDiff	= (int)(__atomic_load_n(&pCell->seq, memory_order_acquire) - seqPut);
+
+			if(iDiff == 0)
+			{
+				DWORD seqCur = ::InterlockedCompareExchange(&m_seqPut, seqPut + 1, seqPut, TRUE, memory_order_relaxed, memory_order_relaxed);
+
+				if(seqCur == seqPut)
+					break;
+
+				seqPut = seqCur;
+			}
+			else if(iDiff < 0)
+				return FALSE;
+			else
+				seqPut = m_seqPut;
+		}
+
+		pCell->tValue = tVal;
+		__atomic_store_n(&pCell->seq, seqPut + 1, memory_order_release);
+
+		return TRUE;
+	}
+
+	/* 读出元素，队列为空则返回 FALSE */
+	BOOL PopFront(T* ptVal)
+	{
+		ASSERT(IsValid() && ptVal != nullptr);
+
+		TCell* pCell	= nullptr;
+		DWORD seqGet	= m_seqGet;
+
+		while(true)
+		{
+			pCell		= m_pCells + (seqGet & m_dwMask);
+			int iDiff	= (int)(__atomic_load_n(&pCell->seq, memory_order_acquire) - (seqGet + 1));
+
+			if(iDiff == 0)
+			{
+				DWORD seqCur = ::InterlockedCompareExchange(&m_seqGet, seqGet + 1, seqGet, TRUE, memory_order_relaxed, memory_order_relaxed);
+
+				if(seqCur == seqGet)
+					break;
+
+				seqGet = seqCur;
+			}
+			else if(iDiff < 0)
+				return FALSE;
+			else
+				seqGet = m_seqGet;
+		}
+
+		*ptVal = pCell->tValue;
+		__atomic_store_n(&pCell->seq, seqGet + m_dwMask + 1, memory_order_release);
+
+		return TRUE;
+	}
+
+	BOOL IsValid	()	const	{return m_pCells != nullptr;}
+	BOOL IsEmpty	()	const	{return m_seqGet == m_seqPut;}
+	DWORD Size		()	const	{return m_seqPut - m_seqGet;}
+	DWORD Capacity	()	const	{return m_dwMask + 1;}
+
+public:
+
+	/* 重置队列容量（向上取整为 2 的幂，0 则释放队列） */
+	void Reset(DWORD dwCapacity = 0)
+	{
+		if(IsValid())
+			Destroy();
+
+		if(dwCapacity > 0)
+		{
+			DWORD dwSize = 1;
+			while(dwSize < dwCapacity) dwSize <<= 1;
+
+			m_pCells = MALLOC(TCell, dwSize);
+			m_dwMask = dwSize - 1;
+
+			for(DWORD i = 0; i < dwSize; i++)
+			{
+				m_pCells[i].seq = i;
+				new (&m_pCells[i].tValue) T();
+			}
+		}
+	}
+
+private:
+
+	void Destroy()
+	{
+		ASSERT(IsValid());
+
+		for(DWORD i = 0; i <= m_dwMask; i++)
+			m_pCells[i].tValue.~T();
+
+		FREE(m_pCells);
+
+		m_pCells = nullptr;
+		m_dwMask = 0;
+		m_seqPut = 0;
+		m_seqGet = 0;
+	}
+
+public:
+	CCASRing(DWORD dwCapacity = 0)
+	: m_pCells(nullptr)
+	, m_dwMask(0)
+	, m_seqPut(0)
+	, m_seqGet(0)
+	{
+		Reset(dwCapacity);
+	}
+
+	~CCASRing()
+	{
+		Reset(0);
+	}
+
+	DECLARE_NO_COPY_CLASS(CCASRing)
+
+private:
+	TCell*				m_pCells;
+	DWORD				m_dwMask;
+	char				pack1[PACK_SIZE_OF(TCell*) - sizeof(DWORD)];
+	volatile DWORD		m_seqPut;
+	char				pack2[PACK_SIZE_OF(DWORD)];
+	volatile DWORD		m_seqGet;
+	char				pack3[PACK_SIZE_OF(DWORD)];
+};
+
 template <class T> using CCASQueue			= CCASQueueX<T>;
 template <class T> using CCASSimpleQueue	= CCASSimpleQueueX<T>;
 
+/* fnCanRelease 非空时，锁定时间已到但 fnCanRelease() 返回 FALSE 的对象也暂不释放（非强制释放时） */
 template<typename T>
-void ReleaseGCObj(CCASQueue<T>& lsGC, DWORD dwLockTime, BOOL bForce = FALSE)
+void ReleaseGCObj(CCASQueue<T>& lsGC, DWORD dwLockTime, BOOL bForce = FALSE, BOOL (*fnCanRelease)(T*) = nullptr)
 {
 	static const int MAX_CHECK_INTERVAL = 15 * 1000;
 
@@ -1743,6 +1905,9 @@ void ReleaseGCObj(CCASQueue<T>& lsGC, DWORD dwLockTime, BOOL bForce = FALSE)
 				if((int)(now - pObj->GetFreeTime()) < (int)dwLockTime)
 					break;
 
+				if(fnCanRelease != nullptr && !fnCanRelease(pObj))
+					break;
+
 				lsGC.UnsafePopFrontNotCheck();
 			}
 
@@ -0,0 +1,277 @@
+﻿/*
+* Copyright: JessMA Open Source (ldcsaa@gmail.com)
+*
+* Author	: Bruce Liang
+* Website	: http://www.jessma.org
+* Project	: https://github.com/ldcsaa
+* Blog		: http://www.cnblogs.com/ldcsaa
+* Wiki		: http://www.oschina.net/p/hp-socket
+* QQ Group	: 75375912, 44636872
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include "GlobalDef.h"
+#include "FuncHelper.h"
+#include "CriSec.h"
+
+#include <vector>
+
+using namespace std;
+
+/* 定时器节点（侵入式，嵌入到使用者的数据结构中，不单独分配内存） */
+struct TTimerNode
+{
+	TTimerNode*	prev;
+	TTimerNode*	next;
+	ULLONG		expire;
+
+	BOOL IsArmed() const {return prev != nullptr;}
+
+	TTimerNode() : prev(nullptr), next(nullptr), expire(0) {}
+};
+
+/*
+* 分层定时轮（第 0 层 256 个槽，第 1 - 3 层各 64 个槽，高层槽轮到时把其中的定时器逐级下放到低层）
+*
+* 1、设置、重新设置和取消定时器均为 O(1)，推进时只访问当前刻度对应的槽
+* 2、到期的定时器从定时轮中摘除后复制到调用者提供的容器中，由调用者在锁外处理，节点本身可以立即被重新设置
+* 3、超出定时轮跨度的定时器先放在最高层的最后一个槽中，轮到时按实际到期时间重新放置
+*/
+template<class T> class CTimingWheelT
+{
+	static const int	ROOT_BITS	= 8;
+	static const int	LEVEL_BITS	= 6;
+	static const int	LEVELS		= 4;
+	static const int	ROOT_SIZE	= 1 << ROOT_BITS;
+	static const int	LEVEL_SIZE	= 1 << LEVEL_BITS;
+	static const ULLONG	ROOT_MASK	= ROOT_SIZE - 1;
+	static const ULLONG	LEVEL_MASK	= LEVEL_SIZE - 1;
+	static const ULLONG	MAX_SPAN	= 1ULL << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS);
+
+public:
+
+	/* 初始化定时轮（dwTick：刻度间隔，毫秒），清除所有定时器 */
+	BOOL Init(DWORD dwTick)
+	{
+		if(dwTick == 0)
+		{
+			::SetLastError(ERROR_INVALID_PARAMETER);
+			return FALSE;
+		}
+
+		Clear();
+
+		CCriSecLock locallock(m_cs);
+
+		m_dwTick	= dwTick;
+		m_ullBase	= Now();
+		m_ullCur	= 0;
+
+		return TRUE;
+	}
+
+	/* 设置定时器（dwTimeout 毫秒后到期），定时器已设置则重新设置 */
+	void Arm(T* pNode, DWORD dwTimeout)
+	{
+		ULLONG ullExpire = (Now() - m_ullBase + dwTimeout + m_dwTick - 1) / m_dwTick;
+
+		CCriSecLock locallock(m_cs);
+
+		if(pNode->IsArmed())
+			Unlink(pNode);
+		else
+			++m_dwCount;
+
+		pNode->expire = ullExpire;
+		Link(pNode);
+	}
+
+	/* 取消定时器，定时器未设置则返回 FALSE */
+	BOOL Cancel(T* pNode)
+	{
+		CCriSecLock locallock(m_cs);
+
+		if(!pNode->IsArmed())
+			return FALSE;
+
+		Unlink(pNode);
+		--m_dwCount;
+
+		return TRUE;
+	}
+
+	/* 推进到当前时间，把到期的定时器复制到 vtExpired 中，返回到期的定时器数量 */
+	int Advance(vector<T>& vtExpired)
+	{
+		size_t size		= vtExpired.size();
+		ULLONG ullNow	= (Now() - m_ullBase) / m_dwTick;
+
+		CCriSecLock locallock(m_cs);
+
+		for(; m_ullCur <= ullNow && m_dwCount > 0; ++m_ullCur)
+			Expire(vtExpired);
+
+		if(m_ullCur <= ullNow)
+			m_ullCur = ullNow + 1;
+
+		return (int)(vtExpired.size() - size);
+	}
+
+	/* 取消所有定时器 */
+	void Clear()
+	{
+		CCriSecLock locallock(m_cs);
+
+		for(int i = 0; i < ROOT_SIZE; i++)
+			Drain(m_root[i]);
+
+		for(int i = 0; i < LEVELS - 1; i++)
+		{
+			for(int j = 0; j < LEVEL_SIZE; j++)
+				Drain(m_levels[i][j]);
+		}
+
+		m_dwCount = 0;
+	}
+
+	DWORD GetTick()		{return m_dwTick;}
+	DWORD GetCount()	{return m_dwCount;}
+
+private:
+
+	void Expire(vector<T>& vtExpired)
+	{
+		if((m_ullCur & ROOT_MASK) == 0)
+		{
+			for(int i = 1; i < LEVELS; i++)
+			{
+				int idx = (int)((m_ullCur >> (ROOT_BITS + (i - 1) * LEVEL_BITS)) & LEVEL_MASK);
+
+				Cascade(m_levels[i - 1][idx]);
+
+				if(idx != 0)
+					break;
+			}
+		}
+
+		TTimerNode& head = m_root[m_ullCur & ROOT_MASK];
+
+		while(head.next != &head)
+		{
+			TTimerNode* pNode = head.next;
+
+			Unlink(pNode);
+			--m_dwCount;
+
+			vtExpired.push_back(*static_cast<T*>(pNode));
+		}
+	}
+
+	void Cascade(TTimerNode& head)
+	{
+		TTimerNode* pNode = head.next;
+
+		head.prev = head.next = &head;
+
+		while(pNode != &head)
+		{
+			TTimerNode* pNext = pNode->next;
+
+			Link(pNode);
+			pNode = pNext;
+		}
+	}
+
+	void Link(TTimerNode* pNode)
+	{
+		ULLONG ullExpire	= max(pNode->expire, m_ullCur);
+		ULLONG ullDelta		= ullExpire - m_ullCur;
+		TTimerNode* pHead	= nullptr;
+
+		if(ullDelta < ROOT_SIZE)
+			pHead = &m_root[ullExpire & ROOT_MASK];
+		else
+		{
+			int i = 1;
+
+			for(; i < LEVELS - 1; i++)
+			{
+				if(ullDelta < (1ULL << (ROOT_BITS + i * LEVEL_BITS)))
+					break;
+			}
+
+			if(ullDelta >= MAX_SPAN)
+				ullExpire = m_ullCur + MAX_SPAN - 1;
+
+			pHead = &m_levels[i - 1][(ullExpire >> (ROOT_BITS + (i - 1) * LEVEL_BITS)) & LEVEL_MASK];
+		}
+
+		pNode->next			= pHead;
+		pNode->prev			= pHead->prev;
+		pHead->prev->next	= pNode;
+		pHead->prev			= pNode;
+	}
+
+	static void Unlink(TTimerNode* pNode)
+	{
+		pNode->prev->next	= pNode->next;
+		pNode->next->prev	= pNode->prev;
+		pNode->prev			= nullptr;
+		pNode->next			= nullptr;
+	}
+
+	static void Drain(TTimerNode& head)
+	{
+		while(head.next != &head)
+			Unlink(head.next);
+	}
+
+	static ULLONG Now()
+	{
+		timespec ts;
+		return (ULLONG)::TimespecToMillisecond(::GetFutureTimespec(0, ts));
+	}
+
+public:
+	CTimingWheelT() : m_dwTick(1), m_ullBase(0), m_ullCur(0), m_dwCount(0)
+	{
+		for(int i = 0; i < ROOT_SIZE; i++)
+			m_root[i].prev = m_root[i].next = &m_root[i];
+
+		for(int i = 0; i < LEVELS - 1; i++)
+		{
+			for(int j = 0; j < LEVEL_SIZE; j++)
+				m_levels[i][j].prev = m_levels[i][j].next = &m_levels[i][j];
+		}
+	}
+
+	~CTimingWheelT()
+	{
+		Clear();
+	}
+
+	DECLARE_NO_COPY_CLASS(CTimingWheelT)
+
+private:
+	CCriSec		m_cs;
+	DWORD		m_dwTick;
+	ULLONG		m_ullBase;
+	ULLONG		m_ullCur;
+	DWORD		m_dwCount;
+
+	TTimerNode	m_root[ROOT_SIZE];
+	TTimerNode	m_levels[LEVELS - 1][LEVEL_SIZE];
+};
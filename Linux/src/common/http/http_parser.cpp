@@ -25,6 +25,11 @@
 #include <string.h>
 #include <limits.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <nmmintrin.h>
+# define HTTP_PARSER_SSE42 1
+#endif
+
 #ifdef __GNUC__
 	#pragma GCC diagnostic push
 	#pragma GCC diagnostic ignored "-Wconversion"
@@ -369,6 +374,107 @@ enum http_host_state
 #define start_state (parser->type == HTTP_REQUEST ? s_start_req : s_start_res)
 
 
+/* Fast range scanning (picohttpparser style).
+ *
+ * Each scanner returns the first byte in [p, end) that falls into one of its
+ * stop ranges. The stop sets are supersets of the bytes that would make the
+ * byte-at-a-time state machine do anything but stay in the current state, so
+ * the caller can resume the ordinary loop at the returned position and get
+ * exactly the same result. The SIMD loop only looks at whole 16-byte blocks;
+ * anything shorter is left to the ordinary loop.
+ */
+
+/* bytes that are not (non-strict) token characters, '|' and '~' excluded */
+static const char token_stop_ranges[16] = {
+  '\x00', ' ', '"', '"', '(', ')', ',', ',',
+  '/', '/', ':', '@', '[', ']', '{', '\xff'
+};
+
+/* the shorter range tables are padded to 16 bytes since they are loaded whole */
+#define URL_STOP_RANGES_LEN 8
+#define CRLF_STOP_RANGES_LEN 4
+
+/* bytes that leave s_req_path / s_req_query_string or need extra checks */
+static const char url_stop_ranges[16] = {
+  '\x00', ' ', '#', '#', '?', '?', '\x7f', '\xff'
+};
+
+static const char crlf_stop_ranges[16] = {
+  '\n', '\n', '\r', '\r'
+};
+
+#if HTTP_PARSER_SSE42
+__attribute__ ((__target__("sse4.2")))
+static const char *find_ranges_sse42(const char *p, const char *end,
+                                     const char *ranges, int ranges_len)
+{
+  __m128i r = _mm_loadu_si128((const __m128i *) ranges);
+
+  for (; end - p >= 16; p += 16) {
+    __m128i b = _mm_loadu_si128((const __m128i *) p);
+    int i = _mm_cmpestri(r, ranges_len, b, 16,
+                         _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES |
+                         _SIDD_LEAST_SIGNIFICANT);
+    if (i != 16)
+      return p + i;
+  }
+
+  return p;
+}
+
+static int sse42_supported(void)
+{
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse4.2");
+}
+
+static const int has_sse42 = sse42_supported();
+#endif
+
+static inline const char *scan_ranges(const char *p, const char *end,
+                                      const char *ranges, int ranges_len)
+{
+#if HTTP_PARSER_SSE42
+  if (LIKELY(has_sse42))
+    return find_ranges_sse42(p, end, ranges, ranges_len);
+#endif
+  return p;
+}
+
+#define SCAN_TOKEN(p, end)                                           \
+  scan_ranges((p), (end), token_stop_ranges, sizeof(token_stop_ranges))
+#define SCAN_URL(p, end)                                             \
+  scan_ranges((p), (end), url_stop_ranges, URL_STOP_RANGES_LEN)
+
+/* first CR or LF in [p, end), or end */
+static inline const char *find_crlf(const char *p, const char *end)
+{
+  const char* p_cr;
+  const char* p_lf;
+
+#if HTTP_PARSER_SSE42
+  if (LIKELY(has_sse42)) {
+    p = find_ranges_sse42(p, end, crlf_stop_ranges, CRLF_STOP_RANGES_LEN);
+
+    for (; p != end; p++) {
+      if (*p == CR || *p == LF)
+        break;
+    }
+
+    return p;
+  }
+#endif
+
+  p_cr = (const char*) memchr(p, CR, end - p);
+  p_lf = (const char*) memchr(p, LF, p_cr != NULL ? p_cr - p : end - p);
+
+  if (p_lf != NULL)
+    return p_lf;
+
+  return p_cr != NULL ? p_cr : end;
+}
+
+
 #if HTTP_PARSER_STRICT
 # define STRICT_CHECK(cond)                                          \
 do {                                                                 \
@@ -986,6 +1092,23 @@ reexecute:
       case s_req_fragment_start:
       case s_req_fragment:
       {
+        if (CURRENT_STATE() == s_req_path ||
+            CURRENT_STATE() == s_req_query_string) {
+          const char* start = p;
+          p = SCAN_URL(p, data + len);
+
+          if (p != start) {
+            if (p == data + len) {
+              COUNT_HEADER_SIZE(p - start - 1);
+              --p;
+              break;
+            }
+
+            COUNT_HEADER_SIZE(p - start);
+            ch = *p;
+          }
+        }
+
         switch (ch) {
           case ' ':
             UPDATE_STATE(s_req_http_start);
@@ -1156,6 +1279,10 @@ reexecute:
       case s_header_field:
       {
         const char* start = p;
+
+        if (parser->header_state == h_general)
+          p = SCAN_TOKEN(p, data + len);
+
         for (; p != data + len; p++) {
           ch = *p;
           c = TOKEN(ch);
@@ -1393,24 +1520,13 @@ reexecute:
           switch (h_state) {
             case h_general:
             {
-              const char* p_cr;
-              const char* p_lf;
               size_t limit = data + len - p;
 
               limit = MIN(limit, HTTP_MAX_HEADER_SIZE);
 
-              p_cr = (const char*) memchr(p, CR, limit);
-              p_lf = (const char*) memchr(p, LF, limit);
-              if (p_cr != NULL) {
-                if (p_lf != NULL && p_cr >= p_lf)
-                  p = p_lf;
-                else
-                  p = p_cr;
-              } else if (UNLIKELY(p_lf != NULL)) {
-                p = p_lf;
-              } else {
-                p = data + len;
-              }
+              const char* p_crlf = find_crlf(p, p + limit);
+
+              p = (p_crlf != p + limit) ? p_crlf : data + len;
               --p;
 
               break;